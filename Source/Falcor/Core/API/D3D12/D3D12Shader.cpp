@@ -45,8 +45,14 @@ namespace Falcor
     {
     }
 
-    bool Shader::init(ComPtr<slang::IComponentType> slangEntryPoint, const std::string& entryPointName, CompilerFlags flags, std::string& log)
+    bool Shader::init(ComPtr<slang::IComponentType> slangEntryPoint, const std::string& entryPointName, CompilerFlags flags, std::string& log, Blob pCachedCode)
     {
+        if (pCachedCode)
+        {
+            mpPrivateData->pBlob = pCachedCode.get();
+            return true;
+        }
+
         // Compile the shader kernel.
         ComPtr<slang::IBlob> pSlangDiagnostics;
         ComPtr<slang::IBlob> pShaderBlob;
@@ -60,7 +60,7 @@ namespace Falcor
     {
     }
 
-    bool Shader::init(ComPtr<slang::IComponentType> slangEntryPoint, const std::string& entryPointName, CompilerFlags flags, std::string& log)
+    bool Shader::init(ComPtr<slang::IComponentType> slangEntryPoint, const std::string& entryPointName, CompilerFlags flags, std::string& log, Blob pCachedCode)
     {
         // In GFX, we do not generate actual shader code at program creation.
         // The actual shader code will only be generated and cached when all specialization arguments
@@ -71,7 +71,7 @@ namespace Falcor
         // Since most users/render-passes do not need to get shader kernel code, we defer
         // the call to slang's `getEntryPointCode` function until it is actually needed.
         // to avoid redundant shader compiler invocation.
-        mpPrivateData->pBlob = nullptr;
+        mpPrivateData->pBlob = pCachedCode;
         mpPrivateData->pLinkedSlangEntryPoint = slangEntryPoint;
         return slangEntryPoint != nullptr;
     }
@@ -328,13 +328,14 @@ namespace Falcor
             \param[in] linkedSlangEntryPoint The Slang IComponentType that defines the shader entry point.
             \param[in] type The Type of the shader
             \param[out] log This string will contain the error log message in case shader compilation failed
+            \param[in] pCachedCode Optional. Previously compiled code of the entry point. If set, the entry point is not compiled again.
             \return If success, a new shader object, otherwise nullptr
         */
-        static SharedPtr create(ComPtr<slang::IComponentType> linkedSlangEntryPoint, ShaderType type, std::string const&  entryPointName, CompilerFlags flags, std::string& log)
+        static SharedPtr create(ComPtr<slang::IComponentType> linkedSlangEntryPoint, ShaderType type, std::string const&  entryPointName, CompilerFlags flags, std::string& log, Blob pCachedCode = nullptr)
         {
             SharedPtr pShader = SharedPtr(new Shader(type));
             pShader->mEntryPointName = entryPointName;
-            return pShader->init(linkedSlangEntryPoint, entryPointName, flags, log) ? pShader : nullptr;
+            return pShader->init(linkedSlangEntryPoint, entryPointName, flags, log, pCachedCode) ? pShader : nullptr;
         }
 
         virtual ~Shader();
@@ -358,7 +359,7 @@ namespace Falcor
 
     protected:
         // API handle depends on the shader Type, so it stored be stored as part of the private data
-        bool init(ComPtr<slang::IComponentType> linkedSlangEntryPoint, const std::string& entryPointName, CompilerFlags flags, std::string& log);
+        bool init(ComPtr<slang::IComponentType> linkedSlangEntryPoint, const std::string& entryPointName, CompilerFlags flags, std::string& log, Blob pCachedCode);
         Shader(ShaderType Type);
         ShaderType mType;
         std::string mEntryPointName;
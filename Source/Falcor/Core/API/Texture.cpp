@@ -343,7 +343,15 @@ namespace Falcor
         uint32_t height = getHeight(mipLevel);
         auto func = [=]()
         {
-            Bitmap::saveImage(path, width, height, format, exportFlags, resourceFormat, true, (void*)textureData.data());
+            // Nobody waits on the task, so errors are reported here instead of through the task handle.
+            try
+            {
+                Bitmap::saveImage(path, width, height, format, exportFlags, resourceFormat, true, (void*)textureData.data());
+            }
+            catch (const std::exception& e)
+            {
+                logError("Failed to save texture to '{}': {}", path, e.what());
+            }
         };
 
         Threading::dispatchTask(func);
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Program.h"
+#include "ProgramKernelCache.h"
 #include "ProgramVars.h"
 #include "Core/Platform/OS.h"
 #include "Core/API/Device.h"
@@ -37,6 +38,7 @@
 
 #include <slang.h>
 
+#include <algorithm>
 #include <set>
 
 namespace Falcor
@@ -51,6 +53,52 @@ namespace Falcor
     static bool sGenerateDebugInfo;
     static Program::ForcedCompilerFlags sForcedCompilerFlags;
 
+    // Bump this whenever the layout of the kernel cache key changes.
+    static const uint32_t kKernelCacheKeyVersion = 1;
+
+    static void hashString(SHA1& sha1, const std::string& str)
+    {
+        uint64_t length = str.size();
+        sha1.update(&length, sizeof(length));
+        sha1.update(str.data(), str.size());
+    }
+
+    static void hashDefineList(SHA1& sha1, const Program::DefineList& defineList)
+    {
+        uint64_t count = defineList.size();
+        sha1.update(&count, sizeof(count));
+        for (const auto& [name, value] : defineList)
+        {
+            hashString(sha1, name);
+            hashString(sha1, value);
+        }
+    }
+
+    static ProgramKernelCache::Key computeKernelKey(
+        const SHA1::MD& versionKey,
+        const Program::TypeConformanceList& typeConformances,
+        const std::string& name,
+        const std::string& exportName,
+        ShaderType stage,
+        const std::string& groupNameSuffix)
+    {
+        SHA1 sha1;
+        sha1.update(versionKey.data(), versionKey.size());
+        uint64_t count = typeConformances.size();
+        sha1.update(&count, sizeof(count));
+        for (const auto& [conformance, id] : typeConformances)
+        {
+            hashString(sha1, conformance.mTypeName);
+            hashString(sha1, conformance.mInterfaceName);
+            sha1.update(&id, sizeof(id));
+        }
+        hashString(sha1, name);
+        hashString(sha1, exportName);
+        sha1.update(&stage, sizeof(stage));
+        hashString(sha1, groupNameSuffix);
+        return sha1.finalize();
+    }
+
     Program::Desc applyForcedCompilerFlags(Program::Desc desc)
     {
         Shader::CompilerFlags flags = desc.getCompilerFlags();
@@ -838,7 +886,9 @@ namespace Falcor
         // Create one composite component type for the type conformances of each entry point group.
         // The type conformances for each group is the combination of the global and group type conformances.
         std::vector<ComPtr<slang::IComponentType>> typeConformancesCompositeComponents;
+        std::vector<TypeConformanceList> groupTypeConformances;
         typeConformancesCompositeComponents.reserve(getEntryPointGroupCount());
+        groupTypeConformances.reserve(getEntryPointGroupCount());
         for (const auto& group : mDesc.mGroups)
         {
             TypeConformanceList typeConformances = mTypeConformanceList;
@@ -847,6 +897,7 @@ namespace Falcor
                 typeConformancesCompositeComponents.emplace_back(*typeConformanceComponentList);
             else
                 return nullptr;
+            groupTypeConformances.push_back(std::move(typeConformances));
         }
 
         // Create a `IComponentType` for each entry point.
@@ -984,6 +1035,15 @@ namespace Falcor
         ProgramReflection::SharedPtr pReflector;
         doSlangReflection(pVersion, pSpecializedSlangProgram, pLinkedEntryPoints, pReflector, log);
 
+        // Kernels are only looked up in the persistent cache if the global scope is not specialized,
+        // as the specialization arguments are not part of the kernel key.
+        bool useKernelCache = pVersion->mKernelCacheKey.has_value();
+#ifdef FALCOR_D3D12
+        useKernelCache = useKernelCache && specializationArgs.empty();
+#else
+        useKernelCache = false;
+#endif
+
         // Create Shader objects for each entry point and cache them here.
         std::vector<Shader::SharedPtr> allShaders;
         for (uint32_t i = 0; i < allEntryPointCount; i++)
@@ -991,9 +1051,24 @@ namespace Falcor
             auto pLinkedEntryPoint = pLinkedEntryPoints[i];
             auto entryPointDesc = mDesc.mEntryPoints[i];
 
-            Shader::SharedPtr shader = Shader::create(pLinkedEntryPoint, entryPointDesc.stage, entryPointDesc.exportName, mDesc.getCompilerFlags(), log);
+            ProgramKernelCache::Key kernelKey;
+            Shader::Blob pCachedCode;
+            if (useKernelCache)
+            {
+                const auto& group = mDesc.mGroups[entryPointDesc.groupIndex];
+                kernelKey = computeKernelKey(*pVersion->mKernelCacheKey, groupTypeConformances[entryPointDesc.groupIndex], entryPointDesc.name, entryPointDesc.exportName, entryPointDesc.stage, group.nameSuffix);
+                pCachedCode = ProgramKernelCache::read(kernelKey);
+            }
+
+            Shader::SharedPtr shader = Shader::create(pLinkedEntryPoint, entryPointDesc.stage, entryPointDesc.exportName, mDesc.getCompilerFlags(), log, pCachedCode);
             if (!shader) return nullptr;
 
+            if (useKernelCache && !pCachedCode)
+            {
+                auto blobData = shader->getBlobData();
+                ProgramKernelCache::write(kernelKey, blobData.data, blobData.size);
+            }
+
             allShaders.push_back(std::move(shader));
         }
 
@@ -1117,10 +1192,13 @@ namespace Falcor
 
         // Extract list of files referenced, for dependency-tracking purposes.
         int depFileCount = spGetDependencyFileCount(pSlangRequest);
+        std::vector<std::string> depFilePaths;
+        depFilePaths.reserve(depFileCount);
         for (int ii = 0; ii < depFileCount; ++ii)
         {
             std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
             mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
+            depFilePaths.push_back(depFilePath);
         }
 
         // Note: the `ProgramReflection` needs to be able to refer back to the
@@ -1134,6 +1212,10 @@ namespace Falcor
         // of Falcor they could be the same object.
         //
         ProgramVersion::SharedPtr pVersion = ProgramVersion::createEmpty(const_cast<Program*>(this), pSlangGlobalScope);
+        if (mDesc.mUseKernelCache && ProgramKernelCache::isEnabled())
+        {
+            pVersion->mKernelCacheKey = computeKernelCacheKey(depFilePaths);
+        }
 
         // Note: Because of interactions between how `SV_Target` outputs
         // and `u` register bindings work in Slang today (as a compatibility
@@ -1173,6 +1255,59 @@ namespace Falcor
         return pVersion;
     }
 
+    std::optional<SHA1::MD> Program::computeKernelCacheKey(const std::vector<std::string>& dependencyPaths) const
+    {
+        SHA1 sha1;
+        sha1.update(&kKernelCacheKeyVersion, sizeof(kKernelCacheKeyVersion));
+        hashString(sha1, spGetBuildTagString());
+        hashString(sha1, mDesc.mShaderModel);
+        Shader::CompilerFlags compilerFlags = mDesc.getCompilerFlags();
+        sha1.update(&compilerFlags, sizeof(compilerFlags));
+        sha1.update(&sGenerateDebugInfo, sizeof(sGenerateDebugInfo));
+        uint64_t argumentCount = mDesc.mCompilerArguments.size();
+        sha1.update(&argumentCount, sizeof(argumentCount));
+        for (const auto& arg : mDesc.mCompilerArguments) hashString(sha1, arg);
+        hashDefineList(sha1, sGlobalDefineList);
+        hashDefineList(sha1, mDefineList);
+
+        // Hash the modules in order, as later modules can depend on earlier ones.
+        uint64_t sourceCount = mDesc.mSources.size();
+        sha1.update(&sourceCount, sizeof(sourceCount));
+        for (const auto& src : mDesc.mSources)
+        {
+            const auto& module = src.source;
+            sha1.update(&module.type, sizeof(module.type));
+            sha1.update(&module.createTranslationUnit, sizeof(module.createTranslationUnit));
+            hashString(sha1, module.moduleName);
+            hashString(sha1, module.type == ShaderModule::Type::String ? module.str : module.filePath.string());
+        }
+
+        // Hash the contents of all dependencies. The paths are only used for ordering, so that
+        // the key does not depend on the location of the source tree.
+        std::vector<std::string> sortedPaths = dependencyPaths;
+        std::sort(sortedPaths.begin(), sortedPaths.end());
+        sortedPaths.erase(std::unique(sortedPaths.begin(), sortedPaths.end()), sortedPaths.end());
+        for (const auto& path : sortedPaths)
+        {
+            // Modules created from strings have virtual paths, their contents are hashed above.
+            if (!std::filesystem::exists(path)) continue;
+
+            std::string content;
+            try
+            {
+                content = readFile(path);
+            }
+            catch (const std::exception& e)
+            {
+                logWarning("Kernel cache is disabled for program '{}', failed to read '{}': {}", getProgramDescString(), path, e.what());
+                return {};
+            }
+            hashString(sha1, content);
+        }
+
+        return sha1.finalize();
+    }
+
     EntryPointGroupKernels::SharedPtr Program::createEntryPointGroupKernels(
         const std::vector<Shader::SharedPtr>& shaders,
         EntryPointBaseReflection::SharedPtr const& pReflector) const
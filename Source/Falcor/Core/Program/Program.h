@@ -29,8 +29,10 @@
 #include "ProgramVersion.h"
 #include "Core/Macros.h"
 #include "Core/API/Shader.h"
+#include "Utils/CryptoUtils.h"
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string_view>
 #include <string>
 #include <map>
@@ -147,6 +149,11 @@ namespace Falcor
             */
             Desc& dumpIntermediates(bool enable) { enable ? mShaderFlags |= Shader::CompilerFlags::DumpIntermediates : mShaderFlags &= ~(Shader::CompilerFlags::DumpIntermediates); return *this; }
 
+            /** Enable/disable the persistent kernel cache (see ProgramKernelCache).
+                Use this for large programs that are recompiled with the same defines and type conformances across runs.
+            */
+            Desc& useKernelCache(bool enable) { mUseKernelCache = enable; return *this; }
+
             /** Set the shader model string.
                 This should be `6_0`, `6_1`, `6_2`, `6_3`, `6_4`, or `6_5`. The default is `6_3`.
             */
@@ -211,6 +218,7 @@ namespace Falcor
             Shader::CompilerFlags mShaderFlags = Shader::CompilerFlags::None;
             ArgumentList mCompilerArguments;
             std::string mShaderModel = "6_3";
+            bool mUseKernelCache = false;
         };
 
         struct CompilationStats
@@ -382,6 +390,12 @@ namespace Falcor
 
         ProgramVersion::SharedPtr preprocessAndCreateProgramVersion(std::string& log) const;
 
+        /** Compute the kernel cache key of the inputs shared by all kernels of a program version.
+            \param[in] dependencyPaths Paths of all source files the program version depends on.
+            \return The key, or nullopt if a source file could not be read.
+        */
+        std::optional<SHA1::MD> computeKernelCacheKey(const std::vector<std::string>& dependencyPaths) const;
+
         ProgramKernels::SharedPtr preprocessAndCreateProgramKernels(
             ProgramVersion const* pVersion,
             ProgramVars    const* pVars,
@@ -0,0 +1,259 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ProgramKernelCache.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/Scripting/ScriptBindings.h"
+
+#include <slang.h>
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <sstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Specifies the current kernel file version.
+            This needs to be incremented every time the file format changes!
+        */
+        const uint32_t kVersion = 1;
+
+        /** Kernel cache directory (subdirectory in the application data directory).
+        */
+        const std::string kDirectory = "NVIDIA/Falcor/ProgramKernelCache";
+
+        const char* kMagic = "FalcorK$";
+        struct Header
+        {
+            uint8_t magic[8]{};
+            uint32_t version{};
+            uint32_t reserved{};
+            uint64_t size{};
+
+            bool isValid() const
+            {
+                return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
+            }
+        };
+
+        /** Blob holding kernel code read from the cache.
+            The interface ID of ISlangBlob matches ID3DBlob, so it can be used wherever Slang's own blobs are used.
+        */
+        class KernelBlob : public ISlangBlob
+        {
+        public:
+            KernelBlob(std::vector<uint8_t>&& data) : mData(std::move(data)) {}
+
+            SLANG_NO_THROW SlangResult SLANG_MCALL queryInterface(SlangUUID const& uuid, void** outObject) override
+            {
+                if (isSameUUID(uuid, ISlangUnknown::getTypeGuid()) || isSameUUID(uuid, ISlangBlob::getTypeGuid()))
+                {
+                    addRef();
+                    *outObject = static_cast<ISlangBlob*>(this);
+                    return SLANG_OK;
+                }
+                *outObject = nullptr;
+                return SLANG_E_NO_INTERFACE;
+            }
+
+            SLANG_NO_THROW uint32_t SLANG_MCALL addRef() override { return ++mRefCount; }
+
+            SLANG_NO_THROW uint32_t SLANG_MCALL release() override
+            {
+                uint32_t count = --mRefCount;
+                if (count == 0) delete this;
+                return count;
+            }
+
+            SLANG_NO_THROW void const* SLANG_MCALL getBufferPointer() override { return mData.data(); }
+            SLANG_NO_THROW size_t SLANG_MCALL getBufferSize() override { return mData.size(); }
+
+        private:
+            static bool isSameUUID(const SlangUUID& a, const SlangUUID& b) { return std::memcmp(&a, &b, sizeof(SlangUUID)) == 0; }
+
+            std::atomic<uint32_t> mRefCount = 0;
+            std::vector<uint8_t> mData;
+        };
+
+        // Kernels may be compiled from multiple threads.
+        std::mutex sMutex;
+        bool sEnabled = true;
+        std::filesystem::path sDirectory;
+        ProgramKernelCache::Stats sStats;
+
+        std::filesystem::path getCachePath(const ProgramKernelCache::Key& key)
+        {
+            std::stringstream ss;
+            ss << std::hex << std::setfill('0');
+            for (auto c : key) ss << std::setw(2) << (int)c;
+            return ProgramKernelCache::getDirectory() / ss.str();
+        }
+    }
+
+    void ProgramKernelCache::setEnabled(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sEnabled = enabled;
+    }
+
+    bool ProgramKernelCache::isEnabled()
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        return sEnabled;
+    }
+
+    void ProgramKernelCache::setDirectory(const std::filesystem::path& path)
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sDirectory = path;
+    }
+
+    std::filesystem::path ProgramKernelCache::getDirectory()
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        return sDirectory.empty() ? getAppDataDirectory() / kDirectory : sDirectory;
+    }
+
+    Shader::Blob ProgramKernelCache::read(const Key& key)
+    {
+        auto cachePath = getCachePath(key);
+
+        std::vector<uint8_t> data;
+        std::ifstream fs(cachePath, std::ios_base::binary);
+        if (fs.good())
+        {
+            Header header;
+            fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (fs.good() && header.isValid() && header.size > 0)
+            {
+                data.resize(header.size);
+                fs.read(reinterpret_cast<char*>(data.data()), data.size());
+                // A truncated file, e.g. from a concurrent write that failed, counts as a miss.
+                if (!fs.good()) data.clear();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (data.empty())
+        {
+            sStats.missCount++;
+            return nullptr;
+        }
+        sStats.hitCount++;
+        sStats.bytesRead += data.size();
+        return Shader::Blob(new KernelBlob(std::move(data)));
+    }
+
+    void ProgramKernelCache::write(const Key& key, const void* pData, size_t size)
+    {
+        FALCOR_ASSERT(pData && size > 0);
+        auto cachePath = getCachePath(key);
+
+        // Write to a temporary file first, so that concurrent readers never see a partial kernel.
+        auto tempPath = cachePath;
+        tempPath += fmt::format(".{:08x}.tmp", std::random_device()());
+        try
+        {
+            std::filesystem::create_directories(cachePath.parent_path());
+            {
+                std::ofstream fs(tempPath, std::ios_base::binary);
+                Header header;
+                std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+                header.version = kVersion;
+                header.size = size;
+                fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                fs.write(reinterpret_cast<const char*>(pData), size);
+                if (!fs.good()) throw RuntimeError("Failed to write '{}'.", tempPath);
+            }
+            std::filesystem::rename(tempPath, cachePath);
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("Failed to write program kernel cache file '{}': {}", cachePath, e.what());
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(sMutex);
+        sStats.writeCount++;
+        sStats.bytesWritten += size;
+    }
+
+    void ProgramKernelCache::clear()
+    {
+        auto directory = getDirectory();
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+        if (ec) logWarning("Failed to clear program kernel cache directory '{}': {}", directory, ec.message());
+    }
+
+    ProgramKernelCache::Stats ProgramKernelCache::getStats()
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        return sStats;
+    }
+
+    void ProgramKernelCache::resetStats()
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sStats = {};
+    }
+
+    FALCOR_SCRIPT_BINDING(ProgramKernelCache)
+    {
+        pybind11::class_<ProgramKernelCache> programKernelCache(m, "ProgramKernelCache");
+        programKernelCache.def_property_static("enabled",
+            [](pybind11::object) { return ProgramKernelCache::isEnabled(); },
+            [](pybind11::object, bool enabled) { ProgramKernelCache::setEnabled(enabled); }
+        );
+        programKernelCache.def_property_static("directory",
+            [](pybind11::object) { return ProgramKernelCache::getDirectory(); },
+            [](pybind11::object, const std::filesystem::path& path) { ProgramKernelCache::setDirectory(path); }
+        );
+        programKernelCache.def_static("stats", []()
+        {
+            auto stats = ProgramKernelCache::getStats();
+            pybind11::dict d;
+            d["hitCount"] = stats.hitCount;
+            d["missCount"] = stats.missCount;
+            d["writeCount"] = stats.writeCount;
+            d["bytesRead"] = stats.bytesRead;
+            d["bytesWritten"] = stats.bytesWritten;
+            return d;
+        });
+        programKernelCache.def_static("resetStats", &ProgramKernelCache::resetStats);
+        programKernelCache.def_static("clear", &ProgramKernelCache::clear);
+    }
+}
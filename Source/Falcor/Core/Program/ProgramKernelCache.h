@@ -0,0 +1,89 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Shader.h"
+#include "Utils/CryptoUtils.h"
+#include <filesystem>
+
+namespace Falcor
+{
+    /** Persistent cache of compiled program kernels.
+        Programs that opt in with Program::Desc::useKernelCache() look up the compiled code of each entry point
+        in this cache before invoking the downstream compiler, and store the code on a miss. The cache is shared
+        by all programs and persists across runs in the application data directory.
+        The key of a kernel covers the contents of all source files of the program, the define lists, the type
+        conformances, the entry point, the shader model, compiler flags and arguments, and the Slang version.
+        Entries of outdated sources are never hit again; use clear() to remove them.
+        Only the D3D12 backend uses the cache. With GFX the kernel code is generated when the pipeline is created.
+    */
+    class FALCOR_API ProgramKernelCache
+    {
+    public:
+        using Key = SHA1::MD;
+
+        struct Stats
+        {
+            uint64_t hitCount = 0;      ///< Number of kernels read from the cache.
+            uint64_t missCount = 0;     ///< Number of kernels not found in the cache.
+            uint64_t writeCount = 0;    ///< Number of kernels written to the cache.
+            uint64_t bytesRead = 0;     ///< Total size of the kernels read from the cache in bytes.
+            uint64_t bytesWritten = 0;  ///< Total size of the kernels written to the cache in bytes.
+        };
+
+        /** Enable/disable the cache for all programs. The cache is enabled by default.
+        */
+        static void setEnabled(bool enabled);
+        static bool isEnabled();
+
+        /** Set the cache directory. The default is a subdirectory of the application data directory.
+        */
+        static void setDirectory(const std::filesystem::path& path);
+        static std::filesystem::path getDirectory();
+
+        /** Read a kernel from the cache.
+            \param[in] key Kernel key.
+            \return The kernel code, or nullptr on a miss.
+        */
+        static Shader::Blob read(const Key& key);
+
+        /** Write a kernel to the cache. Failures are logged and otherwise ignored.
+            \param[in] key Kernel key.
+            \param[in] pData Kernel code.
+            \param[in] size Size of the kernel code in bytes.
+        */
+        static void write(const Key& key, const void* pData, size_t size);
+
+        /** Remove all kernels from the cache directory.
+        */
+        static void clear();
+
+        static Stats getStats();
+        static void resetStats();
+    };
+}
@@ -30,7 +30,9 @@
 #include "Core/Macros.h"
 #include "Core/API/Shader.h"
 #include "Core/API/Handles.h"
+#include "Utils/CryptoUtils.h"
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -269,6 +271,9 @@ namespace Falcor
         ComPtr<slang::IComponentType>   mpSlangGlobalScope;
         std::vector<ComPtr<slang::IComponentType>> mpSlangEntryPoints;
 
+        // Kernel cache key of the inputs shared by all kernels, or nullopt if the kernel cache is not used
+        std::optional<SHA1::MD>         mKernelCacheKey;
+
         // Cached version of compiled kernels for this program version
         mutable std::unordered_map<std::string, ProgramKernels::SharedPtr> mpKernels;
     };
@@ -192,6 +192,10 @@ namespace Falcor
             */
             Desc& dumpIntermediates(bool enable) { mBaseDesc.dumpIntermediates(enable); return *this; }
 
+            /** Enable/disable the persistent kernel cache (see ProgramKernelCache).
+            */
+            Desc& useKernelCache(bool enable) { mBaseDesc.useKernelCache(enable); return *this; }
+
             /** Set the shader model. The default is SM 6.5 for DXR Tier 1.1 support.
             */
             Desc& setShaderModel(const std::string& sm) { mBaseDesc.setShaderModel(sm); return *this; };
@@ -82,6 +82,7 @@
 #include "Core/Program/GraphicsProgram.h"
 #include "Core/Program/CUDAProgram.h"
 #include "Core/Program/Program.h"
+#include "Core/Program/ProgramKernelCache.h"
 #include "Core/Program/ProgramReflection.h"
 #include "Core/Program/ProgramVars.h"
 #include "Core/Program/ProgramVersion.h"
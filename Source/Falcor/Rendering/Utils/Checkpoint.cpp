@@ -0,0 +1,295 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Checkpoint.h"
+#include "Core/API/RenderContext.h"
+#include "Core/API/Texture.h"
+#include "Utils/Math/Common.h"
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Version of the file format. This needs to be incremented every time the layout of the file changes.
+            The layout of the entries is versioned separately by the owner of the checkpoint.
+        */
+        const uint32_t kFormatVersion = 1;
+
+        const char kMagic[8] = { 'F', 'a', 'l', 'c', 'o', 'r', 'C', 'P' };
+
+        enum class EntryKind : uint32_t
+        {
+            Value = 0,
+            Texture = 1,
+        };
+
+        uint64_t getTextureDataSize(const Checkpoint::TextureData& texture)
+        {
+            const uint64_t rowPitch = getFormatRowPitch(texture.format, texture.width);
+            const uint64_t rows = div_round_up(texture.height, getFormatHeightCompressionRatio(texture.format));
+            return rowPitch * rows * texture.depth;
+        }
+
+        class Writer
+        {
+        public:
+            Writer(std::ostream& stream) : mStream(stream) {}
+
+            void write(const void* data, size_t len) { mStream.write(reinterpret_cast<const char*>(data), len); }
+
+            template<typename T>
+            void write(const T& value) { write(&value, sizeof(T)); }
+
+            void writeString(const std::string& value)
+            {
+                write((uint64_t)value.size());
+                write(value.data(), value.size());
+            }
+
+            void writeBytes(const std::vector<uint8_t>& bytes)
+            {
+                write((uint64_t)bytes.size());
+                write(bytes.data(), bytes.size());
+            }
+
+        private:
+            std::ostream& mStream;
+        };
+
+        class Reader
+        {
+        public:
+            Reader(std::istream& stream) : mStream(stream) {}
+
+            void read(void* data, size_t len)
+            {
+                mStream.read(reinterpret_cast<char*>(data), len);
+                if (!mStream || (size_t)mStream.gcount() != len) throw RuntimeError("Checkpoint is truncated.");
+            }
+
+            template<typename T>
+            T read()
+            {
+                T value;
+                read(&value, sizeof(T));
+                return value;
+            }
+
+            std::string readString()
+            {
+                std::string value(readSize(), '\0');
+                read(value.data(), value.size());
+                return value;
+            }
+
+            std::vector<uint8_t> readBytes()
+            {
+                std::vector<uint8_t> bytes(readSize());
+                read(bytes.data(), bytes.size());
+                return bytes;
+            }
+
+        private:
+            size_t readSize()
+            {
+                // Guard against allocating huge buffers for corrupt files.
+                const uint64_t size = read<uint64_t>();
+                const std::streampos pos = mStream.tellg();
+                mStream.seekg(0, std::ios::end);
+                const std::streampos end = mStream.tellg();
+                mStream.seekg(pos);
+                if (pos < 0 || end < 0 || size > uint64_t(end - pos)) throw RuntimeError("Checkpoint is truncated.");
+                return (size_t)size;
+            }
+
+            std::istream& mStream;
+        };
+    }
+
+    Checkpoint::Checkpoint(const std::string& type, uint32_t version)
+        : mType(type)
+        , mVersion(version)
+    {}
+
+    void Checkpoint::setTexture(const std::string& name, TextureData texture)
+    {
+        if (texture.format == ResourceFormat::Unknown) throw ArgumentError("Checkpoint texture '{}' has an unknown format.", name);
+        if (texture.data.size() != getTextureDataSize(texture))
+        {
+            throw ArgumentError("Checkpoint texture '{}' has {} bytes of data, expected {} bytes for a {}x{}x{} {} texture.",
+                name, texture.data.size(), getTextureDataSize(texture), texture.width, texture.height, texture.depth, to_string(texture.format));
+        }
+        mTextures[name] = std::move(texture);
+    }
+
+    const Checkpoint::TextureData& Checkpoint::getTexture(const std::string& name) const
+    {
+        auto it = mTextures.find(name);
+        if (it == mTextures.end()) throw ArgumentError("Checkpoint has no texture '{}'.", name);
+        return it->second;
+    }
+
+    const std::vector<uint8_t>& Checkpoint::getValueBytes(const std::string& name, size_t size) const
+    {
+        auto it = mValues.find(name);
+        if (it == mValues.end()) throw ArgumentError("Checkpoint has no value '{}'.", name);
+        if (it->second.size() != size) throw ArgumentError("Checkpoint value '{}' has {} bytes, expected {} bytes.", name, it->second.size(), size);
+        return it->second;
+    }
+
+    void Checkpoint::captureTexture(const std::string& name, RenderContext* pRenderContext, const Texture* pTexture)
+    {
+        FALCOR_ASSERT(pRenderContext && pTexture);
+        TextureData texture;
+        texture.width = pTexture->getWidth();
+        texture.height = pTexture->getHeight();
+        texture.depth = pTexture->getDepth();
+        texture.format = pTexture->getFormat();
+        texture.data = pRenderContext->readTextureSubresource(pTexture, 0);
+        setTexture(name, std::move(texture));
+    }
+
+    void Checkpoint::restoreTexture(const std::string& name, RenderContext* pRenderContext, const Texture* pTexture) const
+    {
+        FALCOR_ASSERT(pRenderContext && pTexture);
+        const TextureData& texture = getTexture(name);
+        if (texture.width != pTexture->getWidth() || texture.height != pTexture->getHeight() || texture.depth != pTexture->getDepth() || texture.format != pTexture->getFormat())
+        {
+            throw ArgumentError("Checkpoint texture '{}' is a {}x{}x{} {} texture, but the target is {}x{}x{} {}.",
+                name, texture.width, texture.height, texture.depth, to_string(texture.format),
+                pTexture->getWidth(), pTexture->getHeight(), pTexture->getDepth(), to_string(pTexture->getFormat()));
+        }
+        pRenderContext->updateSubresourceData(pTexture, 0, texture.data.data());
+    }
+
+    void Checkpoint::write(std::ostream& stream) const
+    {
+        Writer writer(stream);
+        writer.write(kMagic, sizeof(kMagic));
+        writer.write(kFormatVersion);
+        writer.writeString(mType);
+        writer.write(mVersion);
+
+        writer.write((uint32_t)(mValues.size() + mTextures.size()));
+        for (const auto& [name, bytes] : mValues)
+        {
+            writer.writeString(name);
+            writer.write(EntryKind::Value);
+            writer.writeBytes(bytes);
+        }
+        for (const auto& [name, texture] : mTextures)
+        {
+            writer.writeString(name);
+            writer.write(EntryKind::Texture);
+            writer.write(texture.width);
+            writer.write(texture.height);
+            writer.write(texture.depth);
+            writer.write(texture.format);
+            writer.writeBytes(texture.data);
+        }
+
+        if (!stream) throw RuntimeError("Failed to write checkpoint.");
+    }
+
+    void Checkpoint::write(const std::filesystem::path& path) const
+    {
+        // Write to a temporary file first so that a crash while writing doesn't destroy the previous checkpoint.
+        std::filesystem::path tempPath = path;
+        tempPath += ".tmp";
+        {
+            std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+            if (!stream) throw RuntimeError("Failed to open checkpoint file '{}' for writing.", tempPath.string());
+            write(stream);
+            stream.close();
+            if (!stream) throw RuntimeError("Failed to write checkpoint file '{}'.", tempPath.string());
+        }
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec) throw RuntimeError("Failed to write checkpoint file '{}': {}", path.string(), ec.message());
+    }
+
+    Checkpoint Checkpoint::read(std::istream& stream, const std::string& type, uint32_t version)
+    {
+        Reader reader(stream);
+
+        char magic[sizeof(kMagic)] = {};
+        reader.read(magic, sizeof(magic));
+        if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) throw RuntimeError("Data is not a checkpoint.");
+        const uint32_t formatVersion = reader.read<uint32_t>();
+        if (formatVersion != kFormatVersion) throw RuntimeError("Checkpoint has file format version {}, expected {}.", formatVersion, kFormatVersion);
+
+        // Read the header fields into locals first, as the evaluation order of function arguments is unspecified.
+        const std::string checkpointType = reader.readString();
+        const uint32_t checkpointVersion = reader.read<uint32_t>();
+        Checkpoint checkpoint(checkpointType, checkpointVersion);
+        if (checkpoint.mType != type) throw RuntimeError("Checkpoint is of type '{}', expected '{}'.", checkpoint.mType, type);
+        if (checkpoint.mVersion != version) throw RuntimeError("Checkpoint of type '{}' has version {}, expected {}.", type, checkpoint.mVersion, version);
+
+        const uint32_t entryCount = reader.read<uint32_t>();
+        for (uint32_t i = 0; i < entryCount; i++)
+        {
+            std::string name = reader.readString();
+            const EntryKind kind = reader.read<EntryKind>();
+            if (kind == EntryKind::Value)
+            {
+                checkpoint.mValues[name] = reader.readBytes();
+            }
+            else if (kind == EntryKind::Texture)
+            {
+                TextureData texture;
+                texture.width = reader.read<uint32_t>();
+                texture.height = reader.read<uint32_t>();
+                texture.depth = reader.read<uint32_t>();
+                texture.format = reader.read<ResourceFormat>();
+                if ((uint32_t)texture.format >= (uint32_t)ResourceFormat::Count) throw RuntimeError("Checkpoint texture '{}' has an invalid format.", name);
+                texture.data = reader.readBytes();
+                if (texture.data.size() != getTextureDataSize(texture)) throw RuntimeError("Checkpoint texture '{}' has an invalid size.", name);
+                checkpoint.mTextures[name] = std::move(texture);
+            }
+            else
+            {
+                throw RuntimeError("Checkpoint entry '{}' has an invalid kind.", name);
+            }
+        }
+        return checkpoint;
+    }
+
+    Checkpoint Checkpoint::read(const std::filesystem::path& path, const std::string& type, uint32_t version)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) throw RuntimeError("Failed to open checkpoint file '{}'.", path.string());
+        try
+        {
+            return read(stream, type, version);
+        }
+        catch (const RuntimeError& e)
+        {
+            throw RuntimeError("Failed to read checkpoint file '{}': {}", path.string(), e.what());
+        }
+    }
+}
@@ -0,0 +1,144 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Errors.h"
+#include "Core/API/Formats.h"
+#include <cstring>
+#include <filesystem>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Falcor
+{
+    class RenderContext;
+    class Texture;
+
+    /** Snapshot of the state of a render pass, stored in a versioned binary file.
+
+        A checkpoint holds named entries: plain values (e.g. frame counters) and texture contents.
+        It is tagged with the type of the state (e.g. the render pass name) and a version of the
+        state layout, which the owner increments whenever the set or meaning of the entries changes.
+        Reading a checkpoint of a different type or version fails, so stale checkpoints are never
+        applied partially.
+
+        The container and the file format don't depend on a device and can be tested on the CPU.
+        Only captureTexture() and restoreTexture() access the GPU.
+    */
+    class FALCOR_API Checkpoint
+    {
+    public:
+        /** Texture contents. The data is tightly packed, one mip level and array slice.
+        */
+        struct TextureData
+        {
+            uint32_t width = 0;
+            uint32_t height = 1;
+            uint32_t depth = 1;
+            ResourceFormat format = ResourceFormat::Unknown;
+            std::vector<uint8_t> data;
+        };
+
+        /** Create an empty checkpoint.
+            \param[in] type Type of the state, e.g. the render pass name.
+            \param[in] version Version of the state layout.
+        */
+        Checkpoint(const std::string& type, uint32_t version);
+
+        const std::string& getType() const { return mType; }
+        uint32_t getVersion() const { return mVersion; }
+
+        /** Check if an entry exists.
+        */
+        bool hasEntry(const std::string& name) const { return mValues.count(name) > 0 || mTextures.count(name) > 0; }
+
+        /** Store a value. The value is stored as raw bytes, so it must be trivially copyable.
+        */
+        template<typename T>
+        void setValue(const std::string& name, const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Checkpoint values must be trivially copyable");
+            std::vector<uint8_t> bytes(sizeof(T));
+            std::memcpy(bytes.data(), &value, sizeof(T));
+            mValues[name] = std::move(bytes);
+        }
+
+        /** Get a value. Throws an ArgumentError if the entry doesn't exist or has a different size.
+        */
+        template<typename T>
+        T getValue(const std::string& name) const
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Checkpoint values must be trivially copyable");
+            const std::vector<uint8_t>& bytes = getValueBytes(name, sizeof(T));
+            T value;
+            std::memcpy(&value, bytes.data(), sizeof(T));
+            return value;
+        }
+
+        /** Store texture contents. Throws an ArgumentError if the data size doesn't match the dimensions and format.
+        */
+        void setTexture(const std::string& name, TextureData texture);
+
+        /** Get texture contents. Throws an ArgumentError if the entry doesn't exist.
+        */
+        const TextureData& getTexture(const std::string& name) const;
+
+        /** Read back the contents of the first mip level of a texture and store it. This waits for the GPU.
+        */
+        void captureTexture(const std::string& name, RenderContext* pRenderContext, const Texture* pTexture);
+
+        /** Upload stored texture contents to the first mip level of a texture.
+            Throws an ArgumentError if the texture has different dimensions or format than the stored contents.
+        */
+        void restoreTexture(const std::string& name, RenderContext* pRenderContext, const Texture* pTexture) const;
+
+        /** Write the checkpoint to a stream or file. Throws a RuntimeError on failure.
+        */
+        void write(std::ostream& stream) const;
+        void write(const std::filesystem::path& path) const;
+
+        /** Read a checkpoint from a stream or file.
+            Throws a RuntimeError if the data is not a checkpoint, is truncated, or has a different type or version than expected.
+            \param[in] type Expected type of the state.
+            \param[in] version Expected version of the state layout.
+        */
+        static Checkpoint read(std::istream& stream, const std::string& type, uint32_t version);
+        static Checkpoint read(const std::filesystem::path& path, const std::string& type, uint32_t version);
+
+    private:
+        const std::vector<uint8_t>& getValueBytes(const std::string& name, size_t size) const;
+
+        std::string mType;
+        uint32_t mVersion = 0;
+        std::map<std::string, std::vector<uint8_t>> mValues;
+        std::map<std::string, TextureData> mTextures;
+    };
+}
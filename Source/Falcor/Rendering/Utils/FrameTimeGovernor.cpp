@@ -0,0 +1,107 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FrameTimeGovernor.h"
+#include "Core/Errors.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    FrameTimeGovernor::FrameTimeGovernor(const Options& options)
+    {
+        setOptions(options);
+        reset();
+    }
+
+    void FrameTimeGovernor::setOptions(const Options& options)
+    {
+        mOptions = options;
+        mOptions.targetFrameTime = std::max(mOptions.targetFrameTime, 0.f);
+        mOptions.minBudget = std::clamp(mOptions.minBudget, 1e-4f, 1.f);
+        mOptions.smoothing = std::clamp(mOptions.smoothing, 1e-3f, 1.f);
+        mOptions.tolerance = std::max(mOptions.tolerance, 0.f);
+        mOptions.maxStepScale = std::max(mOptions.maxStepScale, 1.f);
+        mOptions.maxRadiusScale = std::max(mOptions.maxRadiusScale, 1.f);
+        mBudget = std::clamp(mBudget, mOptions.minBudget, 1.f);
+    }
+
+    bool FrameTimeGovernor::update(float fixedTime, float scaledTime)
+    {
+        if (!(fixedTime >= 0.f) || !(scaledTime >= 0.f)) throw ArgumentError("Frame times must be non-negative (fixed {}, scaled {}).", fixedTime, scaledTime);
+
+        // The first updates after a change still measure frames rendered with the previous budget.
+        if (mSettleFramesLeft > 0)
+        {
+            mSettleFramesLeft--;
+            return false;
+        }
+
+        const float fullScaledTime = scaledTime / mBudget;
+        if (mHasEstimate)
+        {
+            const float a = mOptions.smoothing;
+            mFixedTime += a * (fixedTime - mFixedTime);
+            mFullScaledTime += a * (fullScaledTime - mFullScaledTime);
+        }
+        else
+        {
+            mFixedTime = fixedTime;
+            mFullScaledTime = fullScaledTime;
+            mHasEstimate = true;
+        }
+
+        const float target = mOptions.targetFrameTime;
+        if (std::abs(getPredictedFrameTime() - target) <= mOptions.tolerance * target) return false;
+
+        // Solve fixed + full * budget = target. If the fixed work alone exceeds the target, the budget goes to its minimum.
+        float budget = 1.f;
+        if (mFullScaledTime > 0.f) budget = std::max(target - mFixedTime, 0.f) / mFullScaledTime;
+
+        budget = std::clamp(budget, mBudget / mOptions.maxStepScale, mBudget * mOptions.maxStepScale);
+        budget = std::clamp(budget, mOptions.minBudget, 1.f);
+        if (budget == mBudget) return false;
+
+        mBudget = budget;
+        mSettleFramesLeft = mOptions.settleFrames;
+        return true;
+    }
+
+    void FrameTimeGovernor::reset(float budget)
+    {
+        mBudget = std::clamp(budget, mOptions.minBudget, 1.f);
+        mFixedTime = 0.f;
+        mFullScaledTime = 0.f;
+        mHasEstimate = false;
+        mSettleFramesLeft = 0;
+    }
+
+    float FrameTimeGovernor::getRadiusScale() const
+    {
+        return std::min(1.f / std::sqrt(mBudget), mOptions.maxRadiusScale);
+    }
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Controller that scales a work budget between frames to reach a target frame time.
+
+        The frame time is modeled as a fixed part plus a part proportional to the budget, e.g. the
+        number of light paths traced per frame. Both parts are estimated from measured timings with
+        exponential smoothing, and the budget is set so that the predicted frame time matches the target.
+        Changes are limited per update and measurements are ignored for a few frames after a change,
+        since profiler timings lag the frame they were measured in.
+
+        The budget is a fraction of the maximum work in [minBudget, 1]. The controller also reports a
+        radius scale for density estimation: scaling the merge radius by 1/sqrt(budget) keeps the
+        expected number of vertices within the radius constant as the vertex density drops.
+
+        The controller has no device dependencies, so it can be tested with synthetic timings.
+    */
+    class FALCOR_API FrameTimeGovernor
+    {
+    public:
+        struct Options
+        {
+            float targetFrameTime = 33.3f;  ///< Target frame time in ms.
+            float minBudget = 0.0625f;      ///< Smallest budget, as a fraction of the maximum work.
+            float smoothing = 0.25f;        ///< Weight of a new measurement in the time estimates, in (0, 1].
+            float tolerance = 0.05f;        ///< Relative deviation from the target that doesn't change the budget.
+            float maxStepScale = 2.f;       ///< Largest factor the budget changes by per update.
+            float maxRadiusScale = 4.f;     ///< Largest radius scale.
+            uint32_t settleFrames = 3;      ///< Number of updates ignored after a budget change.
+        };
+
+        FrameTimeGovernor(const Options& options = Options());
+
+        /** Set the options. Invalid values are clamped. The current budget is kept.
+        */
+        void setOptions(const Options& options);
+        const Options& getOptions() const { return mOptions; }
+
+        /** Feed the timings of a frame.
+            \param[in] fixedTime Time in ms of the work that doesn't depend on the budget.
+            \param[in] scaledTime Time in ms of the work that scales with the budget.
+            \return True if the budget changed.
+        */
+        bool update(float fixedTime, float scaledTime);
+
+        /** Discard the time estimates and set the budget.
+            \param[in] budget Budget, clamped to [minBudget, 1].
+        */
+        void reset(float budget = 1.f);
+
+        /** Get the current budget, a fraction of the maximum work in [minBudget, 1].
+        */
+        float getBudget() const { return mBudget; }
+
+        /** Get the factor the density estimation radius is scaled with at the current budget.
+        */
+        float getRadiusScale() const;
+
+        /** Get the predicted frame time in ms at the current budget, or zero before the first measurement.
+        */
+        float getPredictedFrameTime() const { return mHasEstimate ? mFixedTime + mFullScaledTime * mBudget : 0.f; }
+
+        float getFixedTimeEstimate() const { return mFixedTime; }
+        float getFullScaledTimeEstimate() const { return mFullScaledTime; }
+
+    private:
+        Options mOptions;
+        float mBudget = 1.f;
+        float mFixedTime = 0.f;         ///< Smoothed time of the fixed work in ms.
+        float mFullScaledTime = 0.f;    ///< Smoothed time of the scaled work at budget 1 in ms.
+        bool mHasEstimate = false;
+        uint32_t mSettleFramesLeft = 0;
+    };
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ReadbackRing.h"
+#include "Core/API/RenderContext.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        std::vector<Buffer::SharedPtr> createStagingBuffers(uint32_t latency, size_t size)
+        {
+            if (latency == 0) throw ArgumentError("Readback latency must be at least one frame");
+            std::vector<Buffer::SharedPtr> buffers(latency);
+            for (auto& pBuffer : buffers)
+            {
+                pBuffer = Buffer::create(size, Resource::BindFlags::None, Buffer::CpuAccess::Read);
+                pBuffer->setName("GpuReadbackRing::staging");
+            }
+            return buffers;
+        }
+    }
+
+    GpuReadbackRing::SharedPtr GpuReadbackRing::create(uint32_t latency, size_t size)
+    {
+        return SharedPtr(new GpuReadbackRing(latency, size));
+    }
+
+    GpuReadbackRing::GpuReadbackRing(uint32_t latency, size_t size)
+        : mSize(size)
+        , mRing(createStagingBuffers(latency, size))
+    {
+    }
+
+    bool GpuReadbackRing::push(RenderContext* pRenderContext, const Buffer* pSrc, uint64_t srcOffset)
+    {
+        FALCOR_ASSERT(pRenderContext && pSrc);
+        FALCOR_ASSERT(srcOffset + mSize <= pSrc->getSize());
+
+        Buffer* pStaging = mRing.beginWrite();
+        if (!pStaging) return false;
+
+        pRenderContext->copyBufferRegion(pStaging, 0, pSrc, srcOffset, mSize);
+
+        // The copy is submitted with the next flush of the render context, which signals the context fence with its current CPU value.
+        const auto& pFence = pRenderContext->getLowLevelData()->getFence();
+        FALCOR_ASSERT(!mpFence || mpFence == pFence);
+        mpFence = pFence;
+        mRing.endWrite(mpFence->getCpuValue());
+        return true;
+    }
+
+    bool GpuReadbackRing::poll(void* pDst)
+    {
+        if (!mpFence) return false;
+        return mRing.poll(mpFence->getGpuValue(), pDst, mSize);
+    }
+}
@@ -0,0 +1,193 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Assert.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/GpuFence.h"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    class RenderContext;
+
+    /** Ring of CPU-readable staging buffers used to read back small amounts of GPU data without stalling.
+
+        Each frame the caller copies the data into the slot returned by beginWrite() and tags the slot
+        with a fence value in endWrite(). The data becomes visible on the CPU in poll() once the GPU has
+        passed that fence value, which is typically N frames later for a ring of N slots.
+        If all slots are still in flight, beginWrite() returns nullptr and the frame is skipped instead of waiting.
+
+        The buffer type is a template parameter so that the ring logic can be tested without a device.
+        It needs to provide 'void* map(Buffer::MapType)' and 'void unmap()'.
+    */
+    template<typename BufferType = Buffer>
+    class ReadbackRing
+    {
+    public:
+        using BufferPtr = std::shared_ptr<BufferType>;
+
+        /** Create a ring over the given staging buffers.
+            \param[in] slots Staging buffers, one per frame of latency. All buffers must be at least as large as the data read back.
+        */
+        explicit ReadbackRing(std::vector<BufferPtr> slots)
+        {
+            FALCOR_ASSERT(!slots.empty());
+            mSlots.reserve(slots.size());
+            for (auto& pBuffer : slots) mSlots.push_back({ std::move(pBuffer), 0, false });
+        }
+
+        /** Get the staging buffer to write this frame's data into.
+            \return The staging buffer, or nullptr if all slots are still waiting for the GPU.
+        */
+        BufferType* beginWrite()
+        {
+            FALCOR_ASSERT(!mWriting);
+            Slot& slot = mSlots[mWriteIndex];
+            if (slot.inFlight) return nullptr;
+            mWriting = true;
+            return slot.pBuffer.get();
+        }
+
+        /** Mark the slot returned by beginWrite() as in flight.
+            \param[in] fenceValue Fence value the GPU signals once the copy into the slot has completed.
+        */
+        void endWrite(uint64_t fenceValue)
+        {
+            FALCOR_ASSERT(mWriting);
+            Slot& slot = mSlots[mWriteIndex];
+            slot.fenceValue = fenceValue;
+            slot.inFlight = true;
+            mWriteIndex = (mWriteIndex + 1) % (uint32_t)mSlots.size();
+            mWriting = false;
+        }
+
+        /** Read back the newest slot the GPU has completed, and release all completed slots.
+            \param[in] completedFenceValue Last fence value signaled by the GPU.
+            \param[out] pDst Destination for the data.
+            \param[in] size Number of bytes to copy.
+            \return True if new data was copied to pDst, false if no slot has completed since the last call.
+        */
+        bool poll(uint64_t completedFenceValue, void* pDst, size_t size)
+        {
+            // Visit the slots in submission order, starting at the oldest one.
+            const Slot* pNewest = nullptr;
+            for (uint32_t i = 0; i < (uint32_t)mSlots.size(); i++)
+            {
+                Slot& slot = mSlots[(mWriteIndex + i) % (uint32_t)mSlots.size()];
+                if (!slot.inFlight || slot.fenceValue > completedFenceValue) continue;
+                if (!pNewest || slot.fenceValue > pNewest->fenceValue) pNewest = &slot;
+                slot.inFlight = false;
+            }
+            if (!pNewest) return false;
+
+            const void* pData = pNewest->pBuffer->map(Buffer::MapType::Read);
+            FALCOR_ASSERT(pData);
+            std::memcpy(pDst, pData, size);
+            pNewest->pBuffer->unmap();
+            return true;
+        }
+
+        /** Get the number of slots, i.e. the maximum number of frames the data can lag behind.
+        */
+        uint32_t getLatency() const { return (uint32_t)mSlots.size(); }
+
+        /** Get the number of slots currently waiting for the GPU.
+        */
+        uint32_t getInFlightCount() const
+        {
+            uint32_t count = 0;
+            for (const auto& slot : mSlots) count += slot.inFlight ? 1 : 0;
+            return count;
+        }
+
+    private:
+        struct Slot
+        {
+            BufferPtr pBuffer;
+            uint64_t fenceValue = 0;
+            bool inFlight = false;
+        };
+
+        std::vector<Slot> mSlots;
+        uint32_t mWriteIndex = 0;
+        bool mWriting = false;
+    };
+
+    /** Readback ring for GPU buffers, synchronized with a GPU fence.
+    */
+    class FALCOR_API GpuReadbackRing
+    {
+    public:
+        using SharedPtr = std::shared_ptr<GpuReadbackRing>;
+
+        /** Create a new object.
+            \param[in] latency Number of staging buffers, i.e. the number of frames the data can lag behind.
+            \param[in] size Size in bytes of the data read back each frame.
+            \return New object, or throws an exception on error.
+        */
+        static SharedPtr create(uint32_t latency, size_t size);
+
+        /** Copy a region of a GPU buffer into the next staging buffer.
+            The copy is tracked with the fence of the render context, so it completes with the frame's normal submission
+            and no extra flush is issued. If all staging buffers are still in flight the copy is skipped.
+            \param[in] pRenderContext The render context.
+            \param[in] pSrc Source buffer.
+            \param[in] srcOffset Offset in bytes into the source buffer.
+            \return True if the copy was issued.
+        */
+        bool push(RenderContext* pRenderContext, const Buffer* pSrc, uint64_t srcOffset = 0);
+
+        /** Read back the newest data the GPU has completed. This never waits on the GPU.
+            \param[out] pDst Destination for the data. Must hold at least getSize() bytes.
+            \return True if new data was copied to pDst.
+        */
+        bool poll(void* pDst);
+
+        /** Typed version of poll().
+        */
+        template<typename T>
+        bool poll(T& dst)
+        {
+            FALCOR_ASSERT(sizeof(T) == mSize);
+            return poll(static_cast<void*>(&dst));
+        }
+
+        size_t getSize() const { return mSize; }
+        uint32_t getLatency() const { return mRing.getLatency(); }
+
+    private:
+        GpuReadbackRing(uint32_t latency, size_t size);
+
+        size_t mSize;
+        ReadbackRing<Buffer> mRing;
+        GpuFence::SharedPtr mpFence;    ///< Fence of the render context the copies are recorded on.
+    };
+}
@@ -30,7 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/FalcorMath.h"
@@ -44,7 +44,6 @@
 #include <assimp/scene.h>
 #include <assimp/pbrmaterial.h>
 
-#include <execution>
 #include <fstream>
 
 namespace Falcor
@@ -539,23 +538,28 @@ namespace Falcor
                 meshes.push_back(pMesh);
             }
 
-            // Pre-process meshes.
-            std::vector<SceneBuilder::ProcessedMesh> processedMeshes(meshes.size());
-            auto range = NumericRange<size_t>(0, meshes.size());
-            std::for_each(std::execution::par, range.begin(), range.end(), [&] (size_t i) {
+            // Temporary memory for the vertex and index data. This is kept until the meshes have been added.
+            struct MeshData
+            {
+                std::vector<uint32_t> indexList;
+                std::vector<float2> texCrds;
+                std::vector<float4> tangents;
+                std::vector<uint4> boneIds;
+                std::vector<float4> boneWeights;
+            };
+
+            // Convert meshes.
+            std::vector<SceneBuilder::Mesh> sceneMeshes(meshes.size());
+            std::vector<MeshData> meshData(meshes.size());
+            Threading::parallelFor(0, meshes.size(), [&] (size_t i) {
                 const aiMesh* pAiMesh = meshes[i];
                 const uint32_t perFaceIndexCount = pAiMesh->mFaces[0].mNumIndices;
 
-                SceneBuilder::Mesh mesh;
+                SceneBuilder::Mesh& mesh = sceneMeshes[i];
                 mesh.name = pAiMesh->mName.C_Str();
                 mesh.faceCount = pAiMesh->mNumFaces;
 
-                // Temporary memory for the vertex and index data.
-                std::vector<uint32_t> indexList;
-                std::vector<float2> texCrds;
-                std::vector<float4> tangents;
-                std::vector<uint4> boneIds;
-                std::vector<float4> boneWeights;
+                auto& [indexList, texCrds, tangents, boneIds, boneWeights] = meshData[i];
 
                 // Indices
                 createIndexList(pAiMesh, indexList);
@@ -600,18 +604,14 @@ namespace Falcor
                 }
 
                 mesh.pMaterial = data.materialMap.at(pAiMesh->mMaterialIndex);
-
-                processedMeshes[i] = data.builder.processMesh(mesh);
             });
 
             // Add meshes to the scene.
-            // We retain a deterministic order of the meshes in the global scene buffer by adding
-            // them sequentially after being processed in parallel.
-            uint32_t i = 0;
-            for (const auto& mesh : processedMeshes)
+            // The meshes are processed in parallel, and added in a deterministic order to the global scene buffer.
+            std::vector<MeshID> meshIDs = data.builder.addMeshes(sceneMeshes);
+            for (uint32_t i = 0; i < (uint32_t)meshIDs.size(); i++)
             {
-                MeshID meshID = data.builder.addProcessedMesh(mesh);
-                data.meshMap[i++] = meshID;
+                data.meshMap[i] = meshIDs[i];
             }
         }
 
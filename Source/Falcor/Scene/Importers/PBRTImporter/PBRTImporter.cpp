@@ -1678,19 +1678,30 @@ namespace Falcor
             }
         }
 
+        /** Add the triangle meshes of a list of shapes in a single batch, which processes the meshes in parallel.
+        */
+        std::vector<Falcor::MeshID> addTriangleMeshes(BuilderContext& ctx, const std::vector<Shape>& shapes)
+        {
+            std::vector<Falcor::TriangleMesh::SharedPtr> triangleMeshes;
+            std::vector<Falcor::Material::SharedPtr> materials;
+            for (const auto& shape : shapes)
+            {
+                triangleMeshes.push_back(shape.pTriangleMesh);
+                materials.push_back(shape.pMaterial);
+            }
+            return ctx.builder.addTriangleMeshes(triangleMeshes, materials);
+        }
+
         InstanceDefinition createInstanceDefinition(BuilderContext& ctx, const InstanceDefinitionSceneEntity& entity)
         {
             InstanceDefinition instanceDefinition;
+            std::vector<Shape> shapes;
 
             for (const auto& shapeEntity : entity.shapes)
             {
-                // Process shapes and create meshes.
+                // Process shapes. Meshes are created in a batch after all shapes are processed.
                 auto shape = createShape(ctx, shapeEntity);
-                if (shape.pTriangleMesh)
-                {
-                    auto meshID = ctx.builder.addTriangleMesh(shape.pTriangleMesh, shape.pMaterial);
-                    instanceDefinition.meshes.emplace_back(meshID, shape.transform);
-                }
+                if (shape.pTriangleMesh) shapes.push_back(std::move(shape));
 
                 // Create curves from curve aggregates assembled during the processing step above.
                 for (const auto& [_, curveAggregate] : ctx.curveAggregates)
@@ -1711,6 +1722,10 @@ namespace Falcor
                 ctx.curveAggregates.clear();
             }
 
+            // Create meshes.
+            std::vector<Falcor::MeshID> meshIDs = addTriangleMeshes(ctx, shapes);
+            for (size_t i = 0; i < shapes.size(); i++) instanceDefinition.meshes.emplace_back(meshIDs[i], shapes[i].transform);
+
             return instanceDefinition;
         }
 
@@ -1775,18 +1790,27 @@ namespace Falcor
                 }
             }
 
-            // Process shapes and create meshes.
+            // Process shapes.
+            std::vector<Shape> shapes;
+            std::vector<std::string> shapeNames;
             for (const auto& entity : ctx.scene.getShapes())
             {
                 auto shape = createShape(ctx, entity);
                 if (shape.pTriangleMesh)
                 {
-                    auto nodeID = ctx.builder.addNode({ entity.name, shape.transform });
-                    auto meshID = ctx.builder.addTriangleMesh(shape.pTriangleMesh, shape.pMaterial);
-                    ctx.builder.addMeshInstance(nodeID, meshID);
+                    shapes.push_back(std::move(shape));
+                    shapeNames.push_back(entity.name);
                 }
             }
 
+            // Create meshes.
+            std::vector<Falcor::MeshID> meshIDs = addTriangleMeshes(ctx, shapes);
+            for (size_t i = 0; i < shapes.size(); i++)
+            {
+                auto nodeID = ctx.builder.addNode({ shapeNames[i], shapes[i].transform });
+                ctx.builder.addMeshInstance(nodeID, meshIDs[i]);
+            }
+
             // Create curves from curve aggregates assembled during the processing step above.
             for (const auto& [_, curveAggregate] : ctx.curveAggregates)
             {
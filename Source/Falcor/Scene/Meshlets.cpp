@@ -0,0 +1,288 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Meshlets.h"
+#include "Camera/Camera.h"
+#include "Core/Errors.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = 0xffffffff;
+
+        // Normal cones wider than this (dot product of the axis and the normals) can't be used for culling.
+        const float kMinConeDot = 0.1f;
+
+        float3 getTriangleNormal(const float3& p0, const float3& p1, const float3& p2, bool isFrontFaceCW)
+        {
+            float3 normal = glm::cross(p1 - p0, p2 - p0);
+            return isFrontFaceCW ? -normal : normal;
+        }
+    }
+
+    MeshletBuilder::Result MeshletBuilder::build(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, bool isFrontFaceCW, const Settings& settings)
+    {
+        checkArgument(indices.size() % 3 == 0, "'indices' must contain whole triangles, but has {} indices.", indices.size());
+        checkArgument(positions.size() < kInvalidIndex, "'positions' has too many elements.");
+        checkArgument(settings.maxVertices >= 3, "'maxVertices' ({}) must be at least 3.", settings.maxVertices);
+        checkArgument(settings.maxTriangles >= 1, "'maxTriangles' ({}) must be at least 1.", settings.maxTriangles);
+
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+
+        // Build the vertex-triangle adjacency.
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (uint32_t index : indices)
+        {
+            checkArgument(index < vertexCount, "'indices' contains index {}, but there are only {} vertices.", index, vertexCount);
+            offsets[index + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); i++) adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+        }
+
+        Result result;
+        result.indices.reserve(indices.size());
+
+        std::vector<bool> isAssigned(triangleCount, false);
+        std::vector<uint32_t> vertexMeshlet(vertexCount, kInvalidIndex);  // Last meshlet that used each vertex.
+        std::vector<uint32_t> candidates;                                 // Triangles adjacent to the current meshlet.
+        uint32_t seedCursor = 0;
+
+        auto countNewVertices = [&](uint32_t triangle, uint32_t meshletIndex)
+        {
+            uint32_t count = 0;
+            for (uint32_t j = 0; j < 3; j++) count += vertexMeshlet[indices[triangle * 3 + j]] != meshletIndex ? 1 : 0;
+            return count;
+        };
+
+        while (true)
+        {
+            // Seed the meshlet next to the previous one if possible, or else with the first unassigned triangle.
+            uint32_t triangle = kInvalidIndex;
+            for (uint32_t candidate : candidates)
+            {
+                if (!isAssigned[candidate])
+                {
+                    triangle = candidate;
+                    break;
+                }
+            }
+            if (triangle == kInvalidIndex)
+            {
+                while (seedCursor < triangleCount && isAssigned[seedCursor]) seedCursor++;
+                if (seedCursor == triangleCount) break;
+                triangle = seedCursor;
+            }
+
+            const uint32_t meshletIndex = (uint32_t)result.meshlets.size();
+            MeshletDesc meshlet = {};
+            meshlet.triangleOffset = (uint32_t)(result.indices.size() / 3);
+            candidates.clear();
+
+            while (triangle != kInvalidIndex)
+            {
+                isAssigned[triangle] = true;
+                meshlet.triangleCount++;
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    const uint32_t vertex = indices[triangle * 3 + j];
+                    result.indices.push_back(vertex);
+                    if (vertexMeshlet[vertex] == meshletIndex) continue;
+
+                    vertexMeshlet[vertex] = meshletIndex;
+                    meshlet.vertexCount++;
+                    for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+                    {
+                        if (!isAssigned[adjacency[i]]) candidates.push_back(adjacency[i]);
+                    }
+                }
+                if (meshlet.triangleCount == settings.maxTriangles) break;
+
+                // Pick the candidate that adds the fewest vertices. Ties go to the oldest candidate, which grows the meshlet evenly.
+                // Assigned candidates are removed while searching.
+                triangle = kInvalidIndex;
+                uint32_t bestCount = 4;
+                size_t candidateCount = 0;
+                for (uint32_t candidate : candidates)
+                {
+                    if (isAssigned[candidate]) continue;
+                    candidates[candidateCount++] = candidate;
+
+                    const uint32_t count = countNewVertices(candidate, meshletIndex);
+                    if (count < bestCount && meshlet.vertexCount + count <= settings.maxVertices)
+                    {
+                        triangle = candidate;
+                        bestCount = count;
+                    }
+                }
+                candidates.resize(candidateCount);
+            }
+
+            result.meshlets.push_back(meshlet);
+        }
+
+        FALCOR_ASSERT(result.indices.size() == indices.size());
+
+        for (auto& meshlet : result.meshlets)
+        {
+            fstd::span<const uint32_t> meshletIndices(result.indices.data() + meshlet.triangleOffset * 3, meshlet.triangleCount * 3);
+            computeBounds(meshletIndices, positions, isFrontFaceCW, meshlet);
+        }
+
+        return result;
+    }
+
+    void MeshletBuilder::computeBounds(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, bool isFrontFaceCW, MeshletDesc& meshlet)
+    {
+        FALCOR_ASSERT(indices.size() % 3 == 0);
+
+        // The bounding sphere is centered on the bounding box.
+        float3 minPos(std::numeric_limits<float>::max());
+        float3 maxPos(-std::numeric_limits<float>::max());
+        for (uint32_t index : indices)
+        {
+            minPos = glm::min(minPos, positions[index]);
+            maxPos = glm::max(maxPos, positions[index]);
+        }
+        meshlet.center = 0.5f * (minPos + maxPos);
+        meshlet.radius = 0.f;
+        for (uint32_t index : indices) meshlet.radius = std::max(meshlet.radius, glm::length(positions[index] - meshlet.center));
+
+        // The normal cone axis is the average of the triangle normals. The cone is opened to include all normals,
+        // and its apex is placed so that all triangle planes are in front of it [Shirman and Abi-Ezzi 1993].
+        float3 axis(0.f);
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            float3 normal = getTriangleNormal(positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]], isFrontFaceCW);
+            float length = glm::length(normal);
+            if (length > 0.f) axis += normal / length;
+        }
+
+        meshlet.coneAxis = float3(0.f, 0.f, 1.f);
+        meshlet.coneCutoff = 1.f;
+        meshlet.coneApex = meshlet.center;
+
+        const float axisLength = glm::length(axis);
+        if (axisLength == 0.f) return;
+        axis /= axisLength;
+
+        float minDot = 1.f;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            float3 normal = getTriangleNormal(positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]], isFrontFaceCW);
+            float length = glm::length(normal);
+            if (length > 0.f) minDot = std::min(minDot, glm::dot(axis, normal / length));
+        }
+        meshlet.coneAxis = axis;
+        if (minDot <= kMinConeDot) return;
+
+        float maxT = 0.f;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            const float3& p0 = positions[indices[i]];
+            float3 normal = getTriangleNormal(p0, positions[indices[i + 1]], positions[indices[i + 2]], isFrontFaceCW);
+            float length = glm::length(normal);
+            if (length == 0.f) continue;
+            normal /= length;
+            // Distance along the axis from the center to the triangle plane.
+            maxT = std::max(maxT, glm::dot(meshlet.center - p0, normal) / glm::dot(axis, normal));
+        }
+
+        meshlet.coneCutoff = std::sqrt(1.f - minDot * minDot);
+        meshlet.coneApex = meshlet.center - axis * maxT;
+    }
+
+    CullingFrustum CullingFrustum::create(const rmcv::mat4& viewProjMat, const float3& origin)
+    {
+        // Extract the planes from the rows of the view-projection matrix.
+        // See: https://fgiesen.wordpress.com/2012/08/31/frustum-planes-from-the-projection-matrix/
+        const rmcv::mat4 rows = rmcv::transpose(viewProjMat);
+        const float4 r0 = rows.getCol(0);
+        const float4 r1 = rows.getCol(1);
+        const float4 r2 = rows.getCol(2);
+        const float4 r3 = rows.getCol(3);
+
+        CullingFrustum frustum;
+        frustum.planes[0] = r3 + r0;    // Left
+        frustum.planes[1] = r3 - r0;    // Right
+        frustum.planes[2] = r3 + r1;    // Bottom
+        frustum.planes[3] = r3 - r1;    // Top
+        frustum.planes[4] = r2;         // Near
+        frustum.planes[5] = r3 - r2;    // Far
+        for (auto& plane : frustum.planes) plane /= glm::length(float3(plane));
+        frustum.origin = origin;
+        return frustum;
+    }
+
+    CullingFrustum CullingFrustum::create(const Camera& camera)
+    {
+        return create(camera.getViewProjMatrixNoJitter(), camera.getPosition());
+    }
+
+    bool CullingFrustum::isSphereCulled(const float3& center, float radius) const
+    {
+        for (const auto& plane : planes)
+        {
+            if (glm::dot(float3(plane), center) + plane.w < -radius) return true;
+        }
+        return false;
+    }
+
+    void cullMeshlets(fstd::span<const MeshletDesc> meshlets, const rmcv::mat4& worldMat, const CullingFrustum& frustum, bool cullBackfacing, std::vector<uint32_t>& visibleMeshlets)
+    {
+        // The bounding spheres are transformed to world space and scaled by the largest scale of the transform.
+        // The normal cones are tested in object space instead.
+        const float scale = std::max({ glm::length(float3(worldMat.getCol(0))), glm::length(float3(worldMat.getCol(1))), glm::length(float3(worldMat.getCol(2))) });
+        const float3 objectOrigin = cullBackfacing ? float3(rmcv::inverse(worldMat) * float4(frustum.origin, 1.f)) : float3(0.f);
+
+        for (uint32_t i = 0; i < (uint32_t)meshlets.size(); i++)
+        {
+            const MeshletDesc& meshlet = meshlets[i];
+            const float3 center = float3(worldMat * float4(meshlet.center, 1.f));
+            if (frustum.isSphereCulled(center, meshlet.radius * scale)) continue;
+
+            if (cullBackfacing && meshlet.coneCutoff < 1.f)
+            {
+                const float3 dir = meshlet.coneApex - objectOrigin;
+                const float length = glm::length(dir);
+                if (length > 0.f && glm::dot(dir / length, meshlet.coneAxis) >= meshlet.coneCutoff) continue;
+            }
+
+            visibleMeshlets.push_back(i);
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneTypes.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    class Camera;
+
+    /** Partitions triangle meshes into meshlets.
+        The triangles are reordered so that each meshlet is a consecutive range of triangles, which allows
+        the meshlets to be drawn from the existing index buffer of the mesh.
+    */
+    class FALCOR_API MeshletBuilder
+    {
+    public:
+        struct Settings
+        {
+            uint32_t maxVertices = 64;      ///< Maximum number of unique vertices per meshlet.
+            uint32_t maxTriangles = 124;    ///< Maximum number of triangles per meshlet.
+        };
+
+        struct Result
+        {
+            std::vector<uint32_t> indices;          ///< Reordered triangle list indices.
+            std::vector<MeshletDesc> meshlets;      ///< Meshlets in the order of the triangles.
+        };
+
+        /** Partition a triangle list into meshlets.
+            Meshlets are grown greedily from a seed triangle, adding the adjacent triangle that adds the fewest new vertices.
+            New meshlets are seeded next to the previous one, so the input order matters little.
+            \param[in] indices Triangle list indices.
+            \param[in] positions Vertex positions.
+            \param[in] isFrontFaceCW True if front-facing triangles have clockwise winding. This orients the normal cones.
+            \param[in] settings Meshlet size limits.
+            \return The reordered indices and the meshlets.
+        */
+        static Result build(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, bool isFrontFaceCW, const Settings& settings);
+
+        /** Compute the bounding sphere and normal cone of a meshlet.
+            \param[in] indices Triangle list indices of the meshlet.
+            \param[in] positions Vertex positions.
+            \param[in] isFrontFaceCW True if front-facing triangles have clockwise winding.
+            \param[in,out] meshlet The meshlet. Only the bounds are written.
+        */
+        static void computeBounds(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, bool isFrontFaceCW, MeshletDesc& meshlet);
+    };
+
+    /** Camera frustum for culling on the CPU.
+    */
+    struct FALCOR_API CullingFrustum
+    {
+        float4 planes[6];   ///< Normalized planes (normal, distance) in world space. Points inside the frustum are on the positive side of all planes.
+        float3 origin;      ///< Camera position in world space.
+
+        /** Create a frustum from a view-projection matrix with a clip space depth range of [0, 1].
+        */
+        static CullingFrustum create(const rmcv::mat4& viewProjMat, const float3& origin);
+
+        /** Create the frustum of a camera. The jitter of the camera is ignored.
+        */
+        static CullingFrustum create(const Camera& camera);
+
+        /** Check if a sphere is outside the frustum.
+        */
+        bool isSphereCulled(const float3& center, float radius) const;
+    };
+
+    /** Cull meshlets of a mesh instance against a frustum.
+        Meshlets outside of the frustum are culled. With backface culling, meshlets with all triangles facing away
+        from the frustum origin are culled too. Backface culling assumes a perspective camera and an instance transform
+        that preserves angles (rotation, translation, uniform scale and mirroring).
+        \param[in] meshlets Meshlets of the mesh.
+        \param[in] worldMat Object to world transform of the instance.
+        \param[in] frustum Frustum to cull against.
+        \param[in] cullBackfacing Cull meshlets that face away from the camera.
+        \param[out] visibleMeshlets Indices of the visible meshlets are appended here.
+    */
+    FALCOR_API void cullMeshlets(fstd::span<const MeshletDesc> meshlets, const rmcv::mat4& worldMat, const CullingFrustum& frustum, bool cullBackfacing, std::vector<uint32_t>& visibleMeshlets);
+}
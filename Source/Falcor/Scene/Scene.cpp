@@ -160,6 +160,11 @@ namespace Falcor
         mMeshBBs = std::move(sceneData.meshBBs);
         mMeshIdToInstanceIds = std::move(sceneData.meshIdToInstanceIds);
         mMeshGroups = std::move(sceneData.meshGroups);
+        mMeshletDesc = std::move(sceneData.meshletDesc);
+        mMeshletOffsets = std::move(sceneData.meshletOffsets);
+        mMeshLODDesc = std::move(sceneData.meshLODDesc);
+        mMeshLODOffsets = std::move(sceneData.meshLODOffsets);
+        mSelectedMeshLODs.resize(mMeshDesc.size(), 0);
 
         mUseCompressedHitInfo = sceneData.useCompressedHitInfo;
         mHas16BitIndices = sceneData.has16BitIndices;
@@ -1645,6 +1650,18 @@ namespace Falcor
         mUpdates |= updateSDFGrids(pContext);
         pContext->flush();
 
+        if (mMeshLODsChanged)
+        {
+            updateGeometryInstances(true);
+            createDrawList();
+
+            // Rebuild the BLASes with the selected LODs.
+            mBlasDataValid = false;
+            invalidateTlasCache();
+            mUpdates |= UpdateFlags::MeshLODsChanged;
+            mMeshLODsChanged = false;
+        }
+
         if (is_set(mUpdates, UpdateFlags::GeometryMoved))
         {
             invalidateTlasCache();
@@ -2240,6 +2257,81 @@ namespace Falcor
         return instanceIDs;
     }
 
+    uint2 Scene::getMeshletRange(MeshID meshID) const
+    {
+        if (meshID.get() >= mMeshDesc.size()) throw ArgumentError("'meshID' ({}) is out of range.", meshID);
+        if (mMeshletOffsets.empty()) return uint2(0);
+        uint32_t offset = mMeshletOffsets[meshID.get()];
+        return uint2(offset, mMeshletOffsets[meshID.get() + 1] - offset);
+    }
+
+    std::vector<uint2> Scene::cullMeshlets(const Camera& camera, bool cullBackfacing) const
+    {
+        std::vector<uint2> visibleMeshlets;
+        if (mMeshletDesc.empty()) return visibleMeshlets;
+
+        const auto frustum = CullingFrustum::create(camera);
+        const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
+        std::vector<uint32_t> meshlets;
+
+        for (uint32_t instanceID = 0; instanceID < getGeometryInstanceCount(); instanceID++)
+        {
+            const auto& instance = mGeometryInstanceData[instanceID];
+            if (instance.getType() != GeometryType::TriangleMesh) continue;
+
+            const MeshID meshID = MeshID::fromSlang(instance.geometryID);
+            if (mSelectedMeshLODs[meshID.get()] > 0) continue;
+            uint2 range = getMeshletRange(meshID);
+            if (range.y == 0) continue;
+
+            bool doubleSided = mpMaterials->getMaterial(MaterialID::fromSlang(instance.materialID))->isDoubleSided();
+            fstd::span<const MeshletDesc> meshletDesc(mMeshletDesc.data() + range.x, range.y);
+
+            meshlets.clear();
+            Falcor::cullMeshlets(meshletDesc, globalMatrices[instance.globalMatrixID], frustum, cullBackfacing && !doubleSided, meshlets);
+            for (uint32_t i : meshlets) visibleMeshlets.push_back(uint2(instanceID, range.x + i));
+        }
+
+        return visibleMeshlets;
+    }
+
+    uint32_t Scene::getMeshLODCount(MeshID meshID) const
+    {
+        if (meshID.get() >= mMeshDesc.size()) throw ArgumentError("'meshID' ({}) is out of range.", meshID);
+        if (mMeshLODOffsets.empty()) return 1;
+        return 1 + mMeshLODOffsets[meshID.get() + 1] - mMeshLODOffsets[meshID.get()];
+    }
+
+    MeshLODDesc Scene::getMeshLOD(MeshID meshID, uint32_t lod) const
+    {
+        uint32_t lodCount = getMeshLODCount(meshID);
+        if (lod >= lodCount) throw ArgumentError("'lod' ({}) is out of range, mesh {} has {} LODs.", lod, meshID, lodCount);
+        if (lod > 0) return mMeshLODDesc[mMeshLODOffsets[meshID.get()] + lod - 1];
+
+        const auto& mesh = mMeshDesc[meshID.get()];
+        MeshLODDesc lodDesc = {};
+        lodDesc.ibOffset = mesh.ibOffset;
+        lodDesc.indexCount = mesh.indexCount;
+        return lodDesc;
+    }
+
+    void Scene::setMeshLOD(MeshID meshID, uint32_t lod)
+    {
+        const uint32_t ibOffset = getMeshLOD(meshID, lod).ibOffset;
+        if (mSelectedMeshLODs[meshID.get()] == lod) return;
+
+        // The instances of a mesh share its BLAS, so the LOD is applied to all of them.
+        for (uint32_t instanceID : mMeshIdToInstanceIds[meshID.get()]) mGeometryInstanceData[instanceID].ibOffset = ibOffset;
+        mSelectedMeshLODs[meshID.get()] = lod;
+        mMeshLODsChanged = true;
+    }
+
+    uint32_t Scene::getSelectedMeshLOD(MeshID meshID) const
+    {
+        if (meshID.get() >= mMeshDesc.size()) throw ArgumentError("'meshID' ({}) is out of range.", meshID);
+        return mSelectedMeshLODs[meshID.get()];
+    }
+
     Material::SharedPtr Scene::getGeometryMaterial(GlobalGeometryID geometryID) const
     {
         GlobalGeometryID::IntType geometryIdx = geometryID.get();
@@ -2425,17 +2517,20 @@ namespace Falcor
             std::vector<DrawIndexedArguments> drawClockwiseMeshes[2], drawCounterClockwiseMeshes[2];
 
             uint32_t instanceID = 0;
-            for (const auto& instance : mGeometryInstanceData)
+            for (uint32_t i = 0; i < getGeometryInstanceCount(); i++)
             {
+                const auto& instance = mGeometryInstanceData[i];
                 if (instance.getType() != GeometryType::TriangleMesh) continue;
 
                 const auto& mesh = mMeshDesc[instance.geometryID];
                 bool use16Bit = mesh.use16BitIndices();
 
+                // The instance index buffer offset refers to the selected LOD.
                 DrawIndexedArguments draw;
-                draw.IndexCountPerInstance = mesh.indexCount;
+                const MeshID meshID = MeshID::fromSlang(instance.geometryID);
+                draw.IndexCountPerInstance = getMeshLOD(meshID, mSelectedMeshLODs[meshID.get()]).indexCount;
                 draw.InstanceCount = 1;
-                draw.StartIndexLocation = mesh.ibOffset * (use16Bit ? 2 : 1);
+                draw.StartIndexLocation = instance.ibOffset * (use16Bit ? 2 : 1);
                 draw.BaseVertexLocation = mesh.vbOffset;
                 draw.StartInstanceLocation = instanceID++;
 
@@ -2586,9 +2681,12 @@ namespace Falcor
                         {
                             // The global index data is stored in a dword array.
                             // Each mesh specifies whether its indices are in 16-bit or 32-bit format.
+                            // The BLAS is shared by all instances of the mesh and uses the selected LOD.
+                            const MeshLODDesc lodDesc = getMeshLOD(meshID, mSelectedMeshLODs[meshID.get()]);
+
                             ResourceFormat ibFormat = mesh.use16BitIndices() ? ResourceFormat::R16Uint : ResourceFormat::R32Uint;
-                            desc.content.triangles.indexData = pIb->getGpuAddress() + mesh.ibOffset * sizeof(uint32_t);
-                            desc.content.triangles.indexCount = mesh.indexCount;
+                            desc.content.triangles.indexData = pIb->getGpuAddress() + lodDesc.ibOffset * sizeof(uint32_t);
+                            desc.content.triangles.indexCount = lodDesc.indexCount;
                             desc.content.triangles.indexFormat = ibFormat;
                         }
                         else
@@ -29,6 +29,7 @@
 #include "SceneIDs.h"
 #include "SceneTypes.slang"
 #include "HitInfo.h"
+#include "Meshlets.h"
 #include "Animation/Animation.h"
 #include "Animation/AnimationController.h"
 #include "Displacement/DisplacementUpdateTask.slang"
@@ -149,6 +150,7 @@ namespace Falcor
             SDFGridConfigChanged        = 0x400000,     ///< SDF grid config changed.
             SDFGeometryChanged          = 0x800000,     ///< SDF grid geometry changed.
             MeshesChanged               = 0x1000000,    ///< Mesh data changed (skinning or vertex animations).
+            MeshLODsChanged             = 0x2000000,    ///< The LOD selection of mesh instances changed.
             All                         = -1
         };
 
@@ -324,6 +326,10 @@ namespace Falcor
             std::vector<uint32_t> meshIndexData;                    ///< Vertex indices for all meshes in either 32-bit or 16-bit format packed tightly, decided per mesh.
             std::vector<PackedStaticVertexData> meshStaticData;     ///< Vertex attributes for all meshes in packed format.
             std::vector<SkinningVertexData> meshSkinningData;       ///< Additional vertex attributes for skinned meshes.
+            std::vector<MeshletDesc> meshletDesc;                   ///< List of meshlets of all meshes, if built with the BuildMeshlets flag. The meshlets of each mesh are consecutive.
+            std::vector<uint32_t> meshletOffsets;                   ///< Index of the first meshlet of each mesh, followed by the total meshlet count. Empty if meshlets were not built.
+            std::vector<MeshLODDesc> meshLODDesc;                   ///< List of simplified mesh LODs, if built with the GenerateLODs flag. The LODs of each mesh are consecutive.
+            std::vector<uint32_t> meshLODOffsets;                   ///< Index of the first LOD of each mesh, followed by the total LOD count. Empty if LODs were not generated.
 
             // Curve data
             std::vector<CurveDesc> curveDesc;                       ///< List of curve descriptors.
@@ -690,6 +696,49 @@ namespace Falcor
         */
         const MeshDesc& getMesh(MeshID meshID) const { return mMeshDesc[meshID.get()]; }
 
+        /** Get the meshlets of all meshes. This is empty unless the scene was built with meshlets.
+        */
+        const std::vector<MeshletDesc>& getMeshlets() const { return mMeshletDesc; }
+
+        /** Get the range of meshlets of a mesh.
+            \param[in] meshID Mesh ID.
+            \return Index of the first meshlet and the number of meshlets of the mesh.
+        */
+        uint2 getMeshletRange(MeshID meshID) const;
+
+        /** Cull the meshlets of all triangle mesh instances against the view frustum of a camera.
+            The meshlets partition the full mesh, so instances of meshes with a simplified LOD selected (see setMeshLOD()) are skipped
+            and need to be drawn with their LOD instead.
+            \param[in] camera Camera to cull against.
+            \param[in] cullBackfacing Also cull meshlets that face away from the camera. This is not done for double-sided materials.
+            \return List of visible meshlets as (instance ID, meshlet index) pairs.
+        */
+        std::vector<uint2> cullMeshlets(const Camera& camera, bool cullBackfacing = false) const;
+
+        /** Get the number of LODs of a mesh, including the full mesh.
+        */
+        uint32_t getMeshLODCount(MeshID meshID) const;
+
+        /** Get a LOD of a mesh.
+            \param[in] meshID Mesh ID.
+            \param[in] lod LOD index, where 0 is the full mesh.
+            \return The LOD desc.
+        */
+        MeshLODDesc getMeshLOD(MeshID meshID, uint32_t lod) const;
+
+        /** Select the LOD of a triangle mesh. The selection takes effect in the next call to update().
+            All instances of the mesh use the selected LOD, as they share the ray tracing acceleration structures.
+            \param[in] meshID Mesh ID.
+            \param[in] lod LOD index, where 0 is the full mesh.
+        */
+        void setMeshLOD(MeshID meshID, uint32_t lod);
+
+        /** Get the selected LOD of a triangle mesh.
+            \param[in] meshID Mesh ID.
+            \return LOD index, where 0 is the full mesh.
+        */
+        uint32_t getSelectedMeshLOD(MeshID meshID) const;
+
         /** Get the number of curves.
         */
         uint32_t getCurveCount() const { return (uint32_t)mCurveDesc.size(); }
@@ -1212,6 +1261,12 @@ namespace Falcor
         std::vector<MeshDesc> mMeshDesc;                            ///< Copy of mesh data GPU buffer (mpMeshesBuffer).
         std::vector<MeshGroup> mMeshGroups;                         ///< Groups of meshes. Each group maps to a BLAS for ray tracing.
         std::vector<std::string> mMeshNames;                        ///< Mesh names, indxed by mesh ID
+        std::vector<MeshletDesc> mMeshletDesc;                      ///< Meshlets of all meshes.
+        std::vector<uint32_t> mMeshletOffsets;                      ///< Index of the first meshlet of each mesh, followed by the total meshlet count.
+        std::vector<MeshLODDesc> mMeshLODDesc;                      ///< Simplified LODs of all meshes.
+        std::vector<uint32_t> mMeshLODOffsets;                      ///< Index of the first LOD of each mesh, followed by the total LOD count.
+        std::vector<uint32_t> mSelectedMeshLODs;                    ///< Selected LOD of each mesh, indexed by mesh ID. Only written by setMeshLOD(), which also points the index buffer offsets of all instances of the mesh to the LOD.
+        bool mMeshLODsChanged = false;                              ///< True if the LOD selection changed since the last update.
         std::vector<Node> mSceneGraph;                              ///< For each index i, the array element indicates the parent node. Indices are in relation to mLocalToWorldMatrices.
 
         // Displacement mapping.
@@ -31,12 +31,18 @@
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Math/MathHelpers.h"
+#include "Utils/Math/FNVHash.h"
+#include "Utils/Geometry/MeshSimplifier.h"
 #include <mikktspace.h>
+#include <algorithm>
+#include <array>
 #include <filesystem>
 #include <cmath>
 
@@ -175,6 +181,143 @@ namespace Falcor
             return true;
         }
 
+        /** Compare vertices for welding in hash mode. Only the attributes selected in the settings are compared.
+        */
+        bool compareVertices(const SceneBuilder::Mesh::Vertex& lhs, const SceneBuilder::Mesh::Vertex& rhs, const SceneBuilder::VertexWeldSettings& settings)
+        {
+            using namespace glm;
+            using Attributes = SceneBuilder::VertexWeldSettings::Attributes;
+            const float threshold = settings.attributeEpsilon;
+            if (!all(lessThanEqual(abs(lhs.position - rhs.position), float3(settings.positionEpsilon)))) return false;
+            if (is_set(settings.attributes, Attributes::Normal))
+            {
+                if (any(greaterThan(abs(lhs.normal - rhs.normal), float3(threshold)))) return false;
+            }
+            if (is_set(settings.attributes, Attributes::Tangent))
+            {
+                if (lhs.tangent.w != rhs.tangent.w) return false;
+                if (any(greaterThan(abs(lhs.tangent.xyz - rhs.tangent.xyz), float3(threshold)))) return false;
+            }
+            if (is_set(settings.attributes, Attributes::TexCrd))
+            {
+                if (any(greaterThan(abs(lhs.texCrd - rhs.texCrd), float2(threshold)))) return false;
+            }
+            if (is_set(settings.attributes, Attributes::CurveRadius))
+            {
+                if (lhs.curveRadius != rhs.curveRadius) return false;
+            }
+            if (is_set(settings.attributes, Attributes::Bones))
+            {
+                if (lhs.boneIDs != rhs.boneIDs) return false;
+                if (any(greaterThan(abs(lhs.boneWeights - rhs.boneWeights), float4(threshold)))) return false;
+            }
+            return true;
+        }
+
+        uint64_t hashCombine(uint64_t seed, uint64_t value)
+        {
+            // Combine and apply the 64-bit finalizer of MurmurHash3.
+            uint64_t h = seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        using WeldCell = std::array<int64_t, 3>;
+
+        /** Get the cell of a finite vertex position for welding.
+            With a position epsilon, positions within epsilon of each other are in the same or neighboring cells.
+            Without, the cell is the bit pattern of the position, with negative zero mapped to zero as they compare equal.
+        */
+        WeldCell getWeldCell(const float3& position, float epsilon)
+        {
+            WeldCell cell;
+            for (int i = 0; i < 3; i++)
+            {
+                if (epsilon > 0.f)
+                {
+                    const double q = std::floor((double)position[i] / epsilon);
+                    cell[i] = (int64_t)std::clamp(q, -1e18, 1e18);
+                }
+                else
+                {
+                    cell[i] = position[i] == 0.f ? 0 : glm::floatBitsToInt(position[i]);
+                }
+            }
+            return cell;
+        }
+
+        /** Compute the weld hash key of a vertex in the given cell.
+            The key includes the selected attributes that are compared exactly, to keep the vertex lists short at seams.
+        */
+        uint64_t getWeldKey(const WeldCell& cell, const SceneBuilder::Mesh::Vertex& v, SceneBuilder::VertexWeldSettings::Attributes attributes)
+        {
+            using Attributes = SceneBuilder::VertexWeldSettings::Attributes;
+            uint64_t h = hashCombine(hashCombine(hashCombine(0, cell[0]), cell[1]), cell[2]);
+            if (is_set(attributes, Attributes::Tangent)) h = hashCombine(h, v.tangent.w == 0.f ? 0 : glm::floatBitsToUint(v.tangent.w));
+            if (is_set(attributes, Attributes::CurveRadius)) h = hashCombine(h, v.curveRadius == 0.f ? 0 : glm::floatBitsToUint(v.curveRadius));
+            if (is_set(attributes, Attributes::Bones))
+            {
+                h = hashCombine(h, (uint64_t(v.boneIDs.x) << 32) | v.boneIDs.y);
+                h = hashCombine(h, (uint64_t(v.boneIDs.z) << 32) | v.boneIDs.w);
+            }
+            return h;
+        }
+
+        /** Hash table mapping weld keys to the head of a list of vertices with that key.
+            Uses open addressing with linear probing. The capacity is fixed, so it must be an upper bound of the number of keys.
+        */
+        class VertexWeldTable
+        {
+        public:
+            static constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+            VertexWeldTable(size_t capacity)
+            {
+                size_t size = 16;
+                while (size < capacity * 2) size *= 2;
+                mKeys.resize(size);
+                mHeads.resize(size, kInvalidIndex);
+                mMask = size - 1;
+            }
+
+            /** Find the list head for a key.
+                \return The index of the first vertex, or kInvalidIndex if there is none.
+            */
+            uint32_t find(uint64_t key) const
+            {
+                for (size_t slot = key & mMask;; slot = (slot + 1) & mMask)
+                {
+                    if (mHeads[slot] == kInvalidIndex) return kInvalidIndex;
+                    if (mKeys[slot] == key) return mHeads[slot];
+                }
+            }
+
+            /** Get the list head for a key, adding the key if it doesn't exist.
+                The returned head of a new key is kInvalidIndex and must be assigned before the next call.
+            */
+            uint32_t& insert(uint64_t key)
+            {
+                for (size_t slot = key & mMask;; slot = (slot + 1) & mMask)
+                {
+                    if (mHeads[slot] == kInvalidIndex)
+                    {
+                        mKeys[slot] = key;
+                        return mHeads[slot];
+                    }
+                    if (mKeys[slot] == key) return mHeads[slot];
+                }
+            }
+
+        private:
+            std::vector<uint64_t> mKeys;
+            std::vector<uint32_t> mHeads;
+            size_t mMask = 0;
+        };
+
         std::vector<uint32_t> compact16BitIndices(const std::vector<uint32_t>& indices)
         {
             if (indices.empty()) return {};
@@ -206,6 +349,8 @@ namespace Falcor
     {
         mpFence = GpuFence::create();
         mSceneData.pMaterials = MaterialSystem::create();
+
+        if (is_set(mFlags, Flags::WeldVerticesByHash)) mVertexWeldSettings.mode = VertexWeldSettings::Mode::Hash;
     }
 
     SceneBuilder::SharedPtr SceneBuilder::create(Flags flags)
@@ -258,6 +403,23 @@ namespace Falcor
         Importer::import(path, *this, instances, dict);
     }
 
+    void SceneBuilder::setVertexWeldSettings(const VertexWeldSettings& settings)
+    {
+        checkArgument(settings.positionEpsilon >= 0.f, "'positionEpsilon' ({}) must be non-negative.", settings.positionEpsilon);
+        checkArgument(settings.attributeEpsilon >= 0.f, "'attributeEpsilon' ({}) must be non-negative.", settings.attributeEpsilon);
+        mVertexWeldSettings = settings;
+    }
+
+    void SceneBuilder::setLODSettings(const LODSettings& settings)
+    {
+        for (float errorTarget : settings.errorTargets)
+        {
+            checkArgument(errorTarget >= 0.f, "'errorTargets' must be non-negative, but contains {}.", errorTarget);
+        }
+        checkArgument(settings.triangleRatio > 0.f && settings.triangleRatio < 1.f, "'triangleRatio' ({}) must be between zero and one.", settings.triangleRatio);
+        mLODSettings = settings;
+    }
+
     Scene::SharedPtr SceneBuilder::getScene()
     {
         if (mpScene) return mpScene;
@@ -279,6 +441,18 @@ namespace Falcor
             addMeshInstance(nodeID, meshID);
         }
 
+        if (mVertexWeldStats.removedVertexCount > 0)
+        {
+            logInfo("Merged duplicate vertices, removed {} of {} vertices.", mVertexWeldStats.removedVertexCount, mVertexWeldStats.inputVertexCount);
+        }
+        if (is_set(mFlags, Flags::OptimizeVertexCache))
+        {
+            const auto& stats = mVertexCacheOptimizationStats;
+            logInfo("Optimized vertex order of {} triangles: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, overfetch {:.3f} -> {:.3f}.",
+                stats.output.triangleCount, stats.input.getACMR(), stats.output.getACMR(), stats.input.getATVR(), stats.output.getATVR(),
+                stats.input.getOverfetch(), stats.output.getOverfetch());
+        }
+
         // Post-process the scene data.
         TimeReport timeReport;
 
@@ -289,6 +463,7 @@ namespace Falcor
         prepareSceneGraph();
         prepareMeshes();
         removeUnusedMeshes();
+        if (is_set(mFlags, Flags::DeduplicateMeshes)) deduplicateMeshes();
         flattenStaticMeshInstances();
         pretransformStaticMeshes();
         unifyTriangleWinding();
@@ -297,6 +472,8 @@ namespace Falcor
         createMeshGroups();
         optimizeGeometry();
         sortMeshes();
+        if (is_set(mFlags, Flags::BuildMeshlets)) createMeshlets();
+        if (is_set(mFlags, Flags::GenerateLODs)) createMeshLODs();
         createGlobalBuffers();
         createCurveGlobalBuffers();
         collectVolumeGrids();
@@ -350,7 +527,29 @@ namespace Falcor
         return addProcessedMesh(processMesh(mesh));
     }
 
+    std::vector<MeshID> SceneBuilder::addMeshes(fstd::span<const Mesh> meshes)
+    {
+        // Meshes are processed concurrently, but added sequentially to keep the mesh order deterministic.
+        std::vector<ProcessedMesh> processedMeshes(meshes.size());
+        Threading::parallelFor(0, meshes.size(), [&](size_t i) { processedMeshes[i] = processMesh(meshes[i]); }, 1);
+        return addProcessedMeshes(processedMeshes);
+    }
+
     MeshID SceneBuilder::addTriangleMesh(const TriangleMesh::SharedPtr& pTriangleMesh, const Material::SharedPtr& pMaterial)
+    {
+        return addProcessedMesh(processTriangleMesh(pTriangleMesh, pMaterial));
+    }
+
+    std::vector<MeshID> SceneBuilder::addTriangleMeshes(const std::vector<TriangleMesh::SharedPtr>& triangleMeshes, const std::vector<Material::SharedPtr>& materials)
+    {
+        checkArgument(triangleMeshes.size() == materials.size(), "'triangleMeshes' and 'materials' must have the same size ({} vs {})", triangleMeshes.size(), materials.size());
+
+        std::vector<ProcessedMesh> processedMeshes(triangleMeshes.size());
+        Threading::parallelFor(0, triangleMeshes.size(), [&](size_t i) { processedMeshes[i] = processTriangleMesh(triangleMeshes[i], materials[i]); }, 1);
+        return addProcessedMeshes(processedMeshes);
+    }
+
+    SceneBuilder::ProcessedMesh SceneBuilder::processTriangleMesh(const TriangleMesh::SharedPtr& pTriangleMesh, const Material::SharedPtr& pMaterial) const
     {
         checkArgument(pTriangleMesh != nullptr, "'pTriangleMesh' is missing");
         checkArgument(pMaterial != nullptr, "'pMaterial' is missing");
@@ -380,7 +579,7 @@ namespace Falcor
         mesh.normals = { normals.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
         mesh.texCrds = { texCoords.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
 
-        return addMesh(mesh);
+        return processMesh(mesh);
     }
 
     SceneBuilder::ProcessedMesh SceneBuilder::processMesh(const Mesh& mesh_, MeshAttributeIndices* pAttributeIndices) const
@@ -483,7 +682,77 @@ namespace Falcor
             pAttributeIndices->reserve(mesh.vertexCount);
         }
 
-        if (mesh.mergeDuplicateVertices)
+        if (mesh.mergeDuplicateVertices && mVertexWeldSettings.mode == VertexWeldSettings::Mode::Hash)
+        {
+            // In hash mode, vertices are merged across the whole mesh instead.
+            // The lists are kept in a hash table keyed by the quantized position and the attributes that are compared exactly.
+            // With a position epsilon, matching vertices can be in any of the neighboring cells, which are all searched.
+            // The first matching vertex is used, so the result is deterministic.
+            const auto& settings = mVertexWeldSettings;
+            const int64_t range = settings.positionEpsilon > 0.f ? 1 : 0;
+            vertices.reserve(mesh.vertexCount);
+
+            VertexWeldTable table(mesh.indexCount);
+
+            for (uint32_t face = 0; face < mesh.faceCount; face++)
+            {
+                for (uint32_t vert = 0; vert < 3; vert++)
+                {
+                    const Mesh::Vertex v = mesh.getVertex(face, vert);
+                    uint32_t index = invalidIndex;
+
+                    // Vertices with inf/nan positions never compare equal, so they are not added to the table.
+                    const bool isFinite = !glm::any(glm::isinf(v.position) || glm::isnan(v.position));
+                    const WeldCell cell = isFinite ? getWeldCell(v.position, settings.positionEpsilon) : WeldCell{};
+
+                    for (int64_t dz = -range; dz <= range && isFinite && index == invalidIndex; dz++)
+                    {
+                        for (int64_t dy = -range; dy <= range && index == invalidIndex; dy++)
+                        {
+                            for (int64_t dx = -range; dx <= range && index == invalidIndex; dx++)
+                            {
+                                const WeldCell neighbor = { cell[0] + dx, cell[1] + dy, cell[2] + dz };
+                                for (uint32_t i = table.find(getWeldKey(neighbor, v, settings.attributes)); i != invalidIndex; i = vertices[i].second)
+                                {
+                                    if (compareVertices(v, vertices[i].first, settings))
+                                    {
+                                        index = i;
+                                        break;
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    // Insert new vertex if we couldn't find it.
+                    if (index == invalidIndex)
+                    {
+                        FALCOR_ASSERT(vertices.size() < std::numeric_limits<uint32_t>::max());
+                        index = (uint32_t)vertices.size();
+                        if (isFinite)
+                        {
+                            uint32_t& head = table.insert(getWeldKey(cell, v, settings.attributes));
+                            vertices.push_back({ v, head });
+                            head = index;
+                        }
+                        else
+                        {
+                            vertices.push_back({ v, invalidIndex });
+                        }
+
+                        if (pAttributeIndices)
+                        {
+                            pAttributeIndices->push_back(mesh.getAttributeIndices(face, vert));
+                            FALCOR_ASSERT(vertices.size() == pAttributeIndices->size());
+                        }
+                    }
+
+                    // Store new vertex index.
+                    indices[face * 3 + vert] = index;
+                }
+            }
+        }
+        else if (mesh.mergeDuplicateVertices)
         {
             vertices.reserve(mesh.vertexCount);
 
@@ -503,7 +772,7 @@ namespace Falcor
 
                     while (index != invalidIndex)
                     {
-                        if (compareVertices(v, vertices[index].first))
+                        if (compareVertices(v, vertices[index].first, mVertexWeldSettings.attributeEpsilon))
                         {
                             found = true;
                             break;
@@ -567,6 +836,37 @@ namespace Falcor
         {
             logDebug("Mesh with name '{}' had original vertex count {}, new vertex count {}.", mesh.name, mesh.vertexCount, vertices.size());
         }
+        processedMesh.inputVertexCount = mesh.vertexCount;
+        processedMesh.removedVertexCount = vertices.size() < mesh.vertexCount ? mesh.vertexCount - (uint32_t)vertices.size() : 0;
+
+        // Reorder the triangles for the vertex cache and to reduce overdraw, then the vertices in the order they are first used.
+        if (is_set(mFlags, Flags::OptimizeVertexCache))
+        {
+            const uint32_t vertexCount = (uint32_t)vertices.size();
+            const uint32_t vertexSize = (uint32_t)sizeof(PackedStaticVertexData);
+            processedMesh.inputVertexCacheStats = analyzeVertexCache(indices, vertexCount, vertexSize);
+
+            std::vector<float3> positions(vertexCount);
+            for (uint32_t i = 0; i < vertexCount; i++) positions[i] = vertices[i].first.position;
+            indices = optimizeOverdraw(optimizeVertexCache(indices, vertexCount), positions);
+
+            const std::vector<uint32_t> remap = optimizeVertexFetchRemap(indices, vertexCount);
+            for (uint32_t& index : indices) index = remap[index];
+
+            std::vector<std::pair<Mesh::Vertex, uint32_t>> remappedVertices(vertexCount);
+            for (uint32_t i = 0; i < vertexCount; i++) remappedVertices[remap[i]] = vertices[i];
+            vertices = std::move(remappedVertices);
+
+            if (pAttributeIndices)
+            {
+                FALCOR_ASSERT(pAttributeIndices->size() == vertexCount);
+                MeshAttributeIndices remappedAttributeIndices(vertexCount);
+                for (uint32_t i = 0; i < vertexCount; i++) remappedAttributeIndices[remap[i]] = (*pAttributeIndices)[i];
+                *pAttributeIndices = std::move(remappedAttributeIndices);
+            }
+
+            processedMesh.vertexCacheStats = analyzeVertexCache(indices, vertexCount, vertexSize);
+        }
 
         // Validate vertex data to check for invalid numbers and missing tangent frame.
         size_t invalidCount = 0;
@@ -676,6 +976,10 @@ namespace Falcor
         }
 
         mMeshes.push_back(spec);
+        mVertexWeldStats.inputVertexCount += mesh.inputVertexCount;
+        mVertexWeldStats.removedVertexCount += mesh.removedVertexCount;
+        mVertexCacheOptimizationStats.input += mesh.inputVertexCacheStats;
+        mVertexCacheOptimizationStats.output += mesh.vertexCacheStats;
 
         if (mMeshes.size() > std::numeric_limits<uint32_t>::max())
         {
@@ -685,6 +989,18 @@ namespace Falcor
         return MeshID(mMeshes.size() - 1);
     }
 
+    std::vector<MeshID> SceneBuilder::addProcessedMeshes(std::vector<ProcessedMesh>& processedMeshes)
+    {
+        std::vector<MeshID> meshIDs;
+        meshIDs.reserve(processedMeshes.size());
+        for (auto& mesh : processedMeshes)
+        {
+            meshIDs.push_back(addProcessedMesh(mesh));
+            mesh = {};
+        }
+        return meshIDs;
+    }
+
     void SceneBuilder::setCachedMeshes(std::vector<CachedMesh>&& cachedMeshes)
     {
         mSceneData.cachedMeshes = std::move(cachedMeshes);
@@ -1270,12 +1586,97 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::deduplicateMeshes()
+    {
+        // This function merges meshes with identical content into a single mesh with the instances of all of them.
+        // It runs before the static meshes are pre-transformed, so the merged meshes share one BLAS.
+        // Meshes are compared by their processed vertex and index data, material and flags.
+        // Dynamic meshes are excluded as their vertices are animated per mesh.
+
+        mMeshDeduplicationStats = {};
+
+        // Hash the content of all meshes in parallel.
+        const size_t meshCount = mMeshes.size();
+        std::vector<uint64_t> hashes(meshCount, 0);
+        Threading::parallelFor(0, meshCount, [&](size_t meshIndex)
+        {
+            const auto& mesh = mMeshes[meshIndex];
+            if (mesh.isDynamic()) return;
+
+            FNVHash64 hash;
+            uint32_t header[] = { mesh.materialId.get(), (uint32_t)mesh.topology, mesh.indexCount, mesh.vertexCount,
+                (uint32_t)mesh.use16BitIndices | ((uint32_t)mesh.isFrontFaceCW << 1) | ((uint32_t)mesh.isDisplaced << 2) };
+            hash.insert(header, sizeof(header));
+            hash.insert(mesh.indexData.data(), mesh.indexData.size() * sizeof(uint32_t));
+            hash.insert(mesh.staticData.data(), mesh.staticData.size() * sizeof(StaticVertexData));
+            hashes[meshIndex] = hash.get();
+        }, 1);
+
+        auto isIdentical = [](const MeshSpec& a, const MeshSpec& b)
+        {
+            return a.materialId == b.materialId && a.topology == b.topology &&
+                a.indexCount == b.indexCount && a.vertexCount == b.vertexCount &&
+                a.use16BitIndices == b.use16BitIndices && a.isFrontFaceCW == b.isFrontFaceCW && a.isDisplaced == b.isDisplaced &&
+                a.indexData.size() == b.indexData.size() && a.staticData.size() == b.staticData.size() &&
+                std::memcmp(a.indexData.data(), b.indexData.data(), a.indexData.size() * sizeof(uint32_t)) == 0 &&
+                std::memcmp(a.staticData.data(), b.staticData.data(), a.staticData.size() * sizeof(StaticVertexData)) == 0;
+        };
+
+        // Find the first mesh with identical content for each mesh, and move the instances over to it.
+        std::unordered_map<uint64_t, std::vector<MeshID>> meshesByHash;
+        std::vector<bool> isRemoved(meshCount, false);
+        for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)meshCount; ++meshID)
+        {
+            auto& mesh = mMeshes[meshID.get()];
+            if (mesh.isDynamic()) continue;
+
+            auto& candidates = meshesByHash[hashes[meshID.get()]];
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](MeshID id) { return isIdentical(mMeshes[id.get()], mesh); });
+            if (it == candidates.end())
+            {
+                candidates.push_back(meshID);
+                continue;
+            }
+
+            // Keep the mesh if a node already instances the identical mesh, as node mesh lists don't hold the same mesh twice.
+            auto& target = mMeshes[it->get()];
+            bool isInstancedTwice = std::any_of(mesh.instances.begin(), mesh.instances.end(), [&](NodeID nodeID)
+            {
+                const auto& nodeMeshes = mSceneGraph[nodeID.get()].meshes;
+                return std::find(nodeMeshes.begin(), nodeMeshes.end(), *it) != nodeMeshes.end();
+            });
+            if (isInstancedTwice) continue;
+
+            for (const auto& nodeID : mesh.instances)
+            {
+                FALCOR_ASSERT(nodeID.get() < mSceneGraph.size());
+                auto& node = mSceneGraph[nodeID.get()];
+                std::replace(node.meshes.begin(), node.meshes.end(), meshID, *it);
+                target.instances.push_back(nodeID);
+            }
+            mesh.instances.clear();
+            isRemoved[meshID.get()] = true;
+
+            mMeshDeduplicationStats.removedMeshCount++;
+            mMeshDeduplicationStats.removedVertexCount += mesh.staticData.size();
+            mMeshDeduplicationStats.removedIndexCount += mesh.indexCount;
+            mMeshDeduplicationStats.savedBytes += mesh.indexData.size() * sizeof(uint32_t) + mesh.staticData.size() * sizeof(PackedStaticVertexData);
+        }
+
+        if (mMeshDeduplicationStats.removedMeshCount > 0)
+        {
+            logInfo("Merged {} duplicate meshes into instances, saving {} of vertex and index data.",
+                mMeshDeduplicationStats.removedMeshCount, formatByteSize(mMeshDeduplicationStats.savedBytes));
+            removeMeshes(isRemoved);
+        }
+    }
+
     void SceneBuilder::removeUnusedMeshes()
     {
         // If the scene contained meshes that are not referenced by the scene graph,
         // those will be removed here and warnings logged.
 
-        // First count number of unused meshes.
+        std::vector<bool> isRemoved(mMeshes.size(), false);
         size_t unusedCount = 0;
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
@@ -1283,6 +1684,7 @@ namespace Falcor
             if (mesh.instances.empty())
             {
                 logWarning("Mesh with ID {} named '{}' is not referenced by any scene graph nodes.", meshID, mesh.name);
+                isRemoved[meshID.get()] = true;
                 unusedCount++;
             }
         }
@@ -1291,51 +1693,63 @@ namespace Falcor
         if (unusedCount > 0)
         {
             logWarning("Scene has {} unused meshes that will be removed.", unusedCount);
+            removeMeshes(isRemoved);
+        }
+    }
 
-            const size_t meshCount = mMeshes.size();
-            MeshList meshes;
-            meshes.reserve(meshCount);
+    void SceneBuilder::removeMeshes(const std::vector<bool>& isRemoved)
+    {
+        // Removes the flagged meshes and updates the mesh IDs in the scene graph and vertex caches.
+        // The removed meshes must not be referenced by any scene graph nodes.
 
-            for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)meshCount; ++meshID)
+        const size_t meshCount = mMeshes.size();
+        FALCOR_ASSERT(isRemoved.size() == meshCount);
+        MeshList meshes;
+        meshes.reserve(meshCount);
+
+        for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)meshCount; ++meshID)
+        {
+            auto& mesh = mMeshes[meshID.get()];
+            if (isRemoved[meshID.get()])
             {
-                auto& mesh = mMeshes[meshID.get()];
-                if (mesh.instances.empty()) continue; // Skip unused meshes
+                FALCOR_ASSERT(mesh.instances.empty());
+                continue;
+            }
 
-                // Get new mesh ID.
-                const MeshID newMeshID(meshes.size());
+            // Get new mesh ID.
+            const MeshID newMeshID(meshes.size());
 
-                // Update the mesh IDs in the scene graph nodes.
-                for (const auto& nodeID : mesh.instances)
-                {
-                    FALCOR_ASSERT(nodeID.get() < mSceneGraph.size());
-                    auto& node = mSceneGraph[nodeID.get()];
-                    std::replace(node.meshes.begin(), node.meshes.end(), meshID, newMeshID);
-                }
+            // Update the mesh IDs in the scene graph nodes.
+            for (const auto& nodeID : mesh.instances)
+            {
+                FALCOR_ASSERT(nodeID.get() < mSceneGraph.size());
+                auto& node = mSceneGraph[nodeID.get()];
+                std::replace(node.meshes.begin(), node.meshes.end(), meshID, newMeshID);
+            }
 
-                // Update the mesh IDs of cached meshes.
-                for (auto &cachedMesh : mSceneData.cachedMeshes)
+            // Update the mesh IDs of cached meshes.
+            for (auto &cachedMesh : mSceneData.cachedMeshes)
+            {
+                if (cachedMesh.meshID == meshID) cachedMesh.meshID = newMeshID;
+            }
+            for (auto& cache : mSceneData.cachedCurves)
+            {
+                if (cache.tessellationMode != CurveTessellationMode::LinearSweptSphere)
                 {
-                    if (cachedMesh.meshID == meshID) cachedMesh.meshID = newMeshID;
+                    if (cache.geometryID == CurveOrMeshID{ meshID }) cache.geometryID = CurveOrMeshID{ newMeshID };
                 }
-                for (auto& cache : mSceneData.cachedCurves)
-                {
-                    if (cache.tessellationMode != CurveTessellationMode::LinearSweptSphere)
-                    {
-                        if (cache.geometryID == CurveOrMeshID{ meshID }) cache.geometryID = CurveOrMeshID{ newMeshID };
-                    }
-                }
-
-                meshes.push_back(std::move(mesh));
             }
 
-            mMeshes = std::move(meshes);
+            meshes.push_back(std::move(mesh));
+        }
+
+        mMeshes = std::move(meshes);
 
-            // Validate scene graph.
-            FALCOR_ASSERT(mMeshes.size() == meshCount - unusedCount);
-            for (const auto& node : mSceneGraph)
-            {
-                for (MeshID meshID : node.meshes) FALCOR_ASSERT_LT(meshID.get(), mMeshes.size());
-            }
+        // Validate scene graph.
+        FALCOR_ASSERT(mMeshes.size() == meshCount - std::count(isRemoved.begin(), isRemoved.end(), true));
+        for (const auto& node : mSceneGraph)
+        {
+            for (MeshID meshID : node.meshes) FALCOR_ASSERT_LT(meshID.get(), mMeshes.size());
         }
     }
 
@@ -2267,6 +2681,124 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::createMeshlets()
+    {
+        // This function partitions the meshes into meshlets, which reorders their triangles.
+        // The meshlet bounds are computed from the static vertex data, so meshes with vertices that
+        // move at runtime are skipped. Non-indexed meshes are skipped as well.
+        // With OptimizeVertexCache, the triangles are reordered for the vertex cache again within each meshlet,
+        // and the output vertex cache statistics are recomputed to describe the final index buffers.
+        const bool optimizeCache = is_set(mFlags, Flags::OptimizeVertexCache);
+        const uint32_t vertexSize = (uint32_t)sizeof(PackedStaticVertexData);
+        std::vector<VertexCacheStats> cacheStats(mMeshes.size());
+
+        Threading::parallelFor(0, mMeshes.size(), [&](size_t meshIndex)
+        {
+            auto& mesh = mMeshes[meshIndex];
+            if (mesh.indexCount == 0 || mesh.topology != Vao::Topology::TriangleList) return;
+
+            std::vector<uint32_t> indices(mesh.indexCount);
+            for (uint32_t i = 0; i < mesh.indexCount; i++) indices[i] = mesh.getIndex(i);
+            if (mesh.isDynamic() || mesh.isDisplaced)
+            {
+                if (optimizeCache) cacheStats[meshIndex] = analyzeVertexCache(indices, mesh.vertexCount, vertexSize);
+                return;
+            }
+
+            std::vector<float3> positions(mesh.staticData.size());
+            for (size_t i = 0; i < positions.size(); i++) positions[i] = mesh.staticData[i].position;
+
+            auto result = MeshletBuilder::build(indices, positions, mesh.isFrontFaceCW, MeshletBuilder::Settings());
+
+            // Reordering the triangles within a meshlet keeps its bounds valid.
+            if (optimizeCache)
+            {
+                const uint32_t vertexCount = (uint32_t)positions.size();
+                for (const auto& meshlet : result.meshlets)
+                {
+                    auto range = fstd::span<uint32_t>(result.indices).subspan(meshlet.triangleOffset * 3, meshlet.triangleCount * 3);
+                    std::vector<uint32_t> optimized = optimizeVertexCache(range, vertexCount);
+                    std::copy(optimized.begin(), optimized.end(), range.begin());
+                }
+                cacheStats[meshIndex] = analyzeVertexCache(result.indices, vertexCount, vertexSize);
+            }
+
+            mesh.indexData = mesh.use16BitIndices ? compact16BitIndices(result.indices) : std::move(result.indices);
+            mesh.meshlets = std::move(result.meshlets);
+        }, 1);
+
+        size_t meshletCount = 0;
+        for (const auto& mesh : mMeshes) meshletCount += mesh.meshlets.size();
+        logInfo("Created {} meshlets.", meshletCount);
+
+        if (optimizeCache)
+        {
+            auto& stats = mVertexCacheOptimizationStats;
+            stats.output = {};
+            for (const auto& meshStats : cacheStats) stats.output += meshStats;
+            logInfo("Vertex order after partitioning into meshlets: ACMR {:.3f}, ATVR {:.3f}, overfetch {:.3f}.",
+                stats.output.getACMR(), stats.output.getATVR(), stats.output.getOverfetch());
+        }
+    }
+
+    void SceneBuilder::createMeshLODs()
+    {
+        // This function generates the LODs of the meshes by simplification. The LODs use the vertices of the full mesh,
+        // so only index data is added. Meshes with vertices that move at runtime are skipped as the simplification
+        // uses the static vertex positions. Emissive meshes are skipped as the emissive triangles of the light
+        // collection refer to the full mesh.
+        const auto& settings = mLODSettings;
+
+        Threading::parallelFor(0, mMeshes.size(), [&](size_t meshIndex)
+        {
+            auto& mesh = mMeshes[meshIndex];
+            if (mesh.isDynamic() || mesh.isDisplaced || mesh.indexCount == 0 || mesh.topology != Vao::Topology::TriangleList) return;
+            if (mesh.getTriangleCount() < settings.minTriangleCount) return;
+            if (mSceneData.pMaterials->getMaterial(mesh.materialId)->isEmissive()) return;
+
+            std::vector<uint32_t> indices(mesh.indexCount);
+            for (uint32_t i = 0; i < mesh.indexCount; i++) indices[i] = mesh.getIndex(i);
+            std::vector<float3> positions(mesh.staticData.size());
+            for (size_t i = 0; i < positions.size(); i++) positions[i] = mesh.staticData[i].position;
+
+            for (float errorTarget : settings.errorTargets)
+            {
+                // Each LOD is simplified from the previous one, so the errors add up.
+                float prevError = mesh.lods.empty() ? 0.f : mesh.lods.back().error;
+                if (errorTarget <= prevError) break;
+
+                size_t targetIndexCount = (size_t)(indices.size() / 3 * settings.triangleRatio) * 3;
+                float error = 0.f;
+                std::vector<uint32_t> lodIndices = simplifyMesh(indices, positions, targetIndexCount, errorTarget - prevError, &error);
+
+                // Stop when the error target prevents a meaningful reduction.
+                if (lodIndices.empty() || lodIndices.size() > indices.size() * 9 / 10) break;
+
+                if (is_set(mFlags, Flags::OptimizeVertexCache)) lodIndices = optimizeVertexCache(lodIndices, (uint32_t)positions.size());
+
+                MeshSpec::LOD lod;
+                lod.indexCount = (uint32_t)lodIndices.size();
+                lod.error = prevError + error;
+                lod.indexData = mesh.use16BitIndices ? compact16BitIndices(lodIndices) : lodIndices;
+                mesh.lods.push_back(std::move(lod));
+
+                indices = std::move(lodIndices);
+            }
+        }, 1);
+
+        size_t lodMeshCount = 0;
+        size_t lodCount = 0;
+        size_t lodIndexDataSize = 0;
+        for (const auto& mesh : mMeshes)
+        {
+            if (mesh.lods.empty()) continue;
+            lodMeshCount++;
+            lodCount += mesh.lods.size();
+            for (const auto& lod : mesh.lods) lodIndexDataSize += lod.indexData.size() * sizeof(uint32_t);
+        }
+        logInfo("Generated {} LODs for {} meshes, adding {} of index data.", lodCount, lodMeshCount, formatByteSize(lodIndexDataSize));
+    }
+
     void SceneBuilder::createGlobalBuffers()
     {
         FALCOR_ASSERT(mSceneData.meshIndexData.empty());
@@ -2283,6 +2815,7 @@ namespace Falcor
         for (const auto& mesh : mMeshes)
         {
             totalIndexDataCount += mesh.indexData.size();
+            for (const auto& lod : mesh.lods) totalIndexDataCount += lod.indexData.size();
             totalStaticVertexCount += mesh.staticData.size();
             totalSkinningVertexCount += mesh.skinningData.size();
             mSceneData.prevVertexCount += mesh.prevVertexCount;
@@ -2315,6 +2848,13 @@ namespace Falcor
             {
                 mesh.indexOffset = (uint32_t)mSceneData.meshIndexData.size();
                 mSceneData.meshIndexData.insert(mSceneData.meshIndexData.end(), mesh.indexData.begin(), mesh.indexData.end());
+
+                for (auto& lod : mesh.lods)
+                {
+                    lod.indexOffset = (uint32_t)mSceneData.meshIndexData.size();
+                    mSceneData.meshIndexData.insert(mSceneData.meshIndexData.end(), lod.indexData.begin(), lod.indexData.end());
+                    lod.indexData.clear();
+                }
             }
 
             if (mesh.isSkinned())
@@ -2557,6 +3097,25 @@ namespace Falcor
 
             mSceneData.meshNames.push_back(mesh.name);
 
+            if (is_set(mFlags, Flags::BuildMeshlets))
+            {
+                mSceneData.meshletOffsets.push_back((uint32_t)mSceneData.meshletDesc.size());
+                mSceneData.meshletDesc.insert(mSceneData.meshletDesc.end(), mesh.meshlets.begin(), mesh.meshlets.end());
+            }
+
+            if (is_set(mFlags, Flags::GenerateLODs))
+            {
+                mSceneData.meshLODOffsets.push_back((uint32_t)mSceneData.meshLODDesc.size());
+                for (const auto& lod : mesh.lods)
+                {
+                    MeshLODDesc lodDesc = {};
+                    lodDesc.ibOffset = lod.indexOffset;
+                    lodDesc.indexCount = lod.indexCount;
+                    lodDesc.error = lod.error;
+                    mSceneData.meshLODDesc.push_back(lodDesc);
+                }
+            }
+
             uint32_t meshFlags = 0;
             meshFlags |= mesh.use16BitIndices ? (uint32_t)MeshFlags::Use16BitIndices : 0;
             meshFlags |= mesh.isSkinned() ? (uint32_t)MeshFlags::IsSkinned : 0;
@@ -2585,6 +3144,9 @@ namespace Falcor
                 }
             }
         }
+
+        if (is_set(mFlags, Flags::BuildMeshlets)) mSceneData.meshletOffsets.push_back((uint32_t)mSceneData.meshletDesc.size());
+        if (is_set(mFlags, Flags::GenerateLODs)) mSceneData.meshLODOffsets.push_back((uint32_t)mSceneData.meshLODDesc.size());
     }
 
     void SceneBuilder::createMeshInstanceData(uint32_t& tlasInstanceIndex)
@@ -2819,6 +3381,11 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("WeldVerticesByHash", SceneBuilder::Flags::WeldVerticesByHash);
+        flags.value("OptimizeVertexCache", SceneBuilder::Flags::OptimizeVertexCache);
+        flags.value("BuildMeshlets", SceneBuilder::Flags::BuildMeshlets);
+        flags.value("GenerateLODs", SceneBuilder::Flags::GenerateLODs);
+        flags.value("DeduplicateMeshes", SceneBuilder::Flags::DeduplicateMeshes);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
@@ -2844,6 +3411,7 @@ namespace Falcor
             pSceneBuilder->import(path, instanceMatrices, Dictionary(dict));
         }, "path"_a, "dict"_a = pybind11::dict(), "instances"_a = std::vector<Transform>());
         sceneBuilder.def("addTriangleMesh", &SceneBuilder::addTriangleMesh, "triangleMesh"_a, "material"_a);
+        sceneBuilder.def("addTriangleMeshes", &SceneBuilder::addTriangleMeshes, "triangleMeshes"_a, "materials"_a);
         sceneBuilder.def("addSDFGrid", &SceneBuilder::addSDFGrid, "sdfGrid"_a, "material"_a);
         sceneBuilder.def("addMaterial", &SceneBuilder::addMaterial, "material"_a);
         sceneBuilder.def("getMaterial", &SceneBuilder::getMaterial, "name"_a);
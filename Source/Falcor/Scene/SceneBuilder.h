@@ -29,6 +29,7 @@
 #include "Scene.h"
 #include "SceneCache.h"
 #include "SceneIDs.h"
+#include "Meshlets.h"
 #include "Transform.h"
 #include "TriangleMesh.h"
 #include "VertexAttrib.slangh"
@@ -37,10 +38,12 @@
 
 #include "Core/Macros.h"
 #include "Core/API/VAO.h"
+#include "Utils/Geometry/MeshOptimizer.h"
 #include "Utils/Math/AABB.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Scripting/Dictionary.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
 
 #include <filesystem>
 #include <memory>
@@ -76,6 +79,11 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            WeldVerticesByHash              = 0x20000,  ///< Merge duplicate vertices across the whole mesh using a vertex hash, instead of only vertices that share an original index. See VertexWeldSettings.
+            OptimizeVertexCache             = 0x40000,  ///< Reorder the triangles of each mesh for the post-transform vertex cache and to reduce overdraw, and the vertices in the order they are first used.
+            BuildMeshlets                   = 0x80000,  ///< Partition meshes into meshlets with bounds for culling. This reorders the triangles of the meshes, overriding the order of OptimizeVertexCache, which then only reorders the triangles within each meshlet. Skinned, vertex animated, displaced and non-indexed meshes are not partitioned.
+            GenerateLODs                    = 0x100000, ///< Generate simplified LODs of the meshes, which are selected per mesh with Scene::setMeshLOD(). See LODSettings. Skinned, vertex animated, displaced, emissive and non-indexed meshes don't get LODs.
+            DeduplicateMeshes               = 0x200000, ///< Merge meshes with identical vertices, indices and material into one mesh with multiple instances. Skinned and vertex animated meshes are not merged.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -83,6 +91,72 @@ namespace Falcor
             Default = None
         };
 
+        /** Settings for merging duplicate vertices in meshes with `Mesh::mergeDuplicateVertices` set.
+        */
+        struct VertexWeldSettings
+        {
+            enum class Mode
+            {
+                Topology,   ///< Merge identical vertices that use the same original vertex index. Vertices with different indices are never merged.
+                Hash,       ///< Merge matching vertices across the whole mesh. Candidates are found with a hash of the quantized position.
+            };
+
+            /** Vertex attributes that must match for two vertices to be merged in Hash mode.
+                Attributes that are not included are taken from the first of the merged vertices.
+            */
+            enum class Attributes : uint32_t
+            {
+                None        = 0x0,
+                Normal      = 0x1,
+                Tangent     = 0x2,
+                TexCrd      = 0x4,
+                CurveRadius = 0x8,
+                Bones       = 0x10,
+                All         = 0x1f,
+            };
+
+            Mode mode = Mode::Topology;
+            float positionEpsilon = 0.f;                ///< Hash mode: Maximum difference of each position component. Zero requires identical positions, which avoids cracks.
+            float attributeEpsilon = 1e-6f;             ///< Maximum difference of each component of normals, tangents, texture coordinates and bone weights.
+            Attributes attributes = Attributes::All;    ///< Hash mode: Attributes that must match.
+        };
+
+        /** Vertex welding statistics over all meshes added to the builder.
+        */
+        struct VertexWeldStats
+        {
+            uint64_t inputVertexCount = 0;      ///< Number of vertices of the meshes as they were added.
+            uint64_t removedVertexCount = 0;    ///< Number of vertices removed by merging duplicates.
+        };
+
+        /** Vertex cache statistics over all meshes added to the builder with the OptimizeVertexCache flag set.
+        */
+        struct VertexCacheOptimizationStats
+        {
+            VertexCacheStats input;     ///< Statistics of the meshes as they were added, after merging duplicate vertices.
+            VertexCacheStats output;    ///< Statistics of the reordered meshes. With BuildMeshlets, this is recomputed for the final meshes of the scene when it is built.
+        };
+
+        /** Statistics of merging duplicate meshes with the DeduplicateMeshes flag.
+        */
+        struct MeshDeduplicationStats
+        {
+            uint64_t removedMeshCount = 0;      ///< Number of meshes that were replaced by instances of an identical mesh.
+            uint64_t removedVertexCount = 0;    ///< Number of vertices of the removed meshes.
+            uint64_t removedIndexCount = 0;     ///< Number of indices of the removed meshes.
+            uint64_t savedBytes = 0;            ///< Size of the vertex and index data of the removed meshes in bytes.
+        };
+
+        /** Settings for generating mesh LODs with the GenerateLODs flag.
+            Each LOD is simplified from the previous one. No more LODs are generated for a mesh once the error target stops a LOD from reducing the triangle count.
+        */
+        struct LODSettings
+        {
+            std::vector<float> errorTargets = { 0.002f, 0.008f, 0.03f };   ///< Maximum simplification error of each LOD, relative to the largest extent of the mesh. The number of entries is the maximum number of LODs in addition to the full mesh.
+            float triangleRatio = 0.5f;                                     ///< Target triangle count of each LOD relative to the previous LOD.
+            uint32_t minTriangleCount = 256;                                ///< Meshes with fewer triangles don't get LODs.
+        };
+
         /** Mesh description.
             This struct is used by the importers to add new meshes.
             The description is then processed by the scene builder into an optimized runtime format.
@@ -275,6 +349,12 @@ namespace Falcor
             std::vector<uint32_t> indexData;    ///< Vertex indices in either 32-bit or 16-bit format packed tightly, or empty if non-indexed.
             std::vector<StaticVertexData> staticData;
             std::vector<SkinningVertexData> skinningData;
+
+            uint32_t inputVertexCount = 0;      ///< Number of vertices of the mesh as it was added.
+            uint32_t removedVertexCount = 0;    ///< Number of vertices removed by merging duplicates.
+
+            VertexCacheStats inputVertexCacheStats; ///< Vertex cache statistics before reordering. Only set with the OptimizeVertexCache flag.
+            VertexCacheStats vertexCacheStats;      ///< Vertex cache statistics after reordering. Only set with the OptimizeVertexCache flag.
         };
 
         using MeshAttributeIndices = std::vector<Mesh::VertexAttributeIndices>;
@@ -354,6 +434,36 @@ namespace Falcor
         */
         Flags getFlags() const { return mFlags; }
 
+        /** Set the vertex weld settings. These apply to meshes added after the call.
+            The settings are not part of the scene cache key, the flag WeldVerticesByHash is.
+        */
+        void setVertexWeldSettings(const VertexWeldSettings& settings);
+
+        /** Get the vertex weld settings.
+        */
+        const VertexWeldSettings& getVertexWeldSettings() const { return mVertexWeldSettings; }
+
+        /** Get the vertex welding statistics of the meshes added so far.
+        */
+        const VertexWeldStats& getVertexWeldStats() const { return mVertexWeldStats; }
+
+        /** Get the vertex cache statistics of the meshes added so far. Only meshes that were reordered with the OptimizeVertexCache flag are included.
+        */
+        const VertexCacheOptimizationStats& getVertexCacheOptimizationStats() const { return mVertexCacheOptimizationStats; }
+
+        /** Set the settings for generating mesh LODs. These apply when the scene is built.
+            The settings are not part of the scene cache key, the flag GenerateLODs is.
+        */
+        void setLODSettings(const LODSettings& settings);
+
+        /** Get the settings for generating mesh LODs.
+        */
+        const LODSettings& getLODSettings() const { return mLODSettings; }
+
+        /** Get the statistics of merging duplicate meshes. These are set when the scene is built with the DeduplicateMeshes flag.
+        */
+        const MeshDeduplicationStats& getMeshDeduplicationStats() const { return mMeshDeduplicationStats; }
+
         /** Set the render settings.
         */
         void setRenderSettings(const Scene::RenderSettings& renderSettings) { mSceneData.renderSettings = renderSettings; }
@@ -387,6 +497,14 @@ namespace Falcor
         */
         MeshID addMesh(const Mesh& mesh);
 
+        /** Add a batch of meshes.
+            The meshes are pre-processed in parallel and added in order, so the mesh IDs are the same as when calling addMesh() for each mesh.
+            Throws an exception if something went wrong, in which case none of the meshes are added.
+            \param meshes The meshes to add.
+            \return The IDs of the meshes in the scene, in the order of the input.
+        */
+        std::vector<MeshID> addMeshes(fstd::span<const Mesh> meshes);
+
         /** Add a triangle mesh.
             \param The triangle mesh to add.
             \param pMaterial The material to use for the mesh.
@@ -394,6 +512,13 @@ namespace Falcor
         */
         MeshID addTriangleMesh(const TriangleMesh::SharedPtr& pTriangleMesh, const Material::SharedPtr& pMaterial);
 
+        /** Add a batch of triangle meshes. See addMeshes().
+            \param triangleMeshes The triangle meshes to add.
+            \param materials The material to use for each triangle mesh.
+            \return The IDs of the meshes in the scene, in the order of the input.
+        */
+        std::vector<MeshID> addTriangleMeshes(const std::vector<TriangleMesh::SharedPtr>& triangleMeshes, const std::vector<Material::SharedPtr>& materials);
+
         /** Pre-process a mesh into the data format that is used in the global scene buffers.
             Throws an exception if something went wrong.
             \param mesh The mesh to pre-process.
@@ -670,6 +795,16 @@ namespace Falcor
             bool isAnimated = false;                ///< True if mesh has vertex animations.
             AABB boundingBox;                       ///< Mesh bounding-box in object space.
             std::vector<NodeID> instances;          ///< Node IDs of all instances of this mesh.
+            std::vector<MeshletDesc> meshlets;      ///< Meshlets of the mesh. This is calculated in createMeshlets().
+
+            struct LOD
+            {
+                std::vector<uint32_t> indexData;    ///< Vertex indices in the same format as the mesh indices.
+                uint32_t indexOffset = 0;           ///< Offset into the shared 'indexData' array. This is calculated in createGlobalBuffers().
+                uint32_t indexCount = 0;            ///< Number of indices.
+                float error = 0.f;                  ///< Simplification error relative to the largest extent of the mesh.
+            };
+            std::vector<LOD> lods;                  ///< Simplified LODs, excluding the full mesh. This is calculated in createMeshLODs().
 
             // Pre-processed vertex data.
             std::vector<uint32_t> indexData;    ///< Vertex indices in either 32-bit or 16-bit format packed tightly, or empty if non-indexed.
@@ -732,6 +867,12 @@ namespace Falcor
         SceneGraph mSceneGraph;
         const Flags mFlags;
 
+        VertexWeldSettings mVertexWeldSettings;
+        VertexWeldStats mVertexWeldStats;
+        VertexCacheOptimizationStats mVertexCacheOptimizationStats;
+        LODSettings mLODSettings;
+        MeshDeduplicationStats mMeshDeduplicationStats;
+
         MeshList mMeshes;
         MeshGroupList mMeshGroups; ///< Groups of meshes. Each group represents all the geometries in a BLAS for ray tracing.
 
@@ -764,11 +905,17 @@ namespace Falcor
         MeshGroupList splitMeshGroupMedian(MeshGroup& meshGroup) const;
         MeshGroupList splitMeshGroupMidpointMeshes(MeshGroup& meshGroup);
 
+        // Meshes
+        ProcessedMesh processTriangleMesh(const TriangleMesh::SharedPtr& pTriangleMesh, const Material::SharedPtr& pMaterial) const;
+        std::vector<MeshID> addProcessedMeshes(std::vector<ProcessedMesh>& processedMeshes);
+
         // Post processing
         void prepareDisplacementMaps();
         void prepareSceneGraph();
         void prepareMeshes();
+        void deduplicateMeshes();
         void removeUnusedMeshes();
+        void removeMeshes(const std::vector<bool>& isRemoved);
         void flattenStaticMeshInstances();
         void optimizeSceneGraph();
         void pretransformStaticMeshes();
@@ -777,6 +924,8 @@ namespace Falcor
         void createMeshGroups();
         void optimizeGeometry();
         void sortMeshes();
+        void createMeshlets();
+        void createMeshLODs();
         void createGlobalBuffers();
         void createCurveGlobalBuffers();
         void optimizeMaterials();
@@ -798,4 +947,5 @@ namespace Falcor
     };
 
     FALCOR_ENUM_CLASS_OPERATORS(SceneBuilder::Flags);
+    FALCOR_ENUM_CLASS_OPERATORS(SceneBuilder::VertexWeldSettings::Attributes);
 }
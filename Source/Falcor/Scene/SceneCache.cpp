@@ -44,7 +44,7 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 27;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
@@ -353,6 +353,10 @@ namespace Falcor
         stream.write(sceneData.meshIndexData);
         stream.write(sceneData.meshStaticData);
         stream.write(sceneData.meshSkinningData);
+        stream.write(sceneData.meshletDesc);
+        stream.write(sceneData.meshletOffsets);
+        stream.write(sceneData.meshLODDesc);
+        stream.write(sceneData.meshLODOffsets);
 
         writeMarker(stream, "Curves");
         stream.write(sceneData.curveDesc);
@@ -474,6 +478,10 @@ namespace Falcor
         stream.read(sceneData.meshIndexData);
         stream.read(sceneData.meshStaticData);
         stream.read(sceneData.meshSkinningData);
+        stream.read(sceneData.meshletDesc);
+        stream.read(sceneData.meshletOffsets);
+        stream.read(sceneData.meshLODDesc);
+        stream.read(sceneData.meshLODOffsets);
 
         readMarker(stream, "Curves");
         stream.read(sceneData.curveDesc);
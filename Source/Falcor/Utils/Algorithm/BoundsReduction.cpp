@@ -0,0 +1,117 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BoundsReduction.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/Profiler.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFile[] = "Utils/Algorithm/BoundsReduction.cs.slang";
+        const uint32_t kGroupSize = 1024;
+        const uint32_t kElementsPerGroup = 2 * kGroupSize;
+    }
+
+    BoundsReduction::BoundsReduction(uint32_t maxElementCount)
+        : mMaxElementCount(maxElementCount)
+    {
+        if (maxElementCount == 0) throw ArgumentError("'maxElementCount' must be positive.");
+
+        Program::DefineList defines = { {"GROUP_SIZE", std::to_string(kGroupSize)} };
+        mpReduceProgram = ComputeProgram::createFromFile(kShaderFile, "reduce", defines);
+        mpReduceVars = ComputeVars::create(mpReduceProgram.get());
+        mpComputeState = ComputeState::create();
+
+        // Add levels until a single group covers all partial bounds.
+        uint32_t count = maxElementCount;
+        do
+        {
+            count = div_round_up(count, kElementsPerGroup);
+            mGroupCounts.push_back(count);
+        } while (count > 1);
+
+        // The first level writes the most partial bounds. Levels alternate between the two buffers.
+        if (mGroupCounts.size() > 1)
+        {
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                mpPartials[i] = Buffer::createStructured(sizeof(float4), 2 * mGroupCounts[0], Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+            }
+        }
+    }
+
+    BoundsReduction::SharedPtr BoundsReduction::create(uint32_t maxElementCount)
+    {
+        return SharedPtr(new BoundsReduction(maxElementCount));
+    }
+
+    void BoundsReduction::execute(RenderContext* pRenderContext, const Buffer::SharedPtr& pInput, const Buffer::SharedPtr& pCounter, uint32_t counterOffset, const Buffer::SharedPtr& pResult)
+    {
+        FALCOR_PROFILE("BoundsReduction::execute");
+
+        FALCOR_ASSERT(pRenderContext);
+        FALCOR_ASSERT(pInput && pCounter && pResult);
+        FALCOR_ASSERT(pResult->getSize() >= 2 * sizeof(float4));
+
+        mpReduceVars["CB"]["gMaxCount"] = std::min(mMaxElementCount, pInput->getElementCount());
+        mpReduceVars["CB"]["gCounterOffset"] = counterOffset;
+        mpReduceVars["gCounter"] = pCounter;
+        mpReduceVars["gInput"] = pInput;
+        mpReduceVars["gBounds"] = pResult;
+        mpComputeState->setProgram(mpReduceProgram);
+
+        pRenderContext->uavBarrier(pCounter.get());
+        pRenderContext->uavBarrier(pInput.get());
+
+        for (uint32_t level = 0; level < (uint32_t)mGroupCounts.size(); level++)
+        {
+            const bool isLastLevel = level + 1 == mGroupCounts.size();
+            mpReduceVars["CB"]["gLevel"] = level;
+            mpReduceVars["CB"]["gIsLastLevel"] = isLastLevel;
+            mpReduceVars["gPartialsIn"] = level > 0 ? mpPartials[(level - 1) % 2] : nullptr;
+            mpReduceVars["gPartialsOut"] = isLastLevel ? nullptr : mpPartials[level % 2];
+
+            // Groups beyond the element count of the level exit early.
+            pRenderContext->dispatch(mpComputeState.get(), mpReduceVars.get(), { mGroupCounts[level], 1, 1 });
+            if (!isLastLevel) pRenderContext->uavBarrier(mpPartials[level % 2].get());
+        }
+
+        pRenderContext->uavBarrier(pResult.get());
+    }
+
+    AABB BoundsReduction::reduceHost(const std::vector<float4>& elements)
+    {
+        AABB bounds;
+        for (const float4& e : elements) bounds.include(float3(e));
+        return bounds;
+    }
+}
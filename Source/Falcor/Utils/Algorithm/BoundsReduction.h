@@ -0,0 +1,94 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/State/ComputeState.h"
+#include "Core/Program/ComputeProgram.h"
+#include "Core/Program/ProgramVars.h"
+#include "Utils/Math/AABB.h"
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    class RenderContext;
+
+    /** Computes the bounding box of a list of points on the GPU.
+
+        The minimum and maximum are reduced together in one chain of passes, each reducing blocks of
+        2048 elements, so every element is read once. The element count is read on the GPU from a
+        counter buffer and the dispatch sizes are fixed by the capacity, so the reduction can follow a
+        pass that appends the points without reading the count back to the CPU.
+
+        The result is written to a buffer as two float4: the minimum and the maximum, with w = 0.
+        An empty input gives the bounds of an invalid AABB (+inf, -inf).
+    */
+    class FALCOR_API BoundsReduction
+    {
+    public:
+        using SharedPtr = std::shared_ptr<BoundsReduction>;
+        using SharedConstPtr = std::shared_ptr<const BoundsReduction>;
+        virtual ~BoundsReduction() = default;
+
+        /** Create a new bounds reduction object.
+            \param[in] maxElementCount Maximum number of elements reduced.
+            \return New object, or throws an exception if creation failed.
+        */
+        static SharedPtr create(uint32_t maxElementCount);
+
+        /** Reduce the bounds of the points in a buffer.
+            \param[in] pRenderContext The render context.
+            \param[in] pInput Structured buffer of float4 elements. The points are in xyz.
+            \param[in] pCounter Buffer holding the number of elements (uint32_t). The count is clamped to the capacity.
+            \param[in] counterOffset Byte offset of the count in pCounter.
+            \param[in] pResult Structured buffer of at least two float4 the minimum and maximum are written to.
+        */
+        void execute(RenderContext* pRenderContext, const Buffer::SharedPtr& pInput, const Buffer::SharedPtr& pCounter, uint32_t counterOffset, const Buffer::SharedPtr& pResult);
+
+        uint32_t getMaxElementCount() const { return mMaxElementCount; }
+
+        /** Reduce the bounds of points on the CPU. This is the reference used for validation.
+            \param[in] elements Points in xyz.
+            \return Bounding box. Invalid if there are no elements.
+        */
+        static AABB reduceHost(const std::vector<float4>& elements);
+
+    protected:
+        BoundsReduction(uint32_t maxElementCount);
+
+        ComputeState::SharedPtr     mpComputeState;
+        ComputeProgram::SharedPtr   mpReduceProgram;
+        ComputeVars::SharedPtr      mpReduceVars;
+
+        Buffer::SharedPtr           mpPartials[2];      ///< Per-group bounds of the intermediate levels, as min/max pairs.
+
+        uint32_t                    mMaxElementCount = 0;
+        std::vector<uint32_t>       mGroupCounts;       ///< Number of thread groups of each level, for the maximum element count.
+    };
+}
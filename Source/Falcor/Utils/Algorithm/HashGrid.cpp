@@ -0,0 +1,94 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "HashGrid.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Utils/Math/Common.h"
+
+namespace Falcor
+{
+    uint32_t HashGrid::getBucketCount(uint32_t pointCount)
+    {
+        uint32_t count = 1;
+        while (count < pointCount) count <<= 1;
+        return count;
+    }
+
+    void HashGrid::build(const std::vector<float3>& positions, float cellSize, uint32_t bucketCount)
+    {
+        if (!(cellSize > 0.f)) throw ArgumentError("'cellSize' must be positive.");
+        if (bucketCount == 0 || !isPowerOf2(bucketCount)) throw ArgumentError("'bucketCount' must be a power of two.");
+
+        mPositions = positions;
+        mCellSize = cellSize;
+        mHeads.assign(bucketCount, kInvalidIndex);
+        mNext.resize(positions.size());
+
+        for (uint32_t i = 0; i < (uint32_t)positions.size(); i++)
+        {
+            uint32_t bucket = hashGridBucket(hashGridCell(positions[i], cellSize), bucketCount);
+            mNext[i] = mHeads[bucket];
+            mHeads[bucket] = i;
+        }
+    }
+
+    std::vector<uint32_t> HashGrid::query(const float3& center, float radius) const
+    {
+        std::vector<uint32_t> result;
+        const int3 minCell = hashGridCell(center - radius, mCellSize);
+        const int3 maxCell = hashGridCell(center + radius, mCellSize);
+        const float radiusSqr = radius * radius;
+
+        for (int z = minCell.z; z <= maxCell.z; z++)
+        {
+            for (int y = minCell.y; y <= maxCell.y; y++)
+            {
+                for (int x = minCell.x; x <= maxCell.x; x++)
+                {
+                    const int3 cell(x, y, z);
+                    for (uint32_t i = mHeads[hashGridBucket(cell, getBucketCount())]; i != kInvalidIndex; i = mNext[i])
+                    {
+                        // Skip points of other cells sharing the bucket, they are visited with their own cell.
+                        if (hashGridCell(mPositions[i], mCellSize) != cell) continue;
+                        const float3 d = mPositions[i] - center;
+                        if (glm::dot(d, d) < radiusSqr) result.push_back(i);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> HashGrid::getBucket(uint32_t bucket) const
+    {
+        FALCOR_ASSERT(bucket < mHeads.size());
+        std::vector<uint32_t> result;
+        for (uint32_t i = mHeads[bucket]; i != kInvalidIndex; i = mNext[i]) result.push_back(i);
+        return result;
+    }
+}
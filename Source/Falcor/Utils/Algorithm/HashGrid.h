@@ -0,0 +1,82 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "HashGrid.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Spatial hash grid for fixed-radius neighbour queries over points.
+
+        This is the CPU version of the grid built by HashGrid.cs.slang, with the same bucket lists and
+        hash function (see HashGrid.slang). Points are inserted in order, so a bucket list holds its
+        points in reverse insertion order. The GPU build inserts in arbitrary order, so only the set of
+        points in each bucket is expected to match. This is used for validation and testing.
+    */
+    class FALCOR_API HashGrid
+    {
+    public:
+        static constexpr uint32_t kInvalidIndex = kHashGridInvalidIndex;
+
+        /** Get the number of buckets used for a number of points: the next power of two, at least one.
+        */
+        static uint32_t getBucketCount(uint32_t pointCount);
+
+        /** Build the grid over a set of points.
+            \param[in] positions Point positions.
+            \param[in] cellSize Cell size. Should be at least twice the query radius.
+            \param[in] bucketCount Number of buckets. Must be a power of two.
+        */
+        void build(const std::vector<float3>& positions, float cellSize, uint32_t bucketCount);
+
+        /** Find all points within a radius of a position.
+            \param[in] center Query position.
+            \param[in] radius Query radius. Points at a distance smaller than the radius are returned.
+            \return Indices of the points found, in traversal order.
+        */
+        std::vector<uint32_t> query(const float3& center, float radius) const;
+
+        /** Get the point indices in a bucket, in list order.
+        */
+        std::vector<uint32_t> getBucket(uint32_t bucket) const;
+
+        float getCellSize() const { return mCellSize; }
+        uint32_t getBucketCount() const { return (uint32_t)mHeads.size(); }
+        const std::vector<uint32_t>& getHeads() const { return mHeads; }
+        const std::vector<uint32_t>& getNext() const { return mNext; }
+
+    private:
+        std::vector<float3> mPositions;
+        std::vector<uint32_t> mHeads;   ///< Last point inserted into each bucket.
+        std::vector<uint32_t> mNext;    ///< Point inserted before each point into the same bucket.
+        float mCellSize = 1.f;
+    };
+}
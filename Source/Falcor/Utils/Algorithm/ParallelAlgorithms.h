@@ -0,0 +1,342 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace Falcor
+{
+    /** Options for the host-side parallel algorithms, which run on the global thread pool (see Threading).
+
+        The input range is split into chunks of ParallelOptions::grainSize elements, and each chunk is processed
+        serially by one task. By default the grain size is picked from the element count and the number of workers,
+        so results of operations that are not associative (e.g. floating-point addition) can change with the worker
+        count. Partial results are always combined in chunk order, and setting ParallelOptions::deterministic uses chunks
+        that only depend on the element count, so the result is the same for every run and every machine.
+
+        The sorts are stable, so their results never depend on the options.
+    */
+    struct ParallelOptions
+    {
+        size_t grainSize = 0;       ///< Number of elements per chunk. Zero picks a size from the element count.
+        bool deterministic = false; ///< Make results independent of the worker count and the task scheduling.
+    };
+
+    /** Returns the number of elements per chunk used to process a range.
+        \param[in] count Number of elements.
+        \param[in] options Options.
+        \param[in] minGrainSize Minimum number of elements per chunk when the grain size is picked automatically.
+    */
+    inline size_t getParallelGrainSize(size_t count, const ParallelOptions& options, size_t minGrainSize = 1)
+    {
+        // Fixed chunk size for deterministic results. Large enough to hide the per-chunk overhead.
+        constexpr size_t kDeterministicGrainSize = 4096;
+
+        if (options.grainSize > 0) return options.grainSize;
+        if (options.deterministic) return kDeterministicGrainSize;
+
+        const size_t workerCount = Threading::getWorkerCount() > 0 ? Threading::getWorkerCount() : Threading::getLogicalThreadCount();
+        return std::max(minGrainSize, div_round_up(count, 4 * workerCount));
+    }
+
+    /** Calls func(chunkBegin, chunkEnd) for consecutive chunks covering [begin, end) in parallel and waits for completion.
+        Rethrows the first exception thrown by func.
+    */
+    template<typename Func>
+    void parallelForChunks(size_t begin, size_t end, Func&& func, const ParallelOptions& options = {})
+    {
+        if (begin >= end) return;
+
+        const size_t count = end - begin;
+        const size_t grainSize = getParallelGrainSize(count, options);
+        const size_t chunkCount = div_round_up(count, grainSize);
+
+        if (chunkCount == 1)
+        {
+            func(begin, end);
+            return;
+        }
+
+        Threading::parallelFor(0, chunkCount, [&](size_t chunk)
+        {
+            const size_t chunkBegin = begin + chunk * grainSize;
+            func(chunkBegin, std::min(end, chunkBegin + grainSize));
+        });
+    }
+
+    /** Calls func(i) for all i in [begin, end) in parallel and waits for completion.
+        Order of execution is unspecified. Rethrows the first exception thrown by func.
+    */
+    template<typename Func>
+    void parallelFor(size_t begin, size_t end, Func&& func, const ParallelOptions& options = {})
+    {
+        parallelForChunks(begin, end, [&](size_t chunkBegin, size_t chunkEnd)
+        {
+            for (size_t i = chunkBegin; i < chunkEnd; ++i) func(i);
+        }, options);
+    }
+
+    /** Reduces transform(i) for all i in [begin, end) with a binary operation.
+        Each chunk is reduced from left to right starting at the identity, then the chunk results are combined in chunk order.
+        \param[in] begin First index.
+        \param[in] end One past the last index.
+        \param[in] identity Identity element of the operation.
+        \param[in] transform Function returning the value of an index.
+        \param[in] combine Associative binary operation.
+        \param[in] options Options.
+        \return The reduced value, or the identity if the range is empty.
+    */
+    template<typename T, typename Transform, typename Combine>
+    T parallelReduce(size_t begin, size_t end, const T& identity, Transform&& transform, Combine&& combine, const ParallelOptions& options = {})
+    {
+        if (begin >= end) return identity;
+
+        const size_t count = end - begin;
+        const size_t grainSize = getParallelGrainSize(count, options);
+        const size_t chunkCount = div_round_up(count, grainSize);
+
+        auto reduceChunk = [&](size_t chunk)
+        {
+            const size_t chunkBegin = begin + chunk * grainSize;
+            const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+            T value = identity;
+            for (size_t i = chunkBegin; i < chunkEnd; ++i) value = combine(value, transform(i));
+            return value;
+        };
+
+        if (chunkCount == 1) return reduceChunk(0);
+
+        // Wrapped so that std::vector<bool> does not pack the partial results.
+        struct Partial { T value; };
+        std::vector<Partial> partials(chunkCount, Partial{ identity });
+        Threading::parallelFor(0, chunkCount, [&](size_t chunk) { partials[chunk].value = reduceChunk(chunk); });
+
+        // Combined in chunk order, so the operation does not need to be commutative.
+        T result = identity;
+        for (const auto& partial : partials) result = combine(result, partial.value);
+        return result;
+    }
+
+    /** Scan shared by parallelInclusiveScan() and parallelExclusiveScan().
+    */
+    template<typename T, typename Combine>
+    T parallelScan(const T* pInput, T* pOutput, size_t count, const T& identity, Combine&& combine, const ParallelOptions& options, bool inclusive)
+    {
+        if (count == 0) return identity;
+
+        const size_t grainSize = getParallelGrainSize(count, options);
+        const size_t chunkCount = div_round_up(count, grainSize);
+
+        // Reduce each chunk, then scan the chunk sums to get the offset of each chunk.
+        struct Partial { T value; };
+        std::vector<Partial> offsets(chunkCount, Partial{ identity });
+        if (chunkCount > 1)
+        {
+            Threading::parallelFor(0, chunkCount - 1, [&](size_t chunk)
+            {
+                const size_t chunkBegin = chunk * grainSize;
+                T value = identity;
+                for (size_t i = chunkBegin; i < chunkBegin + grainSize; ++i) value = combine(value, pInput[i]);
+                offsets[chunk + 1].value = value;
+            });
+            for (size_t chunk = 1; chunk < chunkCount; ++chunk) offsets[chunk].value = combine(offsets[chunk - 1].value, offsets[chunk].value);
+        }
+
+        // Scan each chunk starting at its offset. Inputs are read before the output is written, so pInput can equal pOutput.
+        const T lastInput = pInput[count - 1];
+        Threading::parallelFor(0, chunkCount, [&](size_t chunk)
+        {
+            const size_t chunkBegin = chunk * grainSize;
+            const size_t chunkEnd = std::min(count, chunkBegin + grainSize);
+            T value = offsets[chunk].value;
+            for (size_t i = chunkBegin; i < chunkEnd; ++i)
+            {
+                if (inclusive)
+                {
+                    value = combine(value, pInput[i]);
+                    pOutput[i] = value;
+                }
+                else
+                {
+                    T input = pInput[i];
+                    pOutput[i] = value;
+                    value = combine(value, input);
+                }
+            }
+        });
+
+        return inclusive ? pOutput[count - 1] : combine(pOutput[count - 1], lastInput);
+    }
+
+    /** Computes the inclusive scan pOutput[i] = pInput[0] op ... op pInput[i].
+        Each chunk is scanned from left to right starting at the combined sums of the previous chunks.
+        Results only depend on the chunk size, not on the task scheduling.
+        \param[in] pInput Input elements.
+        \param[out] pOutput Output elements. Can be equal to pInput for an in-place scan.
+        \param[in] count Number of elements.
+        \param[in] identity Identity element of the operation.
+        \param[in] combine Associative binary operation.
+        \param[in] options Options.
+        \return The combination of all elements.
+    */
+    template<typename T, typename Combine>
+    T parallelInclusiveScan(const T* pInput, T* pOutput, size_t count, const T& identity, Combine&& combine, const ParallelOptions& options = {})
+    {
+        return parallelScan(pInput, pOutput, count, identity, combine, options, true);
+    }
+
+    /** Computes the exclusive scan pOutput[i] = identity op pInput[0] op ... op pInput[i - 1].
+        See parallelInclusiveScan().
+        \return The combination of all elements.
+    */
+    template<typename T, typename Combine>
+    T parallelExclusiveScan(const T* pInput, T* pOutput, size_t count, const T& identity, Combine&& combine, const ParallelOptions& options = {})
+    {
+        return parallelScan(pInput, pOutput, count, identity, combine, options, false);
+    }
+
+    /** Stable LSD radix sort by an unsigned integer key, 8 key bits per pass.
+        \param[in,out] data Elements to sort. The element type must be default constructible.
+        \param[in] getKey Function returning the unsigned integer key of an element.
+        \param[in] keyBits Number of low key bits to sort by. Higher bits are ignored.
+        \param[in] options Options. The grain size sets the number of elements per chunk.
+    */
+    template<typename T, typename KeyFunc>
+    void parallelRadixSort(std::vector<T>& data, KeyFunc&& getKey, uint32_t keyBits, const ParallelOptions& options = {})
+    {
+        using Key = std::decay_t<std::invoke_result_t<KeyFunc&, const T&>>;
+        static_assert(std::is_unsigned_v<Key>, "Radix sort keys must be unsigned integers");
+
+        constexpr uint32_t kDigitBits = 8;
+        constexpr size_t kDigitCount = size_t(1) << kDigitBits;
+        constexpr size_t kMinGrainSize = size_t(1) << 14; // Smaller chunks spend more time on histograms than on sorting.
+
+        if (keyBits == 0 || keyBits > (uint32_t)std::numeric_limits<Key>::digits) throw ArgumentError("'keyBits' must be in the range [1,{}], got {}.", std::numeric_limits<Key>::digits, keyBits);
+
+        const size_t elementCount = data.size();
+        if (elementCount <= 1) return;
+
+        const size_t grainSize = getParallelGrainSize(elementCount, options, kMinGrainSize);
+        const size_t chunkCount = div_round_up(elementCount, grainSize);
+        const uint32_t passCount = div_round_up(keyBits, kDigitBits);
+
+        std::vector<T> scratch(elementCount);
+        std::vector<size_t> offsets(chunkCount * kDigitCount);
+
+        for (uint32_t pass = 0; pass < passCount; pass++)
+        {
+            const uint32_t shift = pass * kDigitBits;
+            const uint32_t digitBits = std::min(kDigitBits, keyBits - shift);
+            const Key digitMask = (Key(1) << digitBits) - 1;
+            auto getDigit = [&](const T& element) { return size_t((Key(getKey(element)) >> shift) & digitMask); };
+
+            // Count digits in each chunk.
+            Threading::parallelFor(0, chunkCount, [&](size_t chunk)
+            {
+                size_t* pCounts = &offsets[chunk * kDigitCount];
+                std::fill(pCounts, pCounts + kDigitCount, size_t(0));
+                const size_t end = std::min(elementCount, (chunk + 1) * grainSize);
+                for (size_t i = chunk * grainSize; i < end; i++) pCounts[getDigit(data[i])]++;
+            }, 1);
+
+            // Exclusive scan in digit-major order. Equal digits keep their chunk order, which makes the sort stable.
+            size_t sum = 0;
+            for (size_t digit = 0; digit < kDigitCount; digit++)
+            {
+                for (size_t chunk = 0; chunk < chunkCount; chunk++)
+                {
+                    size_t& offset = offsets[chunk * kDigitCount + digit];
+                    size_t count = offset;
+                    offset = sum;
+                    sum += count;
+                }
+            }
+
+            // Scatter each chunk.
+            Threading::parallelFor(0, chunkCount, [&](size_t chunk)
+            {
+                size_t* pOffsets = &offsets[chunk * kDigitCount];
+                const size_t end = std::min(elementCount, (chunk + 1) * grainSize);
+                for (size_t i = chunk * grainSize; i < end; i++) scratch[pOffsets[getDigit(data[i])]++] = std::move(data[i]);
+            }, 1);
+
+            data.swap(scratch);
+        }
+    }
+
+    /** Stable merge sort. Chunks are sorted in parallel, then merged pairwise in parallel.
+        \param[in,out] data Elements to sort. The element type must be default constructible.
+        \param[in] compare Strict weak ordering of the elements.
+        \param[in] options Options. The grain size sets the number of elements per chunk.
+    */
+    template<typename T, typename Compare = std::less<T>>
+    void parallelMergeSort(std::vector<T>& data, Compare compare = {}, const ParallelOptions& options = {})
+    {
+        constexpr size_t kMinGrainSize = 1024;
+
+        const size_t elementCount = data.size();
+        if (elementCount <= 1) return;
+
+        const size_t grainSize = getParallelGrainSize(elementCount, options, kMinGrainSize);
+
+        // Sort the chunks.
+        const size_t chunkCount = div_round_up(elementCount, grainSize);
+        Threading::parallelFor(0, chunkCount, [&](size_t chunk)
+        {
+            const size_t begin = chunk * grainSize;
+            const size_t end = std::min(elementCount, begin + grainSize);
+            std::stable_sort(data.begin() + begin, data.begin() + end, compare);
+        }, 1);
+        if (chunkCount == 1) return;
+
+        // Merge pairs of sorted runs until a single run is left. std::merge takes equal elements from the first run first, which keeps the sort stable.
+        std::vector<T> scratch(elementCount);
+        for (size_t width = grainSize; width < elementCount; width *= 2)
+        {
+            const size_t pairCount = div_round_up(elementCount, 2 * width);
+            Threading::parallelFor(0, pairCount, [&](size_t pair)
+            {
+                const size_t begin = pair * 2 * width;
+                const size_t middle = std::min(elementCount, begin + width);
+                const size_t end = std::min(elementCount, begin + 2 * width);
+                std::merge(std::make_move_iterator(data.begin() + begin), std::make_move_iterator(data.begin() + middle),
+                    std::make_move_iterator(data.begin() + middle), std::make_move_iterator(data.begin() + end),
+                    scratch.begin() + begin, compare);
+            }, 1);
+            data.swap(scratch);
+        }
+    }
+}
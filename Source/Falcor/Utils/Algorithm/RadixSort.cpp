@@ -0,0 +1,185 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RadixSort.h"
+#include "Core/Assert.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/Profiler.h"
+#include <algorithm>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFilename[] = "Utils/Algorithm/RadixSort.cs.slang";
+
+        const uint32_t kTileSize = 1024;
+        const uint32_t kDigitBits = 8;
+        const uint32_t kDigitCount = 1 << kDigitBits;
+
+        // Minimum number of elements per thread for the CPU sort. Smaller inputs use fewer threads.
+        const size_t kMinElementsPerThread = 1 << 14;
+
+        uint32_t getKeyMask(uint32_t keyBits)
+        {
+            return keyBits >= 32 ? 0xffffffff : (1u << keyBits) - 1;
+        }
+
+        void validateKeyBits(uint32_t keyBits)
+        {
+            if (keyBits == 0 || keyBits > 32) throw ArgumentError("RadixSort: 'keyBits' must be in the range [1,32], got {}.", keyBits);
+        }
+    }
+
+    RadixSort::RadixSort()
+    {
+        Program::DefineList defines = { {"TILE_SIZE", std::to_string(kTileSize)} };
+        mpSetupArgsPass = ComputePass::create(kShaderFilename, "setupArgs", defines);
+        mpCountDigitsPass = ComputePass::create(kShaderFilename, "countDigits", defines);
+        mpScatterPass = ComputePass::create(kShaderFilename, "scatter", defines);
+        mpPrefixSum = PrefixSum::create();
+
+        mpDispatchArgs = Buffer::create(sizeof(uint3), Resource::BindFlags::UnorderedAccess | Resource::BindFlags::IndirectArg, Buffer::CpuAccess::None, nullptr);
+        mpConstantCount = Buffer::create(sizeof(uint32_t), Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr);
+    }
+
+    RadixSort::SharedPtr RadixSort::create()
+    {
+        return SharedPtr(new RadixSort());
+    }
+
+    void RadixSort::prepareBuffers(uint32_t maxElementCount)
+    {
+        if (maxElementCount <= mMaxElementCount) return;
+
+        const uint32_t maxTileCount = div_round_up(maxElementCount, kTileSize);
+        mpScratch = Buffer::create(maxElementCount * sizeof(uint2), Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr);
+        mpScratch->setName("RadixSort::mpScratch");
+        mpHistogram = Buffer::create(kDigitCount * maxTileCount * sizeof(uint32_t), Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr);
+        mpHistogram->setName("RadixSort::mpHistogram");
+        mMaxElementCount = maxElementCount;
+    }
+
+    void RadixSort::execute(RenderContext* pRenderContext, const Buffer::SharedPtr& pData, uint32_t maxElementCount, Order order, uint32_t keyBits,
+        const Buffer::SharedPtr& pCounterBuffer, uint32_t counterOffset)
+    {
+        FALCOR_PROFILE("RadixSort::execute");
+
+        FALCOR_ASSERT(pRenderContext);
+        FALCOR_ASSERT(pData);
+        validateKeyBits(keyBits);
+        if (pData->getSize() < (uint64_t)maxElementCount * sizeof(uint2)) throw ArgumentError("RadixSort: Data buffer is too small for {} elements.", maxElementCount);
+
+        // Early out if there is nothing to be done.
+        if (maxElementCount <= 1) return;
+
+        prepareBuffers(maxElementCount);
+
+        // Without a counter buffer the element count is uploaded, so that the same indirect path is used in both cases.
+        Buffer::SharedPtr pCount = pCounterBuffer;
+        if (!pCount)
+        {
+            mpConstantCount->setBlob(&maxElementCount, 0, sizeof(uint32_t));
+            pCount = mpConstantCount;
+            counterOffset = 0;
+        }
+
+        const uint32_t maxTileCount = div_round_up(maxElementCount, kTileSize);
+        const uint32_t passCount = div_round_up(keyBits, kDigitBits);
+
+        auto setConstants = [&](const ComputePass::SharedPtr& pPass, uint32_t shift)
+        {
+            auto var = pPass->getRootVar()["CB"];
+            var["gMaxElementCount"] = maxElementCount;
+            var["gMaxTileCount"] = maxTileCount;
+            var["gCounterOffset"] = counterOffset;
+            var["gKeyMask"] = getKeyMask(keyBits);
+            var["gOrderMask"] = order == Order::Descending ? 0xffffffff : 0u;
+            var["gShift"] = shift;
+            pPass["gCounterBuffer"] = pCount;
+        };
+
+        // Compute the dispatch size from the element count.
+        setConstants(mpSetupArgsPass, 0);
+        mpSetupArgsPass["gDispatchArgs"] = mpDispatchArgs;
+        pRenderContext->uavBarrier(pCount.get());
+        mpSetupArgsPass->execute(pRenderContext, 1, 1);
+        pRenderContext->uavBarrier(mpDispatchArgs.get());
+
+        Buffer::SharedPtr pSrc = pData;
+        Buffer::SharedPtr pDst = mpScratch;
+
+        for (uint32_t pass = 0; pass < passCount; pass++)
+        {
+            const uint32_t shift = pass * kDigitBits;
+
+            // Pass 1: per-tile digit histograms. Tiles beyond the element count are not dispatched and keep their cleared histograms.
+            pRenderContext->clearUAV(mpHistogram->getUAV().get(), uint4(0));
+            setConstants(mpCountDigitsPass, shift);
+            mpCountDigitsPass["gSrc"] = pSrc;
+            mpCountDigitsPass["gHistogram"] = mpHistogram;
+            pRenderContext->uavBarrier(pSrc.get());
+            mpCountDigitsPass->executeIndirect(pRenderContext, mpDispatchArgs.get());
+
+            // Pass 2: global offset of each (digit, tile).
+            pRenderContext->uavBarrier(mpHistogram.get());
+            mpPrefixSum->execute(pRenderContext, mpHistogram, kDigitCount * maxTileCount);
+            pRenderContext->uavBarrier(mpHistogram.get());
+
+            // Pass 3: stable scatter.
+            setConstants(mpScatterPass, shift);
+            mpScatterPass["gSrc"] = pSrc;
+            mpScatterPass["gDst"] = pDst;
+            mpScatterPass["gHistogram"] = mpHistogram;
+            mpScatterPass->executeIndirect(pRenderContext, mpDispatchArgs.get());
+            pRenderContext->uavBarrier(pDst.get());
+
+            std::swap(pSrc, pDst);
+        }
+
+        // An odd number of passes leaves the result in the scratch buffer.
+        if (pSrc != pData)
+        {
+            pRenderContext->copyBufferRegion(pData.get(), 0, pSrc.get(), 0, maxElementCount * sizeof(uint2));
+        }
+    }
+
+    void RadixSort::executeHost(std::vector<uint2>& data, Order order, uint32_t keyBits, uint32_t threadCount)
+    {
+        validateKeyBits(keyBits);
+
+        const uint32_t keyMask = getKeyMask(keyBits);
+        const uint32_t orderMask = order == Order::Descending ? 0xffffffff : 0u;
+
+        ParallelOptions options;
+        if (threadCount > 0) options.grainSize = std::max(kMinElementsPerThread, div_round_up(data.size(), size_t(threadCount)));
+
+        parallelRadixSort(data, [=](const uint2& element) { return (element.y ^ orderMask) & keyMask; }, keyBits, options);
+    }
+}
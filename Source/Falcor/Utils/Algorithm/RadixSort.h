@@ -0,0 +1,108 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "RenderGraph/BasePasses/ComputePass.h"
+#include "Utils/Algorithm/PrefixSum.h"
+#include "Utils/Math/Vector.h"
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    class RenderContext;
+
+    /** Stable in-place LSD radix sort of 64-bit key-index pairs.
+
+        Each element is a uint2 where x holds the index (payload) and y holds the 32-bit sort key.
+        The sort processes 8 key bits per pass, so sorting fewer key bits reduces the number of passes.
+        The time complexity is O(N) per pass and no padding to a power-of-two is needed.
+
+        The element count can be read on the GPU from a counter buffer (e.g. the UAV counter of an
+        append buffer). All dispatches are then sized from indirect arguments and the host never
+        needs to know the count.
+
+        A multithreaded CPU implementation with identical ordering is provided for validation.
+    */
+    class FALCOR_API RadixSort
+    {
+    public:
+        using SharedPtr = std::shared_ptr<RadixSort>;
+        using SharedConstPtr = std::shared_ptr<const RadixSort>;
+        virtual ~RadixSort() = default;
+
+        enum class Order
+        {
+            Ascending,
+            Descending,
+        };
+
+        /** Create a new radix sort object.
+            \return New object, or throws an exception on error.
+        */
+        static SharedPtr create();
+
+        /** Sort key-index pairs in place on the GPU.
+            \param[in] pRenderContext The render context.
+            \param[in] pData The data buffer to sort in-place. Holds uint2 elements and must be bindable as a UAV.
+            \param[in] maxElementCount Number of elements, or the capacity of pData if pCounterBuffer is set.
+            \param[in] order Sort order of the keys.
+            \param[in] keyBits Number of low key bits to sort by, in the range [1,32]. Higher bits are ignored.
+            \param[in] pCounterBuffer (Optional) Buffer holding the element count as a uint32_t. The count is clamped to maxElementCount.
+            \param[in] counterOffset Byte offset of the element count in pCounterBuffer.
+        */
+        void execute(RenderContext* pRenderContext, const Buffer::SharedPtr& pData, uint32_t maxElementCount, Order order = Order::Ascending, uint32_t keyBits = 32,
+            const Buffer::SharedPtr& pCounterBuffer = nullptr, uint32_t counterOffset = 0);
+
+        /** Sort key-index pairs in place on the CPU.
+            The result is identical to execute() on the GPU.
+            \param[in,out] data Elements to sort.
+            \param[in] order Sort order of the keys.
+            \param[in] keyBits Number of low key bits to sort by, in the range [1,32]. Higher bits are ignored.
+            \param[in] threadCount Number of threads to use. Zero uses all logical processors, one runs serially.
+        */
+        static void executeHost(std::vector<uint2>& data, Order order = Order::Ascending, uint32_t keyBits = 32, uint32_t threadCount = 0);
+
+    protected:
+        RadixSort();
+
+        void prepareBuffers(uint32_t maxElementCount);
+
+        ComputePass::SharedPtr      mpSetupArgsPass;
+        ComputePass::SharedPtr      mpCountDigitsPass;
+        ComputePass::SharedPtr      mpScatterPass;
+        PrefixSum::SharedPtr        mpPrefixSum;
+
+        Buffer::SharedPtr           mpScratch;          ///< Ping-pong buffer for the sort passes.
+        Buffer::SharedPtr           mpHistogram;        ///< Digit-major per-tile histograms.
+        Buffer::SharedPtr           mpDispatchArgs;     ///< Indirect dispatch arguments for the per-tile passes.
+        Buffer::SharedPtr           mpConstantCount;    ///< Holds the element count when no counter buffer is given.
+        uint32_t                    mMaxElementCount = 0;
+    };
+}
@@ -0,0 +1,113 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RadixTree.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include <algorithm>
+#include <fstd/bit.h> // TODO: Replace with C++20 <bit> when available on all targets
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Length of the common prefix of the keys at i and j, or -1 if j is out of range.
+            Equal keys are disambiguated by the common prefix of their indices.
+        */
+        int commonPrefix(const std::vector<uint32_t>& keys, int i, int j)
+        {
+            if (j < 0 || j >= (int)keys.size()) return -1;
+            uint32_t a = keys[i];
+            uint32_t b = keys[j];
+            if (a != b) return fstd::countl_zero(a ^ b);
+            return 32 + fstd::countl_zero(uint32_t(i) ^ uint32_t(j));
+        }
+    }
+
+    uint2 RadixTree::getChildren(const Node& node, uint32_t keyCount)
+    {
+        FALCOR_ASSERT(node.split != kInvalidIndex);
+        const uint32_t leafStart = getLeafNodeStart(keyCount);
+        uint32_t left = node.leafRange.x == node.split ? leafStart + node.split : node.split;
+        uint32_t right = node.leafRange.y == node.split + 1 ? leafStart + node.split + 1 : node.split + 1;
+        return uint2(left, right);
+    }
+
+    std::vector<RadixTree::Node> RadixTree::build(const std::vector<uint32_t>& keys)
+    {
+        if (keys.size() >= kInvalidIndex / 2) throw ArgumentError("Too many keys for a radix tree ({}).", keys.size());
+
+        const uint32_t keyCount = (uint32_t)keys.size();
+        const uint32_t leafStart = getLeafNodeStart(keyCount);
+        std::vector<Node> nodes(getNodeCount(keyCount));
+
+        for (uint32_t i = 0; i < keyCount; i++) nodes[leafStart + i].leafRange = uint2(i);
+
+        // Each internal node is found independently of the others, which is what makes the construction parallel.
+        parallelFor(0, leafStart, [&](size_t index)
+        {
+            const int i = (int)index;
+
+            // Direction of the range covered by the node.
+            const int d = commonPrefix(keys, i, i + 1) - commonPrefix(keys, i, i - 1) > 0 ? 1 : -1;
+
+            // Upper bound of the range length, then binary search for the other end.
+            const int minPrefix = commonPrefix(keys, i, i - d);
+            int maxLength = 2;
+            while (commonPrefix(keys, i, i + maxLength * d) > minPrefix) maxLength <<= 1;
+            int length = 0;
+            for (int t = maxLength >> 1; t >= 1; t >>= 1)
+            {
+                if (commonPrefix(keys, i, i + (length + t) * d) > minPrefix) length += t;
+            }
+            const int j = i + length * d;
+
+            // Binary search for the split position.
+            const int nodePrefix = commonPrefix(keys, i, j);
+            int s = 0;
+            int t = length;
+            do
+            {
+                t = (t + 1) >> 1;
+                if (commonPrefix(keys, i, i + (s + t) * d) > nodePrefix) s += t;
+            } while (t > 1);
+            const int split = i + s * d + std::min(d, 0);
+
+            Node& node = nodes[i];
+            node.leafRange = uint2(std::min(i, j), std::max(i, j));
+            node.split = (uint32_t)split;
+
+            // Every node has a single parent, so these writes never race.
+            uint2 children = getChildren(node, keyCount);
+            nodes[children.x].parent = (uint32_t)index;
+            nodes[children.y].parent = (uint32_t)index;
+        });
+
+        return nodes;
+    }
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Binary radix tree over sorted keys.
+
+        This is the construction from Karras, "Maximizing Parallelism in the Construction of BVHs,
+        Octrees, and k-d Trees", HPG 2012. A tree over n keys has exactly n - 1 internal nodes and
+        n leaves, so it needs 2n - 1 nodes and no padding to a power-of-two. The nodes are stored in a
+        single array: internal node i at index i (the root is node 0) and leaf i at index n - 1 + i.
+
+        Every node covers a contiguous range of leaves. The children of an internal node are found
+        from its split index: the left child covers [first, split] and the right child [split + 1, last].
+        A child covering a single key is a leaf.
+
+        The keys must be sorted, in either ascending or descending order. Duplicate keys are allowed
+        and are disambiguated by their index, as in the paper. The same construction runs on the GPU,
+        and this CPU version is used for validation.
+    */
+    class FALCOR_API RadixTree
+    {
+    public:
+        static constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+        struct Node
+        {
+            uint2 leafRange;                    ///< First and last leaf covered by the node.
+            uint32_t split = kInvalidIndex;     ///< Split index. Only valid for internal nodes.
+            uint32_t parent = kInvalidIndex;    ///< Index of the parent node, or kInvalidIndex for the root.
+        };
+
+        /** Get the number of nodes in a tree over the given number of keys.
+        */
+        static uint32_t getNodeCount(uint32_t keyCount) { return keyCount > 0 ? 2 * keyCount - 1 : 0; }
+
+        /** Get the index of the first leaf node in a tree over the given number of keys.
+        */
+        static uint32_t getLeafNodeStart(uint32_t keyCount) { return keyCount > 0 ? keyCount - 1 : 0; }
+
+        /** Get the node indices of the two children of an internal node.
+            \param[in] node The internal node.
+            \param[in] keyCount Number of keys the tree was built over.
+            \return Node indices of the left and right child.
+        */
+        static uint2 getChildren(const Node& node, uint32_t keyCount);
+
+        /** Build the tree over sorted keys. The internal nodes are built in parallel.
+            \param[in] keys Sorted keys.
+            \return Array of getNodeCount(keys.size()) nodes.
+        */
+        static std::vector<Node> build(const std::vector<uint32_t>& keys);
+    };
+}
@@ -0,0 +1,338 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshOptimizer.h"
+#include "Core/Errors.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = 0xffffffff;
+
+        // Simulated cache for vertex fetches. It is direct-mapped with 64 byte lines.
+        const uint64_t kFetchCacheLineSize = 64;
+        const uint64_t kFetchCacheLineCount = 256;
+
+        void checkIndices(fstd::span<const uint32_t> indices, uint32_t vertexCount)
+        {
+            checkArgument(indices.size() % 3 == 0, "'indices' must contain whole triangles, but has {} indices.", indices.size());
+            for (uint32_t index : indices)
+            {
+                checkArgument(index < vertexCount, "'indices' contains index {}, but there are only {} vertices.", index, vertexCount);
+            }
+        }
+
+        /** Simulates a FIFO post-transform vertex cache.
+            The time each vertex was inserted is stored, so a vertex is in the cache if fewer than cacheSize vertices were inserted since.
+        */
+        class VertexCache
+        {
+        public:
+            VertexCache(uint32_t vertexCount, uint32_t cacheSize)
+                : mCacheTime(vertexCount, 0)
+                , mCacheSize(cacheSize)
+                , mTime(cacheSize + 1)
+            {}
+
+            /** Access a vertex.
+                \return True if the vertex was a cache miss.
+            */
+            bool access(uint32_t vertex)
+            {
+                if (getAge(vertex) <= mCacheSize) return false;
+                mCacheTime[vertex] = mTime++;
+                return true;
+            }
+
+            /** Get the number of vertices inserted since the vertex was inserted, plus one.
+            */
+            uint32_t getAge(uint32_t vertex) const { return mTime - mCacheTime[vertex]; }
+
+            /** Evict all vertices.
+            */
+            void flush() { mTime += mCacheSize + 1; }
+
+        private:
+            std::vector<uint32_t> mCacheTime;
+            uint32_t mCacheSize;
+            uint32_t mTime;
+        };
+    }
+
+    VertexCacheStats analyzeVertexCache(fstd::span<const uint32_t> indices, uint32_t vertexCount, uint32_t vertexSize, uint32_t cacheSize)
+    {
+        checkIndices(indices, vertexCount);
+        checkArgument(vertexSize > 0, "'vertexSize' must be positive.");
+        checkArgument(cacheSize > 0, "'cacheSize' must be positive.");
+
+        VertexCacheStats stats;
+        stats.triangleCount = indices.size() / 3;
+        stats.vertexCount = vertexCount;
+        stats.vertexBytes = (uint64_t)vertexCount * vertexSize;
+
+        VertexCache cache(vertexCount, cacheSize);
+        std::vector<uint64_t> lineTags(kFetchCacheLineCount, std::numeric_limits<uint64_t>::max());
+
+        for (uint32_t index : indices)
+        {
+            if (!cache.access(index)) continue;
+            stats.cacheMissCount++;
+
+            // Vertices are only fetched on vertex cache misses.
+            const uint64_t begin = (uint64_t)index * vertexSize;
+            const uint64_t end = begin + vertexSize;
+            for (uint64_t line = begin / kFetchCacheLineSize; line <= (end - 1) / kFetchCacheLineSize; line++)
+            {
+                uint64_t& tag = lineTags[line % kFetchCacheLineCount];
+                if (tag == line) continue;
+                tag = line;
+                stats.fetchedBytes += kFetchCacheLineSize;
+            }
+        }
+
+        return stats;
+    }
+
+    std::vector<uint32_t> optimizeVertexCache(fstd::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        checkIndices(indices, vertexCount);
+        checkArgument(cacheSize > 0, "'cacheSize' must be positive.");
+
+        const size_t triangleCount = indices.size() / 3;
+
+        // Build the vertex-triangle adjacency and count the live (not yet emitted) triangles of each vertex.
+        std::vector<uint32_t> liveCount(vertexCount, 0);
+        for (uint32_t index : indices) liveCount[index]++;
+
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        std::partial_sum(liveCount.begin(), liveCount.end(), offsets.begin() + 1);
+
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); i++) adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+        }
+
+        // Tipsify: Fan around a vertex by emitting all its live triangles. The next vertex to fan around is
+        // picked among the vertices of the emitted triangles, preferring the oldest vertex that is still in the
+        // cache after emitting its own triangles. If there is none, a recently used vertex with live triangles
+        // is taken from the dead-end stack, or else the next vertex with live triangles in input order.
+        VertexCache cache(vertexCount, cacheSize);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEnd;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> result;
+        deadEnd.reserve(indices.size());
+        result.reserve(indices.size());
+        uint32_t cursor = 0;
+
+        auto skipDeadEnd = [&]()
+        {
+            while (!deadEnd.empty())
+            {
+                uint32_t vertex = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveCount[vertex] > 0) return vertex;
+            }
+            for (; cursor < vertexCount; cursor++)
+            {
+                if (liveCount[cursor] > 0) return cursor;
+            }
+            return kInvalidIndex;
+        };
+
+        uint32_t fanning = skipDeadEnd();
+        while (fanning != kInvalidIndex)
+        {
+            candidates.clear();
+            for (uint32_t i = offsets[fanning]; i < offsets[fanning + 1]; i++)
+            {
+                const uint32_t triangle = adjacency[i];
+                if (emitted[triangle]) continue;
+                emitted[triangle] = true;
+
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    const uint32_t vertex = indices[triangle * 3 + j];
+                    result.push_back(vertex);
+                    deadEnd.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveCount[vertex]--;
+                    cache.access(vertex);
+                }
+            }
+
+            uint32_t next = kInvalidIndex;
+            int64_t bestPriority = -1;
+            for (uint32_t vertex : candidates)
+            {
+                if (liveCount[vertex] == 0) continue;
+                int64_t priority = 0;
+                if ((int64_t)cache.getAge(vertex) + 2 * (int64_t)liveCount[vertex] <= cacheSize) priority = cache.getAge(vertex);
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    next = vertex;
+                }
+            }
+            fanning = next != kInvalidIndex ? next : skipDeadEnd();
+        }
+
+        FALCOR_ASSERT(result.size() == indices.size());
+        return result;
+    }
+
+    std::vector<uint32_t> optimizeOverdraw(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, float threshold, uint32_t cacheSize)
+    {
+        checkArgument(positions.size() <= std::numeric_limits<uint32_t>::max(), "'positions' has too many elements.");
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        checkIndices(indices, vertexCount);
+        checkArgument(cacheSize > 0, "'cacheSize' must be positive.");
+
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+        VertexCache cache(vertexCount, cacheSize);
+        auto accessTriangle = [&](uint32_t triangle)
+        {
+            uint32_t misses = 0;
+            for (uint32_t j = 0; j < 3; j++) misses += cache.access(indices[triangle * 3 + j]) ? 1 : 0;
+            return misses;
+        };
+
+        // Split into hard clusters where the cache restarts, which is where all vertices of a triangle miss.
+        std::vector<uint32_t> hardBoundaries;
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            if (accessTriangle(triangle) == 3) hardBoundaries.push_back(triangle);
+        }
+        hardBoundaries.push_back(triangleCount);
+
+        // Split the hard clusters further, wherever the cache miss ratio of the cluster so far is within
+        // the threshold of the ratio of the whole hard cluster.
+        std::vector<uint32_t> clusterStarts;
+        for (size_t i = 0; i + 1 < hardBoundaries.size(); i++)
+        {
+            const uint32_t begin = hardBoundaries[i];
+            const uint32_t end = hardBoundaries[i + 1];
+
+            cache.flush();
+            uint32_t misses = 0;
+            for (uint32_t triangle = begin; triangle < end; triangle++) misses += accessTriangle(triangle);
+            const float targetRatio = (float)misses / (end - begin) * threshold;
+
+            cache.flush();
+            misses = 0;
+            uint32_t start = begin;
+            clusterStarts.push_back(begin);
+            for (uint32_t triangle = begin; triangle + 1 < end; triangle++)
+            {
+                misses += accessTriangle(triangle);
+                if ((float)misses / (triangle - start + 1) <= targetRatio)
+                {
+                    start = triangle + 1;
+                    clusterStarts.push_back(start);
+                    misses = 0;
+                    cache.flush();
+                }
+            }
+        }
+
+        const uint32_t clusterCount = (uint32_t)clusterStarts.size();
+        if (clusterCount <= 1) return std::vector<uint32_t>(indices.begin(), indices.end());
+        clusterStarts.push_back(triangleCount);
+
+        // Sort the clusters by how much they face away from the mesh center, using area-weighted centroids and normals.
+        std::vector<float3> clusterCentroids(clusterCount, float3(0.f));
+        std::vector<float3> clusterNormals(clusterCount, float3(0.f));
+        std::vector<float> clusterAreas(clusterCount, 0.f);
+        float3 meshCentroid(0.f);
+        float meshArea = 0.f;
+
+        for (uint32_t cluster = 0; cluster < clusterCount; cluster++)
+        {
+            for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+            {
+                const float3& p0 = positions[indices[triangle * 3 + 0]];
+                const float3& p1 = positions[indices[triangle * 3 + 1]];
+                const float3& p2 = positions[indices[triangle * 3 + 2]];
+                const float3 normal = glm::cross(p1 - p0, p2 - p0);
+                const float area = glm::length(normal);
+                const float3 centroid = (p0 + p1 + p2) / 3.f;
+
+                clusterCentroids[cluster] += centroid * area;
+                clusterNormals[cluster] += normal;
+                clusterAreas[cluster] += area;
+            }
+            meshCentroid += clusterCentroids[cluster];
+            meshArea += clusterAreas[cluster];
+        }
+        if (meshArea > 0.f) meshCentroid /= meshArea;
+
+        std::vector<float> sortKeys(clusterCount, 0.f);
+        for (uint32_t cluster = 0; cluster < clusterCount; cluster++)
+        {
+            const float normalLength = glm::length(clusterNormals[cluster]);
+            if (clusterAreas[cluster] > 0.f && normalLength > 0.f)
+            {
+                const float3 centroid = clusterCentroids[cluster] / clusterAreas[cluster];
+                sortKeys[cluster] = glm::dot(centroid - meshCentroid, clusterNormals[cluster] / normalLength);
+            }
+        }
+
+        std::vector<uint32_t> clusterOrder(clusterCount);
+        std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (uint32_t cluster : clusterOrder)
+        {
+            result.insert(result.end(), indices.begin() + clusterStarts[cluster] * 3, indices.begin() + clusterStarts[cluster + 1] * 3);
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> optimizeVertexFetchRemap(fstd::span<const uint32_t> indices, uint32_t vertexCount)
+    {
+        checkIndices(indices, vertexCount);
+
+        std::vector<uint32_t> remap(vertexCount, kInvalidIndex);
+        uint32_t nextIndex = 0;
+        for (uint32_t index : indices)
+        {
+            if (remap[index] == kInvalidIndex) remap[index] = nextIndex++;
+        }
+        for (uint32_t& index : remap)
+        {
+            if (index == kInvalidIndex) index = nextIndex++;
+        }
+        return remap;
+    }
+}
@@ -0,0 +1,119 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <cstdint>
+#include <vector>
+
+/** Host-side optimizations of indexed triangle meshes.
+
+    The functions operate on triangle list index buffers and are independent of the vertex format.
+    A typical pipeline is to reorder the triangles for the post-transform vertex cache, then reorder
+    clusters of triangles to reduce overdraw, and finally reorder the vertices in the order they are
+    first referenced to improve the locality of vertex fetches.
+*/
+
+namespace Falcor
+{
+    /** Default size of the simulated post-transform vertex cache (FIFO).
+    */
+    static constexpr uint32_t kDefaultVertexCacheSize = 16;
+
+    /** Vertex cache and vertex fetch statistics of an index buffer.
+    */
+    struct VertexCacheStats
+    {
+        uint64_t triangleCount = 0;
+        uint64_t vertexCount = 0;       ///< Number of vertices in the vertex buffer.
+        uint64_t cacheMissCount = 0;    ///< Number of vertex shader invocations with a simulated FIFO vertex cache.
+        uint64_t vertexBytes = 0;       ///< Size of the vertex buffer in bytes.
+        uint64_t fetchedBytes = 0;      ///< Number of bytes fetched from memory with a simulated cache of 64 byte lines.
+
+        /** Average cache miss ratio, the number of transformed vertices per triangle. Ranges from 0.5 for large regular meshes to 3.
+        */
+        float getACMR() const { return triangleCount > 0 ? (float)cacheMissCount / triangleCount : 0.f; }
+
+        /** Average transformed vertex ratio, the number of transformed vertices per vertex. Optimal is 1.
+        */
+        float getATVR() const { return vertexCount > 0 ? (float)cacheMissCount / vertexCount : 0.f; }
+
+        /** Ratio of fetched bytes to the vertex buffer size. Optimal is 1.
+        */
+        float getOverfetch() const { return vertexBytes > 0 ? (float)fetchedBytes / vertexBytes : 0.f; }
+
+        VertexCacheStats& operator+=(const VertexCacheStats& other)
+        {
+            triangleCount += other.triangleCount;
+            vertexCount += other.vertexCount;
+            cacheMissCount += other.cacheMissCount;
+            vertexBytes += other.vertexBytes;
+            fetchedBytes += other.fetchedBytes;
+            return *this;
+        }
+    };
+
+    /** Compute the vertex cache and vertex fetch statistics of a triangle list.
+        \param[in] indices Triangle list indices.
+        \param[in] vertexCount Number of vertices.
+        \param[in] vertexSize Size of a vertex in bytes.
+        \param[in] cacheSize Size of the simulated vertex cache.
+        \return The statistics.
+    */
+    FALCOR_API VertexCacheStats analyzeVertexCache(fstd::span<const uint32_t> indices, uint32_t vertexCount, uint32_t vertexSize, uint32_t cacheSize = kDefaultVertexCacheSize);
+
+    /** Reorder the triangles of a triangle list for the post-transform vertex cache.
+        This uses the linear-time Tipsify algorithm [Sander et al. 2007].
+        \param[in] indices Triangle list indices.
+        \param[in] vertexCount Number of vertices.
+        \param[in] cacheSize Size of the targeted vertex cache.
+        \return The reordered indices.
+    */
+    FALCOR_API std::vector<uint32_t> optimizeVertexCache(fstd::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = kDefaultVertexCacheSize);
+
+    /** Reorder clusters of triangles to reduce overdraw, while keeping most of the vertex cache efficiency.
+        The triangles are split into clusters where the vertex cache is restarted, or where the cache miss ratio so far
+        is within `threshold` of that of the whole cluster. The clusters are then sorted to draw clusters facing away
+        from the mesh center first, as they are more likely to occlude the rest of the mesh [Sander et al. 2007].
+        \param[in] indices Triangle list indices, ideally ordered by optimizeVertexCache().
+        \param[in] positions Vertex positions.
+        \param[in] threshold Allowed increase of the cache miss ratio. Larger values create more clusters.
+        \param[in] cacheSize Size of the targeted vertex cache.
+        \return The reordered indices.
+    */
+    FALCOR_API std::vector<uint32_t> optimizeOverdraw(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, float threshold = 1.05f, uint32_t cacheSize = kDefaultVertexCacheSize);
+
+    /** Create a vertex remap that orders the vertices by their first use in a triangle list.
+        Unreferenced vertices are moved to the end, in their original order.
+        \param[in] indices Triangle list indices.
+        \param[in] vertexCount Number of vertices.
+        \return Remap table from old to new vertex index.
+    */
+    FALCOR_API std::vector<uint32_t> optimizeVertexFetchRemap(fstd::span<const uint32_t> indices, uint32_t vertexCount);
+}
@@ -0,0 +1,410 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshSimplifier.h"
+#include "Core/Errors.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = 0xffffffff;
+
+        // Weight of the planes that keep border vertices on the border, relative to the triangle planes.
+        const float kBorderWeight = 10.f;
+
+        enum class VertexKind : uint8_t
+        {
+            Manifold,   ///< Interior vertex, can collapse onto any neighbor.
+            Border,     ///< Vertex on an open border, can only collapse onto its neighbors on the border.
+            Locked,     ///< Seam or non-manifold vertex, never collapses.
+        };
+
+        /** Error quadric. Stores the weighted sum of squared distances to a set of planes.
+        */
+        struct Quadric
+        {
+            double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            double c = 0.0;
+            double weight = 0.0;
+
+            /** Create the quadric of the plane dot(n, p) + d = 0.
+            */
+            static Quadric fromPlane(const float3& n, float d, float weight)
+            {
+                Quadric q;
+                q.a00 = weight * n.x * n.x;
+                q.a11 = weight * n.y * n.y;
+                q.a22 = weight * n.z * n.z;
+                q.a01 = weight * n.x * n.y;
+                q.a02 = weight * n.x * n.z;
+                q.a12 = weight * n.y * n.z;
+                q.b0 = weight * n.x * d;
+                q.b1 = weight * n.y * d;
+                q.b2 = weight * n.z * d;
+                q.c = weight * d * d;
+                q.weight = weight;
+                return q;
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                a00 += other.a00; a11 += other.a11; a22 += other.a22;
+                a01 += other.a01; a02 += other.a02; a12 += other.a12;
+                b0 += other.b0; b1 += other.b1; b2 += other.b2;
+                c += other.c;
+                weight += other.weight;
+                return *this;
+            }
+
+            /** Evaluate the weighted mean of the squared distances of a point to the planes.
+            */
+            double evaluate(const float3& p) const
+            {
+                if (weight == 0.0) return 0.0;
+                double x = p.x, y = p.y, z = p.z;
+                double r = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+                return std::abs(r) / weight;
+            }
+        };
+
+        struct Collapse
+        {
+            uint32_t from;
+            uint32_t to;
+            double error;
+        };
+
+        uint64_t getEdgeKey(uint32_t a, uint32_t b)
+        {
+            return ((uint64_t)a << 32) | b;
+        }
+
+        /** Map each vertex to the lowest index of the vertices with a bitwise identical position.
+        */
+        std::vector<uint32_t> createPositionRemap(fstd::span<const float3> positions)
+        {
+            auto getKey = [&](uint32_t i)
+            {
+                std::array<uint32_t, 3> key;
+                std::memcpy(key.data(), &positions[i], sizeof(key));
+                return key;
+            };
+
+            std::vector<uint32_t> order(positions.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+            {
+                auto keyA = getKey(a), keyB = getKey(b);
+                return keyA < keyB || (keyA == keyB && a < b);
+            });
+
+            std::vector<uint32_t> remap(positions.size());
+            for (size_t i = 0; i < order.size(); i++)
+            {
+                bool isFirst = i == 0 || getKey(order[i]) != getKey(order[i - 1]);
+                remap[order[i]] = isFirst ? order[i] : remap[order[i - 1]];
+            }
+            return remap;
+        }
+    }
+
+    std::vector<uint32_t> simplifyMesh(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, size_t targetIndexCount, float targetError, float* pResultError)
+    {
+        checkArgument(indices.size() % 3 == 0, "'indices' must contain whole triangles, but has {} indices.", indices.size());
+        checkArgument(positions.size() < kInvalidIndex, "'positions' has too many elements.");
+        checkArgument(targetError >= 0.f, "'targetError' ({}) must not be negative.", targetError);
+
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        for (uint32_t index : indices)
+        {
+            checkArgument(index < vertexCount, "'indices' contains index {}, but there are only {} vertices.", index, vertexCount);
+        }
+
+        std::vector<uint32_t> result(indices.begin(), indices.end());
+        if (pResultError) *pResultError = 0.f;
+        if (result.size() <= targetIndexCount) return result;
+
+        // Scale the positions to the unit cube, so that the errors are relative to the mesh extent.
+        float3 minPos(std::numeric_limits<float>::max());
+        float3 maxPos(-std::numeric_limits<float>::max());
+        for (uint32_t index : indices)
+        {
+            minPos = min(minPos, positions[index]);
+            maxPos = max(maxPos, positions[index]);
+        }
+        float3 extent = maxPos - minPos;
+        float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+        float scale = maxExtent > 0.f ? 1.f / maxExtent : 1.f;
+
+        std::vector<float3> scaledPositions(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++) scaledPositions[i] = (positions[i] - minPos) * scale;
+
+        // Classify the vertices. This is done on the vertices with unique positions, so that seams don't appear as borders.
+        std::vector<uint32_t> remap = createPositionRemap(positions);
+
+        std::vector<uint32_t> wedgeCount(vertexCount, 0);
+        {
+            std::vector<bool> isReferenced(vertexCount, false);
+            for (uint32_t index : indices) isReferenced[index] = true;
+            for (uint32_t i = 0; i < vertexCount; i++) if (isReferenced[i]) wedgeCount[remap[i]]++;
+        }
+
+        std::vector<uint64_t> edges;
+        edges.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            for (size_t j = 0; j < 3; j++)
+            {
+                uint32_t a = remap[indices[i + j]];
+                uint32_t b = remap[indices[i + (j + 1) % 3]];
+                if (a != b) edges.push_back(getEdgeKey(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::vector<VertexKind> kinds(vertexCount, VertexKind::Manifold);
+        std::vector<uint32_t> borderNext(vertexCount, kInvalidIndex);
+        std::vector<uint32_t> borderPrev(vertexCount, kInvalidIndex);
+        std::vector<uint32_t> borderEdgeCount(vertexCount, 0);
+
+        for (size_t i = 0; i < edges.size();)
+        {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j] == edges[i]) j++;
+
+            uint32_t a = (uint32_t)(edges[i] >> 32);
+            uint32_t b = (uint32_t)edges[i];
+            auto reverse = std::equal_range(edges.begin(), edges.end(), getEdgeKey(b, a));
+            size_t reverseCount = reverse.second - reverse.first;
+
+            if (j - i > 1 || reverseCount > 1)
+            {
+                // Edges shared by more than two triangles, or by two triangles with opposite winding.
+                kinds[a] = kinds[b] = VertexKind::Locked;
+            }
+            else if (reverseCount == 0)
+            {
+                borderNext[a] = b;
+                borderPrev[b] = a;
+                borderEdgeCount[a]++;
+                borderEdgeCount[b]++;
+            }
+            i = j;
+        }
+
+        for (uint32_t i = 0; i < vertexCount; i++)
+        {
+            if (wedgeCount[remap[i]] > 1) kinds[i] = VertexKind::Locked;
+            else if (kinds[i] == VertexKind::Manifold && borderEdgeCount[i] > 0)
+            {
+                // Vertices where several borders meet are locked.
+                kinds[i] = borderEdgeCount[i] == 2 && borderNext[i] != kInvalidIndex && borderPrev[i] != kInvalidIndex ? VertexKind::Border : VertexKind::Locked;
+            }
+        }
+
+        // Initialize the quadrics with the planes of the triangles, weighted by area, and planes through the border edges perpendicular to the triangles.
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            const uint32_t v[3] = { remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]] };
+            const float3 p[3] = { scaledPositions[v[0]], scaledPositions[v[1]], scaledPositions[v[2]] };
+
+            float3 normal = cross(p[1] - p[0], p[2] - p[0]);
+            float area = length(normal);
+            if (area == 0.f) continue;
+            normal /= area;
+
+            Quadric q = Quadric::fromPlane(normal, -dot(normal, p[0]), 0.5f * area);
+            for (uint32_t j = 0; j < 3; j++) quadrics[v[j]] += q;
+
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                uint32_t a = v[j], b = v[(j + 1) % 3];
+                if (a == b || std::binary_search(edges.begin(), edges.end(), getEdgeKey(b, a))) continue;
+
+                float3 edge = p[(j + 1) % 3] - p[j];
+                float edgeLength = length(edge);
+                if (edgeLength == 0.f) continue;
+
+                float3 edgeNormal = normalize(cross(edge, normal));
+                Quadric edgeQuadric = Quadric::fromPlane(edgeNormal, -dot(edgeNormal, p[j]), kBorderWeight * edgeLength * edgeLength);
+                quadrics[a] += edgeQuadric;
+                quadrics[b] += edgeQuadric;
+            }
+        }
+
+        auto canCollapse = [&](uint32_t from, uint32_t to)
+        {
+            // Collapsible vertices have unique positions, so their index is the same as their remapped index.
+            switch (kinds[from])
+            {
+            case VertexKind::Manifold:
+                return true;
+            case VertexKind::Border:
+                return borderNext[from] == remap[to] || borderPrev[from] == remap[to];
+            default:
+                return false;
+            }
+        };
+
+        const double errorLimit = (double)targetError * targetError;
+        const size_t targetTriangleCount = targetIndexCount / 3;
+        double resultError = 0.0;
+
+        std::vector<uint32_t> adjacencyOffsets;
+        std::vector<uint32_t> adjacency;
+        std::vector<Collapse> collapses;
+        std::vector<uint32_t> collapseRemap(vertexCount);
+        std::vector<bool> collapseLocked(vertexCount);
+
+        // Check if moving a vertex flips any of its triangles that are not removed by the collapse.
+        auto hasTriangleFlips = [&](uint32_t from, uint32_t to)
+        {
+            for (uint32_t k = adjacencyOffsets[from]; k < adjacencyOffsets[from + 1]; k++)
+            {
+                const uint32_t triangle = adjacency[k];
+                uint32_t v[3];
+                for (uint32_t j = 0; j < 3; j++) v[j] = collapseRemap[result[triangle * 3 + j]];
+                if (v[0] == to || v[1] == to || v[2] == to) continue;
+
+                uint32_t j = v[0] == from ? 0 : (v[1] == from ? 1 : 2);
+                const float3& p1 = scaledPositions[v[(j + 1) % 3]];
+                const float3& p2 = scaledPositions[v[(j + 2) % 3]];
+                float3 normal = cross(p1 - scaledPositions[from], p2 - scaledPositions[from]);
+                float3 newNormal = cross(p1 - scaledPositions[to], p2 - scaledPositions[to]);
+                // Reject rotations of more than about 75 degrees, which avoids flipping through a series of smaller rotations.
+                if (dot(normal, newNormal) <= 0.25f * length(normal) * length(newNormal)) return true;
+            }
+            return false;
+        };
+
+        // Collapse edges in passes. Each vertex is part of at most one collapse per pass, after which the mesh is updated.
+        while (result.size() / 3 > targetTriangleCount)
+        {
+            const size_t triangleCount = result.size() / 3;
+
+            adjacencyOffsets.assign(vertexCount + 1, 0);
+            for (uint32_t index : result) adjacencyOffsets[index + 1]++;
+            std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+            adjacency.resize(result.size());
+            {
+                std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+                for (size_t i = 0; i < result.size(); i++) adjacency[cursors[result[i]]++] = (uint32_t)(i / 3);
+            }
+
+            // Find the cheapest direction of each edge.
+            collapses.clear();
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (size_t j = 0; j < 3; j++)
+                {
+                    uint32_t a = result[i + j];
+                    uint32_t b = result[i + (j + 1) % 3];
+
+                    double errorAB = canCollapse(a, b) ? quadrics[a].evaluate(scaledPositions[b]) : std::numeric_limits<double>::infinity();
+                    double errorBA = canCollapse(b, a) ? quadrics[b].evaluate(scaledPositions[a]) : std::numeric_limits<double>::infinity();
+                    Collapse collapse = errorAB <= errorBA ? Collapse{ a, b, errorAB } : Collapse{ b, a, errorBA };
+                    if (collapse.error <= errorLimit) collapses.push_back(collapse);
+                }
+            }
+            if (collapses.empty()) break;
+
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+            std::iota(collapseRemap.begin(), collapseRemap.end(), 0);
+            std::fill(collapseLocked.begin(), collapseLocked.end(), false);
+
+            const size_t triangleGoal = triangleCount - targetTriangleCount;
+            size_t removedTriangleCount = 0;
+            size_t collapseCount = 0;
+
+            for (const auto& collapse : collapses)
+            {
+                if (collapseLocked[collapse.from] || collapseLocked[collapse.to]) continue;
+                if (hasTriangleFlips(collapse.from, collapse.to)) continue;
+
+                collapseRemap[collapse.from] = collapse.to;
+                collapseLocked[collapse.from] = true;
+                collapseLocked[collapse.to] = true;
+                quadrics[remap[collapse.to]] += quadrics[collapse.from];
+
+                if (kinds[collapse.from] == VertexKind::Border)
+                {
+                    // Reconnect the border around the removed vertex.
+                    uint32_t to = remap[collapse.to];
+                    if (borderNext[collapse.from] == to)
+                    {
+                        uint32_t prev = borderPrev[collapse.from];
+                        borderNext[prev] = to;
+                        borderPrev[to] = prev;
+                    }
+                    else
+                    {
+                        uint32_t next = borderNext[collapse.from];
+                        borderPrev[next] = to;
+                        borderNext[to] = next;
+                    }
+                    removedTriangleCount += 1;
+                }
+                else
+                {
+                    removedTriangleCount += 2;
+                }
+
+                resultError = std::max(resultError, collapse.error);
+                collapseCount++;
+                if (removedTriangleCount >= triangleGoal) break;
+            }
+            if (collapseCount == 0) break;
+
+            // Apply the collapses and remove the degenerate triangles.
+            size_t writeIndex = 0;
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                uint32_t a = collapseRemap[result[i]];
+                uint32_t b = collapseRemap[result[i + 1]];
+                uint32_t c = collapseRemap[result[i + 2]];
+                if (a == b || b == c || a == c) continue;
+                result[writeIndex++] = a;
+                result[writeIndex++] = b;
+                result[writeIndex++] = c;
+            }
+            result.resize(writeIndex);
+        }
+
+        if (pResultError) *pResultError = (float)std::sqrt(resultError);
+        return result;
+    }
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Simplify a triangle list by quadric error edge collapses [Garland and Heckbert 1997].
+
+        Edges are collapsed onto one of their end points, so the simplified mesh references a subset of the
+        input vertices and can share the vertex buffer of the input mesh. Vertices on attribute seams (vertices
+        with identical positions) and non-manifold vertices are never moved, and vertices on open borders only
+        move along the border, which keeps the attribute discontinuities and the outline of the mesh intact.
+
+        The error is the distance of the moved vertices to the planes of the triangles they represent,
+        relative to the largest extent of the mesh bounding box.
+
+        \param[in] indices Triangle list indices.
+        \param[in] positions Vertex positions.
+        \param[in] targetIndexCount Number of indices to reduce the mesh to. The result has more indices if the error limit is reached first.
+        \param[in] targetError Maximum error relative to the mesh extent, for example 0.01 for 1%.
+        \param[out] pResultError If non-null, the error of the simplified mesh relative to the mesh extent is written here.
+        \return Triangle list indices of the simplified mesh.
+    */
+    FALCOR_API std::vector<uint32_t> simplifyMesh(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, size_t targetIndexCount, float targetError, float* pResultError = nullptr);
+}
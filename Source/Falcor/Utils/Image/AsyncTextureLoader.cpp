@@ -27,7 +27,7 @@
  **************************************************************************/
 #include "AsyncTextureLoader.h"
 #include "Core/API/Device.h"
-#include "Utils/Threading.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -37,13 +37,13 @@ namespace Falcor
     }
 
     AsyncTextureLoader::AsyncTextureLoader(size_t threadCount)
+        : mMaxConcurrency(std::max<size_t>(1, threadCount))
     {
-        runWorkers(threadCount);
     }
 
     AsyncTextureLoader::~AsyncTextureLoader()
     {
-        terminateWorkers();
+        mTasks.wait();
 
         gpDevice->flushAndSync();
     }
@@ -52,53 +52,33 @@ namespace Falcor
     {
         std::lock_guard<std::mutex> lock(mMutex);
         mLoadRequestQueue.push(LoadRequest{path, generateMipLevels, loadAsSrgb, bindFlags, callback });
-        mCondition.notify_one();
-        return mLoadRequestQueue.back().promise.get_future();
-    }
-
-    void AsyncTextureLoader::runWorkers(size_t threadCount)
-    {
-        // Create a barrier to synchronize worker threads before issuing a global flush.
-        mFlushBarrier = std::make_shared<Barrier>(threadCount, [&]() {
-            gpDevice->flushAndSync();
-            mFlushPending = false;
-            mUploadCounter = 0;
-            });
+        auto future = mLoadRequestQueue.back().promise.get_future();
 
-        for (size_t i = 0; i < threadCount; ++i)
+        // Start another task unless the maximum number of tasks are already draining the queue.
+        if (mActiveTaskCount < mMaxConcurrency)
         {
-            mThreads.emplace_back(&AsyncTextureLoader::runWorker, this);
+            mActiveTaskCount++;
+            mTasks.run([this]() { processRequests(); });
         }
+
+        return future;
     }
 
-    void AsyncTextureLoader::runWorker()
+    void AsyncTextureLoader::processRequests()
     {
-        // This function is the entry point for worker threads.
-        // The workers wait on the load request queue and load a texture when woken up.
-        // To avoid the upload heap growing too large, we synchronize the threads and
-        // issue a global GPU flush at regular intervals.
+        // This function runs as a task on the thread pool and loads textures until the request queue is empty.
+        // To avoid the upload heap growing too large, we issue a global GPU flush at regular intervals.
+        // Loads hold the flush mutex shared, so the flush waits for the loads in flight and blocks new ones.
 
         while (true)
         {
-            // Wait on condition until more work is ready.
             std::unique_lock<std::mutex> lock(mMutex);
-            mCondition.wait(lock, [&]() { return mTerminate || !mLoadRequestQueue.empty() || mFlushPending; });
-
-            // Sync thread if a flush is pending.
-            if (mFlushPending)
+            if (mLoadRequestQueue.empty())
             {
-                lock.unlock();
-                mFlushBarrier->wait();
-                mCondition.notify_one();
-                continue;
+                mActiveTaskCount--;
+                break;
             }
 
-            // Terminate thread unless there is more work to do.
-            if (mTerminate && mLoadRequestQueue.empty() && !mFlushPending) break;
-
-            // Go back waiting if queue is currently empty.
-            if (mLoadRequestQueue.empty()) continue;
-
             // Pop next load request from queue.
             auto request = std::move(mLoadRequestQueue.front());
             mLoadRequestQueue.pop();
@@ -106,7 +86,11 @@ namespace Falcor
             lock.unlock();
 
             // Load the textures (this part is running in parallel).
-            Texture::SharedPtr pTexture = Texture::createFromFile(request.path, request.generateMipLevels, request.loadAsSRGB, request.bindFlags);
+            Texture::SharedPtr pTexture;
+            {
+                std::shared_lock<std::shared_mutex> flushLock(mFlushMutex);
+                pTexture = Texture::createFromFile(request.path, request.generateMipLevels, request.loadAsSRGB, request.bindFlags);
+            }
             request.promise.set_value(pTexture);
 
             if (request.callback)
@@ -114,30 +98,18 @@ namespace Falcor
                 request.callback(pTexture);
             }
 
-            lock.lock();
-
             // Issue a global flush if necessary.
             // TODO: It would be better to check the size of the upload heap instead.
-            if (!mTerminate && pTexture != nullptr &&
-                ++mUploadCounter >= kUploadsPerFlush)
+            lock.lock();
+            bool flush = pTexture != nullptr && ++mUploadCounter >= kUploadsPerFlush;
+            if (flush) mUploadCounter = 0;
+            lock.unlock();
+
+            if (flush)
             {
-                mFlushPending = true;
-                mCondition.notify_all();
+                std::unique_lock<std::shared_mutex> flushLock(mFlushMutex);
+                gpDevice->flushAndSync();
             }
-
-            mCondition.notify_one();
         }
     }
-
-    void AsyncTextureLoader::terminateWorkers()
-    {
-        {
-            std::lock_guard<std::mutex> lock(mMutex);
-            mTerminate = true;
-        }
-
-        mCondition.notify_all();
-
-        for (auto& thread : mThreads) thread.join();
-    }
 }
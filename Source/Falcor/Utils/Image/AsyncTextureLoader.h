@@ -29,20 +29,18 @@
 #include "Core/Macros.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
-#include <condition_variable>
+#include "Utils/Threading.h"
 #include <filesystem>
 #include <functional>
 #include <future>
 #include <mutex>
 #include <queue>
+#include <shared_mutex>
 #include <thread>
-#include <vector>
 
 namespace Falcor
 {
-    class Barrier;
-
-    /** Utility class to load textures asynchronously using multiple worker threads.
+    /** Utility class to load textures asynchronously on the global thread pool.
     */
     class FALCOR_API AsyncTextureLoader
     {
@@ -50,12 +48,12 @@ namespace Falcor
         using LoadCallback = std::function<void(Texture::SharedPtr pTexture)>;
 
         /** Constructor.
-            \param[in] threadCount Number of worker threads.
+            \param[in] threadCount Maximum number of textures loaded concurrently.
         */
         AsyncTextureLoader(size_t threadCount = std::thread::hardware_concurrency());
 
         /** Destructor.
-            Blocks until all threads have terminated.
+            Blocks until all pending loads have finished.
         */
         ~AsyncTextureLoader();
 
@@ -76,9 +74,7 @@ namespace Falcor
         );
 
     private:
-        void runWorkers(size_t threadCount);
-        void runWorker();
-        void terminateWorkers();
+        void processRequests();
 
         struct LoadRequest
         {
@@ -90,16 +86,15 @@ namespace Falcor
             std::promise<Texture::SharedPtr> promise;
         };
 
-        std::mutex mMutex;                          ///< Mutex for synchronizing access to shared resources.
-        std::condition_variable mCondition;         ///< Condition variable for workers to wait on.
-        std::shared_ptr<Barrier> mFlushBarrier;     ///< Barrier for flushing the GPU to upload textures.
-        std::vector<std::thread> mThreads;          ///< Worker threads.
+        size_t mMaxConcurrency;                     ///< Maximum number of tasks processing requests at the same time.
+        Threading::TaskGroup mTasks;                ///< Tasks processing the request queue.
+        std::shared_mutex mFlushMutex;              ///< Held shared while loading, exclusively while flushing the GPU to upload textures.
+
+        std::mutex mMutex;                          ///< Mutex for synchronizing access to the internal state.
 
         // Internal state. Do not access outside of critical section.
         std::queue<LoadRequest> mLoadRequestQueue;  ///< Texture loading request queue.
-
-        bool mTerminate = false;                    ///< Flag to terminate worker threads.
-        bool mFlushPending = false;                 ///< Flag to indicate a GPU flush is pending.
+        size_t mActiveTaskCount = 0;                ///< Number of tasks processing requests.
         uint32_t mUploadCounter = 0;                ///< Counter to issue a flush every few uploads.
     };
 }
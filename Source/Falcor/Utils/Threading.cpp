@@ -27,68 +27,335 @@
  **************************************************************************/
 #include "Threading.h"
 #include "Core/Assert.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
 
 namespace Falcor
 {
+    struct Threading::TaskState
+    {
+        std::function<void(void)> func;
+        std::atomic<bool> done = false;
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
     namespace
     {
+        using TaskPtr = std::shared_ptr<Threading::TaskState>;
+
+        constexpr uint32_t kNoWorker = ~0u;
+        constexpr auto kHelpWaitTime = std::chrono::microseconds(100); ///< Time a waiting worker sleeps when no task could be found to help with.
+
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<TaskPtr> tasks;
+        };
+
         struct ThreadingData
         {
-            bool initialized = false;
+            std::atomic<bool> initialized = false;
+            std::mutex startMutex;
             std::vector<std::thread> threads;
-            uint32_t current;
+            std::vector<std::unique_ptr<WorkQueue>> workerQueues;   ///< Per-worker task deques.
+            WorkQueue sharedQueue;                                  ///< Tasks dispatched from threads outside the pool.
+
+            std::atomic<int64_t> queuedCount = 0;                   ///< Number of tasks waiting in a queue.
+            std::atomic<int64_t> pendingCount = 0;                  ///< Number of dispatched tasks that have not finished.
+
+            std::mutex sleepMutex;
+            std::condition_variable sleepCondition;
+            bool terminate = false;
+
+            std::mutex finishMutex;
+            std::condition_variable finishCondition;
+
+            ~ThreadingData()
+            {
+                // Join workers of a pool that was started lazily and never shut down.
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    terminate = true;
+                }
+                sleepCondition.notify_all();
+                for (auto& t : threads) t.join();
+            }
         } gData;
+
+        thread_local uint32_t tWorkerIndex = kNoWorker;
+
+        TaskPtr popFront(WorkQueue& queue)
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) return nullptr;
+            TaskPtr pTask = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            gData.queuedCount--;
+            return pTask;
+        }
+
+        TaskPtr popBack(WorkQueue& queue)
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) return nullptr;
+            TaskPtr pTask = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            gData.queuedCount--;
+            return pTask;
+        }
+
+        /** Find a task for a worker: the newest task of its own deque, then the oldest shared task,
+            then the oldest task of another worker.
+        */
+        TaskPtr findTask(uint32_t workerIndex)
+        {
+            FALCOR_ASSERT(workerIndex < gData.workerQueues.size());
+            if (gData.queuedCount.load() <= 0) return nullptr;
+
+            if (auto pTask = popBack(*gData.workerQueues[workerIndex])) return pTask;
+            if (auto pTask = popFront(gData.sharedQueue)) return pTask;
+
+            const size_t workerCount = gData.workerQueues.size();
+            for (size_t i = 1; i < workerCount; ++i)
+            {
+                if (auto pTask = popFront(*gData.workerQueues[(workerIndex + i) % workerCount])) return pTask;
+            }
+            return nullptr;
+        }
+
+        void runTask(const TaskPtr& pTask)
+        {
+            try
+            {
+                pTask->func();
+            }
+            catch (...)
+            {
+                pTask->exception = std::current_exception();
+            }
+            pTask->func = nullptr;
+
+            {
+                std::lock_guard<std::mutex> lock(pTask->mutex);
+                pTask->done = true;
+            }
+            pTask->condition.notify_all();
+
+            if (--gData.pendingCount == 0)
+            {
+                std::lock_guard<std::mutex> lock(gData.finishMutex);
+                gData.finishCondition.notify_all();
+            }
+        }
+
+        void runWorker(uint32_t workerIndex)
+        {
+            tWorkerIndex = workerIndex;
+
+            while (true)
+            {
+                if (auto pTask = findTask(workerIndex))
+                {
+                    runTask(pTask);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(gData.sleepMutex);
+                gData.sleepCondition.wait(lock, [] { return gData.terminate || gData.queuedCount.load() > 0; });
+                if (gData.terminate && gData.queuedCount.load() <= 0) break;
+            }
+
+            tWorkerIndex = kNoWorker;
+        }
+
+        void ensureStarted()
+        {
+            if (!gData.initialized.load()) Threading::start();
+        }
     }
 
     void Threading::start(uint32_t threadCount)
     {
+        std::lock_guard<std::mutex> lock(gData.startMutex);
         if (gData.initialized) return;
 
-        gData.threads.resize(threadCount);
+        if (threadCount == 0) threadCount = getLogicalThreadCount();
+
+        gData.terminate = false;
+        gData.workerQueues.resize(threadCount);
+        for (auto& pQueue : gData.workerQueues) pQueue = std::make_unique<WorkQueue>();
+        for (uint32_t i = 0; i < threadCount; ++i) gData.threads.emplace_back(runWorker, i);
+
         gData.initialized = true;
     }
 
     void Threading::shutdown()
     {
-        for (auto& t : gData.threads)
+        std::lock_guard<std::mutex> lock(gData.startMutex);
+        if (!gData.initialized) return;
+
+        finish();
+
         {
-            if (t.joinable()) t.join();
+            std::lock_guard<std::mutex> sleepLock(gData.sleepMutex);
+            gData.terminate = true;
         }
+        gData.sleepCondition.notify_all();
 
+        for (auto& t : gData.threads) t.join();
+
+        gData.threads.clear();
+        gData.workerQueues.clear();
         gData.initialized = false;
     }
 
+    void Threading::finish()
+    {
+        FALCOR_ASSERT(!isWorkerThread());
+
+        std::unique_lock<std::mutex> lock(gData.finishMutex);
+        gData.finishCondition.wait(lock, [] { return gData.pendingCount.load() == 0; });
+    }
+
+    uint32_t Threading::getWorkerCount()
+    {
+        return gData.initialized ? (uint32_t)gData.threads.size() : 0;
+    }
+
+    bool Threading::isWorkerThread()
+    {
+        return tWorkerIndex != kNoWorker;
+    }
+
     Threading::Task Threading::dispatchTask(const std::function<void(void)>& func)
     {
-        FALCOR_ASSERT(gData.initialized);
+        ensureStarted();
 
-        std::thread& t = gData.threads[gData.current];
-        if (t.joinable()) t.join();
-        t = std::thread(func);
-        gData.current = (gData.current + 1) % gData.threads.size();
+        auto pTask = std::make_shared<TaskState>();
+        pTask->func = func;
+        gData.pendingCount++;
 
-        return Task();
+        // Tasks spawned from a worker go to its own deque, other tasks to the shared queue.
+        WorkQueue& queue = isWorkerThread() ? *gData.workerQueues[tWorkerIndex] : gData.sharedQueue;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(pTask);
+        }
+        gData.queuedCount++;
+
+        {
+            std::lock_guard<std::mutex> lock(gData.sleepMutex);
+        }
+        gData.sleepCondition.notify_one();
+
+        return Task(pTask);
     }
 
-    void Threading::finish()
+    void Threading::parallelFor(size_t begin, size_t end, const std::function<void(size_t)>& func, size_t grainSize)
     {
-        for (auto& t : gData.threads)
+        if (begin >= end) return;
+        ensureStarted();
+
+        const size_t count = end - begin;
+        if (grainSize == 0) grainSize = std::max<size_t>(1, count / (4 * (size_t)getWorkerCount()));
+        const size_t chunkCount = (count + grainSize - 1) / grainSize;
+
+        if (chunkCount == 1)
         {
-            if (t.joinable()) t.join();
+            for (size_t i = begin; i < end; ++i) func(i);
+            return;
         }
+
+        TaskGroup group;
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            group.run([&, chunk]()
+            {
+                const size_t chunkBegin = begin + chunk * grainSize;
+                const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+                for (size_t i = chunkBegin; i < chunkEnd; ++i) func(i);
+            });
+        }
+        group.wait();
+    }
+
+    bool Threading::Task::isRunning() const
+    {
+        return mpState && !mpState->done.load();
+    }
+
+    void Threading::Task::finish() const
+    {
+        if (!mpState) return;
+
+        if (isWorkerThread())
+        {
+            // Execute other tasks while waiting so that nested tasks cannot starve the pool.
+            while (!mpState->done.load())
+            {
+                if (auto pTask = findTask(tWorkerIndex))
+                {
+                    runTask(pTask);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(mpState->mutex);
+                mpState->condition.wait_for(lock, kHelpWaitTime, [this] { return mpState->done.load(); });
+            }
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(mpState->mutex);
+            mpState->condition.wait(lock, [this] { return mpState->done.load(); });
+        }
+
+        if (mpState->exception) std::rethrow_exception(mpState->exception);
     }
 
-    Threading::Task::Task()
+    Threading::TaskGroup::~TaskGroup()
     {
+        try
+        {
+            wait();
+        }
+        catch (...)
+        {
+        }
     }
 
-    bool Threading::Task::isRunning()
+    void Threading::TaskGroup::run(const std::function<void(void)>& func)
     {
-        FALCOR_UNIMPLEMENTED();
+        Task task = dispatchTask(func);
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTasks.push_back(std::move(task));
     }
 
-    void Threading::Task::finish()
+    void Threading::TaskGroup::wait()
     {
-        FALCOR_UNIMPLEMENTED();
+        std::exception_ptr exception;
+        while (true)
+        {
+            std::vector<Task> tasks;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                tasks.swap(mTasks);
+            }
+            if (tasks.empty()) break;
+
+            for (const auto& task : tasks)
+            {
+                try
+                {
+                    task.finish();
+                }
+                catch (...)
+                {
+                    if (!exception) exception = std::current_exception();
+                }
+            }
+        }
+        if (exception) std::rethrow_exception(exception);
     }
 }
@@ -27,60 +27,172 @@
  **************************************************************************/
 #pragma once
 #include "Core/Macros.h"
+#include <algorithm>
 #include <condition_variable>
+#include <exception>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <cstdint>
 
 namespace Falcor
 {
+    /** Global work-stealing thread pool.
+
+        The pool runs a fixed set of persistent worker threads. Each worker owns a task deque: tasks spawned
+        from a worker are pushed to its own deque and popped in LIFO order, idle workers steal the oldest tasks
+        from other workers. Tasks dispatched from threads outside the pool go to a shared queue.
+
+        Waiting on a task from a worker thread executes other pending tasks until the task has finished,
+        so tasks can spawn and wait on nested tasks without deadlocking the pool.
+        Waiting from a thread outside the pool blocks.
+
+        The pool is started lazily with the default worker count on the first dispatch if start() was not called.
+    */
     class FALCOR_API Threading
     {
     public:
-        const static uint32_t kDefaultThreadCount = 16;
+        /** Default number of worker threads. Zero uses one worker per logical core.
+        */
+        const static uint32_t kDefaultThreadCount = 0;
 
-        /** Handle to a dispatched task
+        struct TaskState;
 
-            TODO: Implementation
+        /** Handle to a dispatched task.
+            Exceptions thrown by the task are captured and rethrown by finish().
         */
-        class Task
+        class FALCOR_API Task
         {
         public:
-            /** Check if task is still executing
+            Task() = default;
+
+            /** Check if the handle refers to a dispatched task.
             */
-            bool isRunning();
+            bool isValid() const { return mpState != nullptr; }
+
+            /** Check if task is still executing (or waiting to be executed).
+            */
+            bool isRunning() const;
+
+            /** Wait for task to finish executing.
+                Rethrows the exception thrown by the task, if any.
+            */
+            void finish() const;
+
+        private:
+            Task(std::shared_ptr<TaskState> pState) : mpState(std::move(pState)) {}
+
+            std::shared_ptr<TaskState> mpState;
+            friend class Threading;
+        };
 
-            /** Wait for task to finish executing
+        /** Handle to a dispatched task returning a value.
+        */
+        template<typename T>
+        class Future : public Task
+        {
+        public:
+            Future() = default;
+
+            /** Wait for the task to finish and return its result.
+                Rethrows the exception thrown by the task, if any.
             */
-            void finish();
+            T& get() const { finish(); return **mpResult; }
 
         private:
-            Task();
+            Future(Task task, std::shared_ptr<std::optional<T>> pResult) : Task(std::move(task)), mpResult(std::move(pResult)) {}
+
+            std::shared_ptr<std::optional<T>> mpResult;
             friend class Threading;
         };
 
-        /** Initializes the global thread pool
-            \param[in] threadCount Number of threads in the pool
+        /** Group of tasks that are waited on together.
+            Tasks can be added to the group from any thread, including from tasks running in the group.
+        */
+        class FALCOR_API TaskGroup
+        {
+        public:
+            TaskGroup() = default;
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+
+            /** Destructor. Waits for all tasks in the group, exceptions are discarded.
+            */
+            ~TaskGroup();
+
+            /** Dispatch a task in the group.
+            */
+            void run(const std::function<void(void)>& func);
+
+            /** Wait for all tasks in the group, including tasks added while waiting.
+                Rethrows the first exception thrown by a task, after all tasks have finished.
+            */
+            void wait();
+
+        private:
+            std::mutex mMutex;
+            std::vector<Task> mTasks;
+        };
+
+        /** Initializes the global thread pool.
+            Does nothing if the pool is already running.
+            \param[in] threadCount Number of worker threads in the pool. Zero uses getLogicalThreadCount().
         */
         static void start(uint32_t threadCount = kDefaultThreadCount);
 
-        /** Waits for all currently executing threads to finish
+        /** Waits for all dispatched tasks to finish.
+            Must not be called from a worker thread.
         */
         static void finish();
 
-        /** Waits for all currently executing threads to finish and shuts down the thread pool
+        /** Waits for all dispatched tasks to finish and shuts down the thread pool.
         */
         static void shutdown();
 
         /** Returns the maximum number of concurrent threads supported by the hardware
         */
-        static uint32_t getLogicalThreadCount() { return std::thread::hardware_concurrency(); }
+        static uint32_t getLogicalThreadCount() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+        /** Returns the number of worker threads in the pool, or zero if the pool is not running.
+        */
+        static uint32_t getWorkerCount();
+
+        /** Returns true if the calling thread is a worker thread of the pool.
+        */
+        static bool isWorkerThread();
 
         /** Starts a task on an available thread.
             \return Handle to the task
         */
         static Task dispatchTask(const std::function<void(void)>& func);
+
+        /** Starts a task returning a value on an available thread.
+            The callable must be copyable.
+            \return Handle to the task result.
+        */
+        template<typename Func, typename R = std::invoke_result_t<std::decay_t<Func>&>>
+        static Future<R> dispatch(Func&& func)
+        {
+            static_assert(!std::is_void_v<R>, "Use dispatchTask() for tasks without a result");
+            auto pResult = std::make_shared<std::optional<R>>();
+            Task task = dispatchTask([pResult, func = std::forward<Func>(func)]() mutable { pResult->emplace(func()); });
+            return Future<R>(std::move(task), std::move(pResult));
+        }
+
+        /** Calls func(i) for all i in [begin, end) on the thread pool and waits for completion.
+            The range is split into chunks of grainSize indices. Order of execution is unspecified.
+            Rethrows the first exception thrown by func.
+            \param[in] begin First index.
+            \param[in] end One past the last index.
+            \param[in] func Function to call for each index.
+            \param[in] grainSize Number of indices per task, or zero to split the range evenly over the workers.
+        */
+        static void parallelFor(size_t begin, size_t end, const std::function<void(size_t)>& func, size_t grainSize = 0);
     };
 
     /** Simple thread barrier class.
@@ -0,0 +1,52 @@
+# Headless comparison of the BDPT light vertex sort backends.
+# Run with: Mogwai --headless --script Data/BDPT-SortBenchmark.py
+# The scene can be overridden with the BDPT_BENCHMARK_SCENE environment variable.
+import os
+from falcor import *
+
+kScene = os.environ.get('BDPT_BENCHMARK_SCENE', 'Arcade/Arcade.pyscene')
+kWarmupFrames = 16
+kBenchmarkFrames = 256
+kSortEvent = 'sortLightVertices/gpuTime'
+
+def render_graph_BDPT_sort(sort):
+    g = RenderGraph('BDPT')
+    loadRenderPassLibrary('BDPT.dll')
+    loadRenderPassLibrary('GBuffer.dll')
+    BDPT = createPass('BDPT', {'samplesPerPixel': 1, 'maxSurfaceBounces': 10, 'maxDiffuseBounces': 3, 'maxSpecularBounces': 3, 'maxTransmissionBounces': 10, 'lightVertexSort': sort})
+    g.addPass(BDPT, 'BDPT')
+    VBufferRT = createPass('VBufferRT', {'outputSize': IOSize.Default, 'samplePattern': SamplePattern.Center, 'sampleCount': 16, 'useAlphaTest': True})
+    g.addPass(VBufferRT, 'VBufferRT')
+    g.addEdge('VBufferRT.vbuffer', 'BDPT.vbuffer')
+    g.addEdge('VBufferRT.mvec', 'BDPT.mvec')
+    g.addEdge('VBufferRT.viewW', 'BDPT.viewW')
+    g.markOutput('BDPT.color')
+    return g
+
+def benchmark(sort):
+    m.removeGraph('BDPT')
+    m.addGraph(render_graph_BDPT_sort(sort))
+    m.clock.pause()
+    for _ in range(kWarmupFrames): m.renderFrame()
+
+    m.profiler.startCapture(kBenchmarkFrames)
+    for _ in range(kBenchmarkFrames): m.renderFrame()
+    capture = m.profiler.endCapture()
+
+    times = [t for name, lane in capture['events'].items() if name.endswith(kSortEvent) for t in lane['records']]
+    return sum(times) / len(times) if times else float('nan')
+
+m.profiler.enabled = True
+m.loadScene(kScene)
+
+results = {}
+for sort in [LightVertexSort.Bitonic, LightVertexSort.Radix]:
+    results[sort] = benchmark(sort)
+
+print('Light vertex sort ({}, {} frames):'.format(kScene, kBenchmarkFrames))
+for sort, ms in results.items():
+    print('  {:<8} {:8.3f} ms'.format(str(sort).split('.')[-1], ms))
+if results[LightVertexSort.Radix] > 0:
+    print('  speedup  {:8.2f}x'.format(results[LightVertexSort.Bitonic] / results[LightVertexSort.Radix]))
+
+exit()
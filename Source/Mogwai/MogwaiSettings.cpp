@@ -234,6 +234,20 @@ namespace Mogwai
             g.text(oss.str());
 
             if (g.button("Reset")) Program::resetGlobalCompilationStats();
+
+            g.text("Program kernel cache:\n");
+
+            const auto& kc = ProgramKernelCache::getStats();
+            std::ostringstream kcss;
+            kcss << "Hits: " << kc.hitCount << std::endl
+                 << "Misses: " << kc.missCount << std::endl
+                 << "Writes: " << kc.writeCount << std::endl
+                 << "Bytes read: " << formatByteSize(kc.bytesRead) << std::endl
+                 << "Bytes written: " << formatByteSize(kc.bytesWritten) << std::endl;
+            g.text(kcss.str());
+
+            if (g.button("Reset##KernelCache")) ProgramKernelCache::resetStats();
+            if (g.button("Clear cache", true)) ProgramKernelCache::clear();
         }
 
         // Scene UI
@@ -42,6 +42,8 @@ static void regAccumulatePass(pybind11::module& m)
     pybind11::class_<AccumulatePass, RenderPass, AccumulatePass::SharedPtr> pass(m, "AccumulatePass");
     pass.def_property("enabled", &AccumulatePass::isEnabled, &AccumulatePass::setEnabled);
     pass.def("reset", &AccumulatePass::reset);
+    pass.def("saveCheckpoint", [](AccumulatePass* pPass, const std::string& path) { pPass->saveCheckpoint(path); }, pybind11::arg("path"));
+    pass.def("loadCheckpoint", [](AccumulatePass* pPass, const std::string& path) { pPass->loadCheckpoint(path); }, pybind11::arg("path"));
 
     pybind11::enum_<AccumulatePass::Precision> precision(m, "AccumulatePrecision");
     precision.value("Double", AccumulatePass::Precision::Double);
@@ -72,6 +74,9 @@ namespace
     const char kSubFrameCount[] = "subFrameCount";
     const char kMaxAccumulatedFrames[] = "maxAccumulatedFrames";
 
+    // Version of the checkpoint layout. Increment when the set or meaning of the checkpoint entries changes.
+    const uint32_t kCheckpointVersion = 1;
+
     const Gui::DropdownList kModeSelectorList =
     {
         { (uint32_t)AccumulatePass::Precision::Double, "Double precision" },
@@ -257,6 +262,7 @@ void AccumulatePass::accumulate(RenderContext* pRenderContext, const Texture::Sh
 
     // Setup accumulation.
     prepareAccumulation(pRenderContext, mFrameDim.x, mFrameDim.y);
+    if (mpPendingCheckpoint) restoreCheckpoint(pRenderContext);
 
     // Set shader parameters.
     mpVars["PerFrameCB"]["gResolution"] = mFrameDim;
@@ -356,6 +362,61 @@ void AccumulatePass::reset()
     mFrameCount = 0;
 }
 
+void AccumulatePass::saveCheckpoint(const std::filesystem::path& path)
+{
+    if (mFrameCount == 0) throw RuntimeError("AccumulatePass: Cannot save a checkpoint before any frames are accumulated.");
+
+    RenderContext* pRenderContext = gpDevice->getRenderContext();
+    Checkpoint checkpoint(kInfo.type, kCheckpointVersion);
+    checkpoint.setValue("frameCount", mFrameCount);
+    checkpoint.setValue("frameDim", mFrameDim);
+    checkpoint.setValue("precisionMode", mPrecisionMode);
+    for (const auto& [name, pTexture] : getCheckpointTextures())
+    {
+        if (pTexture) checkpoint.captureTexture(name, pRenderContext, pTexture.get());
+    }
+    checkpoint.write(path);
+}
+
+void AccumulatePass::loadCheckpoint(const std::filesystem::path& path)
+{
+    auto pCheckpoint = std::make_unique<Checkpoint>(Checkpoint::read(path, kInfo.type, kCheckpointVersion));
+
+    // The precision mode determines which buffers are allocated, so it is applied before the buffers are prepared.
+    mPrecisionMode = pCheckpoint->getValue<Precision>("precisionMode");
+    mpPendingCheckpoint = std::move(pCheckpoint);
+}
+
+std::vector<std::pair<std::string, Texture::SharedPtr>> AccumulatePass::getCheckpointTextures() const
+{
+    return
+    {
+        { "lastFrameSum", mpLastFrameSum },
+        { "lastFrameCorr", mpLastFrameCorr },
+        { "lastFrameSumLo", mpLastFrameSumLo },
+        { "lastFrameSumHi", mpLastFrameSumHi },
+    };
+}
+
+void AccumulatePass::restoreCheckpoint(RenderContext* pRenderContext)
+{
+    FALCOR_ASSERT(mpPendingCheckpoint);
+    std::unique_ptr<Checkpoint> pCheckpoint = std::move(mpPendingCheckpoint);
+
+    const uint2 frameDim = pCheckpoint->getValue<uint2>("frameDim");
+    if (frameDim != mFrameDim || pCheckpoint->getValue<Precision>("precisionMode") != mPrecisionMode)
+    {
+        logError("AccumulatePass: Checkpoint doesn't match the current resolution or precision mode. Ignoring the checkpoint.");
+        return;
+    }
+
+    for (const auto& [name, pTexture] : getCheckpointTextures())
+    {
+        if (pTexture) pCheckpoint->restoreTexture(name, pRenderContext, pTexture.get());
+    }
+    mFrameCount = pCheckpoint->getValue<uint32_t>("frameCount");
+}
+
 void AccumulatePass::prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height)
 {
     // Allocate/resize/clear buffers for intermedate data. These are different depending on accumulation mode.
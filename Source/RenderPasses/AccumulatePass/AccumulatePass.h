@@ -28,6 +28,7 @@
 #pragma once
 #include "Falcor.h"
 #include "RenderGraph/RenderPassHelpers.h"
+#include "Rendering/Utils/Checkpoint.h"
 
 using namespace Falcor;
 
@@ -66,6 +67,17 @@ public:
     // Scripting functions
     void reset();
 
+    /** Write the accumulated frames to a checkpoint file. This waits for the GPU.
+        \param[in] path File path.
+    */
+    void saveCheckpoint(const std::filesystem::path& path);
+
+    /** Read a checkpoint file written by saveCheckpoint(). The accumulation resumes from it in the next frame.
+        Throws if the file is not an accumulation checkpoint of the current version.
+        \param[in] path File path.
+    */
+    void loadCheckpoint(const std::filesystem::path& path);
+
     enum class Precision : uint32_t
     {
         Double,                 ///< Standard summation in double precision.
@@ -77,6 +89,8 @@ protected:
     AccumulatePass(const Dictionary& dict);
     void prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height);
     void accumulate(RenderContext* pRenderContext, const Texture::SharedPtr& pSrc, const Texture::SharedPtr& pDst);
+    std::vector<std::pair<std::string, Texture::SharedPtr>> getCheckpointTextures() const;
+    void restoreCheckpoint(RenderContext* pRenderContext);
 
     // Internal state
     Scene::SharedPtr            mpScene;                        ///< The current scene (or nullptr if no scene).
@@ -91,6 +105,7 @@ protected:
     Texture::SharedPtr          mpLastFrameCorr;                ///< Last frame running compensation term. Used in SingleKahan mode.
     Texture::SharedPtr          mpLastFrameSumLo;               ///< Last frame running sum (lo bits). Used in Double mode.
     Texture::SharedPtr          mpLastFrameSumHi;               ///< Last frame running sum (hi bits). Used in Double mode.
+    std::unique_ptr<Checkpoint> mpPendingCheckpoint;            ///< Checkpoint to restore in the next accumulated frame.
 
     // UI variables
     bool                        mEnabled = true;                ///< True if accumulation is enabled.
@@ -0,0 +1,61 @@
+#include "AdaptiveSampler.h"
+
+namespace
+{
+    const std::string kAdaptiveSamplerFilename = "RenderPasses/BDPT/AdaptiveSampler.cs.slang";
+}
+
+AdaptiveSampler::AdaptiveSampler(uint2 _frameDim) : frameDim(_frameDim) {
+    FALCOR_ASSERT(frameDim.x > 0 && frameDim.y > 0);
+
+    UpdateMomentsCS = ComputePass::create(kAdaptiveSamplerFilename, "updateMoments");
+    AllocateCS = ComputePass::create(kAdaptiveSamplerFilename, "allocate");
+    ErrorReduction = ComputeParallelReduction::create();
+
+    SampleCount = Texture::create2D(frameDim.x, frameDim.y, ResourceFormat::R8Uint, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+    PixelMoments = Texture::create2D(frameDim.x, frameDim.y, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+    PixelError = Texture::create2D(frameDim.x, frameDim.y, ResourceFormat::R32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+    ErrorSum = Buffer::create(sizeof(float4), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None);
+
+    UpdateMomentsCS["sampleCount"] = SampleCount;
+    UpdateMomentsCS["pixelMoments"] = PixelMoments;
+    UpdateMomentsCS["pixelError"] = PixelError;
+    AllocateCS["pixelError"] = PixelError;
+    AllocateCS["errorSum"] = ErrorSum;
+    AllocateCS["nextSampleCount"] = SampleCount;
+    for (auto pPass : { UpdateMomentsCS, AllocateCS }) pPass["CSConstants"]["frameDim"] = frameDim;
+}
+
+void AdaptiveSampler::reset(RenderContext* pRenderContext, const Options& options) {
+    pRenderContext->clearUAV(PixelMoments->getUAV().get(), float4(0.f));
+    frameCount = 0;
+    allocate(pRenderContext, options, true);
+}
+
+void AdaptiveSampler::update(RenderContext* pRenderContext, const Texture::SharedPtr& pFrameColor, const Options& options) {
+    FALCOR_PROFILE("adaptiveSampling");
+    FALCOR_ASSERT(pFrameColor && pFrameColor->getWidth() == frameDim.x && pFrameColor->getHeight() == frameDim.y);
+
+    UpdateMomentsCS["frameColor"] = pFrameColor;
+    UpdateMomentsCS["CSConstants"]["epsilon"] = options.epsilon;
+    UpdateMomentsCS->execute(pRenderContext, frameDim.x, frameDim.y);
+    pRenderContext->uavBarrier(PixelMoments.get());
+    pRenderContext->uavBarrier(PixelError.get());
+    frameCount++;
+
+    // The moments need a few frames before the errors are meaningful.
+    const bool uniformSamples = frameCount < std::max(options.warmupFrames, 2u);
+    if (!uniformSamples) ErrorReduction->execute<float4>(pRenderContext, PixelError, ComputeParallelReduction::Type::Sum, nullptr, ErrorSum, 0);
+    allocate(pRenderContext, options, uniformSamples);
+}
+
+void AdaptiveSampler::allocate(RenderContext* pRenderContext, const Options& options, bool uniformSamples) {
+    auto var = AllocateCS["CSConstants"];
+    var["frameCount"] = frameCount;
+    var["uniformSamples"] = uniformSamples;
+    var["samplesPerPixel"] = options.samplesPerPixel;
+    var["minSamples"] = 1u;
+    var["maxSamples"] = options.maxSamplesPerPixel;
+    AllocateCS->execute(pRenderContext, frameDim.x, frameDim.y);
+    pRenderContext->uavBarrier(SampleCount.get());
+}
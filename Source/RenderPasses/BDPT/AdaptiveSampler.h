@@ -0,0 +1,54 @@
+#pragma once
+#include "Falcor.h"
+#include "Utils/Algorithm/ComputeParallelReduction.h"
+
+using namespace Falcor;
+
+/** Per-pixel sample counts for adaptive sampling, driven by the variance of the accumulated frames.
+    Each frame the luminance of the frame color is added to per-pixel moments, and the samples of the
+    next frame are distributed proportional to the relative variance of the accumulated estimate.
+    The sum of the pixel errors is reduced on the GPU, so the map is built without a readback.
+    See Rendering/Utils/AdaptiveSampling.slang for the allocation and its CPU reference.
+*/
+struct AdaptiveSampler
+{
+    struct Options
+    {
+        float samplesPerPixel = 2.f;    ///< Average sample count over all pixels.
+        uint maxSamplesPerPixel = 8;    ///< Largest sample count of a pixel, up to kMaxSamplesPerPixel.
+        uint warmupFrames = 4;          ///< Frames with uniform sample counts after a reset, at least 2.
+        float epsilon = 1e-3f;          ///< Added to the squared mean luminance in the relative variance.
+    };
+
+    AdaptiveSampler(uint2 _frameDim);
+
+    /** Discard the accumulated moments and set all pixels to the average sample count.
+    */
+    void reset(RenderContext* pRenderContext, const Options& options);
+
+    /** Add a frame to the moments and compute the sample counts of the next frame.
+        \param[in] pFrameColor Frame color, averaged over the samples of each pixel.
+    */
+    void update(RenderContext* pRenderContext, const Texture::SharedPtr& pFrameColor, const Options& options);
+
+    /** Get the sample count texture (R8Uint) for the next frame.
+    */
+    Texture::SharedPtr getSampleCount() { return SampleCount; }
+    uint2 getFrameDim() const { return frameDim; }
+    uint getFrameCount() const { return frameCount; }
+
+private:
+    void allocate(RenderContext* pRenderContext, const Options& options, bool uniformSamples);
+
+    Texture::SharedPtr SampleCount;
+    Texture::SharedPtr PixelMoments;
+    Texture::SharedPtr PixelError;
+    Buffer::SharedPtr ErrorSum;
+
+    uint2 frameDim;
+    uint frameCount = 0;
+
+    ComputePass::SharedPtr UpdateMomentsCS;
+    ComputePass::SharedPtr AllocateCS;
+    ComputeParallelReduction::SharedPtr ErrorReduction;
+};
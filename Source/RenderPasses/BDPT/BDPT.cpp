@@ -34,7 +34,6 @@
 //#include "PathData.slang"
 
 static const uint zero = 0;
-static const bool fastBuild = true;
 static const uint4 zero4 = uint4(0, 0, 0, 0);
 const RenderPass::Info BDPT::kInfo { "BDPT", "Insert pass description here." };
 
@@ -53,6 +52,41 @@ namespace
 
     const std::string kShaderModel = "6_5";
 
+    // Number of frames the light vertex count shown in the UI lags behind.
+    const uint32_t kLightVertexCountReadbackLatency = 3;
+
+    // Profiler events of the BDPT stages, in execution order. See StageTimings.
+    const std::vector<std::string> kStageNames =
+    {
+        "generatePaths",
+        "traceLightPath",
+        "gatherLightVertexCache",
+        "sortLightVertices",
+        "buildLightVertexTree",
+        "buildLightVertexHashGrid",
+        "traceCameraPaths",
+        "buildPhotonAS",
+        "adaptiveSampling",
+        "buildSubspaceWeightMatrix",
+    };
+
+    // Stages whose cost scales with the number of light paths. The frame-time governor treats the other stages as fixed cost.
+    const std::vector<std::string> kLightPathStageNames =
+    {
+        "traceLightPath",
+        "gatherLightVertexCache",
+        "sortLightVertices",
+        "buildLightVertexTree",
+        "buildLightVertexHashGrid",
+    };
+
+    // Maximum number of camera vertices per camera pass dispatch.
+    // This is the capacity of the sample pair textures (2048 wide) at the maximum texture height.
+    const uint64_t kMaxCameraVertexCount = 2048 * 16384;
+
+    // Maximum number of light path slices of the light vertex cache, i.e. the smallest fraction of light paths retraced per frame is 1/16.
+    const uint32_t kMaxLightPathSlices = 16;
+
     // Render pass inputs and outputs.
     const std::string kInputVBuffer = "vbuffer";
     const std::string kInputMotionVectors = "mvec";
@@ -157,6 +191,25 @@ namespace
         { (uint32_t)TexLODMode::RayDiffs, "Ray Diffs" }
     };
 
+    const Gui::DropdownList kLightVertexSortList =
+    {
+        { (uint32_t)KeyIndexSortType::Bitonic, "Bitonic" },
+        { (uint32_t)KeyIndexSortType::Radix, "Radix" },
+    };
+
+    const Gui::DropdownList kPhotonASBuildPreferenceList =
+    {
+        { (uint32_t)PhotonAccelerationStructure::BuildPreference::FastTrace, "Fast trace" },
+        { (uint32_t)PhotonAccelerationStructure::BuildPreference::FastBuild, "Fast build" },
+        { (uint32_t)PhotonAccelerationStructure::BuildPreference::MinimizeMemory, "Minimize memory" },
+    };
+
+    const Gui::DropdownList kVertexMergeStructureList =
+    {
+        { (uint32_t)VertexMergeStructure::Tree, "Tree" },
+        { (uint32_t)VertexMergeStructure::HashGrid, "Hash grid" },
+    };
+
     // Scripting options.
     const std::string kSamplesPerPixel = "samplesPerPixel";
     const std::string kMaxSurfaceBounces = "maxSurfaceBounces";
@@ -190,6 +243,35 @@ namespace
     const std::string kFixedOutputSize = "fixedOutputSize";
     const std::string kColorFormat = "colorFormat";
 
+    // BDPT parameters.
+    const std::string kLightVertexSort = "lightVertexSort";
+    const std::string kUsePackedVertexInfo = "usePackedVertexInfo";
+    const std::string kUsePackedSampleData = "usePackedSampleData";
+    const std::string kVertexMergeStructure = "vertexMergeStructure";
+    const std::string kCameraTileSize = "cameraTileSize";
+    const std::string kLogSubspaceSize = "logSubspaceSize";
+    const std::string kLightPathCacheFraction = "lightPathCacheFraction";
+    const std::string kLightPathBudget = "lightPathBudget";
+    const std::string kUseFrameTimeGovernor = "useFrameTimeGovernor";
+    const std::string kTargetFrameTime = "targetFrameTime";
+    const std::string kAdaptiveSampling = "adaptiveSampling";
+    const std::string kAdaptiveSamplesPerPixel = "adaptiveSamplesPerPixel";
+    const std::string kAdaptiveMaxSamplesPerPixel = "adaptiveMaxSamplesPerPixel";
+    const std::string kAdaptiveWarmupFrames = "adaptiveWarmupFrames";
+    const std::string kPhotonASBuildPreference = "photonASBuildPreference";
+    const std::string kPhotonASAllowRefit = "photonASAllowRefit";
+    const std::string kPhotonASRebuildInterval = "photonASRebuildInterval";
+    const std::string kPhotonASUseCompaction = "photonASUseCompaction";
+    const std::string kUseVertexMerge = "useVertexMerge";
+    const std::string kUseSubspace = "useSubspace";
+    const std::string kUseReservoir = "useReservoir";
+    const std::string kUseSpatialReuse = "useSpatialReuse";
+
+    const uint32_t kMaxPhotonASRebuildInterval = 256;
+
+    // Version of the checkpoint layout. Increment when the set or meaning of the checkpoint entries changes.
+    const uint32_t kCheckpointVersion = 2;
+
     //const std::string kUseNRDDemodulation = "useNRDDemodulation";
 }
 
@@ -215,6 +297,19 @@ void BDPT::registerBindings(pybind11::module& m)
     misHeuristic.value("PowerTwo", MISHeuristic::PowerTwo);
     misHeuristic.value("PowerExp", MISHeuristic::PowerExp);
 
+    pybind11::enum_<KeyIndexSortType> lightVertexSort(m, "LightVertexSort");
+    lightVertexSort.value("Bitonic", KeyIndexSortType::Bitonic);
+    lightVertexSort.value("Radix", KeyIndexSortType::Radix);
+
+    pybind11::enum_<VertexMergeStructure> vertexMergeStructure(m, "VertexMergeStructure");
+    vertexMergeStructure.value("Tree", VertexMergeStructure::Tree);
+    vertexMergeStructure.value("HashGrid", VertexMergeStructure::HashGrid);
+
+    pybind11::enum_<PhotonAccelerationStructure::BuildPreference> photonASBuildPreference(m, "PhotonASBuildPreference");
+    photonASBuildPreference.value("FastTrace", PhotonAccelerationStructure::BuildPreference::FastTrace);
+    photonASBuildPreference.value("FastBuild", PhotonAccelerationStructure::BuildPreference::FastBuild);
+    photonASBuildPreference.value("MinimizeMemory", PhotonAccelerationStructure::BuildPreference::MinimizeMemory);
+
     pybind11::class_<BDPT, RenderPass, BDPT::SharedPtr> pass(m, "BDPT");
     pass.def_property_readonly("pixelStats", &BDPT::getPixelStats);
 
@@ -226,6 +321,49 @@ void BDPT::registerBindings(pybind11::module& m)
         [](const BDPT* pt) { return pt->mParams.fixedSeed; },
         [](BDPT* pt, uint32_t value) { pt->mParams.fixedSeed = value; }
     );
+
+    // Per-stage GPU/CPU times in ms of the last profiled frame. Requires the profiler to be enabled.
+    pass.def_property_readonly("stageTimings", [](const BDPT* pt) { return pt->mStageTimings.toPython(); });
+    // Record per-frame stage times and write them to a .json or .csv file.
+    pass.def("startTimingCapture", [](BDPT* pt) { pt->mStageTimings.startRecording(); });
+    pass.def("endTimingCapture",
+        [](BDPT* pt, const std::string& path) { pt->mStageTimings.stopRecording(); pt->mStageTimings.write(path); },
+        pybind11::arg("path")
+    );
+
+    // Frame-time governor of the light path budget.
+    pass.def_property("useFrameTimeGovernor",
+        [](const BDPT* pt) { return pt->mUseFrameTimeGovernor; },
+        [](BDPT* pt, bool value)
+        {
+            pt->mUseFrameTimeGovernor = value;
+            pt->mFrameTimeGovernor.reset(pt->mLightPathBudget);
+            if (value) Profiler::instance().setEnabled(true);
+        }
+    );
+    pass.def_property("targetFrameTime",
+        [](const BDPT* pt) { return pt->mFrameTimeGovernor.getOptions().targetFrameTime; },
+        [](BDPT* pt, float value) { auto options = pt->mFrameTimeGovernor.getOptions(); options.targetFrameTime = value; pt->mFrameTimeGovernor.setOptions(options); }
+    );
+    pass.def_property_readonly("lightPathCount", [](const BDPT* pt) { return pt->mParams.lightPathCount; });
+    pass.def_property_readonly("lightPathBudget", [](const BDPT* pt) { return pt->mUseFrameTimeGovernor ? pt->mFrameTimeGovernor.getBudget() : pt->mLightPathBudget; });
+
+    // Bytes of GPU memory allocated by the pass, by resource group. The "total" entry is the sum of all groups.
+    pass.def_property_readonly("memoryUsage", [](const BDPT* pt)
+    {
+        pybind11::dict d;
+        uint64_t total = 0;
+        for (const auto& [name, bytes] : pt->getMemoryUsage())
+        {
+            d[name.c_str()] = bytes;
+            total += bytes;
+        }
+        d["total"] = total;
+        return d;
+    });
+
+    pass.def("saveCheckpoint", [](BDPT* pt, const std::string& path) { pt->saveCheckpoint(path); }, pybind11::arg("path"));
+    pass.def("loadCheckpoint", [](BDPT* pt, const std::string& path) { pt->loadCheckpoint(path); }, pybind11::arg("path"));
 }
 
 BDPT::SharedPtr BDPT::create(RenderContext* pRenderContext, const Dictionary& dict)
@@ -234,7 +372,9 @@ BDPT::SharedPtr BDPT::create(RenderContext* pRenderContext, const Dictionary& di
     return pPass;
 }
 
-BDPT::BDPT(const Dictionary& dict) : RenderPass(kInfo)
+BDPT::BDPT(const Dictionary& dict)
+    : RenderPass(kInfo)
+    , mStageTimings(kStageNames)
 {
     if (!gpDevice->isShaderModelSupported(Device::ShaderModel::SM6_5))
     {
@@ -248,6 +388,10 @@ BDPT::BDPT(const Dictionary& dict) : RenderPass(kInfo)
     parseDictionary(dict);
     validateOptions();
 
+    // The frame-time governor starts from the configured budget. It is driven by the stage timings, which need the profiler.
+    mFrameTimeGovernor.reset(mLightPathBudget);
+    if (mUseFrameTimeGovernor) Profiler::instance().setEnabled(true);
+
     // Create sample generator.
     mpSampleGenerator = SampleGenerator::create(mStaticParams.sampleGenerator);
 
@@ -256,9 +400,10 @@ BDPT::BDPT(const Dictionary& dict) : RenderPass(kInfo)
     mpResolvePass = ComputePass::create(Program::Desc(kResolvePassFilename).setShaderModel(kShaderModel).csEntry("main"), defines, false);
 
     Program::DefineList subSpaceDefines;
-    subSpaceDefines.add("GROUP_SIZE", std::to_string(1 << (mStaticParams.logSubspaceSize - 1)));
+    subSpaceDefines.add("GROUP_SIZE", std::to_string(1 << (kMaxLogSubspaceSize - 1)));
     mpMergePass = ComputePass::create(kMapPassFilename, "main", subSpaceDefines);
     mpPrefixSumPass = ComputePass::create(kMapPassFilename, "scan", subSpaceDefines);
+    mpCompactRowsPass = ComputePass::create(kMapPassFilename, "compactRows", subSpaceDefines);
 
     // Note: The other programs are lazily created in updatePrograms() because a scene needs to be present when creating them.
 
@@ -309,6 +454,35 @@ void BDPT::parseDictionary(const Dictionary& dict)
         else if (key == kFixedOutputSize) mFixedOutputSize = value;
         else if (key == kColorFormat) mStaticParams.colorFormat = value;
 
+        // BDPT parameters
+        else if (key == kLightVertexSort) mLightVertexSort = value;
+        else if (key == kUsePackedVertexInfo) mStaticParams.usePackedVertexInfo = value;
+        else if (key == kUsePackedSampleData) mStaticParams.usePackedSampleData = value;
+        else if (key == kVertexMergeStructure) mStaticParams.vertexMergeStructure = value;
+        else if (key == kCameraTileSize) mCameraTileSize = value;
+        else if (key == kLogSubspaceSize) mParams.logSubspaceSize = value;
+        else if (key == kLightPathCacheFraction) mLightPathCacheFraction = value;
+        else if (key == kLightPathBudget) mLightPathBudget = value;
+        else if (key == kUseFrameTimeGovernor) mUseFrameTimeGovernor = value;
+        else if (key == kTargetFrameTime)
+        {
+            auto options = mFrameTimeGovernor.getOptions();
+            options.targetFrameTime = value;
+            mFrameTimeGovernor.setOptions(options);
+        }
+        else if (key == kAdaptiveSampling) mAdaptiveSampling = value;
+        else if (key == kAdaptiveSamplesPerPixel) mAdaptiveSamplingOptions.samplesPerPixel = value;
+        else if (key == kAdaptiveMaxSamplesPerPixel) mAdaptiveSamplingOptions.maxSamplesPerPixel = value;
+        else if (key == kAdaptiveWarmupFrames) mAdaptiveSamplingOptions.warmupFrames = value;
+        else if (key == kPhotonASBuildPreference) mPhotonASOptions.buildPreference = value;
+        else if (key == kPhotonASAllowRefit) mPhotonASOptions.allowRefit = value;
+        else if (key == kPhotonASRebuildInterval) mPhotonASOptions.rebuildInterval = value;
+        else if (key == kPhotonASUseCompaction) mPhotonASOptions.useCompaction = value;
+        else if (key == kUseVertexMerge) mUseVertexMerge = value;
+        else if (key == kUseSubspace) mUseSubspace = value;
+        else if (key == kUseReservoir) mUseReservoir = value;
+        else if (key == kUseSpatialReuse) spatialReuse = value;
+
         else logWarning("Unknown field '{}' in BDPT dictionary.", key);
     }
 
@@ -345,6 +519,48 @@ void BDPT::validateOptions()
         mParams.specularRoughnessThreshold = clamp(mParams.specularRoughnessThreshold, 0.f, 1.f);
     }
 
+    if (mParams.logSubspaceSize < 1 || mParams.logSubspaceSize > kMaxLogSubspaceSize)
+    {
+        logWarning("'logSubspaceSize' must be in the range [1, {}]. Clamping to this range.", kMaxLogSubspaceSize);
+        mParams.logSubspaceSize = std::clamp(mParams.logSubspaceSize, 1u, kMaxLogSubspaceSize);
+    }
+
+    if (mLightPathCacheFraction < 1.f / kMaxLightPathSlices || mLightPathCacheFraction > 1.f)
+    {
+        logWarning("'lightPathCacheFraction' must be in the range [1/{}, 1]. Clamping to this range.", kMaxLightPathSlices);
+        mLightPathCacheFraction = std::clamp(mLightPathCacheFraction, 1.f / kMaxLightPathSlices, 1.f);
+    }
+
+    const float minLightPathBudget = mFrameTimeGovernor.getOptions().minBudget;
+    if (mLightPathBudget < minLightPathBudget || mLightPathBudget > 1.f)
+    {
+        logWarning("'lightPathBudget' must be in the range [{}, 1]. Clamping to this range.", minLightPathBudget);
+        mLightPathBudget = std::clamp(mLightPathBudget, minLightPathBudget, 1.f);
+    }
+
+    auto& adaptive = mAdaptiveSamplingOptions;
+    if (adaptive.maxSamplesPerPixel < 1 || adaptive.maxSamplesPerPixel > kMaxSamplesPerPixel)
+    {
+        logWarning("'adaptiveMaxSamplesPerPixel' must be in the range [1, {}]. Clamping to this range.", kMaxSamplesPerPixel);
+        adaptive.maxSamplesPerPixel = std::clamp(adaptive.maxSamplesPerPixel, 1u, kMaxSamplesPerPixel);
+    }
+    if (adaptive.samplesPerPixel < 1.f || adaptive.samplesPerPixel > adaptive.maxSamplesPerPixel)
+    {
+        logWarning("'adaptiveSamplesPerPixel' must be in the range [1, adaptiveMaxSamplesPerPixel]. Clamping to this range.");
+        adaptive.samplesPerPixel = std::clamp(adaptive.samplesPerPixel, 1.f, (float)adaptive.maxSamplesPerPixel);
+    }
+    if (adaptive.warmupFrames < 2)
+    {
+        logWarning("'adaptiveWarmupFrames' must be at least 2. Clamping to 2.");
+        adaptive.warmupFrames = 2;
+    }
+
+    if (mPhotonASOptions.rebuildInterval < 1 || mPhotonASOptions.rebuildInterval > kMaxPhotonASRebuildInterval)
+    {
+        logWarning("'photonASRebuildInterval' must be in the range [1, {}]. Clamping to this range.", kMaxPhotonASRebuildInterval);
+        mPhotonASOptions.rebuildInterval = std::clamp(mPhotonASOptions.rebuildInterval, 1u, kMaxPhotonASRebuildInterval);
+    }
+
     // Static parameters.
     if (mStaticParams.samplesPerPixel < 1 || mStaticParams.samplesPerPixel > kMaxSamplesPerPixel)
     {
@@ -425,6 +641,30 @@ Dictionary BDPT::getScriptingDictionary()
     if (mOutputSizeSelection == RenderPassHelpers::IOSize::Fixed) d[kFixedOutputSize] = mFixedOutputSize;
     d[kColorFormat] = mStaticParams.colorFormat;
 
+    // BDPT parameters
+    d[kLightVertexSort] = mLightVertexSort;
+    d[kUsePackedVertexInfo] = mStaticParams.usePackedVertexInfo;
+    d[kUsePackedSampleData] = mStaticParams.usePackedSampleData;
+    d[kVertexMergeStructure] = mStaticParams.vertexMergeStructure;
+    d[kCameraTileSize] = mCameraTileSize;
+    d[kLogSubspaceSize] = mParams.logSubspaceSize;
+    d[kLightPathCacheFraction] = mLightPathCacheFraction;
+    d[kLightPathBudget] = mLightPathBudget;
+    d[kUseFrameTimeGovernor] = mUseFrameTimeGovernor;
+    d[kTargetFrameTime] = mFrameTimeGovernor.getOptions().targetFrameTime;
+    d[kAdaptiveSampling] = mAdaptiveSampling;
+    d[kAdaptiveSamplesPerPixel] = mAdaptiveSamplingOptions.samplesPerPixel;
+    d[kAdaptiveMaxSamplesPerPixel] = mAdaptiveSamplingOptions.maxSamplesPerPixel;
+    d[kAdaptiveWarmupFrames] = mAdaptiveSamplingOptions.warmupFrames;
+    d[kPhotonASBuildPreference] = mPhotonASOptions.buildPreference;
+    d[kPhotonASAllowRefit] = mPhotonASOptions.allowRefit;
+    d[kPhotonASRebuildInterval] = mPhotonASOptions.rebuildInterval;
+    d[kPhotonASUseCompaction] = mPhotonASOptions.useCompaction;
+    d[kUseVertexMerge] = mUseVertexMerge;
+    d[kUseSubspace] = mUseSubspace;
+    d[kUseReservoir] = mUseReservoir;
+    d[kUseSpatialReuse] = spatialReuse;
+
     return d;
 }
 
@@ -445,7 +685,7 @@ void BDPT::setFrameDim(const uint2 frameDim)
     auto prevScreenTiles = mParams.screenTiles;
 
     mParams.frameDim = frameDim;
-    if (mParams.frameDim.x > kMaxFrameDimension || mParams.frameDim.y > kMaxFrameDimensionY)
+    if (mParams.frameDim.x > kMaxFrameDimension || mParams.frameDim.y > kMaxFrameDimension)
     {
         throw RuntimeError("Frame dimensions up to {} pixels width/height are supported.", kMaxFrameDimension);
     }
@@ -521,6 +761,7 @@ BDPT::CollectPass::CollectPass(const std::string& shaderFile, const Scene::Share
     desc.setMaxPayloadSize(maxPayloadSize);
     desc.setMaxAttributeSize(8u);
     desc.setMaxTraceRecursionDepth(2u);
+    desc.useKernelCache(true);
 
     pBindingTable = RtBindingTable::create(1, 1, pScene->getGeometryCount());
     auto& sbt = pBindingTable;
@@ -534,9 +775,6 @@ BDPT::CollectPass::CollectPass(const std::string& shaderFile, const Scene::Share
 
 void BDPT::execute(RenderContext* pRenderContext, const RenderData& renderData)
 {
-    //initTimer();
-
-    //pGpuTimer->begin();
     if (!beginFrame(pRenderContext, renderData)) return;
 
     // Update shader program specialization.
@@ -549,7 +787,10 @@ void BDPT::execute(RenderContext* pRenderContext, const RenderData& renderData)
     // This should be called after all resources have been created.
     preparePathTracer(renderData);
 
-    //if (mRebuild) prepareAccelerationStructure(pRenderContext);
+    // Restore a loaded checkpoint into the prepared resources.
+    if (mpPendingCheckpoint) restoreCheckpoint(pRenderContext);
+
+    prepareAccelerationStructure(pRenderContext);
 
     // Generate paths at primary hits.
     generatePaths(pRenderContext, renderData);
@@ -570,56 +811,41 @@ void BDPT::execute(RenderContext* pRenderContext, const RenderData& renderData)
     //mParams.LightPathsIndexBufferLength = 0;
     //pRenderContext->clearUAV(mpLightPathVertexBuffer->getUAV().get(), zero4);
     //pRenderContext->clearUAV(mpLightPathsIndexBuffer->getUAV().get(), zero4);
-    pRenderContext->uavBarrier(mpLightPathsIndexBuffer->getUAVCounter().get());
-    pRenderContext->clearUAVCounter(mpLightPathsIndexBuffer, 0);
-    //pGpuTimer->end();
-    //pGpuTimer->resolve();
-    //logWarning("init part " + std::to_string(pGpuTimer->getElapsedTime()));
-
-    //pGpuTimer->begin();
-    FALCOR_ASSERT(mpTraceLightPath);
-    tracePass(pRenderContext, renderData, *mpTraceLightPath, uint2(mStaticParams.lightPassWidth, mStaticParams.lightPassHeight));
-
-    pRenderContext->uavBarrier(mpLightPathVertexBuffer.get());
-    //pRenderContext->uavBarrier(mpLightPathsVertexsPositionBuffer.get());
-    pRenderContext->uavBarrier(mpLightPathsIndexBuffer.get());
+    traceLightPaths(pRenderContext, renderData);
 
-    //pGpuTimer->end();
-    //pGpuTimer->resolve();
-    //logWarning("light path: " + std::to_string(pGpuTimer->getElapsedTime()));
-    //pGpuTimer->begin();
     // Generate camera path
     
-    auto kCounterPtr = (uint*)mpLightPathsIndexBuffer->getUAVCounter()->map(Buffer::MapType::Read);
-    uint counter = *kCounterPtr;
-    logWarning(std::to_string(counter));
-    mpSortPass->setListCount(counter);
-    mpSortPass->sort(pRenderContext);
-    //pGpuTimer->end();
-    //pGpuTimer->resolve();
-    //logWarning("sort: " + std::to_string(pGpuTimer->getElapsedTime()));
-    //pGpuTimer->begin();
-    mpTreeBuilder->update(counter, radius);
-    mpTreeBuilder->build(pRenderContext);
+    // The light vertex count stays on the GPU: the sort and tree build read it from the UAV counter.
+    {
+        FALCOR_PROFILE("sortLightVertices");
+        mpSortPass->sort(pRenderContext);
+    }
+    {
+        FALCOR_PROFILE("buildLightVertexTree");
+        mpTreeBuilder->update(radius);
+        mpTreeBuilder->build(pRenderContext);
+    }
+    if (mpHashGridBuilder && mUseVertexMerge)
+    {
+        // The hash grid indexes the unsorted vertices and doesn't depend on the sort.
+        FALCOR_PROFILE("buildLightVertexHashGrid");
+        mpHashGridBuilder->build(pRenderContext);
+    }
+    if (mValidateLightVertexTree)
+    {
+        mpTreeBuilder->validate(pRenderContext);
+        if (mpHashGridBuilder && mUseVertexMerge) mpHashGridBuilder->validate(pRenderContext);
+        mValidateLightVertexTree = false;
+    }
     //mpSortPass->sortTest(pRenderContext, renderData.getTexture(kOutputColor), mParams.frameDim);
 
     pRenderContext->uavBarrier(mpTreeBuilder->getTree().get());
-    //pGpuTimer->end();
-    //pGpuTimer->resolve();
-    //logWarning("build tree: " + std::to_string(pGpuTimer->getElapsedTime()));
-    //pGpuTimer->begin();
     //mpPrevGatherPoints->uavBarrier(pRenderContext);
         
-    //pRenderContext->clearUAVCounter(mpAABB, 0);  
+    if (mpPhotonAS) mpPhotonAS->clearAABBs(pRenderContext);
    
 
-    FALCOR_ASSERT(mpTraceCameraPath);
-    {
-        auto var = mpPathTracerBlock->getRootVar();
-        var["leafNodeStart"] = mpTreeBuilder->getLeafNodeStartIndex();
-        var["counter"] = counter;
-    }
-    tracePass(pRenderContext, renderData, *mpTraceCameraPath, mParams.frameDim);
+    traceCameraPath(pRenderContext, renderData);
     mpSubspaceReservoir->uavBarrier(pRenderContext);
     mpGatherPoints->uavBarrier(pRenderContext);
     //mpPairs->uavBarrier(pRenderContext);
@@ -628,10 +854,6 @@ void BDPT::execute(RenderContext* pRenderContext, const RenderData& renderData)
     pRenderContext->uavBarrier(mpSubspaceSecondaryMoment.get());
     //pRenderContext->uavBarrier(mpAABB->getUAVCounter().get());
     pRenderContext->uavBarrier(mpOutput.get());
-    //pGpuTimer->end();
-    //pGpuTimer->resolve();
-    //logWarning("eye path: " + std::to_string(pGpuTimer->getElapsedTime()));
-    //pGpuTimer->begin();
     //auto kValidCounterPtr = (uint*)mpAABB->getUAVCounter()->map(Buffer::MapType::Read);
     //uint validCounter = *kValidCounterPtr;
     //logWarning(std::to_string(validCounter));
@@ -669,189 +891,343 @@ void BDPT::execute(RenderContext* pRenderContext, const RenderData& renderData)
 
     //spatiotemporalReuse(pRenderContext, renderData);
 
-    //buildAccelerationStructure(pRenderContext);
+    buildAccelerationStructure(pRenderContext);
 
     pRenderContext->copyResource(renderData.getTexture(kOutputColor).get(), mpOutput.get());
+    if (mpAdaptiveSampler) mpAdaptiveSampler->update(pRenderContext, mpOutput, mAdaptiveSamplingOptions);
     if(mUseSubspace) buildSubspaceWeightMatrix(pRenderContext, renderData);
-    //pGpuTimer->end();
-    //pGpuTimer->resolve();
-    //logWarning("update matrix: " + std::to_string(pGpuTimer->getElapsedTime()));
     //spatiotemporalReuse(pRenderContext, renderData);
     // Resolve pass.
     //resolvePass(pRenderContext, renderData);
 
     //pRenderContext->uavBarrier(mpCameraPathsVertexsReservoirBuffer.get());
     //pRenderContext->uavBarrier(mpOutput.get());
-    //pGpuTimer->begin();
     endFrame(pRenderContext, renderData);
-    //pGpuTimer->end();
-    //pGpuTimer->resolve();
-    //logWarning("end: " + std::to_string(pGpuTimer->getElapsedTime()));
-}
-
-double BDPT::checkTime(RenderContext* pRenderContext) {
-    //pRenderContext->readti
-    auto currentTime = std::chrono::steady_clock::now();
-    std::chrono::duration<double> elapsedSec = currentTime - mCurrentTime;
-    mCurrentTime = currentTime;
-    return elapsedSec.count();
 }
 
-void BDPT::prepareAccelerationStructure(RenderContext* pRenderContext) {
-    //mPhotonInstanceDesc = nullptr;
-    mpTlasScratch = nullptr;
-    mPhotonTlas.pInstanceDescs = nullptr; mPhotonTlas.pSrv = nullptr; mPhotonTlas.pTlas = nullptr;
+void BDPT::traceLightPaths(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    FALCOR_ASSERT(mpTraceLightPath);
 
-    mBlasScratchMaxSize = 0;
-    mTlasScratchMaxSize = 0;
+    if (!mpLightVertexCache)
+    {
+        pRenderContext->uavBarrier(mpLightPathsIndexBuffer->getUAVCounter().get());
+        pRenderContext->clearUAVCounter(mpLightPathsIndexBuffer, 0);
+        tracePass(pRenderContext, renderData, *mpTraceLightPath, uint2(mStaticParams.lightPassWidth, getLightPassRowCount()));
+        pRenderContext->uavBarrier(mpLightPathVertexBuffer.get());
+        pRenderContext->uavBarrier(mpLightPathsIndexBuffer.get());
+        return;
+    }
 
-    // prepare blas
-    { 
-        auto& blas = mBlasData;
+    // Retrace one slice of the light paths and store its vertices in the slice's cache slot.
+    // After an invalidation all slices are retraced, which costs the same as tracing the light pass at once.
+    const uint32_t sliceCount = mpLightVertexCache->getSlotCount();
+    const uint32_t sliceHeight = div_round_up(getLightPassRowCount(), sliceCount);
+    const uint32_t firstSlice = mLightPathCacheValid ? mLightPathCacheNextSlice % sliceCount : 0;
+    const uint32_t tracedSliceCount = mLightPathCacheValid ? 1 : sliceCount;
 
-        //Create geometry description
-        D3D12_RAYTRACING_GEOMETRY_DESC& desc = blas.geomDescs;
-        desc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_PROCEDURAL_PRIMITIVE_AABBS;
-        desc.Flags = D3D12_RAYTRACING_GEOMETRY_FLAG_NO_DUPLICATE_ANYHIT_INVOCATION;         //< Important! So that photons are not collected multiple times
-        desc.AABBs.AABBCount = kMaxFrameDimension * kMaxFrameDimensionY * mStaticParams.maxSurfaceBounces;
-        desc.AABBs.AABBs.StartAddress = mpAABB->getGpuAddress();
-        desc.AABBs.AABBs.StrideInBytes = sizeof(D3D12_RAYTRACING_AABB);
+    auto var = mpPathTracerBlock->getRootVar();
+    for (uint32_t i = 0; i < tracedSliceCount; i++)
+    {
+        const uint32_t slice = firstSlice + i;
+        pRenderContext->uavBarrier(mpLightPathsIndexBuffer->getUAVCounter().get());
+        pRenderContext->clearUAVCounter(mpLightPathsIndexBuffer, 0);
+        mParams.lightPassRowOffset = slice * sliceHeight;
+        var["params"].setBlob(mParams);
+        tracePass(pRenderContext, renderData, *mpTraceLightPath, uint2(mStaticParams.lightPassWidth, sliceHeight));
+        mpLightVertexCache->store(pRenderContext, slice);
+    }
+    mParams.lightPassRowOffset = 0;
+    var["params"].setBlob(mParams);
 
-        //Create input for blas
-        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS& inputs = blas.buildInputs;
-        inputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL;
-        inputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-        inputs.NumDescs = 1;
-        inputs.pGeometryDescs = &blas.geomDescs;
+    mLightPathCacheNextSlice = (firstSlice + tracedSliceCount) % sliceCount;
+    mLightPathCacheValid = true;
 
-        //Updating is no option for BLAS as individual photons move to much.
+    // Rebuild the light vertex buffers from all slots. The sort and the tree are built over the whole pool as before.
+    FALCOR_PROFILE("gatherLightVertexCache");
+    mpLightVertexCache->gather(pRenderContext);
+}
 
-        inputs.Flags = fastBuild ? D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD : D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
-        //get prebuild Info
-        FALCOR_GET_COM_INTERFACE(gpDevice->getApiHandle(), ID3D12Device5, pDevice5);
-        pDevice5->GetRaytracingAccelerationStructurePrebuildInfo(&blas.buildInputs, &blas.prebuildInfo);
+uint32_t BDPT::getLightPathSliceCount() const
+{
+    return std::clamp((uint32_t)std::lround(1.f / mLightPathCacheFraction), 1u, kMaxLightPathSlices);
+}
 
-        // Figure out the padded allocation sizes to have proper alignment.
-        FALCOR_ASSERT(blas.prebuildInfo.ResultDataMaxSizeInBytes > 0);
-        blas.blasByteSize = align_to((uint64_t)D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT, blas.prebuildInfo.ResultDataMaxSizeInBytes);
+uint32_t BDPT::getLightPassRowCount() const
+{
+    // The budget is applied in whole rows of the light pass, so the light path count is a multiple of the pass width.
+    const float budget = mUseFrameTimeGovernor ? mFrameTimeGovernor.getBudget() : mLightPathBudget;
+    const uint32_t rowCount = (uint32_t)std::ceil(budget * mStaticParams.lightPassHeight);
+    return std::clamp(rowCount, 1u, mStaticParams.lightPassHeight);
+}
 
-        uint64_t scratchByteSize = std::max(blas.prebuildInfo.ScratchDataSizeInBytes, blas.prebuildInfo.UpdateScratchDataSizeInBytes);
-        blas.scratchByteSize = align_to((uint64_t)D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT, scratchByteSize);
+void BDPT::updateFrameTimeGovernor()
+{
+    // The governor is driven by the GPU times of the BDPT stages, split into the stages that scale with the light path count and the rest.
+    float fixedTime = 0.f;
+    float scaledTime = 0.f;
+    bool valid = false;
+    for (const auto& stage : mStageTimings.getStages())
+    {
+        if (!stage.valid) continue;
+        bool scaled = std::find(kLightPathStageNames.begin(), kLightPathStageNames.end(), stage.name) != kLightPathStageNames.end();
+        (scaled ? scaledTime : fixedTime) += stage.gpuTime;
+        valid = true;
+    }
+    if (valid) mFrameTimeGovernor.update(fixedTime, scaledTime);
+}
 
-        mBlasScratchMaxSize = std::max(blas.scratchByteSize, mBlasScratchMaxSize);
-        
+uint2 BDPT::getCameraPassDim() const
+{
+    uint2 dim = mCameraTileSize == 0 ? mParams.frameDim : glm::min(uint2(mCameraTileSize), mParams.frameDim);
 
-        //Create the scratch and blas buffers
-        mpBlasScratch = Buffer::create(mBlasScratchMaxSize, Buffer::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
-        mpBlasScratch->setName("BDPT::BlasScratch");
+    // Fall back to smaller tiles if the camera vertex storage would exceed its size limit.
+    while ((uint64_t)dim.x * dim.y * mStaticParams.maxSurfaceBounces > kMaxCameraVertexCount && (dim.x > 1 || dim.y > 1))
+    {
+        dim = div_round_up(dim, uint2(2));
+    }
+    return dim;
+}
 
-        mpBlas = Buffer::create(mBlasData.blasByteSize, Buffer::BindFlags::AccelerationStructure, Buffer::CpuAccess::None);
+uint32_t BDPT::getFlags() const
+{
+    uint32_t flag = 0;
+    if (s0) flag |= uint(BDPTFlags::s0);
+    if (s1) flag |= uint(BDPTFlags::s1);
+    if (s2) flag |= uint(BDPTFlags::s2);
+    if (mUseVertexMerge)
+    {
+        flag |= uint(BDPTFlags::useVertexMerge);
+        if (!t1) flag |= uint(BDPTFlags::t1);
     }
+    else if (mUseSubspace)
+    {
+        flag |= uint(BDPTFlags::useSubspaceBDPT);
+    }
+    if (mUseReservoir) flag |= uint(BDPTFlags::useReservoir);
+    if (spatialReuse) flag |= uint(BDPTFlags::spatialReuse);
+    return flag;
+}
 
-    // prepare tlas
+std::vector<std::pair<std::string, uint64_t>> BDPT::getMemoryUsage() const
+{
+    auto size = [](const auto& pResource) -> uint64_t
     {
-        D3D12_RAYTRACING_INSTANCE_DESC desc = {};
-        desc.AccelerationStructure = mpBlas->getGpuAddress();
-        desc.Flags = D3D12_RAYTRACING_INSTANCE_FLAG_NONE;
-        desc.InstanceID = 0;
-        desc.InstanceMask = 1;  //0b01 for Caustic and 0b10 for Global
-        desc.InstanceContributionToHitGroupIndex = 0;
+        if (!pResource) return 0;
+        if constexpr (std::is_same_v<std::decay_t<decltype(pResource)>, Texture::SharedPtr>) return pResource->getTextureSizeInBytes();
+        else return pResource->getSize();
+    };
 
-        //Create a identity matrix for the transform and copy it to the instance desc
-        //glm::mat4 transform4x4 = glm::identity<glm::mat4>();
-        //std::memcpy(desc.Transform, &transform4x4, sizeof(desc.Transform));
-        mPhotonInstanceDesc = desc;
+    uint64_t lightVertices = size(mpLightPathVertexBuffer) + size(mpLightPathsIndexBuffer) + size(mpLightPathsVertexsPositionBuffer) + size(KeyIndexList);
+    if (mpLightVertexCache) lightVertices += mpLightVertexCache->getMemoryUsage();
 
-        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS inputs = {};
-        inputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-        inputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-        inputs.NumDescs = 1;
-        inputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD;
+    uint64_t vertexMerge = 0;
+    if (mpTreeBuilder) vertexMerge += size(mpTreeBuilder->getTree());
+    if (mpHashGridBuilder) vertexMerge += size(mpHashGridBuilder->getHeads()) + size(mpHashGridBuilder->getNext());
 
-        //Prebuild
-        FALCOR_GET_COM_INTERFACE(gpDevice->getApiHandle(), ID3D12Device5, pDevice5);
-        pDevice5->GetRaytracingAccelerationStructurePrebuildInfo(&inputs, &mTlasPrebuildInfo);
-        mpTlasScratch = Buffer::create(std::max(mTlasPrebuildInfo.ScratchDataSizeInBytes, mTlasScratchMaxSize), Buffer::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
-        mpTlasScratch->setName("BDPT::TLAS_Scratch");
+    uint64_t subspace = size(mpSubspaceWeight[0]) + size(mpSubspaceWeight[1]) + size(mpSubspaceCount[0]) + size(mpSubspaceCount[1])
+        + size(mpSubspaceSecondaryMoment) + size(mpPrefixOfWeight) + size(mpPrefixOfCount) + size(mpPrefixOfSecondaryMoment)
+        + size(mpSumOfWeight) + size(mpSumOfCount) + size(mpSumOfSecondaryMoment) + size(mpMaxVariance)
+        + size(mpSubspaceDirtyRowMask) + size(mpSubspaceDirtyRows) + size(mpSubspaceDispatchArgs);
 
-        //Create buffers for the TLAS
-        mPhotonTlas.pTlas = Buffer::create(mTlasPrebuildInfo.ResultDataMaxSizeInBytes, Buffer::BindFlags::AccelerationStructure, Buffer::CpuAccess::None);
-        mPhotonTlas.pTlas->setName("BDPT::TLAS");
-        mPhotonTlas.pInstanceDescs = Buffer::create(sizeof(D3D12_RAYTRACING_INSTANCE_DESC), Buffer::BindFlags::None, Buffer::CpuAccess::Write, &mPhotonInstanceDesc);
-        mPhotonTlas.pInstanceDescs->setName("BDPT::TLAS_Instance_Description");
+    uint64_t reservoirs = 0;
+    if (mpSubspaceReservoir)
+    {
+        const auto& r = *mpSubspaceReservoir;
+        reservoirs = size(r.samplePosition) + size(r.hitPointPosition) + size(r.normal) + size(r.radiance) + size(r.reservoir) + size(r.signal);
+    }
 
-        //Acceleration Structure Buffer view for access in shader
-        mPhotonTlas.pSrv = ShaderResourceView::createViewForAccelerationStructure(mPhotonTlas.pTlas);
+    uint64_t samplePairs = 0;
+    for (const auto& pPairs : { mpPairs, mpPrevPairs })
+    {
+        if (pPairs) samplePairs += size(pPairs->samplePosition) + size(pPairs->hitPointPosition) + size(pPairs->normal) + size(pPairs->radiance) + size(pPairs->reservoir);
     }
 
-    if (mRebuild) mRebuild = false;
+    uint64_t gatherPoints = 0;
+    for (const auto& pGatherPoints : { mpGatherPoints, mpPrevGatherPoints })
+    {
+        if (pGatherPoints) gatherPoints += size(pGatherPoints->mpFluxAndNumber) + size(pGatherPoints->mpNormalAndRadii) + size(pGatherPoints->mpPosAndNewRadii) + size(pGatherPoints->mpIteration);
+    }
+
+    uint64_t photonAS = size(mpAABB);
+    if (mpPhotonAS)
+    {
+        const auto& stats = mpPhotonAS->getStats();
+        photonAS += stats.blasResultSize + stats.blasCompactedSize + stats.blasScratchSize + stats.tlasResultSize + stats.tlasScratchSize;
+    }
+
+    uint64_t other = size(mpSampleOffset) + size(mpSampleColor) + size(mpOutput) + size(mpPathPos) + size(mpPathRadiance) + size(mpPathHitInfo);
+
+    return
+    {
+        { "lightVertices", lightVertices },
+        { "vertexMerge", vertexMerge },
+        { "subspace", subspace },
+        { "reservoirs", reservoirs },
+        { "samplePairs", samplePairs },
+        { "gatherPoints", gatherPoints },
+        { "photonAS", photonAS },
+        { "other", other },
+    };
 }
 
-void BDPT::buildAccelerationStructure(RenderContext* pContext) {
-    uint aabbCount;
-    auto pCounter = (uint*)mpAABB->getUAVCounter()->map(Buffer::MapType::Read);
-    aabbCount = *pCounter;
-    //logWarning(std::to_string(aabbCount));
-    
+std::vector<std::pair<std::string, Texture::SharedPtr>> BDPT::getCheckpointTextures() const
+{
+    // Only the state carried over between frames is saved. Per-frame buffers are rebuilt every frame.
+    std::vector<std::pair<std::string, Texture::SharedPtr>> textures =
+    {
+        { "subspaceWeight", mpSubspaceWeight[1] },
+        { "subspaceCount", mpSubspaceCount[1] },
+        { "subspaceSecondaryMoment", mpSubspaceSecondaryMoment },
+        { "prefixOfWeight", mpPrefixOfWeight },
+        { "prefixOfCount", mpPrefixOfCount },
+        { "prefixOfSecondaryMoment", mpPrefixOfSecondaryMoment },
+        { "sumOfWeight", mpSumOfWeight },
+        { "sumOfCount", mpSumOfCount },
+        { "sumOfSecondaryMoment", mpSumOfSecondaryMoment },
+        { "maxVariance", mpMaxVariance },
+    };
+    if (mpSubspaceReservoir)
+    {
+        textures.push_back({ "reservoir.samplePosition", mpSubspaceReservoir->samplePosition });
+        textures.push_back({ "reservoir.hitPointPosition", mpSubspaceReservoir->hitPointPosition });
+        textures.push_back({ "reservoir.normal", mpSubspaceReservoir->normal });
+        textures.push_back({ "reservoir.radiance", mpSubspaceReservoir->radiance });
+        textures.push_back({ "reservoir.reservoir", mpSubspaceReservoir->reservoir });
+        textures.push_back({ "reservoir.signal", mpSubspaceReservoir->signal });
+    }
+    for (const auto& [prefix, pGatherPoints] : { std::make_pair("gatherPoints", mpGatherPoints), std::make_pair("prevGatherPoints", mpPrevGatherPoints) })
+    {
+        if (!pGatherPoints) continue;
+        textures.push_back({ std::string(prefix) + ".fluxAndNumber", pGatherPoints->mpFluxAndNumber });
+        textures.push_back({ std::string(prefix) + ".normalAndRadii", pGatherPoints->mpNormalAndRadii });
+        textures.push_back({ std::string(prefix) + ".posAndNewRadii", pGatherPoints->mpPosAndNewRadii });
+        textures.push_back({ std::string(prefix) + ".iteration", pGatherPoints->mpIteration });
+    }
+    return textures;
+}
 
-    // build blas
+void BDPT::saveCheckpoint(const std::filesystem::path& path)
+{
+    if (mParams.frameCount == 0 || !mpSubspaceWeight[1] || !mpGatherPoints)
     {
-        if (!gpDevice->isFeatureSupported(Device::SupportedFeatures::Raytracing))
-        {
-            throw std::exception("Raytracing is not supported by the current device");
-        }
+        throw RuntimeError("BDPT: Cannot save a checkpoint before the first frame is rendered.");
+    }
 
-        //aabb buffers need to be ready
-        pContext->uavBarrier(mpAABB.get());
+    RenderContext* pRenderContext = gpDevice->getRenderContext();
+    Checkpoint checkpoint(kInfo.type, kCheckpointVersion);
+    checkpoint.setValue("frameCount", mParams.frameCount);
+    checkpoint.setValue("frameDim", mParams.frameDim);
+    checkpoint.setValue("logSubspaceSize", mParams.logSubspaceSize);
+    checkpoint.setValue("radius", radius);
+    checkpoint.setValue("packedSampleData", (uint32_t)mStaticParams.usePackedSampleData);
+    for (const auto& [name, pTexture] : getCheckpointTextures())
+    {
+        if (pTexture) checkpoint.captureTexture(name, pRenderContext, pTexture.get());
+    }
+    checkpoint.write(path);
+    logInfo("BDPT: Saved checkpoint of frame {} to '{}'.", mParams.frameCount, path.string());
+}
 
-        auto& blas = mBlasData;
+void BDPT::loadCheckpoint(const std::filesystem::path& path)
+{
+    auto pCheckpoint = std::make_unique<Checkpoint>(Checkpoint::read(path, kInfo.type, kCheckpointVersion));
 
-        //barriers for the scratch and blas buffer
-        pContext->uavBarrier(mpBlasScratch.get());
-        pContext->uavBarrier(mpBlas.get());
+    // The subspace size determines the texture sizes, so it is applied before the resources are prepared.
+    mParams.logSubspaceSize = pCheckpoint->getValue<uint32_t>("logSubspaceSize");
+    validateOptions();
+    mpPendingCheckpoint = std::move(pCheckpoint);
+}
 
-        //add the photon count for this iteration. geomDesc is saved as a pointer in blasInputs
-        uint maxPhotons = kMaxFrameDimension * kMaxFrameDimensionY * mStaticParams.maxSurfaceBounces;
-        aabbCount = std::min(aabbCount, maxPhotons);
-        blas.geomDescs.AABBs.AABBCount = static_cast<UINT64>(aabbCount);
+void BDPT::restoreCheckpoint(RenderContext* pRenderContext)
+{
+    FALCOR_ASSERT(mpPendingCheckpoint);
+    std::unique_ptr<Checkpoint> pCheckpoint = std::move(mpPendingCheckpoint);
 
-        //Fill the build desc struct
-        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC asDesc = {};
-        asDesc.Inputs = blas.buildInputs;
-        asDesc.ScratchAccelerationStructureData = mpBlasScratch->getGpuAddress();
-        asDesc.DestAccelerationStructureData = mpBlas->getGpuAddress();
+    const uint2 frameDim = pCheckpoint->getValue<uint2>("frameDim");
+    if (frameDim != mParams.frameDim)
+    {
+        logError("BDPT: Checkpoint was saved at {}x{} but the frame is {}x{}. Ignoring the checkpoint.", frameDim.x, frameDim.y, mParams.frameDim.x, mParams.frameDim.y);
+        return;
+    }
+    if (pCheckpoint->getValue<uint32_t>("logSubspaceSize") != mParams.logSubspaceSize)
+    {
+        logError("BDPT: Checkpoint subspace size doesn't match the current subspace size. Ignoring the checkpoint.");
+        return;
+    }
+    // The sample textures have different formats with packed sample data. Checkpoints without the entry were saved unpacked.
+    const bool packedSampleData = pCheckpoint->hasEntry("packedSampleData") && pCheckpoint->getValue<uint32_t>("packedSampleData") != 0;
+    if (packedSampleData != mStaticParams.usePackedSampleData)
+    {
+        logError("BDPT: Checkpoint was saved with usePackedSampleData = {}. Ignoring the checkpoint.", packedSampleData);
+        return;
+    }
+    // The merge radius is derived from the scene bounds, so a mismatch means the checkpoint was saved with a different scene.
+    if (pCheckpoint->getValue<float>("radius") != radius)
+    {
+        logWarning("BDPT: Checkpoint was saved with a different scene. The restored state may be invalid.");
+    }
 
-        //Build the acceleration structure
-        FALCOR_GET_COM_INTERFACE(pContext->getLowLevelData()->getCommandList(), ID3D12GraphicsCommandList4, pList4);
-        pList4->BuildRaytracingAccelerationStructure(&asDesc, 0, nullptr);
+    for (const auto& [name, pTexture] : getCheckpointTextures())
+    {
+        if (pTexture && pCheckpoint->hasEntry(name)) pCheckpoint->restoreTexture(name, pRenderContext, pTexture.get());
+    }
+    mParams.frameCount = pCheckpoint->getValue<uint32_t>("frameCount");
+    logInfo("BDPT: Resumed from checkpoint at frame {}.", mParams.frameCount);
+}
+
+void BDPT::traceCameraPath(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    FALCOR_PROFILE("traceCameraPaths");
+
+    FALCOR_ASSERT(mpTraceCameraPath);
 
-        //Barrier for the blas
-        pContext->uavBarrier(mpBlas.get());
+    const uint2 tileDim = getCameraPassDim();
+    if (tileDim == mParams.frameDim)
+    {
+        tracePass(pRenderContext, renderData, *mpTraceCameraPath, mParams.frameDim);
+        return;
     }
 
-    //
+    // Trace the frame in tiles. Per-path storage is sized for a single tile, which bounds the memory
+    // use for large frames. The tiles write disjoint pixels so no barriers are needed in between.
+    auto var = mpPathTracerBlock->getRootVar();
+    for (uint32_t y = 0; y < mParams.frameDim.y; y += tileDim.y)
     {
-        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS inputs = {};
-        inputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-        inputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-        inputs.NumDescs = 1;
-        //Update Flag could be set for TLAS. This made no real time difference in our test so it is left out. Updating could reduce the memory of the TLAS scratch buffer a bit
-        inputs.Flags = fastBuild ? D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD : D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+        for (uint32_t x = 0; x < mParams.frameDim.x; x += tileDim.x)
+        {
+            mParams.tileOffset = { x, y };
+            var["params"].setBlob(mParams);
+            tracePass(pRenderContext, renderData, *mpTraceCameraPath, glm::min(tileDim, mParams.frameDim - mParams.tileOffset));
+        }
+    }
 
-        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC asDesc = {};
-        asDesc.Inputs = inputs;
-        asDesc.Inputs.InstanceDescs = mPhotonTlas.pInstanceDescs->getGpuAddress();
-        asDesc.ScratchAccelerationStructureData = mpTlasScratch->getGpuAddress();
-        asDesc.DestAccelerationStructureData = mPhotonTlas.pTlas->getGpuAddress();
+    mParams.tileOffset = { 0, 0 };
+    var["params"].setBlob(mParams);
+}
 
-        // Create TLAS
-        FALCOR_GET_COM_INTERFACE(pContext->getLowLevelData()->getCommandList(), ID3D12GraphicsCommandList4, pList4);
-        pContext->resourceBarrier(mPhotonTlas.pInstanceDescs.get(), Resource::State::NonPixelShader);
-        pList4->BuildRaytracingAccelerationStructure(&asDesc, 0, nullptr);
-        pContext->uavBarrier(mPhotonTlas.pTlas.get());
+void BDPT::prepareAccelerationStructure(RenderContext* pRenderContext)
+{
+    // The hit point AABBs are only produced if the AABB buffer is allocated.
+    if (!mpAABB)
+    {
+        mpPhotonAS = nullptr;
+        return;
+    }
 
-        //logWarning(std::to_string(mpBlas->getElementCount()));
+    if (!mpPhotonAS || mpPhotonAS->getAABBs() != mpAABB)
+    {
+        mpPhotonAS = std::make_unique<PhotonAccelerationStructure>(mpAABB, mPhotonASOptions);
     }
+    else mpPhotonAS->setOptions(mPhotonASOptions);
+}
+
+void BDPT::buildAccelerationStructure(RenderContext* pRenderContext)
+{
+    if (!mpPhotonAS) return;
+
+    FALCOR_PROFILE("buildPhotonAS");
+    mpPhotonAS->build(pRenderContext);
 }
 
 bool BDPT::renderRenderingUI(Gui::Widgets& widget)
@@ -867,6 +1243,18 @@ bool BDPT::renderRenderingUI(Gui::Widgets& widget)
     widget.tooltip("Number of samples per pixel. One path is traced for each sample.\n\n"
         "When the '" + kInputSampleCount + "' input is connected, the number of samples per pixel is loaded from the texture.");
 
+    dirty |= widget.checkbox("Adaptive sampling", mAdaptiveSampling);
+    widget.tooltip("Distribute the camera samples of each frame proportional to the relative variance of the accumulated pixel estimates.\n\n"
+        "The sample count map replaces the '" + kInputSampleCount + "' input. It is reset on any scene or option change. "
+        "The per-pixel camera vertex data (gather points, subspace reservoirs) keeps the last sample of a pixel.");
+    if (mAdaptiveSampling)
+    {
+        runtimeDirty |= widget.var("Average samples/pixel", mAdaptiveSamplingOptions.samplesPerPixel, 1.f, (float)mAdaptiveSamplingOptions.maxSamplesPerPixel, 0.25f);
+        runtimeDirty |= widget.var("Max samples/pixel", mAdaptiveSamplingOptions.maxSamplesPerPixel, 1u, kMaxSamplesPerPixel);
+        runtimeDirty |= widget.var("Warmup frames", mAdaptiveSamplingOptions.warmupFrames, 2u, 64u);
+        widget.tooltip("Frames with uniform sample counts after a reset, before the variance estimates are used.");
+    }
+
     if (widget.var("Max surface bounces", mStaticParams.maxSurfaceBounces, 0u, 20u))
     {
         // Allow users to change the max surface bounce parameter in the UI to clamp all other surface bounce parameters.
@@ -944,34 +1332,83 @@ bool BDPT::renderRenderingUI(Gui::Widgets& widget)
     {
         runtimeDirty |= widget.checkbox("s == 0 connection", s0);
         widget.tooltip("Add the contribution of s=0 type to the final result.");
-        mParams.flag = s0 ? uint(BDPTFlags::s0) : 0;
 
         runtimeDirty |= widget.checkbox("s == 1 connection", s1);
         widget.tooltip("Add the contribution of s=1 type to the final result.");
-        mParams.flag |= s1 ? uint(BDPTFlags::s1) : 0;
 
         runtimeDirty |= widget.checkbox("s > 1 connection", s2);
         widget.tooltip("Add the contribution of s>1 type to the final result.");
-        mParams.flag |= s2 ? uint(BDPTFlags::s2) : 0;
 
         runtimeDirty |= widget.checkbox("use Vertex Merge", mUseVertexMerge);
         widget.tooltip("use VCM.");
-        mParams.flag |= mUseVertexMerge ? uint(BDPTFlags::useVertexMerge) : 0;
 
         if (mUseVertexMerge) {
             runtimeDirty |= widget.checkbox("temproal reuse", t1);
             widget.tooltip("temproal reuse surfle");
-            mParams.flag |= t1 ? 0 : uint(BDPTFlags::t1);
+
+            dirty |= widget.dropdown("Vertex merge structure", kVertexMergeStructureList, reinterpret_cast<uint32_t&>(mStaticParams.vertexMergeStructure));
+            widget.tooltip("Structure used to find the light vertices within the merge radius.\n\n"
+                "The hash grid is built in a single pass over the unsorted light vertices with a cell size of twice the merge radius. "
+                "The light vertex tree is still built for light vertex sampling.");
         }
         else {
             runtimeDirty |= widget.checkbox("use subspace", mUseSubspace);
             widget.tooltip("use subspace BDPT");
-            mParams.flag |= mUseSubspace ? uint(BDPTFlags::useSubspaceBDPT) : 0;
         }
 
         runtimeDirty |= widget.checkbox("use subspace reservoir", mUseReservoir);
         widget.tooltip("reservoir");
-        mParams.flag |= mUseReservoir ? uint(BDPTFlags::useReservoir) : 0;
+
+        if (widget.dropdown("Light vertex sort", kLightVertexSortList, reinterpret_cast<uint32_t&>(mLightVertexSort)))
+        {
+            // The sort is recreated in prepareResources().
+            mpSortPass = nullptr;
+        }
+        widget.tooltip("Sort used to order the light vertices by Morton code before building the light vertex tree.");
+
+        dirty |= widget.checkbox("Packed light vertices", mStaticParams.usePackedVertexInfo);
+        widget.tooltip("Store light vertices quantized (octahedral directions, fp16 throughput and pdfs).\n\n"
+            "This reduces the light vertex record from 88 to 56 bytes at a small loss of precision.");
+
+        dirty |= widget.checkbox("Packed sample data", mStaticParams.usePackedSampleData);
+        widget.tooltip("Store the subspace reservoirs, sample pairs and gather points in compact formats "
+            "(octahedral normals, fp16 radiance and shared-exponent positions relative to the scene bounds).\n\n"
+            "This reduces the reservoir and sample pair textures from 64 to 40 bytes and the gather points from 52 to 32 bytes per texel.");
+
+        widget.var("Camera tile size", mCameraTileSize, 0u, kMaxFrameDimension);
+        widget.tooltip("Trace camera paths in square tiles of this size (0 = full frame).\n\n"
+            "Per-vertex storage is sized for a single tile, which bounds the memory use for 4K/8K renders. "
+            "Large frames are tiled automatically if the storage would exceed its size limit.");
+
+        runtimeDirty |= widget.var("Log subspace size", mParams.logSubspaceSize, 1u, kMaxLogSubspaceSize);
+        widget.tooltip("Log2 of the subspace weight matrix dimension.\n\n"
+            "Changing it resets the accumulated subspace weights.");
+
+        runtimeDirty |= widget.var("Light path cache fraction", mLightPathCacheFraction, 1.f / kMaxLightPathSlices, 1.f, 1.f / kMaxLightPathSlices);
+        widget.tooltip("Fraction of the light paths retraced per frame (1 = retrace all).\n\n"
+            "Below 1 the light paths are split into slices of rows and the light vertices of the other slices are reused from earlier frames. "
+            "The cache is invalidated on any scene change that is not a camera change. Use for static scenes only.");
+        if (uint32_t sliceCount = getLightPathSliceCount(); sliceCount > 1) widget.text(fmt::format("Light path slices: {}", sliceCount));
+
+        if (widget.checkbox("Frame-time governor", mUseFrameTimeGovernor))
+        {
+            mFrameTimeGovernor.reset(mLightPathBudget);
+            if (mUseFrameTimeGovernor) Profiler::instance().setEnabled(true);
+        }
+        widget.tooltip("Scale the number of light paths and the merge radius between frames to reach a target GPU time of the BDPT stages.\n\n"
+            "The merge radius is scaled by 1/sqrt(budget) to keep the number of light vertices within the radius constant. "
+            "The governor is driven by the stage timings, so it enables the profiler.");
+        if (mUseFrameTimeGovernor)
+        {
+            auto options = mFrameTimeGovernor.getOptions();
+            if (widget.var("Target frame time (ms)", options.targetFrameTime, 1.f, 1000.f, 0.5f)) mFrameTimeGovernor.setOptions(options);
+        }
+        else
+        {
+            runtimeDirty |= widget.var("Light path budget", mLightPathBudget, mFrameTimeGovernor.getOptions().minBudget, 1.f, 1.f / mStaticParams.lightPassHeight);
+            widget.tooltip("Fraction of the light paths traced per frame.");
+        }
+        widget.text(fmt::format("Light paths: {} ({} rows)", mParams.lightPathCount, mParams.lightPathCount / mStaticParams.lightPassWidth));
     }
 
     
@@ -981,7 +1418,28 @@ bool BDPT::renderRenderingUI(Gui::Widgets& widget)
     {
         runtimeDirty |= widget.checkbox("Spatial reuse", spatialReuse);
         widget.tooltip("Enable spatial reuse.");
-        mParams.flag |= spatialReuse ? uint(BDPTFlags::spatialReuse) : 0;
+    }
+
+    if (auto group = widget.group("Photon acceleration structure"))
+    {
+        widget.dropdown("Build preference", kPhotonASBuildPreferenceList, reinterpret_cast<uint32_t&>(mPhotonASOptions.buildPreference));
+        widget.tooltip("Trade-off between build time, trace time and memory of the hit point BLAS.");
+
+        widget.checkbox("Allow refit", mPhotonASOptions.allowRefit);
+        widget.tooltip("Refit the BLAS in place between full rebuilds. Refitting is cheaper than a rebuild, "
+            "but the BLAS gets slower to trace as the hit points move away from the last rebuild.");
+        if (mPhotonASOptions.allowRefit)
+        {
+            widget.var("Rebuild interval", mPhotonASOptions.rebuildInterval, 1u, kMaxPhotonASRebuildInterval);
+            widget.tooltip("Number of builds per full rebuild.");
+        }
+
+        widget.checkbox("Use compaction", mPhotonASOptions.useCompaction);
+        widget.tooltip("Compact the BLAS after each full rebuild. This reduces its memory, "
+            "but reading back the compacted size waits for the GPU on every full rebuild.");
+
+        if (mpPhotonAS) mpPhotonAS->renderStatsUI(group);
+        else widget.text("No hit point AABBs are produced.");
     }
 
     if (auto group = widget.group("RTXDI"))
@@ -1059,6 +1517,10 @@ bool BDPT::renderDebugUI(Gui::Widgets& widget)
         }
 
         mpPixelDebug->renderUI(group);
+
+        if (group.button("Validate light vertex tree")) mValidateLightVertexTree = true;
+        group.tooltip("Compares the next light vertex tree built on the GPU against a CPU build and logs the result. This stalls the GPU.\n\n"
+            "The light vertex hash grid is validated as well if it is used for vertex merging.");
     }
 
     return dirty;
@@ -1070,6 +1532,16 @@ void BDPT::renderStatsUI(Gui::Widgets& widget)
     {
         // Show ray stats
         mpPixelStats->renderUI(g);
+
+        if (mpLightVertexCountReadback)
+        {
+            g.text("Light vertices: " + std::to_string(mLightVertexCount) + " (" + std::to_string(mpLightVertexCountReadback->getLatency()) + " frames delayed)");
+        }
+    }
+
+    if (auto g = widget.group("Stage timings"))
+    {
+        mStageTimings.renderUI(g);
     }
 }
 
@@ -1150,6 +1622,21 @@ bool BDPT::beginFrame(RenderContext* pRenderContext, const RenderData& renderDat
     prepareRTXDI(pRenderContext);
     if (mpRTXDI) mpRTXDI->beginFrame(pRenderContext, mParams.frameDim);
 
+    // The cached light vertices don't depend on the camera. Any other scene or option change invalidates them.
+    const auto kCameraUpdates = Scene::UpdateFlags::CameraMoved | Scene::UpdateFlags::CameraPropertiesChanged | Scene::UpdateFlags::CameraSwitched;
+    if (is_set(mpScene->getUpdates(), ~kCameraUpdates) || mOptionsChanged || lightingChanged) mLightPathCacheValid = false;
+
+    // Set the light path count of this frame from the budget. Cached slices traced with a different count are retraced.
+    const uint32_t lightPathCount = getLightPassRowCount() * mStaticParams.lightPassWidth;
+    if (lightPathCount != mParams.lightPathCount) mLightPathCacheValid = false;
+    mParams.lightPathCount = lightPathCount;
+
+    // The connection and reuse flags are set from the options each frame, so that they don't depend on the UI.
+    mParams.flag = getFlags();
+
+    // The accumulated pixel moments are only valid while the accumulated image is.
+    if (mpScene->getUpdates() != Scene::UpdateFlags::None || mOptionsChanged || lightingChanged) mAdaptiveSamplerReset = true;
+
     // Update refresh flag if changes that affect the output have occured.
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged || lightingChanged)
@@ -1169,8 +1656,10 @@ bool BDPT::beginFrame(RenderContext* pRenderContext, const RenderData& renderDat
         mRecompile = true;
     }
 
-    // Check if fixed sample count should be used. When the sample count input is connected we load the count from there instead.
-    mFixedSampleCount = renderData[kInputSampleCount] == nullptr;
+    // Check if fixed sample count should be used. When the sample count input is connected or adaptive sampling is enabled we load the count from there instead.
+    const bool fixedSampleCount = renderData[kInputSampleCount] == nullptr && !mAdaptiveSampling;
+    if (fixedSampleCount != mFixedSampleCount) mRecompile = true;
+    mFixedSampleCount = fixedSampleCount;
     /*
     // Check if guide data should be generated.
     mOutputGuideData = renderData[kOutputAlbedo] != nullptr || renderData[kOutputSpecularAlbedo] != nullptr
@@ -1433,6 +1922,9 @@ void BDPT::updatePrograms()
     //mpMergePass->setVars(nullptr);
     //mpCullingPass->setVars(nullptr);
 
+    // The light vertex record layout may have changed.
+    mpLightVertexCache = nullptr;
+
     mVarsChanged = true;
     mRecompile = false;
 }
@@ -1463,8 +1955,15 @@ Program::DefineList BDPT::StaticParams::getDefines(const BDPT& owner) const
     defines.add("MIS_POWER_EXPONENT", std::to_string(misPowerExponent));
     defines.add("LIGHT_PASS_WIDTH", std::to_string(lightPassWidth));
     defines.add("LIGHT_PASS_HEIGHT", std::to_string(lightPassHeight));
+    // The light pass slices can extend past the last row, but never double the light vertex count.
+    const uint64_t maxLightVertexCount = 2ull * lightPassWidth * lightPassHeight * maxSurfaceBounces;
+    uint32_t lightVertexIndexBits = 0;
+    while ((1ull << lightVertexIndexBits) < maxLightVertexCount) lightVertexIndexBits++;
+    defines.add("LIGHT_VERTEX_INDEX_BITS", std::to_string(lightVertexIndexBits));
     //defines.add("CANDIDATE_NUMBER", std::to_string(candidateNumber));
-    defines.add("LOG_SUBSPACE_SIZE", std::to_string(logSubspaceSize));
+    defines.add("USE_PACKED_VERTEX_INFO", usePackedVertexInfo ? "1" : "0");
+    defines.add("USE_PACKED_SAMPLE_DATA", usePackedSampleData ? "1" : "0");
+    defines.add("VERTEX_MERGE_STRUCTURE", std::to_string((uint32_t)vertexMergeStructure));
 
     // Sampling utilities configuration.
     FALCOR_ASSERT(owner.mpSampleGenerator);
@@ -1510,6 +2009,7 @@ BDPT::TracePass::TracePass(const std::string& name, const std::string& passDefin
     desc.setMaxPayloadSize(160); // This is conservative but the required minimum is 140 bytes.
     desc.setMaxAttributeSize(pScene->getRaytracingMaxAttributeSize());
     desc.setMaxTraceRecursionDepth(3);
+    desc.useKernelCache(true);
     if (!pScene->hasProceduralGeometry()) desc.setPipelineFlags(RtPipelineFlags::SkipProceduralPrimitives);
 
     // Create ray tracing binding table.
@@ -1609,6 +2109,35 @@ void BDPT::prepareResources(RenderContext* pRenderContext, const RenderData& ren
         }
     }
     */
+
+    // Allocate output sample offset buffer if needed.
+    // The path generation pass stores the output offset to where the samples for each pixel are stored consecutively.
+    if (!mFixedSampleCount)
+    {
+        if (!mpSampleOffset || mpSampleOffset->getWidth() != mParams.frameDim.x || mpSampleOffset->getHeight() != mParams.frameDim.y)
+        {
+            FALCOR_ASSERT(kScreenTileDim.x * kScreenTileDim.y * kMaxSamplesPerPixel <= (1u << 16));
+            mpSampleOffset = Texture::create2D(mParams.frameDim.x, mParams.frameDim.y, ResourceFormat::R16Uint, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            mVarsChanged = true;
+        }
+    }
+
+    // Create the adaptive sampler for the frame size. After a reset all pixels take the average sample count.
+    if (mAdaptiveSampling)
+    {
+        if (!mpAdaptiveSampler || mpAdaptiveSampler->getFrameDim() != mParams.frameDim)
+        {
+            mpAdaptiveSampler = std::make_unique<AdaptiveSampler>(mParams.frameDim);
+            mAdaptiveSamplerReset = true;
+        }
+        if (mAdaptiveSamplerReset) mpAdaptiveSampler->reset(pRenderContext, mAdaptiveSamplingOptions);
+        mAdaptiveSamplerReset = false;
+    }
+    else
+    {
+        mpAdaptiveSampler = nullptr;
+    }
+
     auto var = mpReflectTypes->getRootVar();
     /*
     // Allocate per-sample buffers.
@@ -1622,17 +2151,73 @@ void BDPT::prepareResources(RenderContext* pRenderContext, const RenderData& ren
         }
     }
     */
-    //TODO: change height
-    uint32_t lightVertexElementCount = mStaticParams.lightPassWidth * mStaticParams.lightPassHeight * mStaticParams.maxSurfaceBounces;
-    uint32_t cameraVertexElementCount = kMaxFrameDimension * kMaxFrameDimensionY * mStaticParams.maxSurfaceBounces;
-    if (!mpLightPathVertexBuffer) mpLightPathVertexBuffer = Buffer::createStructured(var["LightPathsVertexsBuffer"], lightVertexElementCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
-    if (!mpLightPathsIndexBuffer) mpLightPathsIndexBuffer = Buffer::createStructured(var["LightPathsIndexBuffer"], lightVertexElementCount);
-    if (!mpLightPathsVertexsPositionBuffer) mpLightPathsVertexsPositionBuffer = Buffer::createStructured(var["LightPathsVertexsPositionBuffer"], lightVertexElementCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+    // Per-vertex storage is sized from the light pass dimensions, the camera pass dimensions (the frame or a
+    // single tile) and the bounce limit. The buffers grow on demand and are only shrunk when recreated.
+    const uint2 cameraPassDim = getCameraPassDim();
+    // With the light path cache, the light pass is traced in slices of equal height, which may extend past the last row.
+    const uint32_t lightPathSliceCount = getLightPathSliceCount();
+    const uint32_t lightPathSliceHeight = div_round_up(mStaticParams.lightPassHeight, lightPathSliceCount);
+    const uint32_t lightPathSliceVertexCount = mStaticParams.lightPassWidth * lightPathSliceHeight * mStaticParams.maxSurfaceBounces;
+    uint32_t lightVertexElementCount = lightPathSliceVertexCount * lightPathSliceCount;
+    uint32_t cameraVertexElementCount = cameraPassDim.x * cameraPassDim.y * mStaticParams.maxSurfaceBounces;
+    // The light vertex record size depends on usePackedVertexInfo.
+    uint32_t lightVertexStructSize = var["LightPathsVertexsBuffer"].getType()->unwrapArray()->asResourceType()->getStructType()->getByteSize();
+    if (!mpLightPathVertexBuffer || mpLightPathVertexBuffer->getStructSize() != lightVertexStructSize || mpLightPathVertexBuffer->getElementCount() < lightVertexElementCount)
+    {
+        mpLightPathVertexBuffer = Buffer::createStructured(var["LightPathsVertexsBuffer"], lightVertexElementCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mVarsChanged = true;
+    }
+    if (!mpLightPathsIndexBuffer || mpLightPathsIndexBuffer->getElementCount() < lightVertexElementCount)
+    {
+        mpLightPathsIndexBuffer = Buffer::createStructured(var["LightPathsIndexBuffer"], lightVertexElementCount);
+        mpLightPathsVertexsPositionBuffer = Buffer::createStructured(var["LightPathsVertexsPositionBuffer"], lightVertexElementCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        // The sort and the tree builder hold references to the old buffers.
+        mpSortPass = nullptr;
+        mpTreeBuilder = nullptr;
+        mpHashGridBuilder = nullptr;
+        mpLightVertexCache = nullptr;
+        mVarsChanged = true;
+    }
     //if (!mpCameraPathsVertexsReservoirBuffer) mpCameraPathsVertexsReservoirBuffer = Buffer::createStructured(var["CameraPathsVertexsReservoirBuffer"], cameraVertexElementCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     //if (!mpDstCameraPathsVertexsReservoirBuffer) mpDstCameraPathsVertexsReservoirBuffer = Buffer::createStructured(var["DstCameraPathsVertexsReservoirBuffer"], cameraVertexElementCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
-    if (!mpOutput) mpOutput = Texture::create2D(mParams.frameDim.x, mParams.frameDim.y, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+    if (!mpOutput || mpOutput->getWidth() != mParams.frameDim.x || mpOutput->getHeight() != mParams.frameDim.y)
+    {
+        mpOutput = Texture::create2D(mParams.frameDim.x, mParams.frameDim.y, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+        mVarsChanged = true;
+    }
 
-    uint subspaceSize = 1 << mStaticParams.logSubspaceSize;
+    uint subspaceSize = 1 << mParams.logSubspaceSize;
+    if (mpSubspaceWeight[0] && mpSubspaceWeight[0]->getWidth() != subspaceSize)
+    {
+        // The subspace size was changed at runtime. Drop the matrices and the accumulated history, they are recreated below.
+        for (auto& pTex : mpSubspaceWeight) pTex = nullptr;
+        for (auto& pTex : mpSubspaceCount) pTex = nullptr;
+        mpSubspaceSecondaryMoment = nullptr;
+        mpPrefixOfWeight = nullptr;
+        mpPrefixOfCount = nullptr;
+        mpPrefixOfSecondaryMoment = nullptr;
+        mpSumOfWeight = nullptr;
+        mpSumOfCount = nullptr;
+        mpSumOfSecondaryMoment = nullptr;
+        mpMaxVariance = nullptr;
+        mpSubspaceReservoir = nullptr;
+        mVarsChanged = true;
+    }
+    if (!mpSubspaceDirtyRows) {
+        // Rows of the subspace matrix that received samples this frame, as a bitmask set by the camera pass and as a compact list of row indices.
+        const uint32_t maxSubspaceSize = 1u << kMaxLogSubspaceSize;
+        mpSubspaceDirtyRowMask = Buffer::createStructured(sizeof(uint32_t), maxSubspaceSize / 32, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpSubspaceDirtyRows = Buffer::createStructured(sizeof(uint32_t), maxSubspaceSize, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpSubspaceDispatchArgs = Buffer::create(6 * sizeof(uint32_t), Resource::BindFlags::UnorderedAccess | Resource::BindFlags::IndirectArg);
+        pRenderContext->clearUAV(mpSubspaceDirtyRowMask->getUAV().get(), zero4);
+        for (auto pPass : { mpCompactRowsPass, mpMergePass, mpPrefixSumPass })
+        {
+            pPass["dirtyRowMask"] = mpSubspaceDirtyRowMask;
+            pPass["dirtyRows"] = mpSubspaceDirtyRows;
+            pPass["dispatchArgs"] = mpSubspaceDispatchArgs;
+        }
+        mVarsChanged = true;
+    }
     if (!mpSubspaceWeight[0]) {
         mpSubspaceWeight[0] = Texture::create2D(subspaceSize, subspaceSize, ResourceFormat::R32Uint, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
         mpMergePass["subspaceWeight"] = mpSubspaceWeight[0];
@@ -1674,9 +2259,10 @@ void BDPT::prepareResources(RenderContext* pRenderContext, const RenderData& ren
         mpPrefixSumPass["sumCount"] = mpSumOfCount;
     }
 
-    if (!mpSubspaceReservoir) {
-        mpSubspaceReservoir = std::make_shared<subspaceReservoir>(subspaceSize);
+    if (!mpSubspaceReservoir || mpSubspaceReservoir->packed != mStaticParams.usePackedSampleData) {
+        mpSubspaceReservoir = std::make_shared<subspaceReservoir>(subspaceSize, mStaticParams.usePackedSampleData);
         mpSubspaceReservoir->clear(pRenderContext);
+        mVarsChanged = true;
     }
     if (!mpSubspaceSecondaryMoment) {
         mpSubspaceSecondaryMoment = Texture::create2D(subspaceSize, subspaceSize, ResourceFormat::R32Uint, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
@@ -1708,7 +2294,7 @@ void BDPT::prepareResources(RenderContext* pRenderContext, const RenderData& ren
         mpCausticBuffers.maxSize = lightVertexElementCount;
         if (!mpCausticBuffers.infoFlux) mpCausticBuffers.infoFlux = Buffer::createStructured(sizeof(float4), mpCausticBuffers.maxSize);
         if (!mpCausticBuffers.infoDir) mpCausticBuffers.infoDir = Buffer::createStructured(sizeof(float4), mpCausticBuffers.maxSize, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
-        if (!mpCausticBuffers.aabb) mpCausticBuffers.aabb = Buffer::createStructured(sizeof(D3D12_RAYTRACING_AABB), mpCausticBuffers.maxSize);
+        if (!mpCausticBuffers.aabb) mpCausticBuffers.aabb = Buffer::createStructured(sizeof(AABB), mpCausticBuffers.maxSize);
     }
 
     // Global
@@ -1716,19 +2302,54 @@ void BDPT::prepareResources(RenderContext* pRenderContext, const RenderData& ren
         mpGlobalBuffers.maxSize = lightVertexElementCount;
         if (!mpGlobalBuffers.infoFlux) mpGlobalBuffers.infoFlux = Buffer::createStructured(sizeof(float4), mpGlobalBuffers.maxSize);
         if (!mpGlobalBuffers.infoDir) mpGlobalBuffers.infoDir = Buffer::createStructured(sizeof(float4), mpGlobalBuffers.maxSize, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
-        if (!mpGlobalBuffers.aabb) mpGlobalBuffers.aabb = Buffer::createStructured(sizeof(D3D12_RAYTRACING_AABB), mpGlobalBuffers.maxSize);
+        if (!mpGlobalBuffers.aabb) mpGlobalBuffers.aabb = Buffer::createStructured(sizeof(AABB), mpGlobalBuffers.maxSize);
     }
 */
     
-    if (!mpSortPass) mpSortPass = std::make_unique<Bitonic64Sort>(mpLightPathsIndexBuffer, 0);
-    if (!mpTreeBuilder) mpTreeBuilder = std::make_unique<VertexTreeBuilder>(mpLightPathsIndexBuffer, mpLightPathsVertexsPositionBuffer, lightVertexElementCount);
-    
-    if (!mpPrevGatherPoints) mpPrevGatherPoints = std::make_shared<GatherPointInfo>(mParams.frameDim.x, mParams.frameDim.y);
-    if (!mpGatherPoints) mpGatherPoints = std::make_shared<GatherPointInfo>(mParams.frameDim.x, mParams.frameDim.y);
+    if (!mpSortPass)
+    {
+        if (mLightVertexSort == KeyIndexSortType::Radix) mpSortPass = std::make_unique<Radix64Sort>(mpLightPathsIndexBuffer, 0);
+        else mpSortPass = std::make_unique<Bitonic64Sort>(mpLightPathsIndexBuffer, 0);
+        mpSortPass->setCounterBuffer(mpLightPathsIndexBuffer->getUAVCounter());
+    }
+    if (!mpTreeBuilder) mpTreeBuilder = std::make_unique<VertexTreeBuilder>(mpLightPathsIndexBuffer, mpLightPathsVertexsPositionBuffer, mpLightPathsIndexBuffer->getUAVCounter(), lightVertexElementCount);
+    if (mStaticParams.vertexMergeStructure != VertexMergeStructure::HashGrid) mpHashGridBuilder = nullptr;
+    else if (!mpHashGridBuilder)
+    {
+        mpHashGridBuilder = std::make_unique<HashGridBuilder>(mpLightPathsVertexsPositionBuffer, mpLightPathsIndexBuffer->getUAVCounter(), lightVertexElementCount);
+        mVarsChanged = true;
+    }
+    if (mpLightVertexCache && (mpLightVertexCache->getSlotCount() != lightPathSliceCount || mpLightVertexCache->getSlotCapacity() != lightPathSliceVertexCount))
+    {
+        mpLightVertexCache = nullptr;
+    }
+    if (lightPathSliceCount > 1 && !mpLightVertexCache)
+    {
+        Program::Desc desc;
+        desc.addShaderModules(mpScene->getShaderModules());
+        desc.addTypeConformances(mpScene->getMaterialSystem()->getTypeConformances());
+        desc.setShaderModel(kShaderModel);
+        mpLightVertexCache = std::make_unique<LightVertexCache>(desc, mStaticParams.getDefines(*this), mpLightPathVertexBuffer, mpLightPathsIndexBuffer, mpLightPathsVertexsPositionBuffer, lightPathSliceCount, lightPathSliceVertexCount);
+        mLightPathCacheValid = false;
+    }
+    else if (lightPathSliceCount == 1) mpLightVertexCache = nullptr;
+    if (!mpLightVertexCountReadback) mpLightVertexCountReadback = GpuReadbackRing::create(kLightVertexCountReadbackLatency, sizeof(uint32_t));
     
-    if (!mpPairs) mpPairs = std::make_shared<SamplePairs>(cameraVertexElementCount);
-    if (!mpPrevPairs) mpPrevPairs = std::make_shared<SamplePairs>(cameraVertexElementCount);
-    //if (!mpAABB) mpAABB = Buffer::createStructured(sizeof(D3D12_RAYTRACING_AABB), cameraVertexElementCount);
+    // Gather points are reprojected between frames and therefore always cover the full frame.
+    if (!mpGatherPoints || mpGatherPoints->mpFluxAndNumber->getWidth() != mParams.frameDim.x || mpGatherPoints->mpFluxAndNumber->getHeight() != mParams.frameDim.y || mpGatherPoints->packed != mStaticParams.usePackedSampleData)
+    {
+        mpPrevGatherPoints = std::make_shared<GatherPointInfo>(mParams.frameDim.x, mParams.frameDim.y, mStaticParams.usePackedSampleData);
+        mpGatherPoints = std::make_shared<GatherPointInfo>(mParams.frameDim.x, mParams.frameDim.y, mStaticParams.usePackedSampleData);
+        mVarsChanged = true;
+    }
+
+    if (!mpPairs || mpPairs->capacity < cameraVertexElementCount || mpPairs->packed != mStaticParams.usePackedSampleData)
+    {
+        mpPairs = std::make_shared<SamplePairs>(cameraVertexElementCount, mStaticParams.usePackedSampleData);
+        mpPrevPairs = std::make_shared<SamplePairs>(cameraVertexElementCount, mStaticParams.usePackedSampleData);
+        mVarsChanged = true;
+    }
+    //if (!mpAABB) mpAABB = Buffer::createStructured(sizeof(AABB), cameraVertexElementCount);
 
     //if (!mpPathPos) mpPathPos = Texture::create3D(mParams.frameDim.x, mParams.frameDim.y, mStaticParams.maxSurfaceBounces, ResourceFormat::RGBA32Uint, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
     //if (!mpPathRadiance) mpPathRadiance = Texture::create3D(mParams.frameDim.x, mParams.frameDim.y, mStaticParams.maxSurfaceBounces, ResourceFormat::RGBA32Float, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
@@ -1772,18 +2393,17 @@ void BDPT::preparePathTracer(const RenderData& renderData)
     var["corner"] = mpScene->getSceneBounds().minPoint;
     var["dimension"] = dimension;
     radius = 0.005 * sqrt(dimension.x * dimension.x + dimension.y * dimension.y + dimension.z * dimension.z);
+    if (mUseFrameTimeGovernor) radius *= mFrameTimeGovernor.getRadiusScale();
     var["globalRadius"] = radius;
+    if (mpHashGridBuilder)
+    {
+        mpHashGridBuilder->update(radius);
+        var["hashGridCellSize"] = mpHashGridBuilder->getCellSize();
+    }
 
     if (mUseVertexMerge) {
-        var["InputFluxAndNumber"] = mpPrevGatherPoints->mpFluxAndNumber;
-        var["InputNormalAndRadii"] = mpPrevGatherPoints->mpNormalAndRadii;
-        var["InputPosAndNewRadii"] = mpPrevGatherPoints->mpPosAndNewRadii;
-        var["InputIteration"] = mpPrevGatherPoints->mpIteration;
-
-        var["OutputFluxAndNumber"] = mpGatherPoints->mpFluxAndNumber;
-        var["OutputNormalAndRadii"] = mpGatherPoints->mpNormalAndRadii;
-        var["OutputPosAndNewRadii"] = mpGatherPoints->mpPosAndNewRadii;
-        var["OutputIteration"] = mpGatherPoints->mpIteration;
+        mpPrevGatherPoints->bind(var, "Input");
+        mpGatherPoints->bind(var, "Output");
     }
     
     //mpScene->getParameterBlock()->acc
@@ -1792,6 +2412,7 @@ void BDPT::preparePathTracer(const RenderData& renderData)
         var["SubspaceWeight"] = mpSubspaceWeight[0];
         var["prevSubspaceWeight"] = mpSubspaceWeight[1];
         var["SubspaceCount"] = mpSubspaceCount[0];
+        var["SubspaceDirtyRows"] = mpSubspaceDirtyRowMask;
         var["prefixSum"] = mpPrefixOfWeight;
         var["weightSum"] = mpSumOfWeight;
         var["countSum"] = mpSumOfCount;
@@ -1851,6 +2472,17 @@ void BDPT::preparePathTracer(const RenderData& renderData)
     setShaderData(var, renderData);
 }
 
+Texture::SharedPtr BDPT::getSampleCountTexture(const RenderData& renderData) const
+{
+    if (mFixedSampleCount) return nullptr;
+
+    // The adaptive sample count map takes precedence over the sample count input.
+    if (mpAdaptiveSampler) return mpAdaptiveSampler->getSampleCount();
+    auto pSampleCount = renderData.getTexture(kInputSampleCount);
+    if (!pSampleCount) throw RuntimeError("PathTracer: Missing sample count input texture");
+    return pSampleCount;
+}
+
 void BDPT::setShaderData(const ShaderVar& var, const RenderData& renderData, bool useLightSampling) const
 {
     // Bind static resources that don't change per frame.
@@ -1858,13 +2490,20 @@ void BDPT::setShaderData(const ShaderVar& var, const RenderData& renderData, boo
     {
         if (useLightSampling && mpEnvMapSampler) mpEnvMapSampler->setShaderData(var["envMapSampler"]);
 
-        //var["sampleOffset"] = mpSampleOffset; // Can be nullptr
+        var["sampleOffset"] = mpSampleOffset; // Can be nullptr
         //var["sampleColor"] = mpSampleColor;
         var["LightPathsVertexsBuffer"] = mpLightPathVertexBuffer;
         var["LightPathsIndexBuffer"] = mpLightPathsIndexBuffer;
         var["LightPathsVertexsPositionBuffer"] = mpLightPathsVertexsPositionBuffer;
         
         var["nodes"] = mpTreeBuilder->getTree();
+        var["lightTreeParams"] = mpTreeBuilder->getTreeParams();
+        if (mpHashGridBuilder)
+        {
+            var["hashGridHeads"] = mpHashGridBuilder->getHeads();
+            var["hashGridNext"] = mpHashGridBuilder->getNext();
+            var["hashGridBucketCount"] = mpHashGridBuilder->getBucketCount();
+        }
         //var["CameraPathsVertexsReservoirBuffer"] = mpCameraPathsVertexsReservoirBuffer;
         //var["CameraPathsIndexBuffer"] = mpCameraPathsIndexBuffer;
         //var["MCounter"] = mpMCounter;
@@ -1881,12 +2520,7 @@ void BDPT::setShaderData(const ShaderVar& var, const RenderData& renderData, boo
         if (!pViewDir) logWarning("Depth-of-field requires the '{}' input. Expect incorrect rendering.", kInputViewDir);
     }
 
-    Texture::SharedPtr pSampleCount;
-    if (!mFixedSampleCount)
-    {
-        pSampleCount = renderData.getTexture(kInputSampleCount);
-        if (!pSampleCount) throw RuntimeError("PathTracer: Missing sample count input texture");
-    }
+    Texture::SharedPtr pSampleCount = getSampleCountTexture(renderData);
 
     var["params"].setBlob(mParams);
     var["vbuffer"] = renderData.getTexture(kInputVBuffer);
@@ -1960,11 +2594,26 @@ void BDPT::spatiotemporalReuse(RenderContext* pRenderContext, const RenderData&
 }
 
 void BDPT::buildSubspaceWeightMatrix(RenderContext* pRenderContext, const RenderData& renderData) {
+    FALCOR_PROFILE("buildSubspaceWeightMatrix");
+
+    const uint32_t subspaceSize = 1u << mParams.logSubspaceSize;
+
+    // Compact the rows touched by the camera pass into a list and the dispatch arguments of the merge and scan passes.
+    // Merge runs 64-wide groups along a row, scan runs one group per row. The y counts are filled in by compactRows.
+    const uint32_t dispatchArgs[6] = { div_round_up(subspaceSize, 64u), 0, 1, 1, 0, 1 };
+    mpSubspaceDispatchArgs->setBlob(dispatchArgs, 0, sizeof(dispatchArgs));
+    mpCompactRowsPass["CB"]["subspaceSize"] = subspaceSize;
+    mpCompactRowsPass->execute(pRenderContext, subspaceSize, 1, 1);
+    pRenderContext->uavBarrier(mpSubspaceDirtyRows.get());
+    pRenderContext->uavBarrier(mpSubspaceDispatchArgs.get());
+    pRenderContext->clearUAV(mpSubspaceDirtyRowMask->getUAV().get(), zero4);
+
     //mpMergePass["output"] = renderData.getTexture(kOutputColor);
     mpMergePass["CB"]["frameCount"] = 0;// mParams.frameCount;
-    uint groupSize = 1 << (mStaticParams.logSubspaceSize - 1);
-    uint texSize = groupSize << 1;
-    mpMergePass->execute(pRenderContext, { texSize,texSize,1u });
+    mpMergePass["CB"]["subspaceSize"] = subspaceSize;
+    mpMergePass->executeIndirect(pRenderContext, mpSubspaceDispatchArgs.get(), 0);
+    pRenderContext->uavBarrier(mpSubspaceWeight[0].get());
+    pRenderContext->uavBarrier(mpSubspaceCount[0].get());
     pRenderContext->uavBarrier(mpSubspaceWeight[1].get());
     pRenderContext->uavBarrier(mpSubspaceCount[1].get());
     pRenderContext->uavBarrier(mpSubspaceSecondaryMoment.get());
@@ -1972,7 +2621,8 @@ void BDPT::buildSubspaceWeightMatrix(RenderContext* pRenderContext, const Render
     //mpSubspaceWeightComputeState->setProgram(mpPrefixSumPass);
     //pRenderContext->dispatch(mpSubspaceWeightComputeState.get(), mpPrefixSumVar.get(), { 1024u,1u,1u });
     mpPrefixSumPass["CB"]["frameCount"] = mParams.frameCount;
-    mpPrefixSumPass->execute(pRenderContext, uint3(groupSize, texSize, 1u));
+    mpPrefixSumPass["CB"]["subspaceSize"] = subspaceSize;
+    mpPrefixSumPass->executeIndirect(pRenderContext, mpSubspaceDispatchArgs.get(), 3 * sizeof(uint32_t));
     pRenderContext->uavBarrier(mpPrefixOfWeight.get());
     pRenderContext->uavBarrier(mpSumOfWeight.get());
     pRenderContext->uavBarrier(mpPrefixOfCount.get());
@@ -2007,9 +2657,7 @@ void BDPT::tracePass(RenderContext* pRenderContext, const RenderData& renderData
 
     // Bind the path tracer.
     var["gPathTracer"] = mpPathTracerBlock;
-    bool tlasValid = var["gHitPointAS"].setSrv(mPhotonTlas.pSrv);
-    //mPhotonTlas.pTlas->
-    //logWarning(std::to_string(tlasValid));
+    if (mpPhotonAS) var["gHitPointAS"].setAccelerationStructure(mpPhotonAS->getTlas());
 
     // Full screen dispatch.
     mpScene->raytrace(pRenderContext, tracePass.pProgram.get(), tracePass.pVars, uint3(dim, 1));
@@ -2034,7 +2682,7 @@ void BDPT::resolvePass(RenderContext* pRenderContext, const RenderData& renderDa
     // Bind resources.
     auto var = mpResolvePass->getRootVar()["CB"]["gResolvePass"];
     var["params"].setBlob(mParams);
-    var["sampleCount"] = renderData.getTexture(kInputSampleCount); // Can be nullptr
+    var["sampleCount"] = getSampleCountTexture(renderData); // Can be nullptr
     var["outputColor"] = renderData.getTexture(kOutputColor);
     var["outputAlbedo"] = renderData.getTexture(kOutputAlbedo);
     var["outputSpecularAlbedo"] = renderData.getTexture(kOutputSpecularAlbedo);
@@ -2091,7 +2739,10 @@ void BDPT::endFrame(RenderContext* pRenderContext, const RenderData& renderData)
     copyTexture(renderData.getTexture(kOutputPathLength).get(), mpPixelStats->getPathLengthTexture().get());
 
     if (mpRTXDI) mpRTXDI->endFrame(pRenderContext);
-    //mpLightPathsIndexBuffer->getUAVCounter()->
+
+    // Queue a readback of the light vertex count and pick up the newest one that has completed.
+    mpLightVertexCountReadback->poll(mLightVertexCount);
+    mpLightVertexCountReadback->push(pRenderContext, mpLightPathsIndexBuffer->getUAVCounter().get());
     //uint32_t zero = 0;
     //pRenderContext->clearUAV(mpCameraPathsVertexsReservoirBuffer->getUAV().get(), zero4);
     pRenderContext->clearUAV(mpOutput->getUAV().get(), zero4);
@@ -2101,11 +2752,20 @@ void BDPT::endFrame(RenderContext* pRenderContext, const RenderData& renderData)
         std::swap(mpPrevGatherPoints, mpGatherPoints);
     }
     
-    pRenderContext->clearUAV(mpSubspaceWeight[0]->getUAV().get(), zero4);
-    pRenderContext->clearUAV(mpSubspaceCount[0]->getUAV().get(), zero4);
+    // With subspace BDPT enabled, the merge pass resets the rows it consumed.
+    if (!mUseSubspace)
+    {
+        pRenderContext->clearUAV(mpSubspaceWeight[0]->getUAV().get(), zero4);
+        pRenderContext->clearUAV(mpSubspaceCount[0]->getUAV().get(), zero4);
+        pRenderContext->clearUAV(mpSubspaceDirtyRowMask->getUAV().get(), zero4);
+    }
     //mpGatherPoints->clear(pRenderContext);
     //pRenderContext->clearUAV(mpHashBuffer->getUAV().get(), zero4);
 
+    // Pick up the stage times of the last frame the profiler has resolved.
+    mStageTimings.update(mParams.frameCount);
+    if (mUseFrameTimeGovernor) updateFrameTimeGovernor();
+
     mVarsChanged = false;
     //mpScene->getMesh(0).getTriangleCount
     //logWarning(std::to_string(mpScene-> ));
@@ -36,12 +36,20 @@
 #include "Rendering/Lights/EnvMapSampler.h"
 #include "Rendering/Materials/TexLODTypes.slang"
 #include "Rendering/Utils/PixelStats.h"
+#include "Rendering/Utils/Checkpoint.h"
+#include "Rendering/Utils/FrameTimeGovernor.h"
+#include "Rendering/Utils/ReadbackRing.h"
 #include "Rendering/RTXDI/RTXDI.h"
 #include "Core/API/RtAccelerationStructure.h"
 #include "Core/API/Device.h"
-#include "Core/API/D3D12/D3D12API.h"
 
+#include "AdaptiveSampler.h"
 #include "Bitonic64Sort.h"
+#include "HashGridBuilder.h"
+#include "LightVertexCache.h"
+#include "PhotonAccelerationStructure.h"
+#include "Radix64Sort.h"
+#include "StageTimings.h"
 #include "VertexTreeBuilder.h"
 #include "BDPTParams.slang"
 
@@ -72,6 +80,18 @@ public:
 
     const PixelStats::SharedPtr& getPixelStats() const { return mpPixelStats; }
 
+    /** Write the state learned over the accumulation (subspace weights, gather points, frame count) to a checkpoint file.
+        This waits for the GPU. Call between frames.
+        \param[in] path File path.
+    */
+    void saveCheckpoint(const std::filesystem::path& path);
+
+    /** Read a checkpoint file written by saveCheckpoint(). The state is restored at the start of the next frame.
+        Throws if the file is not a BDPT checkpoint of the current version.
+        \param[in] path File path.
+    */
+    void loadCheckpoint(const std::filesystem::path& path);
+
     static void registerBindings(pybind11::module& m);
 
 private:
@@ -103,6 +123,7 @@ private:
     void updatePrograms();
     void setFrameDim(const uint2 frameDim);
     void prepareResources(RenderContext* pRenderContext, const RenderData& renderData);
+    Texture::SharedPtr getSampleCountTexture(const RenderData& renderData) const;
     void preparePathTracer(const RenderData& renderData);
     void resetLighting();
     void prepareMaterials(RenderContext* pRenderContext);
@@ -117,14 +138,22 @@ private:
     void endFrame(RenderContext* pRenderContext, const RenderData& renderData);
     void generatePaths(RenderContext* pRenderContext, const RenderData& renderData);
     void tracePass(RenderContext* pRenderContext, const RenderData& renderData, TracePass& tracePass, uint2 dim);
+    void traceLightPaths(RenderContext* pRenderContext, const RenderData& renderData);
+    void traceCameraPath(RenderContext* pRenderContext, const RenderData& renderData);
+    uint32_t getLightPathSliceCount() const;
+    uint32_t getLightPassRowCount() const;
+    void updateFrameTimeGovernor();
+    uint2 getCameraPassDim() const;
+    uint32_t getFlags() const;
+    std::vector<std::pair<std::string, uint64_t>> getMemoryUsage() const;
+    std::vector<std::pair<std::string, Texture::SharedPtr>> getCheckpointTextures() const;
+    void restoreCheckpoint(RenderContext* pRenderContext);
     void resolvePass(RenderContext* pRenderContext, const RenderData& renderData);
     void spatiotemporalReuse(RenderContext* pRenderContext, const RenderData& renderData);
     void sortPosition(RenderContext* pRenderContext);
     void prepareAccelerationStructure(RenderContext* pRenderContext);
     void buildAccelerationStructure(RenderContext* pRenderContext);
     void buildSubspaceWeightMatrix(RenderContext* pRenderContext, const RenderData& renderData);
-    double checkTime(RenderContext* pRenderContext);
-    void initTimer() { if (!pGpuTimer) { pGpuTimer = GpuTimer::create(); } }
 
     
 
@@ -137,10 +166,12 @@ private:
         uint32_t    maxDiffuseBounces = 10;                      ///< Max number of diffuse bounces (0 = direct only), up to kMaxBounces.
         uint32_t    maxSpecularBounces = 10;                     ///< Max number of specular bounces (0 = direct only), up to kMaxBounces.
         uint32_t    maxTransmissionBounces = 10;                ///< Max number of transmission bounces (0 = none), up to kMaxBounces.
-        uint32_t    lightPassWidth = 512;                        ///<
-        uint32_t    lightPassHeight = 256;
+        uint32_t    lightPassWidth = 512;                        ///< Width of the light pass. The pass size is the maximum number of light paths per frame.
+        uint32_t    lightPassHeight = 256;                       ///< Height of the light pass. The rows traced per frame are set at runtime by the light path budget.
         uint32_t    cullingHashBufferSizeBytes = 22;
-        uint32_t    logSubspaceSize = 11;
+        bool        usePackedVertexInfo = false;                ///< Store light vertices in the quantized PackedVertexInfo format.
+        bool        usePackedSampleData = false;                ///< Store reservoirs, sample pairs and gather points in the compact PackedSampleData formats.
+        VertexMergeStructure vertexMergeStructure = VertexMergeStructure::Tree; ///< Structure used to find the light vertices to merge.
 
         // Sampling parameters
         uint32_t    sampleGenerator = SAMPLE_GENERATOR_TINY_UNIFORM; ///< Pseudorandom sample generator type.
@@ -172,8 +203,6 @@ private:
     };
 
 
-    //time
-    GpuTimer::SharedPtr pGpuTimer;
     // Configuration
     PathTracerParams                mParams;                    ///< Runtime path tracer parameters.
     StaticParams                    mStaticParams;              ///< Static parameters. These are set as compile-time constants in the shaders.
@@ -183,7 +212,6 @@ private:
     bool                            mEnabled = true;            ///< Switch to enable/disable the path tracer. When disabled the pass outputs are cleared.
     RenderPassHelpers::IOSize       mOutputSizeSelection = RenderPassHelpers::IOSize::Default;  ///< Selected output size.
     uint2                           mFixedOutputSize = { 512, 512 };                            ///< Output size in pixels when 'Fixed' size is selected.
-    std::chrono::time_point<std::chrono::steady_clock>  mCurrentTime;
 
 
     // Internal state
@@ -194,6 +222,10 @@ private:
     RTXDI::SharedPtr                mpRTXDI;                    ///< RTXDI sampler for direct illumination or nullptr if not used.
     PixelStats::SharedPtr           mpPixelStats;               ///< Utility class for collecting pixel stats.
     PixelDebug::SharedPtr           mpPixelDebug;               ///< Utility class for pixel debugging (print in shaders).
+    GpuReadbackRing::SharedPtr      mpLightVertexCountReadback; ///< Delayed readback of the light vertex count, for stats only.
+    uint32_t                        mLightVertexCount = 0;      ///< Light vertex count from a previous frame (see mpLightVertexCountReadback).
+    StageTimings                    mStageTimings;              ///< Per-stage timings read back from the profiler.
+    std::unique_ptr<Checkpoint>     mpPendingCheckpoint;        ///< Checkpoint to restore at the start of the next frame.
 
     ParameterBlock::SharedPtr       mpPathTracerBlock;          ///< Parameter block for the path tracer.
 
@@ -208,10 +240,22 @@ private:
     bool                            s2 = true;
     bool                            t1 = false;
     bool                            spatialReuse = true;
-    bool                            mRebuild = true;
     bool                            mUseVertexMerge = false;
     bool                            mUseSubspace = false;
     bool                            mUseReservoir = false;
+    bool                            mValidateLightVertexTree = false; ///< Validate the light vertex tree against a CPU build on the next frame.
+    KeyIndexSortType                mLightVertexSort = KeyIndexSortType::Bitonic; ///< Sort backend for the light vertex key-index list.
+    uint32_t                        mCameraTileSize = 0;        ///< Tile size in pixels for tracing camera paths, or 0 to trace the full frame in one dispatch.
+    float                           mLightPathCacheFraction = 1.f; ///< Fraction of the light paths retraced per frame. Below 1 the other light vertices are reused from earlier frames.
+    bool                            mLightPathCacheValid = false; ///< True if all slots of the light vertex cache hold vertices of the current scene state.
+    uint32_t                        mLightPathCacheNextSlice = 0; ///< Next light path slice to retrace.
+    float                           mLightPathBudget = 1.f;     ///< Fraction of the light pass traced per frame when the frame-time governor is disabled.
+    bool                            mUseFrameTimeGovernor = false; ///< Scale the light path budget and merge radius to reach a target frame time.
+    FrameTimeGovernor               mFrameTimeGovernor;         ///< Controller of the light path budget, driven by the stage timings.
+    bool                            mAdaptiveSampling = false;  ///< Distribute the camera samples per pixel by the variance of the accumulated frames.
+    AdaptiveSampler::Options        mAdaptiveSamplingOptions;   ///< Options of the adaptive sampler.
+    std::unique_ptr<AdaptiveSampler> mpAdaptiveSampler;         ///< Per-pixel moments and sample counts. Only created in adaptive sampling mode.
+    bool                            mAdaptiveSamplerReset = true; ///< Reset the adaptive sampler at the start of the next frame.
     //bool                            mOutputGuideData = false;   ///< True if guide data should be generated as outputs.
     //bool                            mOutputNRDData = false;     ///< True if NRD diffuse/specular data should be generated as outputs.
     //bool                            mOutputNRDAdditionalData = false;   ///< True if NRD data from delta and residual paths should be generated as designated outputs rather than being included in specular NRD outputs.
@@ -225,6 +269,7 @@ private:
     ComputePass::SharedPtr          mpMergePass;
     //ComputeVars::SharedPtr          mpMergePassVar;
     ComputePass::SharedPtr          mpPrefixSumPass;
+    ComputePass::SharedPtr          mpCompactRowsPass;          ///< Compacts the dirty rows of the subspace matrix for the merge and scan passes.
     //ComputeVars::SharedPtr          mpPrefixSumVar;
     
     //ComputePass::SharedPtr          mpPhotonMappingPass;
@@ -234,8 +279,10 @@ private:
     std::unique_ptr<TracePass>      mpTraceDeltaTransmissionPass;   ///< Delta transmission trace pass (for NRD).
     std::unique_ptr<TracePass>      mpTraceLightPath;           ///< Generate light path (for BDPT).
     std::unique_ptr<TracePass>      mpTraceCameraPath;          ///< Generate camera path (for BDPT).
-    std::unique_ptr<Bitonic64Sort>  mpSortPass;
+    std::unique_ptr<KeyIndexSort>   mpSortPass;                 ///< Sort of the light vertex key-index list.
     std::unique_ptr<VertexTreeBuilder> mpTreeBuilder;
+    std::unique_ptr<HashGridBuilder> mpHashGridBuilder;      ///< Light vertex hash grid. Only created if vertexMergeStructure is HashGrid.
+    std::unique_ptr<LightVertexCache> mpLightVertexCache;   ///< Persistent light vertices. Only created if lightPathCacheFraction is below 1.
 
     Texture::SharedPtr              mpSampleOffset;             ///< Output offset into per-sample buffers to where the samples for each pixel are stored (the offset is relative the start of the tile). Only used with non-fixed sample count.
     Buffer::SharedPtr               mpSampleColor;              ///< Compact per-sample color buffer. This is used only if spp > 1.
@@ -256,34 +303,51 @@ private:
     Texture::SharedPtr              mpSumOfCount;
     Texture::SharedPtr              mpSumOfSecondaryMoment;
     Texture::SharedPtr              mpMaxVariance;
+    Buffer::SharedPtr               mpSubspaceDirtyRowMask;     ///< One bit per subspace matrix row that received samples this frame.
+    Buffer::SharedPtr               mpSubspaceDirtyRows;        ///< Compact list of the dirty rows.
+    Buffer::SharedPtr               mpSubspaceDispatchArgs;     ///< Indirect dispatch arguments of the merge (offset 0) and scan (offset 12) passes.
   
 
+    /** Sample texture formats of the reservoirs and sample pairs.
+        The packed formats store the normals in the position textures (see PackedSampleData), so there is no normal texture.
+    */
+    static ResourceFormat getSamplePointFormat(bool packed) { return packed ? ResourceFormat::RGBA32Uint : ResourceFormat::RGBA32Float; }
+    static ResourceFormat getSampleRadianceFormat(bool packed) { return packed ? ResourceFormat::RG32Uint : ResourceFormat::RGBA32Float; }
+
+    static void clearSampleTexture(RenderContext* pRenderContext, const Texture::SharedPtr& pTexture) {
+        if (!pTexture) return;
+        if (isIntegerFormat(pTexture->getFormat())) pRenderContext->clearTexture(pTexture.get(), uint4(0));
+        else pRenderContext->clearTexture(pTexture.get(), float4(0));
+    }
+
     struct subspaceReservoir {
         Texture::SharedPtr          samplePosition;
         Texture::SharedPtr          hitPointPosition;
-        Texture::SharedPtr          normal;
+        Texture::SharedPtr          normal;             ///< Not used with packed sample data.
         Texture::SharedPtr          radiance;
 
         Texture::SharedPtr          reservoir;
 
         Texture::SharedPtr          signal;
 
-        subspaceReservoir(uint size) {
+        bool                        packed = false;     ///< True if the sample textures use the PackedSampleData formats.
+
+        subspaceReservoir(uint size, bool packed) : packed(packed) {
             uint width = size;
             uint height = size;
-            samplePosition = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            hitPointPosition = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            normal = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            radiance = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            samplePosition = Texture::create2D(width, height, getSamplePointFormat(packed), 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            hitPointPosition = Texture::create2D(width, height, getSamplePointFormat(packed), 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            if (!packed) normal = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            radiance = Texture::create2D(width, height, getSampleRadianceFormat(packed), 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
             reservoir = Texture::create2D(width, height, ResourceFormat::RG32Uint, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
             signal = Texture::create2D(width, height, ResourceFormat::R32Uint, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
         }
 
         void clear(RenderContext* pRenderContext) {
-            pRenderContext->clearTexture(samplePosition.get(), float4(0));
-            pRenderContext->clearTexture(hitPointPosition.get(), float4(0));
-            pRenderContext->clearTexture(normal.get(), float4(0));
-            pRenderContext->clearTexture(radiance.get(), float4(0));
+            clearSampleTexture(pRenderContext, samplePosition);
+            clearSampleTexture(pRenderContext, hitPointPosition);
+            clearSampleTexture(pRenderContext, normal);
+            clearSampleTexture(pRenderContext, radiance);
             pRenderContext->clearTexture(reservoir.get(), uint4(0));
             pRenderContext->clearTexture(signal.get(), uint4(0xffffffff));
         }
@@ -291,7 +355,7 @@ private:
         void uavBarrier(RenderContext* pRenderContext) {
             pRenderContext->uavBarrier(samplePosition.get());
             pRenderContext->uavBarrier(hitPointPosition.get());
-            pRenderContext->uavBarrier(normal.get());
+            if (normal) pRenderContext->uavBarrier(normal.get());
             pRenderContext->uavBarrier(radiance.get());
             pRenderContext->uavBarrier(reservoir.get());
             pRenderContext->uavBarrier(signal.get());
@@ -300,7 +364,7 @@ private:
         void bind(const ShaderVar& var) {
             var["samplePosition"] = samplePosition;
             var["hitPointPosition"] = hitPointPosition;
-            var["normal"] = normal;
+            if (normal) var["normal"] = normal;
             var["radiance"] = radiance;
             var["Reservoir"] = reservoir;
             var["ReservoirSignal"] = signal;
@@ -317,28 +381,32 @@ private:
 
         Texture::SharedPtr          reservoir;
 
-        SamplePairs(uint maxNum) {
+        uint                        capacity = 0;   ///< Number of sample pairs that fit in the textures.
+        bool                        packed = false; ///< True if the sample textures use the PackedSampleData formats.
+
+        SamplePairs(uint maxNum, bool packed) : packed(packed) {
             uint width = 2048;
             uint height = maxNum / width + 1;
-            samplePosition      = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            hitPointPosition    = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            normal              = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            radiance            = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            capacity = width * height;
+            samplePosition      = Texture::create2D(width, height, getSamplePointFormat(packed), 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            hitPointPosition    = Texture::create2D(width, height, getSamplePointFormat(packed), 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            if (!packed) normal = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            radiance            = Texture::create2D(width, height, getSampleRadianceFormat(packed), 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
             reservoir           = Texture::create2D(width, height, ResourceFormat::RGBA32Uint, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
         }
 
         void clear(RenderContext* pRenderContext) {
-            pRenderContext->clearTexture(samplePosition.get(), float4(0));
-            pRenderContext->clearTexture(hitPointPosition.get(), float4(0));
-            pRenderContext->clearTexture(normal.get(), float4(0));
-            pRenderContext->clearTexture(radiance.get(), float4(0));
+            clearSampleTexture(pRenderContext, samplePosition);
+            clearSampleTexture(pRenderContext, hitPointPosition);
+            clearSampleTexture(pRenderContext, normal);
+            clearSampleTexture(pRenderContext, radiance);
             pRenderContext->clearTexture(reservoir.get(), uint4(0));
         }
 
         void uavBarrier(RenderContext* pRenderContext) {
             pRenderContext->uavBarrier(samplePosition.get());
             pRenderContext->uavBarrier(hitPointPosition.get());
-            pRenderContext->uavBarrier(normal.get());
+            if (normal) pRenderContext->uavBarrier(normal.get());
             pRenderContext->uavBarrier(radiance.get());
             pRenderContext->uavBarrier(reservoir.get());
         }
@@ -351,32 +419,48 @@ private:
     //PPM
     float radius = 0.01f;
 
+    /** Gather points of the temporal progressive photon mapping.
+        With packed sample data the gather point is stored as PackedGatherPoint in mpFluxAndNumber (fluxAndCount),
+        mpPosAndNewRadii (posAndNormal) and mpNormalAndRadii (radii only), and the iteration texture is not allocated.
+    */
     struct GatherPointInfo
     {
         Texture::SharedPtr mpFluxAndNumber;
         Texture::SharedPtr mpNormalAndRadii;
         Texture::SharedPtr mpPosAndNewRadii;
         Texture::SharedPtr mpIteration;
-
-        GatherPointInfo(uint width, uint height) {
-            mpFluxAndNumber = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            mpNormalAndRadii = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            mpPosAndNewRadii = Texture::create2D(width, height, ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
-            mpIteration = Texture::create2D(width, height, ResourceFormat::R32Uint, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+        bool packed = false;
+
+        GatherPointInfo(uint width, uint height, bool packed) : packed(packed) {
+            ResourceFormat format = packed ? ResourceFormat::RGBA32Uint : ResourceFormat::RGBA32Float;
+            mpFluxAndNumber = Texture::create2D(width, height, format, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            mpPosAndNewRadii = Texture::create2D(width, height, format, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            mpNormalAndRadii = Texture::create2D(width, height, packed ? ResourceFormat::RG32Float : ResourceFormat::RGBA32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            if (!packed)
+            {
+                mpIteration = Texture::create2D(width, height, ResourceFormat::R32Uint, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            }
         }
 
         void clear(RenderContext* pRenderContext) {
-            pRenderContext->clearTexture(mpFluxAndNumber.get(), float4(0));
-            pRenderContext->clearTexture(mpNormalAndRadii.get(), float4(0));
-            pRenderContext->clearTexture(mpPosAndNewRadii.get(), float4(0));
-            pRenderContext->clearTexture(mpIteration.get(), float4(0));       
+            clearSampleTexture(pRenderContext, mpFluxAndNumber);
+            clearSampleTexture(pRenderContext, mpNormalAndRadii);
+            clearSampleTexture(pRenderContext, mpPosAndNewRadii);
+            clearSampleTexture(pRenderContext, mpIteration);
         }
 
         void uavBarrier(RenderContext* pRenderContext) {
             pRenderContext->uavBarrier(mpFluxAndNumber.get());
             pRenderContext->uavBarrier(mpNormalAndRadii.get());
             pRenderContext->uavBarrier(mpPosAndNewRadii.get());
-            pRenderContext->uavBarrier(mpIteration.get());
+            if (mpIteration) pRenderContext->uavBarrier(mpIteration.get());
+        }
+
+        void bind(const ShaderVar& var, const std::string& prefix) {
+            var[prefix + "FluxAndNumber"] = mpFluxAndNumber;
+            var[prefix + "PosAndNewRadii"] = mpPosAndNewRadii;
+            var[prefix + "NormalAndRadii"] = mpNormalAndRadii;
+            if (mpIteration) var[prefix + "Iteration"] = mpIteration;
         }
     };
 
@@ -400,38 +484,13 @@ private:
     PhotonBuffers                   mpGlobalBuffers;               ///< Buffers for the global photons
 */
     // Acceleration Structure
-    struct BlasData
-    {
-        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO prebuildInfo;
-        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS buildInputs;
-        D3D12_RAYTRACING_GEOMETRY_DESC geomDescs;
-
-        uint64_t blasByteSize = 0;                    ///< Maximum result data size for the BLAS build, including padding.
-        uint64_t scratchByteSize = 0;                   ///< Maximum scratch data size for the BLAS build, including padding.
-    };
-
-    struct TlasData
-    {
-        Buffer::SharedPtr pTlas;
-        ShaderResourceView::SharedPtr pSrv;             ///< Shader Resource View for binding the TLAS.
-        Buffer::SharedPtr pInstanceDescs;               ///< Buffer holding instance descs for the TLAS.
-    };
-
-    BlasData mBlasData;
-    Buffer::SharedPtr mpBlasScratch;
-    D3D12_RAYTRACING_INSTANCE_DESC mPhotonInstanceDesc;
-    D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO mTlasPrebuildInfo;
-    Buffer::SharedPtr mpTlasScratch;
-    TlasData mPhotonTlas;
-
-    size_t                    mBlasScratchMaxSize = 0;
-    size_t                    mTlasScratchMaxSize = 0;
+    std::unique_ptr<PhotonAccelerationStructure> mpPhotonAS;  ///< Acceleration structure over the hit point AABBs. Only created if the AABB buffer exists.
+    PhotonAccelerationStructure::Options mPhotonASOptions;
 
     //Buffer::SharedPtr               mpCameraPathsVertexsReservoirBuffer;
     //Buffer::SharedPtr               mpCameraPathsIndexBuffer;
     //Buffer::SharedPtr               mpDstCameraPathsVertexsReservoirBuffer;
     //Buffer::SharedPtr               mpMCounter;
-    Buffer::SharedPtr               mpBlas;
     Buffer::SharedPtr               mpAABB;
     Texture::SharedPtr              mpOutput;
 
@@ -30,10 +30,30 @@ Bitonic64Sort::Bitonic64Sort(Buffer::SharedPtr& _KeyIndexList, uint _listCount)
     SortTestCS["keyIndexList"] = KeyIndexList;
 }
 
+void Bitonic64Sort::setCounterBuffer(const Buffer::SharedPtr& _CounterBuffer, uint _counterOffset) {
+    FALCOR_ASSERT(_CounterBuffer);
+    CounterBuffer = _CounterBuffer;
+    counterOffset = _counterOffset;
+
+    for (auto& pass : { BitonicArgsCS, Bitonic64PreSortCS, Bitonic64OuterSortCS, Bitonic64InnerSortCS })
+    {
+        pass->addDefine("USE_COUNTER_BUFFER", "1", true);
+        pass["g_CounterBuffer"] = CounterBuffer;
+        pass["CounterConstants"]["CounterOffset"] = counterOffset;
+        pass["CounterConstants"]["MaxListCount"] = KeyIndexList->getElementCount();
+    }
+    BitonicArgsCS["g_IndirectArgsBuffer"] = DispatchArgs;
+    Bitonic64PreSortCS["g_SortBuffer"] = KeyIndexList;
+    Bitonic64OuterSortCS["g_SortBuffer"] = KeyIndexList;
+    Bitonic64InnerSortCS["g_SortBuffer"] = KeyIndexList;
+}
+
 void Bitonic64Sort::sort(RenderContext* pRenderContext) {
-    FALCOR_ASSERT(listCount != 0);
+    // With a counter buffer the passes are sized for the whole list and the indirect args skip the unused ones.
+    const uint sortCount = CounterBuffer ? KeyIndexList->getElementCount() : listCount;
+    FALCOR_ASSERT(sortCount != 0);
 
-    const uint MaxNumElements = 1 << int(ceil(log2((double)listCount)));
+    const uint MaxNumElements = 1 << int(ceil(log2((double)sortCount)));
     const uint AlignedMaxNumElements = MaxNumElements;
     const uint MaxIterations = int(ceil(log2(std::max(2048u, AlignedMaxNumElements)))) - 10;
 
@@ -46,6 +66,7 @@ void Bitonic64Sort::sort(RenderContext* pRenderContext) {
     
     Bitonic64PreSortCS["Constants"]["constListCount"] = listCount;
 
+    if (CounterBuffer) pRenderContext->uavBarrier(CounterBuffer.get());
     pRenderContext->uavBarrier(KeyIndexList.get());
     Bitonic64PreSortCS->executeIndirect(pRenderContext, DispatchArgs.get());
     
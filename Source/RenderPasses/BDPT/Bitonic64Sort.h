@@ -1,21 +1,27 @@
 #pragma once
 #include "Falcor.h"
+#include "KeyIndexSort.h"
 
 using namespace Falcor;
 
-struct Bitonic64Sort
+struct Bitonic64Sort : public KeyIndexSort
 {
     Bitonic64Sort(Buffer::SharedPtr& _KeyIndexList, uint _listCount);
-    void sort(RenderContext* pRenderContext);
-    void setListCount(uint _listCount) { listCount = _listCount; };
+    void sort(RenderContext* pRenderContext) override;
+    void setListCount(uint _listCount) override { listCount = _listCount; };
+    /** All dispatch sizes come from indirect args when a counter buffer is set, so the host never reads the count back.
+    */
+    void setCounterBuffer(const Buffer::SharedPtr& _CounterBuffer, uint _counterOffset = 0) override;
     void sortTest(RenderContext* pRenderContext, Texture::SharedPtr& _output, uint2 frameDim);
     //Buffer::SharedPtr
 
 private:
     uint ElementSizeBytes = sizeof(uint64_t);
     uint listCount;
+    uint counterOffset = 0;
 
     Buffer::SharedPtr KeyIndexList;
+    Buffer::SharedPtr CounterBuffer;
     Buffer::SharedPtr DispatchArgs;
 
     ComputePass::SharedPtr BitonicArgsCS;
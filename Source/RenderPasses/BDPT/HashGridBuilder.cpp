@@ -0,0 +1,81 @@
+#include "HashGridBuilder.h"
+
+
+namespace
+{
+    const std::string kBuildHashGridFilename = "Utils/Algorithm/HashGrid.cs.slang";
+
+    template<typename T>
+    std::vector<T> readBuffer(const Buffer::SharedPtr& pBuffer, uint count)
+    {
+        const T* pData = static_cast<const T*>(pBuffer->map(Buffer::MapType::Read));
+        std::vector<T> result(pData, pData + count);
+        pBuffer->unmap();
+        return result;
+    }
+}
+
+HashGridBuilder::HashGridBuilder(Buffer::SharedPtr _VertexBuffer, Buffer::SharedPtr _CounterBuffer, uint maxCounter)
+    :VertexBuffer(_VertexBuffer), CounterBuffer(_CounterBuffer) {
+    maxVertexCount = maxCounter;
+    // One bucket per vertex on average keeps the lists short without a sort.
+    bucketCount = HashGrid::getBucketCount(maxCounter);
+
+    Heads = Buffer::createStructured(sizeof(uint), bucketCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+    Next = Buffer::createStructured(sizeof(uint), std::max(maxCounter, 1u), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+
+    BuildCS = ComputePass::create(kBuildHashGridFilename, "build");
+    BuildCS["gCounter"] = _CounterBuffer;
+    BuildCS["gPositions"] = _VertexBuffer;
+    BuildCS["gHeads"] = Heads;
+    BuildCS["gNext"] = Next;
+    BuildCS["CB"]["gMaxCount"] = maxVertexCount;
+    BuildCS["CB"]["gCounterOffset"] = 0u;
+    BuildCS["CB"]["gBucketCount"] = bucketCount;
+}
+
+void HashGridBuilder::update(float m_radius) {
+    cellSize = 2.f * m_radius;
+}
+
+void HashGridBuilder::build(RenderContext* pRenderContext) {
+    pRenderContext->uavBarrier(CounterBuffer.get());
+    pRenderContext->uavBarrier(VertexBuffer.get());
+    pRenderContext->clearUAV(Heads->getUAV().get(), uint4(HashGrid::kInvalidIndex));
+
+    // The vertex count is only known on the GPU: threads beyond it exit early.
+    BuildCS["CB"]["gCellSize"] = cellSize;
+    BuildCS->execute(pRenderContext, maxVertexCount, 1);
+    pRenderContext->uavBarrier(Heads.get());
+    pRenderContext->uavBarrier(Next.get());
+}
+
+bool HashGridBuilder::validate(RenderContext* pRenderContext) {
+    const uint count = std::min(readBuffer<uint>(CounterBuffer, 1)[0], maxVertexCount);
+    const std::vector<uint> heads = readBuffer<uint>(Heads, bucketCount);
+    const std::vector<uint> next = readBuffer<uint>(Next, count);
+    const std::vector<float4> positions = readBuffer<float4>(VertexBuffer, count);
+
+    std::vector<float3> points(count);
+    for (uint i = 0; i < count; i++) points[i] = float3(positions[i]);
+    HashGrid grid;
+    grid.build(points, cellSize, bucketCount);
+
+    uint mismatchCount = 0;
+    for (uint b = 0; b < bucketCount; b++)
+    {
+        std::vector<uint> gpuBucket;
+        for (uint i = heads[b]; i != HashGrid::kInvalidIndex && i < count && gpuBucket.size() <= count; i = next[i]) gpuBucket.push_back(i);
+        std::vector<uint> cpuBucket = grid.getBucket(b);
+        std::sort(gpuBucket.begin(), gpuBucket.end());
+        std::sort(cpuBucket.begin(), cpuBucket.end());
+        if (gpuBucket != cpuBucket && mismatchCount++ < 10)
+        {
+            logWarning("Light vertex hash grid bucket {} mismatch: GPU has {} vertices, CPU has {} vertices.", b, gpuBucket.size(), cpuBucket.size());
+        }
+    }
+
+    if (mismatchCount > 0) logWarning("Light vertex hash grid validation failed: {} of {} buckets differ.", mismatchCount, bucketCount);
+    else logInfo("Light vertex hash grid validation passed ({} vertices, {} buckets).", count, bucketCount);
+    return mismatchCount == 0;
+}
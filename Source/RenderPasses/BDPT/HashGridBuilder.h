@@ -0,0 +1,39 @@
+#pragma once
+#include "Falcor.h"
+#include "Utils/Algorithm/HashGrid.h"
+
+using namespace Falcor;
+
+/** Builds a spatial hash grid over the light vertices for vertex merging.
+    The cell size is twice the merge radius, so a merge query visits at most 2x2x2 cells.
+    The grid is built in a single pass over the unsorted light vertices (see Utils/Algorithm/HashGrid.cs.slang),
+    with the vertex count read on the GPU from a counter buffer.
+*/
+struct HashGridBuilder
+{
+    HashGridBuilder(Buffer::SharedPtr _VertexBuffer, Buffer::SharedPtr _CounterBuffer, uint maxCounter);
+    void update(float m_radius);
+    void build(RenderContext* pRenderContext);
+
+    Buffer::SharedPtr getHeads() { return Heads; };
+    Buffer::SharedPtr getNext() { return Next; };
+    float getCellSize() const { return cellSize; };
+    uint getBucketCount() const { return bucketCount; };
+
+    /** Read back the last GPU build and compare the contents of each bucket against a CPU build. This stalls the GPU and is meant for debugging.
+        \return True if the grids match. Mismatches are logged.
+    */
+    bool validate(RenderContext* pRenderContext);
+
+private:
+    Buffer::SharedPtr Heads;
+    Buffer::SharedPtr Next;
+    Buffer::SharedPtr VertexBuffer;
+    Buffer::SharedPtr CounterBuffer;
+
+    uint maxVertexCount;
+    uint bucketCount;
+    float cellSize = 1.f;
+
+    ComputePass::SharedPtr BuildCS;
+};
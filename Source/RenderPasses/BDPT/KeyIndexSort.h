@@ -0,0 +1,29 @@
+#pragma once
+#include "Falcor.h"
+
+using namespace Falcor;
+
+/** Sort backends for the light vertex key-index list.
+*/
+enum class KeyIndexSortType : uint32_t
+{
+    Bitonic,    ///< Bitonic sort. Pads to a power of two, O(n log^2 n).
+    Radix,      ///< Stable LSD radix sort, O(n) per 8 key bits.
+};
+
+/** Interface for sorting the light vertex key-index list in place.
+    Each element is a uint2 where x := vertex index and y := Morton code.
+    The list is sorted by descending Morton code.
+*/
+struct KeyIndexSort
+{
+    virtual ~KeyIndexSort() = default;
+
+    virtual void sort(RenderContext* pRenderContext) = 0;
+    virtual void setListCount(uint _listCount) = 0;
+    /** Read the list count on the GPU from a counter buffer instead of setListCount().
+        \param[in] _CounterBuffer Buffer holding the item count, e.g. the UAV counter of the key-index list.
+        \param[in] _counterOffset Offset in bytes of the count in the buffer.
+    */
+    virtual void setCounterBuffer(const Buffer::SharedPtr& _CounterBuffer, uint _counterOffset = 0) = 0;
+};
@@ -0,0 +1,66 @@
+#include "LightVertexCache.h"
+
+namespace
+{
+    const std::string kLightVertexCacheFilename = "RenderPasses/BDPT/LightVertexCache.cs.slang";
+}
+
+LightVertexCache::LightVertexCache(const Program::Desc& desc, const Program::DefineList& defines, Buffer::SharedPtr _VertexBuffer, Buffer::SharedPtr _KeyIndexBuffer, Buffer::SharedPtr _PositionBuffer, uint _slotCount, uint _slotCapacity)
+    :VertexBuffer(_VertexBuffer), KeyIndexBuffer(_KeyIndexBuffer), PositionBuffer(_PositionBuffer), slotCount(_slotCount), slotCapacity(_slotCapacity) {
+    FALCOR_ASSERT(slotCount > 0 && slotCapacity > 0);
+    FALCOR_ASSERT((uint64_t)slotCount * slotCapacity <= KeyIndexBuffer->getElementCount());
+
+    Program::Desc storeDesc = desc;
+    storeDesc.addShaderLibrary(kLightVertexCacheFilename).csEntry("store");
+    StoreCS = ComputePass::create(storeDesc, defines, false);
+    Program::Desc gatherDesc = desc;
+    gatherDesc.addShaderLibrary(kLightVertexCacheFilename).csEntry("gather");
+    GatherCS = ComputePass::create(gatherDesc, defines, false);
+
+    // The record layout depends on the defines, so the cache takes its type from the program.
+    const uint cacheSize = slotCount * slotCapacity;
+    CachedVertices = Buffer::createStructured(StoreCS->getRootVar()["cachedVertices"], cacheSize, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+    CachedMortonCodes = Buffer::createStructured(sizeof(uint), cacheSize, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+    CachedPositions = Buffer::createStructured(sizeof(float4), cacheSize, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+    SlotCounts = Buffer::createStructured(sizeof(uint), slotCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+
+    for (auto pPass : { StoreCS, GatherCS })
+    {
+        pPass["counterBuffer"] = KeyIndexBuffer->getUAVCounter();
+        pPass["vertices"] = VertexBuffer;
+        pPass["keyIndexList"] = KeyIndexBuffer;
+        pPass["posAndIntensityBuffer"] = PositionBuffer;
+        pPass["cachedVertices"] = CachedVertices;
+        pPass["cachedMortonCodes"] = CachedMortonCodes;
+        pPass["cachedPosAndIntensity"] = CachedPositions;
+        pPass["slotCounts"] = SlotCounts;
+        pPass["CSConstants"]["slotCapacity"] = slotCapacity;
+        pPass["CSConstants"]["slotCount"] = slotCount;
+        pPass["CSConstants"]["maxCount"] = (uint)KeyIndexBuffer->getElementCount();
+    }
+}
+
+void LightVertexCache::store(RenderContext* pRenderContext, uint slot) {
+    FALCOR_ASSERT(slot < slotCount);
+    pRenderContext->uavBarrier(KeyIndexBuffer->getUAVCounter().get());
+    pRenderContext->uavBarrier(VertexBuffer.get());
+    pRenderContext->uavBarrier(KeyIndexBuffer.get());
+    pRenderContext->uavBarrier(PositionBuffer.get());
+
+    // The vertex count is only known on the GPU: threads beyond it exit early.
+    StoreCS["CSConstants"]["slot"] = slot;
+    StoreCS->execute(pRenderContext, slotCapacity, 1);
+    pRenderContext->uavBarrier(CachedVertices.get());
+    pRenderContext->uavBarrier(CachedMortonCodes.get());
+    pRenderContext->uavBarrier(CachedPositions.get());
+    pRenderContext->uavBarrier(SlotCounts.get());
+}
+
+void LightVertexCache::gather(RenderContext* pRenderContext) {
+    pRenderContext->clearUAVCounter(KeyIndexBuffer, 0);
+    GatherCS->execute(pRenderContext, slotCapacity, slotCount);
+    pRenderContext->uavBarrier(KeyIndexBuffer->getUAVCounter().get());
+    pRenderContext->uavBarrier(VertexBuffer.get());
+    pRenderContext->uavBarrier(KeyIndexBuffer.get());
+    pRenderContext->uavBarrier(PositionBuffer.get());
+}
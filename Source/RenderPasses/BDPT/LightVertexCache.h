@@ -0,0 +1,52 @@
+#pragma once
+#include "Falcor.h"
+
+using namespace Falcor;
+
+/** Persistent pool of light vertices for static scenes.
+    The light paths are split into slices of rows of the light pass. Each slice owns a slot in the cache,
+    so only the slices traced in a frame are replaced and the others are reused from earlier frames.
+    After the traced slices are stored, all slots are gathered back into the light vertex buffers
+    (vertices, key-index list and positions), which are then sorted and indexed as usual.
+    All counts stay on the GPU.
+*/
+struct LightVertexCache
+{
+    /** Create the cache.
+        \param[in] desc Program description with the scene shader modules and type conformances.
+        \param[in] defines Defines of the path tracer programs. These select the light vertex record layout.
+        \param[in] slotCount Number of slots (light path slices).
+        \param[in] slotCapacity Maximum number of vertices per slot.
+    */
+    LightVertexCache(const Program::Desc& desc, const Program::DefineList& defines, Buffer::SharedPtr _VertexBuffer, Buffer::SharedPtr _KeyIndexBuffer, Buffer::SharedPtr _PositionBuffer, uint slotCount, uint slotCapacity);
+
+    /** Copy the light vertices traced into the light vertex buffers to a slot.
+    */
+    void store(RenderContext* pRenderContext, uint slot);
+
+    /** Clear the light vertex buffers and fill them with the vertices of all slots.
+    */
+    void gather(RenderContext* pRenderContext);
+
+    uint getSlotCount() const { return slotCount; };
+    uint getSlotCapacity() const { return slotCapacity; };
+
+    /** Get the size of the cached vertex buffers in bytes. The light vertex buffers are not owned by the cache.
+    */
+    uint64_t getMemoryUsage() const { return CachedVertices->getSize() + CachedMortonCodes->getSize() + CachedPositions->getSize() + SlotCounts->getSize(); }
+
+private:
+    Buffer::SharedPtr VertexBuffer;
+    Buffer::SharedPtr KeyIndexBuffer;
+    Buffer::SharedPtr PositionBuffer;
+    Buffer::SharedPtr CachedVertices;
+    Buffer::SharedPtr CachedMortonCodes;
+    Buffer::SharedPtr CachedPositions;
+    Buffer::SharedPtr SlotCounts;
+
+    uint slotCount;
+    uint slotCapacity;
+
+    ComputePass::SharedPtr StoreCS;
+    ComputePass::SharedPtr GatherCS;
+};
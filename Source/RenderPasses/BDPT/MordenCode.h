@@ -1,16 +1,19 @@
 #pragma once
 #include "Falcor.h"
+#include "Utils/Algorithm/BoundsReduction.h"
 
 using namespace Falcor;
 
+/** Generates Morton codes of the points in a position buffer, quantized in their bounding box.
+    The point count is read from the UAV counter of the position buffer on the GPU, so the bounds
+    and the codes are computed without a readback.
+*/
 struct MordenCodeSort
 {
     MordenCodeSort(Buffer::SharedPtr& _positionBuffer, uint _positionBufferUpbound);
     void execute(RenderContext* pRenderContext);
     Buffer::SharedPtr getResult() { return KeyIndexList; }
-    Buffer::SharedPtr getBound() { return positionBound; }
-    //void Sort(RenderContext* pRenderContext);
-    //void SortTest(RenderContext* pRenderContext);
+    Buffer::SharedPtr getBound() { return positionBound; }  // [0] := min, [1] := max
 
 private:
     void FindBoundingBox(RenderContext* pRenderContext);
@@ -19,22 +22,9 @@ private:
     Buffer::SharedPtr KeyIndexList;
     Buffer::SharedPtr positionBound;
     Buffer::SharedPtr positionBuffer;
-    
 
-    Buffer::SharedPtr bboxReductionBuffer[2];
-    
-    uint positionBufferCount;
     uint positionBufferUpbound;
 
+    BoundsReduction::SharedPtr BoundReduction;
     ComputePass::SharedPtr GenMordenCode;
-    ComputePass::SharedPtr FindMax;
-    ComputePass::SharedPtr FindMin;
-    
-    //ComputePass::SharedPtr SortTestCS;
-
-    
-
-    float4 corner;
-    float4 dim;
 };
-
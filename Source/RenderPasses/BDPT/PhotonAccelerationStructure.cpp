@@ -0,0 +1,244 @@
+#include "PhotonAccelerationStructure.h"
+
+namespace
+{
+    // A NaN min.x marks an AABB as inactive, which keeps it out of the BLAS.
+    const uint32_t kInactiveAABBValue = 0x7fc00000;
+    // Refitting must not change the active state of a primitive, so with refitting allowed unused slots are
+    // collapsed to a point at the largest float instead.
+    const uint32_t kParkedAABBValue = 0x7f7fffff;
+
+    RtAccelerationStructureBuildFlags getBuildPreferenceFlags(PhotonAccelerationStructure::BuildPreference preference)
+    {
+        switch (preference)
+        {
+        case PhotonAccelerationStructure::BuildPreference::FastTrace: return RtAccelerationStructureBuildFlags::PreferFastTrace;
+        case PhotonAccelerationStructure::BuildPreference::FastBuild: return RtAccelerationStructureBuildFlags::PreferFastBuild;
+        case PhotonAccelerationStructure::BuildPreference::MinimizeMemory: return RtAccelerationStructureBuildFlags::MinimizeMemory;
+        default: FALCOR_UNREACHABLE(); return RtAccelerationStructureBuildFlags::None;
+        }
+    }
+}
+
+PhotonAccelerationStructure::PhotonAccelerationStructure(Buffer::SharedPtr pAABBs, const Options& options)
+    : mpAABBs(pAABBs)
+{
+    FALCOR_ASSERT(mpAABBs && mpAABBs->getElementCount() > 0);
+    if (!gpDevice->isFeatureSupported(Device::SupportedFeatures::Raytracing))
+    {
+        throw RuntimeError("Raytracing is not supported by the current device");
+    }
+
+    mGeometryDesc.type = RtGeometryType::ProcedurePrimitives;
+    mGeometryDesc.flags = RtGeometryFlags::NoDuplicateAnyHitInvocation; // Important! So that photons are not collected multiple times.
+    mGeometryDesc.content.proceduralAABBs.count = mpAABBs->getElementCount();
+    mGeometryDesc.content.proceduralAABBs.data = mpAABBs->getGpuAddress();
+    mGeometryDesc.content.proceduralAABBs.stride = mpAABBs->getStructSize();
+
+    setOptions(options);
+}
+
+void PhotonAccelerationStructure::setOptions(const Options& options)
+{
+    bool flagsChanged = options.buildPreference != mOptions.buildPreference || options.allowRefit != mOptions.allowRefit || options.useCompaction != mOptions.useCompaction;
+    mOptions = options;
+    mOptions.rebuildInterval = std::max(mOptions.rebuildInterval, 1u);
+    if (flagsChanged) mpBlasBuild = nullptr;
+}
+
+void PhotonAccelerationStructure::clearAABBs(RenderContext* pRenderContext)
+{
+    pRenderContext->clearUAV(mpAABBs->getUAV().get(), uint4(mOptions.allowRefit ? kParkedAABBValue : kInactiveAABBValue));
+    if (mpAABBs->getUAVCounter()) pRenderContext->clearUAVCounter(mpAABBs, 0);
+}
+
+RtAccelerationStructureBuildInputs PhotonAccelerationStructure::getBlasInputs() const
+{
+    RtAccelerationStructureBuildInputs inputs = {};
+    inputs.kind = RtAccelerationStructureKind::BottomLevel;
+    inputs.descCount = 1;
+    inputs.geometryDescs = &mGeometryDesc;
+    inputs.flags = getBuildPreferenceFlags(mOptions.buildPreference);
+    if (mOptions.allowRefit) inputs.flags |= RtAccelerationStructureBuildFlags::AllowUpdate;
+    if (mOptions.useCompaction) inputs.flags |= RtAccelerationStructureBuildFlags::AllowCompaction;
+    return inputs;
+}
+
+void PhotonAccelerationStructure::createBlas()
+{
+    RtAccelerationStructurePrebuildInfo prebuildInfo = RtAccelerationStructure::getPrebuildInfo(getBlasInputs());
+    FALCOR_ASSERT(prebuildInfo.resultDataMaxSize > 0);
+
+    mStats.blasResultSize = align_to(kAccelerationStructureByteAlignment, prebuildInfo.resultDataMaxSize);
+    mStats.blasScratchSize = align_to(kAccelerationStructureByteAlignment, std::max(prebuildInfo.scratchDataSize, prebuildInfo.updateScratchDataSize));
+    mStats.blasCompactedSize = 0;
+
+    mpBlasScratch = Buffer::create(mStats.blasScratchSize, Buffer::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
+    mpBlasScratch->setName("BDPT::PhotonBlasScratch");
+    mpBlasBuffer = Buffer::create(mStats.blasResultSize, Buffer::BindFlags::AccelerationStructure, Buffer::CpuAccess::None);
+    mpBlasBuffer->setName("BDPT::PhotonBlas");
+
+    RtAccelerationStructure::Desc desc;
+    desc.setKind(RtAccelerationStructureKind::BottomLevel).setBuffer(mpBlasBuffer, 0, mStats.blasResultSize);
+    mpBlasBuild = RtAccelerationStructure::create(desc);
+    mpBlas = mpBlasBuild;
+
+    mpBlasCompactedBuffer = nullptr;
+    if (mOptions.useCompaction)
+    {
+        RtAccelerationStructurePostBuildInfoPool::Desc poolDesc;
+        poolDesc.queryType = RtAccelerationStructurePostBuildInfoQueryType::CompactedSize;
+        poolDesc.elementCount = 1;
+        mpCompactedSizePool = RtAccelerationStructurePostBuildInfoPool::create(poolDesc);
+    }
+    else mpCompactedSizePool = nullptr;
+
+    mBlasValid = false;
+}
+
+void PhotonAccelerationStructure::build(RenderContext* pRenderContext)
+{
+    if (!mpBlasBuild) createBlas();
+
+    // The AABBs need to be ready.
+    pRenderContext->uavBarrier(mpAABBs.get());
+    pRenderContext->uavBarrier(mpBlasScratch.get());
+
+    RtAccelerationStructure::BuildDesc asDesc = {};
+    asDesc.inputs = getBlasInputs();
+    asDesc.scratchData = mpBlasScratch->getGpuAddress();
+
+    bool refit = mOptions.allowRefit && mBlasValid && mBuildsSinceRebuild < mOptions.rebuildInterval;
+    if (refit)
+    {
+        // Update in place. With compaction this updates the compacted copy.
+        asDesc.inputs.flags |= RtAccelerationStructureBuildFlags::PerformUpdate;
+        asDesc.source = mpBlas.get();
+        asDesc.dest = mpBlas.get();
+        pRenderContext->uavBarrier(mpBlas->getDesc().getBuffer().get());
+        pRenderContext->buildAccelerationStructure(asDesc, 0, nullptr);
+        mBuildsSinceRebuild++;
+        mStats.refitCount++;
+    }
+    else
+    {
+        asDesc.dest = mpBlasBuild.get();
+        pRenderContext->uavBarrier(mpBlasBuffer.get());
+        if (mOptions.useCompaction)
+        {
+            mpCompactedSizePool->reset(pRenderContext);
+            RtAccelerationStructurePostBuildInfoDesc postBuildInfoDesc = {};
+            postBuildInfoDesc.type = RtAccelerationStructurePostBuildInfoQueryType::CompactedSize;
+            postBuildInfoDesc.pool = mpCompactedSizePool.get();
+            postBuildInfoDesc.index = 0;
+            pRenderContext->buildAccelerationStructure(asDesc, 1, &postBuildInfoDesc);
+            compactBlas(pRenderContext);
+        }
+        else
+        {
+            pRenderContext->buildAccelerationStructure(asDesc, 0, nullptr);
+        }
+        mBlasValid = true;
+        mBuildsSinceRebuild = 1;
+        mStats.rebuildCount++;
+    }
+    pRenderContext->uavBarrier(mpBlas->getDesc().getBuffer().get());
+
+    buildTlas(pRenderContext);
+}
+
+void PhotonAccelerationStructure::compactBlas(RenderContext* pRenderContext)
+{
+    // Reading the compacted size waits for the build to finish.
+    uint64_t compactedSize = mpCompactedSizePool->getElement(pRenderContext, 0);
+    if (compactedSize == 0) throw RuntimeError("Photon acceleration structure build failed");
+    compactedSize = align_to(kAccelerationStructureByteAlignment, compactedSize);
+
+    // Only grow the compacted buffer, so that its address rarely changes.
+    if (!mpBlasCompactedBuffer || mpBlasCompactedBuffer->getSize() < compactedSize)
+    {
+        mpBlasCompactedBuffer = Buffer::create(compactedSize, Buffer::BindFlags::AccelerationStructure, Buffer::CpuAccess::None);
+        mpBlasCompactedBuffer->setName("BDPT::PhotonBlasCompacted");
+    }
+    else
+    {
+        pRenderContext->uavBarrier(mpBlasCompactedBuffer.get());
+    }
+
+    RtAccelerationStructure::Desc desc;
+    desc.setKind(RtAccelerationStructureKind::BottomLevel).setBuffer(mpBlasCompactedBuffer, 0, compactedSize);
+    mpBlas = RtAccelerationStructure::create(desc);
+
+    pRenderContext->uavBarrier(mpBlasBuffer.get());
+    pRenderContext->copyAccelerationStructure(mpBlas.get(), mpBlasBuild.get(), RenderContext::RtAccelerationStructureCopyMode::Compact);
+    mStats.blasCompactedSize = compactedSize;
+}
+
+void PhotonAccelerationStructure::buildTlas(RenderContext* pRenderContext)
+{
+    RtAccelerationStructureBuildInputs inputs = {};
+    inputs.kind = RtAccelerationStructureKind::TopLevel;
+    inputs.descCount = 1;
+    // A single instance is cheap to rebuild, so the TLAS is never updated.
+    inputs.flags = RtAccelerationStructureBuildFlags::PreferFastBuild;
+
+    if (!mpTlas)
+    {
+        RtAccelerationStructurePrebuildInfo prebuildInfo = RtAccelerationStructure::getPrebuildInfo(inputs);
+        mStats.tlasResultSize = prebuildInfo.resultDataMaxSize;
+        mStats.tlasScratchSize = prebuildInfo.scratchDataSize;
+
+        mpTlasScratch = Buffer::create(mStats.tlasScratchSize, Buffer::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
+        mpTlasScratch->setName("BDPT::PhotonTlasScratch");
+        mpTlasBuffer = Buffer::create(mStats.tlasResultSize, Buffer::BindFlags::AccelerationStructure, Buffer::CpuAccess::None);
+        mpTlasBuffer->setName("BDPT::PhotonTlas");
+        mpInstanceDescs = Buffer::create(sizeof(RtInstanceDesc), Buffer::BindFlags::None, Buffer::CpuAccess::Write, nullptr);
+        mpInstanceDescs->setName("BDPT::PhotonTlasInstanceDescs");
+
+        RtAccelerationStructure::Desc desc;
+        desc.setKind(RtAccelerationStructureKind::TopLevel).setBuffer(mpTlasBuffer, 0, mStats.tlasResultSize);
+        mpTlas = RtAccelerationStructure::create(desc);
+        mInstanceBlasAddress = 0;
+    }
+    else
+    {
+        pRenderContext->uavBarrier(mpTlasBuffer.get());
+        pRenderContext->uavBarrier(mpTlasScratch.get());
+    }
+
+    // The BLAS moves when it is reallocated or compacted into a new buffer.
+    uint64_t blasAddress = mpBlas->getGpuAddress();
+    if (blasAddress != mInstanceBlasAddress)
+    {
+        RtInstanceDesc instanceDesc = {};
+        instanceDesc.setTransform(rmcv::identity<rmcv::mat4>());
+        instanceDesc.instanceID = 0;
+        instanceDesc.instanceMask = 1;
+        instanceDesc.instanceContributionToHitGroupIndex = 0;
+        instanceDesc.flags = RtGeometryInstanceFlags::None;
+        instanceDesc.accelerationStructure = blasAddress;
+        mpInstanceDescs->setBlob(&instanceDesc, 0, sizeof(instanceDesc));
+        mInstanceBlasAddress = blasAddress;
+    }
+
+    RtAccelerationStructure::BuildDesc asDesc = {};
+    asDesc.inputs = inputs;
+    asDesc.inputs.instanceDescs = mpInstanceDescs->getGpuAddress();
+    asDesc.scratchData = mpTlasScratch->getGpuAddress();
+    asDesc.dest = mpTlas.get();
+
+    pRenderContext->resourceBarrier(mpInstanceDescs.get(), Resource::State::NonPixelShader);
+    pRenderContext->buildAccelerationStructure(asDesc, 0, nullptr);
+    pRenderContext->uavBarrier(mpTlasBuffer.get());
+}
+
+void PhotonAccelerationStructure::renderStatsUI(Gui::Widgets& widget) const
+{
+    std::string text = fmt::format("AABBs: {}\n", getAABBCount());
+    text += fmt::format("BLAS: {}", formatByteSize(mStats.blasResultSize));
+    if (mStats.blasCompactedSize > 0) text += fmt::format(" (compacted {})", formatByteSize(mStats.blasCompactedSize));
+    text += fmt::format(", scratch {}\n", formatByteSize(mStats.blasScratchSize));
+    text += fmt::format("TLAS: {}, scratch {}\n", formatByteSize(mStats.tlasResultSize), formatByteSize(mStats.tlasScratchSize));
+    text += fmt::format("Rebuilds: {}, refits: {}", mStats.rebuildCount, mStats.refitCount);
+    widget.text(text);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "Falcor.h"
+#include "Core/API/RtAccelerationStructure.h"
+
+using namespace Falcor;
+
+/** Acceleration structure over the procedural AABBs of the BDPT hit points.
+    The AABBs are built into a single BLAS, which is instanced once in a TLAS for binding to the trace passes.
+    The BLAS always covers the full capacity of the AABB buffer, so the AABB count never has to be read back.
+    Slots that are not written in a frame must be reset with clearAABBs() before the AABBs are produced.
+
+    The BLAS can be refit in place between full rebuilds, which is cheaper to build but slower to trace as
+    the AABBs move away from the layout of the last rebuild. It can also be compacted after each full rebuild,
+    which reduces its memory but waits for the GPU to read back the compacted size.
+*/
+class PhotonAccelerationStructure
+{
+public:
+    enum class BuildPreference : uint32_t
+    {
+        FastTrace,
+        FastBuild,
+        MinimizeMemory,
+    };
+
+    struct Options
+    {
+        BuildPreference buildPreference = BuildPreference::FastBuild;
+        bool allowRefit = false;        ///< Refit the BLAS in place between full rebuilds.
+        uint32_t rebuildInterval = 8;   ///< Number of builds per full rebuild when refitting is allowed.
+        bool useCompaction = false;     ///< Compact the BLAS after each full rebuild.
+    };
+
+    struct Stats
+    {
+        uint64_t blasResultSize = 0;    ///< Size of the BLAS build result in bytes.
+        uint64_t blasCompactedSize = 0; ///< Size of the compacted BLAS in bytes, or zero if compaction is disabled.
+        uint64_t blasScratchSize = 0;   ///< Size of the BLAS scratch buffer in bytes. This covers builds and updates.
+        uint64_t tlasResultSize = 0;    ///< Size of the TLAS in bytes.
+        uint64_t tlasScratchSize = 0;   ///< Size of the TLAS scratch buffer in bytes.
+        uint64_t rebuildCount = 0;      ///< Number of full BLAS builds.
+        uint64_t refitCount = 0;        ///< Number of BLAS refits.
+    };
+
+    /** Create the acceleration structure.
+        \param[in] pAABBs Structured buffer of AABBs (float3 min, float3 max).
+        \param[in] options Build options.
+    */
+    PhotonAccelerationStructure(Buffer::SharedPtr pAABBs, const Options& options);
+
+    /** Set the build options. Changing the build preference, refitting or compaction reallocates the BLAS on the next build.
+    */
+    void setOptions(const Options& options);
+    const Options& getOptions() const { return mOptions; }
+
+    /** Reset all AABB slots and the AABB counter. Unused slots are made inactive, or with refitting allowed,
+        collapsed to a point out of reach of any ray, since refitting must keep every primitive active.
+    */
+    void clearAABBs(RenderContext* pRenderContext);
+
+    /** Build or refit the BLAS from the current AABBs and rebuild the TLAS.
+    */
+    void build(RenderContext* pRenderContext);
+
+    /** Force a full rebuild on the next build.
+    */
+    void invalidate() { mBlasValid = false; }
+
+    const RtAccelerationStructure::SharedPtr& getTlas() const { return mpTlas; }
+    Buffer::SharedPtr getAABBs() const { return mpAABBs; }
+    uint32_t getAABBCount() const { return mpAABBs->getElementCount(); }
+    const Stats& getStats() const { return mStats; }
+
+    void renderStatsUI(Gui::Widgets& widget) const;
+
+private:
+    RtAccelerationStructureBuildInputs getBlasInputs() const;
+    void createBlas();
+    void compactBlas(RenderContext* pRenderContext);
+    void buildTlas(RenderContext* pRenderContext);
+
+    Options mOptions;
+    Stats mStats;
+
+    Buffer::SharedPtr mpAABBs;
+    RtGeometryDesc mGeometryDesc = {};
+
+    Buffer::SharedPtr mpBlasBuffer;                         ///< Result buffer of full builds.
+    Buffer::SharedPtr mpBlasCompactedBuffer;
+    Buffer::SharedPtr mpBlasScratch;
+    RtAccelerationStructure::SharedPtr mpBlasBuild;         ///< BLAS in the result buffer.
+    RtAccelerationStructure::SharedPtr mpBlas;              ///< BLAS that is traced and refit. This is the compacted copy if compaction is enabled.
+    RtAccelerationStructurePostBuildInfoPool::SharedPtr mpCompactedSizePool;
+    bool mBlasValid = false;
+    uint32_t mBuildsSinceRebuild = 0;
+
+    Buffer::SharedPtr mpTlasBuffer;
+    Buffer::SharedPtr mpTlasScratch;
+    Buffer::SharedPtr mpInstanceDescs;
+    RtAccelerationStructure::SharedPtr mpTlas;
+    uint64_t mInstanceBlasAddress = 0;                      ///< BLAS address written to the instance desc.
+};
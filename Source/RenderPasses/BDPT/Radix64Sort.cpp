@@ -0,0 +1,23 @@
+#include "Radix64Sort.h"
+
+Radix64Sort::Radix64Sort(Buffer::SharedPtr& _KeyIndexList, uint _listCount) : listCount(_listCount), KeyIndexList(_KeyIndexList) {
+    Sort = RadixSort::create();
+}
+
+void Radix64Sort::setCounterBuffer(const Buffer::SharedPtr& _CounterBuffer, uint _counterOffset) {
+    FALCOR_ASSERT(_CounterBuffer);
+    CounterBuffer = _CounterBuffer;
+    counterOffset = _counterOffset;
+}
+
+void Radix64Sort::sort(RenderContext* pRenderContext) {
+    // Descending order to match the bitonic sort (NullItem == 0).
+    if (CounterBuffer)
+    {
+        Sort->execute(pRenderContext, KeyIndexList, KeyIndexList->getElementCount(), RadixSort::Order::Descending, kMortonCodeBits, CounterBuffer, counterOffset);
+    }
+    else
+    {
+        Sort->execute(pRenderContext, KeyIndexList, listCount, RadixSort::Order::Descending, kMortonCodeBits);
+    }
+}
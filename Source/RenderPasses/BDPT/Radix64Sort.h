@@ -0,0 +1,28 @@
+#pragma once
+#include "Falcor.h"
+#include "Utils/Algorithm/RadixSort.h"
+#include "KeyIndexSort.h"
+
+using namespace Falcor;
+
+/** Key-index sort using the stable GPU radix sort.
+    Only the 30 bits of the Morton code are sorted, which takes four 8-bit passes.
+*/
+struct Radix64Sort : public KeyIndexSort
+{
+    Radix64Sort(Buffer::SharedPtr& _KeyIndexList, uint _listCount);
+    void sort(RenderContext* pRenderContext) override;
+    void setListCount(uint _listCount) override { listCount = _listCount; };
+    void setCounterBuffer(const Buffer::SharedPtr& _CounterBuffer, uint _counterOffset = 0) override;
+
+    static const uint kMortonCodeBits = 30;
+
+private:
+    uint listCount;
+    uint counterOffset = 0;
+
+    Buffer::SharedPtr KeyIndexList;
+    Buffer::SharedPtr CounterBuffer;
+
+    RadixSort::SharedPtr Sort;
+};
@@ -0,0 +1,160 @@
+#include "StageTimings.h"
+#include <fstream>
+
+namespace
+{
+    // Find the event of a stage by the last component of the event name.
+    // Event names are paths of the nested events, e.g. "/onFrameRender/RenderGraphExe::execute()/BDPT/sortLightVertices".
+    const Profiler::Event* findStageEvent(const std::vector<Profiler::Event*>& events, const std::string& stageName)
+    {
+        const std::string suffix = "/" + stageName;
+        for (const Profiler::Event* pEvent : events)
+        {
+            const std::string name = pEvent->getName();
+            if (name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) return pEvent;
+        }
+        return nullptr;
+    }
+}
+
+StageTimings::StageTimings(const std::vector<std::string>& stageNames)
+{
+    for (const auto& name : stageNames)
+    {
+        FALCOR_ASSERT(name.find('/') == std::string::npos);
+        mStages.push_back({ name });
+    }
+}
+
+void StageTimings::update(uint32_t frameIndex)
+{
+    const auto& events = Profiler::instance().getEvents();
+
+    for (auto& stage : mStages)
+    {
+        const Profiler::Event* pEvent = findStageEvent(events, stage.name);
+        stage.valid = pEvent != nullptr;
+        stage.cpuTime = pEvent ? pEvent->getCpuTime() : 0.f;
+        stage.gpuTime = pEvent ? pEvent->getGpuTime() : 0.f;
+        stage.gpuTimeAverage = pEvent ? std::max(pEvent->getGpuTimeAverage(), 0.f) : 0.f;
+    }
+
+    if (mRecording && !events.empty())
+    {
+        FrameRecord record;
+        record.frameIndex = frameIndex;
+        for (const auto& stage : mStages)
+        {
+            record.cpuTimes.push_back(stage.cpuTime);
+            record.gpuTimes.push_back(stage.gpuTime);
+        }
+        mFrames.push_back(std::move(record));
+    }
+}
+
+void StageTimings::startRecording()
+{
+    Profiler::instance().setEnabled(true);
+    mFrames.clear();
+    mRecording = true;
+}
+
+void StageTimings::write(const std::filesystem::path& path) const
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    std::string content;
+    if (ext == ".json") content = toJsonString();
+    else if (ext == ".csv") content = toCsvString();
+    else throw ArgumentError("Unsupported stage timing file extension '{}'. Expected '.json' or '.csv'.", ext);
+
+    std::ofstream ofs(path);
+    if (!ofs) throw RuntimeError("Failed to open '{}' for writing.", path.string());
+    ofs.write(content.data(), content.size());
+}
+
+std::string StageTimings::toJsonString() const
+{
+    std::string json = "{\n  \"stages\": [";
+    for (size_t i = 0; i < mStages.size(); i++)
+    {
+        json += fmt::format("{}\"{}\"", i > 0 ? ", " : "", mStages[i].name);
+    }
+    json += "],\n  \"frames\": [";
+
+    auto appendTimes = [&json, this](const char* key, const std::vector<float>& times)
+    {
+        json += fmt::format("\"{}\": {{", key);
+        for (size_t i = 0; i < mStages.size(); i++)
+        {
+            json += fmt::format("{}\"{}\": {}", i > 0 ? ", " : "", mStages[i].name, times[i]);
+        }
+        json += "}";
+    };
+
+    for (size_t f = 0; f < mFrames.size(); f++)
+    {
+        const auto& frame = mFrames[f];
+        json += fmt::format("{}\n    {{\"frame\": {}, ", f > 0 ? "," : "", frame.frameIndex);
+        appendTimes("gpuTime", frame.gpuTimes);
+        json += ", ";
+        appendTimes("cpuTime", frame.cpuTimes);
+        json += "}";
+    }
+    json += mFrames.empty() ? "]\n}\n" : "\n  ]\n}\n";
+    return json;
+}
+
+std::string StageTimings::toCsvString() const
+{
+    std::string csv = "frame";
+    for (const auto& stage : mStages) csv += fmt::format(",{}/gpuTime", stage.name);
+    for (const auto& stage : mStages) csv += fmt::format(",{}/cpuTime", stage.name);
+    csv += "\n";
+
+    for (const auto& frame : mFrames)
+    {
+        csv += std::to_string(frame.frameIndex);
+        for (float t : frame.gpuTimes) csv += fmt::format(",{}", t);
+        for (float t : frame.cpuTimes) csv += fmt::format(",{}", t);
+        csv += "\n";
+    }
+    return csv;
+}
+
+pybind11::dict StageTimings::toPython() const
+{
+    pybind11::dict result;
+    for (const auto& stage : mStages)
+    {
+        if (!stage.valid) continue;
+        pybind11::dict d;
+        d["gpuTime"] = stage.gpuTime;
+        d["cpuTime"] = stage.cpuTime;
+        result[stage.name.c_str()] = d;
+    }
+    return result;
+}
+
+void StageTimings::renderUI(Gui::Widgets& widget) const
+{
+    if (!Profiler::instance().isEnabled())
+    {
+        widget.text("Enable the profiler to show per-stage timings.");
+        return;
+    }
+
+    std::string text;
+    float total = 0.f;
+    for (const auto& stage : mStages)
+    {
+        if (!stage.valid) continue;
+        text += fmt::format("{:<28} {:>8.3f} ms\n", stage.name, stage.gpuTimeAverage);
+        total += stage.gpuTimeAverage;
+    }
+    text += fmt::format("{:<28} {:>8.3f} ms", "total", total);
+    widget.text(text);
+
+    if (mRecording) widget.text(fmt::format("Recording ({} frames)", mFrames.size()));
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Falcor.h"
+
+using namespace Falcor;
+
+/** Per-stage timings of the BDPT pass.
+    The stages are profiled with FALCOR_PROFILE and the times are read back from the global Profiler,
+    so they are only available while the profiler is enabled. The times lag the current frame by the
+    profiler's readback latency.
+    Frames can be recorded and written out as JSON or CSV for offline comparison.
+*/
+class StageTimings
+{
+public:
+    struct Stage
+    {
+        std::string name;           ///< Profiler event name of the stage (last path component).
+        float cpuTime = 0.f;        ///< CPU time in ms.
+        float gpuTime = 0.f;        ///< GPU time in ms.
+        float gpuTimeAverage = 0.f; ///< Moving average of the GPU time in ms.
+        bool valid = false;         ///< True if the stage was profiled in the last frame.
+    };
+
+    /** Create the timings for a list of stages.
+        \param[in] stageNames Profiler event names of the stages, in execution order.
+    */
+    StageTimings(const std::vector<std::string>& stageNames);
+
+    /** Update the stage times from the profiler events of the last frame.
+        \param[in] frameIndex Index of the frame the times are recorded with.
+    */
+    void update(uint32_t frameIndex);
+
+    const std::vector<Stage>& getStages() const { return mStages; }
+
+    /** Start recording per-frame times. This enables the profiler and discards previous recordings.
+    */
+    void startRecording();
+
+    /** Stop recording per-frame times. The recorded frames are kept until the next call to startRecording().
+    */
+    void stopRecording() { mRecording = false; }
+
+    bool isRecording() const { return mRecording; }
+    size_t getRecordedFrameCount() const { return mFrames.size(); }
+
+    /** Write the recorded frames to a file. The format is chosen by the file extension (.json or .csv).
+        \param[in] path File path.
+    */
+    void write(const std::filesystem::path& path) const;
+
+    std::string toJsonString() const;
+    std::string toCsvString() const;
+
+    /** Get the stage times of the last frame as a python dictionary, mapping stage name to GPU and CPU time in ms.
+    */
+    pybind11::dict toPython() const;
+
+    void renderUI(Gui::Widgets& widget) const;
+
+private:
+    struct FrameRecord
+    {
+        uint32_t frameIndex = 0;
+        std::vector<float> cpuTimes;
+        std::vector<float> gpuTimes;
+    };
+
+    std::vector<Stage> mStages;
+    std::vector<FrameRecord> mFrames;
+    bool mRecording = false;
+};
@@ -3,77 +3,153 @@
 
 namespace
 {
-    const std::string kGenInternalLevelFilename = "RenderPasses/BDPT/GenInternalLevel.cs.slang";
-    const std::string kGenLevelZeroFromVertexsFilename = "RenderPasses/BDPT/GenLevelZeroFromVertexs.cs.slang";
+    const std::string kGenTreeArgsFilename = "RenderPasses/BDPT/VertexTreeArgs.cs.slang";
+    const std::string kGenInternalNodesFilename = "RenderPasses/BDPT/GenInternalNodes.cs.slang";
+    const std::string kGenLeafNodesFilename = "RenderPasses/BDPT/GenLeafNodes.cs.slang";
+
+    const float kEmptyBound = 1e10f;
+
+    template<typename T>
+    std::vector<T> readBuffer(const Buffer::SharedPtr& pBuffer, uint count)
+    {
+        const T* pData = static_cast<const T*>(pBuffer->map(Buffer::MapType::Read));
+        std::vector<T> result(pData, pData + count);
+        pBuffer->unmap();
+        return result;
+    }
 }
 
-VertexTreeBuilder::VertexTreeBuilder(Buffer::SharedPtr _KeyIndexBuffer, Buffer::SharedPtr _VertexBuffer, uint maxCounter) :KeyIndexBuffer(_KeyIndexBuffer), VertexBuffer(_VertexBuffer) {
-    uint maxTreeLevels = uint(ceil(log2((double)maxCounter))) + 1;
-    uint maxLeafNodesNum = 1 << (maxTreeLevels - 1);
-    uint maxNodesNum = maxLeafNodesNum << 1;
+VertexTreeBuilder::VertexTreeBuilder(Buffer::SharedPtr _KeyIndexBuffer, Buffer::SharedPtr _VertexBuffer, Buffer::SharedPtr _CounterBuffer, uint maxCounter)
+    :KeyIndexBuffer(_KeyIndexBuffer), VertexBuffer(_VertexBuffer), CounterBuffer(_CounterBuffer) {
+    maxLeafCount = maxCounter;
+    // A radix tree over n vertices has exactly 2n-1 nodes. Keep at least the root for an empty tree.
+    uint maxNodesNum = std::max(RadixTree::getNodeCount(maxCounter), 1u);
 
     Nodes = Buffer::createStructured(sizeof(Node), maxNodesNum);
+    Parents = Buffer::createStructured(sizeof(uint), maxNodesNum);
+    RefitCounters = Buffer::createStructured(sizeof(uint), std::max(RadixTree::getLeafNodeStart(maxCounter), 1u));
+    TreeParams = Buffer::createStructured(sizeof(uint4), 1);
+    DispatchArgs = Buffer::createStructured(sizeof(uint3), 2, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::IndirectArg);
 
-    GenLevelZeroCS = ComputePass::create(kGenLevelZeroFromVertexsFilename, "main");
-    //GenLevelZeroCS->getProgram()->setDefines(defines);
-    GenInternalLevelCS = ComputePass::create(kGenInternalLevelFilename, "main");
+    GenArgsCS = ComputePass::create(kGenTreeArgsFilename, "main");
+    GenInternalNodesCS = ComputePass::create(kGenInternalNodesFilename, "main");
+    GenLeafNodesCS = ComputePass::create(kGenLeafNodesFilename, "main");
 
-    GenLevelZeroCS["keyIndexList"] = _KeyIndexBuffer;
-    GenLevelZeroCS["posAndIntensityBuffer"] = _VertexBuffer;
-    GenLevelZeroCS["nodes"] = Nodes;
+    GenArgsCS["counterBuffer"] = _CounterBuffer;
+    GenArgsCS["treeParams"] = TreeParams;
+    GenArgsCS["dispatchArgs"] = DispatchArgs;
+    GenArgsCS["nodes"] = Nodes;
+    GenArgsCS["parents"] = Parents;
+    GenArgsCS["CSConstants"]["maxCount"] = maxLeafCount;
+    GenArgsCS["CSConstants"]["counterOffset"] = 0u;
 
-    GenInternalLevelCS["nodes"] = Nodes;
+    GenInternalNodesCS["treeParams"] = TreeParams;
+    GenInternalNodesCS["keyIndexList"] = _KeyIndexBuffer;
+    GenInternalNodesCS["nodes"] = Nodes;
+    GenInternalNodesCS["parents"] = Parents;
+    GenInternalNodesCS["refitCounters"] = RefitCounters;
+
+    GenLeafNodesCS["treeParams"] = TreeParams;
+    GenLeafNodesCS["keyIndexList"] = _KeyIndexBuffer;
+    GenLeafNodesCS["posAndIntensityBuffer"] = _VertexBuffer;
+    GenLeafNodesCS["nodes"] = Nodes;
+    GenLeafNodesCS["parents"] = Parents;
+    GenLeafNodesCS["refitCounters"] = RefitCounters;
 }
 
-void VertexTreeBuilder::update(uint counter, float m_radius) {
-    realLeafNodesNum = counter;
+void VertexTreeBuilder::update(float m_radius) {
     radius = m_radius;
-    leafNodesNum = counter == 0 ? 0 : 1 << int(ceil(log2((double)counter)));
-    treeLevels = uint(ceil(log2((double)counter))) + 1;
-    nodesNum = leafNodesNum << 1;
 }
 
-void VertexTreeBuilder::GenLevelZero(RenderContext* pRenderContext) {
-    GenLevelZeroCS["CSConstants"]["numLeafNodes"] = leafNodesNum;
-    GenLevelZeroCS["CSConstants"]["numLevels"] = treeLevels;
-    GenLevelZeroCS["CSConstants"]["counter"] = realLeafNodesNum;
-    GenLevelZeroCS["CSConstants"]["radius"] = radius;
-    
-    GenLevelZeroCS->execute(pRenderContext, leafNodesNum, 1);
+void VertexTreeBuilder::GenArgs(RenderContext* pRenderContext) {
+    pRenderContext->uavBarrier(CounterBuffer.get());
+    GenArgsCS->execute(pRenderContext, 1, 1);
+    pRenderContext->uavBarrier(TreeParams.get());
+    pRenderContext->uavBarrier(DispatchArgs.get());
+}
+
+void VertexTreeBuilder::GenInternalNodes(RenderContext* pRenderContext) {
+    GenInternalNodesCS->executeIndirect(pRenderContext, DispatchArgs.get());
+    pRenderContext->uavBarrier(Nodes.get());
+    pRenderContext->uavBarrier(Parents.get());
+    pRenderContext->uavBarrier(RefitCounters.get());
+}
+
+void VertexTreeBuilder::GenLeafNodes(RenderContext* pRenderContext) {
+    GenLeafNodesCS["CSConstants"]["radius"] = radius;
+
+    // Leaves and the bottom-up refit run in a single dispatch.
+    GenLeafNodesCS->executeIndirect(pRenderContext, DispatchArgs.get(), sizeof(uint3));
+}
+
+void VertexTreeBuilder::build(RenderContext* pRenderContext) {
+    pRenderContext->uavBarrier(KeyIndexBuffer.get());
+    GenArgs(pRenderContext);
+    GenInternalNodes(pRenderContext);
+    GenLeafNodes(pRenderContext);
+}
+
+std::vector<Node> VertexTreeBuilder::buildHost(const std::vector<uint2>& keyIndexList, const std::vector<float4>& positions, float radius) {
+    std::vector<uint32_t> keys(keyIndexList.size());
+    for (size_t i = 0; i < keys.size(); i++) keys[i] = keyIndexList[i].y;
+
+    const std::vector<RadixTree::Node> tree = RadixTree::build(keys);
+    const uint count = (uint)keys.size();
+    const uint leafNodeStart = RadixTree::getLeafNodeStart(count);
+
+    std::vector<Node> nodes(tree.size());
+    for (uint i = 0; i < leafNodeStart; i++)
+    {
+        nodes[i] = { float3(kEmptyBound), 0.f, float3(-kEmptyBound), tree[i].split, tree[i].leafRange };
+    }
+    for (uint i = 0; i < count; i++)
+    {
+        uint index = keyIndexList[i].x;
+        float3 pos = float3(positions[index]);
+        nodes[leafNodeStart + i] = { pos - radius, 1.f, pos + radius, index, tree[leafNodeStart + i].leafRange };
+    }
+
+    // Children cover fewer leaves than their parent, so refitting by increasing leaf count visits children first.
+    std::vector<uint> order(leafNodeStart);
+    for (uint i = 0; i < leafNodeStart; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint a, uint b) { return tree[a].leafRange.y - tree[a].leafRange.x < tree[b].leafRange.y - tree[b].leafRange.x; });
+    for (uint i : order)
+    {
+        uint2 children = RadixTree::getChildren(tree[i], count);
+        const Node& c0 = nodes[children.x];
+        const Node& c1 = nodes[children.y];
+        nodes[i].betaSum = c0.betaSum + c1.betaSum;
+        nodes[i].boundMin = min(c0.boundMin, c1.boundMin);
+        nodes[i].boundMax = max(c0.boundMax, c1.boundMax);
+    }
+
+    return nodes;
 }
 
-void VertexTreeBuilder::GenInternalLevel(RenderContext* pRenderContext) {
-   
-    const uint maxWorkLoad = 2048;
-    int srcLevel = 0;
-    for (int dstLevelStart = 1; dstLevelStart < treeLevels; )
+bool VertexTreeBuilder::validate(RenderContext* pRenderContext) {
+    const uint count = readBuffer<uint4>(TreeParams, 1)[0].x;
+    const std::vector<uint2> keyIndexList = readBuffer<uint2>(KeyIndexBuffer, count);
+    const std::vector<Node> gpuNodes = readBuffer<Node>(Nodes, RadixTree::getNodeCount(count));
+
+    uint maxIndex = 0;
+    for (const auto& keyIndex : keyIndexList) maxIndex = std::max(maxIndex, keyIndex.x);
+    const std::vector<float4> positions = readBuffer<float4>(VertexBuffer, count > 0 ? maxIndex + 1 : 0);
+
+    const std::vector<Node> cpuNodes = buildHost(keyIndexList, positions, radius);
+
+    uint mismatchCount = 0;
+    for (size_t i = 0; i < cpuNodes.size(); i++)
     {
-        int dstLevelEnd;
-        int workLoad = 0;
-        for (dstLevelEnd = dstLevelStart + 1; dstLevelEnd < treeLevels; dstLevelEnd++)
+        const Node& a = gpuNodes[i];
+        const Node& b = cpuNodes[i];
+        bool match = a.ID == b.ID && a.leafRange == b.leafRange && a.betaSum == b.betaSum && a.boundMin == b.boundMin && a.boundMax == b.boundMax;
+        if (!match && mismatchCount++ < 10)
         {
-            workLoad += 1 << (treeLevels - 1 - srcLevel);
-            if (workLoad > maxWorkLoad) break;
+            logWarning("Light vertex tree node {} mismatch: GPU (ID {}, leaves [{}, {}]) vs CPU (ID {}, leaves [{}, {}]).", i, a.ID, a.leafRange.x, a.leafRange.y, b.ID, b.leafRange.x, b.leafRange.y);
         }
-        pRenderContext->uavBarrier(Nodes.get());
-        GenInternalLevelCS["CSConstants"]["srcLevel"] = srcLevel;
-        GenInternalLevelCS["CSConstants"]["dstLevelStart"] = dstLevelStart;
-        GenInternalLevelCS["CSConstants"]["dstLevelEnd"] = dstLevelEnd;
-        GenInternalLevelCS["CSConstants"]["numLevels"] = treeLevels;
-        int numDstLevelsLights = (1 << (treeLevels - dstLevelStart)) - (1 << (treeLevels - dstLevelEnd));
-        GenInternalLevelCS["CSConstants"]["numDstLevelsNodes"] = numDstLevelsLights;
-        GenInternalLevelCS->execute(pRenderContext, numDstLevelsLights, 1);
-        //GenerateMultipleLevels(cptContext, srcLevel, dstLevelStart, dstLevelEnd, nodes.GetUAV(), numLevels);
-
-        srcLevel = dstLevelEnd - 1;
-        dstLevelStart = dstLevelEnd;
     }
-}
 
-void VertexTreeBuilder::build(RenderContext* pRenderContext) {
-    //GenLevelZeroCS["gScene"] = gScene;
-    //GenInternalLevelCS["gScene"] = gScene;
-    pRenderContext->uavBarrier(KeyIndexBuffer.get());
-    GenLevelZero(pRenderContext);
-    GenInternalLevel(pRenderContext);
+    if (mismatchCount > 0) logWarning("Light vertex tree validation failed: {} of {} nodes differ.", mismatchCount, cpuNodes.size());
+    else logInfo("Light vertex tree validation passed ({} nodes).", cpuNodes.size());
+    return mismatchCount == 0;
 }
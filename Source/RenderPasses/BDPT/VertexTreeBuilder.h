@@ -1,39 +1,68 @@
 #pragma once
 #include "Falcor.h"
+#include "Utils/Algorithm/RadixTree.h"
 
 using namespace Falcor;
 
+/** Light vertex tree node. Must match Node.slang.
+*/
 struct Node
 {
     float3 boundMin;
     float betaSum;
     float3 boundMax;
-    uint ID;
+    uint ID;            ///< Leaf: light vertex index. Internal node: split index.
+    uint2 leafRange;    ///< First and last leaf covered by the node.
 };
+static_assert(sizeof(Node) == 40, "Node size must match Node.slang");
 
+/** Builds a bounding volume tree over the sorted light vertices.
+    The tree is a binary radix tree over the Morton codes (see RadixTree) with exactly 2n-1 nodes for n vertices.
+    The vertex count is read on the GPU from a counter buffer and all dispatch sizes come from
+    indirect args, so the tree can be built without reading the count back to the CPU.
+*/
 struct VertexTreeBuilder
 {
-    VertexTreeBuilder(Buffer::SharedPtr _KeyIndexBuffer, Buffer::SharedPtr _VertexBuffer, uint maxCounter);
-    void update(uint counter, float m_radius);
+    VertexTreeBuilder(Buffer::SharedPtr _KeyIndexBuffer, Buffer::SharedPtr _VertexBuffer, Buffer::SharedPtr _CounterBuffer, uint maxCounter);
+    void update(float m_radius);
     void build(RenderContext* pRenderContext);
 
     Buffer::SharedPtr getTree() { return Nodes; };
-    uint getLeafNodeStartIndex() { return leafNodesNum; };
+    /** Tree parameters written on the GPU: x := vertex count, y := leaf node start index, z := node count.
+    */
+    Buffer::SharedPtr getTreeParams() { return TreeParams; };
+
+    /** Build the tree on the CPU with the same node layout as the GPU build.
+        \param[in] keyIndexList Sorted key-index pairs, x := vertex index, y := Morton code.
+        \param[in] positions Light vertex positions indexed by vertex index.
+        \param[in] radius Radius the leaf bounds are extended by.
+        \return Array of 2n-1 nodes.
+    */
+    static std::vector<Node> buildHost(const std::vector<uint2>& keyIndexList, const std::vector<float4>& positions, float radius);
+
+    /** Read back the last GPU build and compare it against buildHost(). This stalls the GPU and is meant for debugging.
+        \return True if the trees match. Mismatches are logged.
+    */
+    bool validate(RenderContext* pRenderContext);
 
 private:
-    void GenLevelZero(RenderContext* pRenderContext);
-    void GenInternalLevel(RenderContext* pRenderContext);
+    void GenArgs(RenderContext* pRenderContext);
+    void GenInternalNodes(RenderContext* pRenderContext);
+    void GenLeafNodes(RenderContext* pRenderContext);
 
     Buffer::SharedPtr Nodes;
+    Buffer::SharedPtr Parents;
+    Buffer::SharedPtr RefitCounters;
     Buffer::SharedPtr KeyIndexBuffer;
     Buffer::SharedPtr VertexBuffer;
+    Buffer::SharedPtr CounterBuffer;
+    Buffer::SharedPtr TreeParams;
+    Buffer::SharedPtr DispatchArgs;
 
-    uint realLeafNodesNum;
-    uint leafNodesNum = 0;
-    uint nodesNum;
-    uint treeLevels;
+    uint maxLeafCount;
     float radius;
 
-    ComputePass::SharedPtr GenLevelZeroCS;
-    ComputePass::SharedPtr GenInternalLevelCS;
+    ComputePass::SharedPtr GenArgsCS;
+    ComputePass::SharedPtr GenInternalNodesCS;
+    ComputePass::SharedPtr GenLeafNodesCS;
 };
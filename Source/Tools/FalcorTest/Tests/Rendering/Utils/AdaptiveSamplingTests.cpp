@@ -0,0 +1,130 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/AdaptiveSampling.slang"
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        const float kEpsilon = 1e-3f;
+
+        /** Accumulate frames of a pixel with the given per-frame luminance values and sample counts.
+        */
+        float4 accumulate(const std::vector<float>& values, const std::vector<uint>& sampleCounts)
+        {
+            float4 moments = float4(0.f);
+            for (size_t i = 0; i < values.size(); i++) moments = updatePixelMoments(moments, values[i], sampleCounts[i]);
+            return moments;
+        }
+    }
+
+    CPU_TEST(AdaptiveSamplingPixelError)
+    {
+        // Fewer than two frames have no error estimate.
+        EXPECT_EQ(computePixelError(float4(0.f), kEpsilon), 0.f);
+        EXPECT_EQ(computePixelError(accumulate({ 5.f }, { 4 }), kEpsilon), 0.f);
+
+        // A constant pixel has no error.
+        EXPECT_EQ(computePixelError(accumulate({ 2.f, 2.f, 2.f }, { 1, 2, 3 }), kEpsilon), 0.f);
+
+        // Two frames of one sample: mean 2, variance ((1-2)^2 + (3-2)^2) / 1 = 2, error 2 / (2 * (4 + eps)).
+        float4 m = accumulate({ 1.f, 3.f }, { 1, 1 });
+        EXPECT(m == float4(4.f, 10.f, 2.f, 2.f));
+        EXPECT(std::abs(computePixelError(m, kEpsilon) - 2.f / (2.f * (4.f + kEpsilon))) < 1e-6f);
+
+        // Frames are weighted by their sample count.
+        std::vector<float> values = { 0.5f, 1.5f, 1.f, 2.f };
+        std::vector<uint> counts = { 1, 3, 2, 4 };
+        double n = 0.0, mean = 0.0;
+        for (size_t i = 0; i < values.size(); i++) { n += counts[i]; mean += counts[i] * values[i]; }
+        mean /= n;
+        double ssd = 0.0;
+        for (size_t i = 0; i < values.size(); i++) ssd += counts[i] * (values[i] - mean) * (values[i] - mean);
+        const double refError = ssd / (values.size() - 1) / (n * (mean * mean + kEpsilon));
+        EXPECT(std::abs(computePixelError(accumulate(values, counts), kEpsilon) - refError) < 1e-5 * refError);
+
+        // The error falls as samples are added.
+        EXPECT_LT(computePixelError(accumulate({ 1.f, 3.f, 1.f, 3.f }, { 1, 1, 1, 1 }), kEpsilon), computePixelError(m, kEpsilon));
+    }
+
+    CPU_TEST(AdaptiveSamplingAllocatePixel)
+    {
+        // Without error estimates all pixels get the budget.
+        EXPECT_EQ(allocatePixelSamples(0.f, 0.f, 3.f, 1, 8, 0.5f), 3u);
+        EXPECT_EQ(allocatePixelSamples(1.f, 0.f, 3.f, 1, 8, 0.5f), 3u);
+
+        // Proportional to the error.
+        EXPECT_EQ(allocatePixelSamples(1.f, 2.f, 2.f, 1, 8, 0.5f), 1u);
+        EXPECT_EQ(allocatePixelSamples(3.f, 2.f, 2.f, 1, 8, 0.5f), 3u);
+        EXPECT_EQ(allocatePixelSamples(4.f, 2.f, 2.f, 1, 8, 0.5f), 4u);
+
+        // Clamped to the range.
+        EXPECT_EQ(allocatePixelSamples(0.f, 2.f, 2.f, 1, 8, 0.5f), 1u);
+        EXPECT_EQ(allocatePixelSamples(100.f, 2.f, 2.f, 1, 8, 0.99f), 8u);
+
+        // Random rounding meets the budget in expectation.
+        std::mt19937 r;
+        std::uniform_real_distribution<float> u(0.f, 1.f);
+        double sum = 0.0;
+        const uint32_t kTrials = 100000;
+        for (uint32_t i = 0; i < kTrials; i++) sum += allocatePixelSamples(1.15f, 1.f, 2.f, 1, 8, u(r));
+        EXPECT(std::abs(sum / kTrials - 2.3) < 0.01);
+    }
+
+    CPU_TEST(AdaptiveSamplingAllocateFrame)
+    {
+        // A constant image keeps the budget everywhere.
+        {
+            std::vector<float4> moments(64, accumulate({ 1.f, 1.f, 1.f }, { 2, 2, 2 }));
+            for (uint s : allocateSamplesHost(moments, kEpsilon, 2.f, 1, 8)) EXPECT_EQ(s, 2u);
+        }
+
+        // Pixels with the same mean and increasing noise get non-decreasing sample counts, and the noisiest get more than the budget.
+        {
+            std::mt19937 r;
+            std::normal_distribution<float> normal(0.f, 1.f);
+            const uint32_t kPixels = 32;
+            const uint32_t kFrames = 64;
+            std::vector<float4> moments(kPixels, float4(0.f));
+            for (uint32_t f = 0; f < kFrames; f++)
+            {
+                const float z = normal(r);
+                for (uint32_t i = 0; i < kPixels; i++) moments[i] = updatePixelMoments(moments[i], 1.f + 0.02f * i * z, 1);
+            }
+
+            std::vector<uint> samples = allocateSamplesHost(moments, kEpsilon, 2.f, 1, 16);
+            for (uint32_t i = 1; i < kPixels; i++) EXPECT_GE(samples[i], samples[i - 1]) << "i = " << i;
+            EXPECT_EQ(samples[0], 1u);
+            EXPECT_GT(samples[kPixels - 1], 2u);
+        }
+
+        EXPECT(allocateSamplesHost({}, kEpsilon, 2.f, 1, 8).empty());
+    }
+}
@@ -0,0 +1,197 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/Checkpoint.h"
+#include <random>
+#include <sstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        const std::string kType = "TestPass";
+        const uint32_t kVersion = 3;
+
+        Checkpoint::TextureData createTexture(uint32_t width, uint32_t height, ResourceFormat format, uint32_t seed)
+        {
+            std::mt19937 r(seed);
+            Checkpoint::TextureData texture;
+            texture.width = width;
+            texture.height = height;
+            texture.format = format;
+            texture.data.resize((size_t)width * height * getFormatBytesPerBlock(format));
+            for (auto& b : texture.data) b = (uint8_t)r();
+            return texture;
+        }
+
+        Checkpoint createCheckpoint()
+        {
+            Checkpoint checkpoint(kType, kVersion);
+            checkpoint.setValue("frameCount", 1234u);
+            checkpoint.setValue("radius", 0.125f);
+            checkpoint.setValue("frameDim", uint2(1920, 1080));
+            checkpoint.setTexture("weight", createTexture(64, 32, ResourceFormat::R32Uint, 1));
+            checkpoint.setTexture("sum", createTexture(64, 1, ResourceFormat::R32Float, 2));
+            checkpoint.setTexture("flux", createTexture(17, 9, ResourceFormat::RGBA32Float, 3));
+            return checkpoint;
+        }
+
+        void expectEqual(CPUUnitTestContext& ctx, const Checkpoint::TextureData& a, const Checkpoint::TextureData& b)
+        {
+            EXPECT_EQ(a.width, b.width);
+            EXPECT_EQ(a.height, b.height);
+            EXPECT_EQ(a.depth, b.depth);
+            EXPECT(a.format == b.format);
+            EXPECT(a.data == b.data);
+        }
+
+        void expectEqual(CPUUnitTestContext& ctx, const Checkpoint& a, const Checkpoint& b)
+        {
+            EXPECT_EQ(a.getType(), b.getType());
+            EXPECT_EQ(a.getVersion(), b.getVersion());
+            EXPECT_EQ(a.getValue<uint32_t>("frameCount"), b.getValue<uint32_t>("frameCount"));
+            EXPECT_EQ(a.getValue<float>("radius"), b.getValue<float>("radius"));
+            EXPECT(a.getValue<uint2>("frameDim") == b.getValue<uint2>("frameDim"));
+            for (const char* name : { "weight", "sum", "flux" }) expectEqual(ctx, a.getTexture(name), b.getTexture(name));
+        }
+
+        template<typename Func>
+        bool throwsRuntimeError(Func func)
+        {
+            try { func(); }
+            catch (const RuntimeError&) { return true; }
+            return false;
+        }
+
+        template<typename Func>
+        bool throwsArgumentError(Func func)
+        {
+            try { func(); }
+            catch (const ArgumentError&) { return true; }
+            return false;
+        }
+    }
+
+    CPU_TEST(CheckpointRoundTrip)
+    {
+        const Checkpoint checkpoint = createCheckpoint();
+        std::stringstream stream;
+        checkpoint.write(stream);
+
+        const Checkpoint result = Checkpoint::read(stream, kType, kVersion);
+        expectEqual(ctx, checkpoint, result);
+        EXPECT(result.hasEntry("weight"));
+        EXPECT(result.hasEntry("frameCount"));
+        EXPECT(!result.hasEntry("missing"));
+    }
+
+    CPU_TEST(CheckpointFileRoundTrip)
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "FalcorCheckpointTest.bin";
+        const Checkpoint checkpoint = createCheckpoint();
+        checkpoint.write(path);
+        EXPECT(std::filesystem::exists(path));
+
+        const Checkpoint result = Checkpoint::read(path, kType, kVersion);
+        expectEqual(ctx, checkpoint, result);
+
+        // Overwriting an existing checkpoint replaces it.
+        Checkpoint next(kType, kVersion);
+        next.setValue("frameCount", 5678u);
+        next.write(path);
+        EXPECT_EQ(Checkpoint::read(path, kType, kVersion).getValue<uint32_t>("frameCount"), 5678u);
+
+        std::filesystem::remove(path);
+        EXPECT(throwsRuntimeError([&]() { Checkpoint::read(path, kType, kVersion); }));
+    }
+
+    CPU_TEST(CheckpointMismatch)
+    {
+        std::stringstream stream;
+        createCheckpoint().write(stream);
+        const std::string data = stream.str();
+
+        auto readFrom = [](const std::string& data, const std::string& type, uint32_t version)
+        {
+            std::stringstream s(data);
+            return Checkpoint::read(s, type, version);
+        };
+
+        EXPECT(throwsRuntimeError([&]() { readFrom(data, "OtherPass", kVersion); }));
+        EXPECT(throwsRuntimeError([&]() { readFrom(data, kType, kVersion + 1); }));
+
+        // Every truncation of the file is detected.
+        for (size_t size = 0; size < data.size(); size += 7)
+        {
+            EXPECT(throwsRuntimeError([&]() { readFrom(data.substr(0, size), kType, kVersion); })) << "size = " << size;
+        }
+
+        std::string badMagic = data;
+        badMagic[0] = 'X';
+        EXPECT(throwsRuntimeError([&]() { readFrom(badMagic, kType, kVersion); }));
+    }
+
+    CPU_TEST(CheckpointInvalidEntries)
+    {
+        Checkpoint checkpoint = createCheckpoint();
+        EXPECT(throwsArgumentError([&]() { checkpoint.getValue<uint32_t>("missing"); }));
+        EXPECT(throwsArgumentError([&]() { checkpoint.getValue<uint64_t>("frameCount"); }));
+        EXPECT(throwsArgumentError([&]() { checkpoint.getTexture("missing"); }));
+
+        Checkpoint::TextureData texture = createTexture(8, 8, ResourceFormat::R32Float, 4);
+        texture.data.pop_back();
+        EXPECT(throwsArgumentError([&]() { checkpoint.setTexture("bad", texture); }));
+    }
+
+    GPU_TEST(CheckpointTexture)
+    {
+        RenderContext* pRenderContext = ctx.getRenderContext();
+        Checkpoint::TextureData data = createTexture(37, 21, ResourceFormat::RGBA32Float, 5);
+        for (size_t i = 0; i < data.data.size(); i += 4) data.data[i + 3] &= 0x3f; // Keep the floats finite.
+
+        Texture::SharedPtr pTexture = Texture::create2D(data.width, data.height, data.format, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+        Checkpoint checkpoint(kType, kVersion);
+        checkpoint.setTexture("flux", data);
+        checkpoint.restoreTexture("flux", pRenderContext, pTexture.get());
+
+        Checkpoint capture(kType, kVersion);
+        capture.captureTexture("flux", pRenderContext, pTexture.get());
+        const Checkpoint::TextureData& result = capture.getTexture("flux");
+        EXPECT_EQ(result.width, data.width);
+        EXPECT_EQ(result.height, data.height);
+        EXPECT(result.format == data.format);
+        EXPECT(result.data == data.data);
+
+        // Restoring into a texture of a different size fails.
+        Texture::SharedPtr pOther = Texture::create2D(16, 16, data.format, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+        bool thrown = false;
+        try { checkpoint.restoreTexture("flux", pRenderContext, pOther.get()); }
+        catch (const ArgumentError&) { thrown = true; }
+        EXPECT(thrown);
+    }
+}
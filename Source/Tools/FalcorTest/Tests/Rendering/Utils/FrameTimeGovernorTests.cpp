@@ -0,0 +1,165 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/FrameTimeGovernor.h"
+#include <deque>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Synthetic frame cost: a fixed part plus a part proportional to the budget.
+        */
+        struct SyntheticLoad
+        {
+            float fixedTime;
+            float fullScaledTime;
+
+            float frameTime(float budget) const { return fixedTime + fullScaledTime * budget; }
+        };
+
+        /** Run the governor for a number of frames. The timings of a frame reach the governor 'latency' frames later, like profiler timings.
+        */
+        void simulate(FrameTimeGovernor& governor, const SyntheticLoad& load, uint32_t frameCount, uint32_t latency)
+        {
+            std::deque<float> budgets;
+            for (uint32_t i = 0; i < frameCount; i++)
+            {
+                budgets.push_back(governor.getBudget());
+                if (budgets.size() > latency)
+                {
+                    float budget = budgets.front();
+                    budgets.pop_front();
+                    governor.update(load.fixedTime, load.fullScaledTime * budget);
+                }
+            }
+        }
+
+        bool isNear(float value, float target, float tolerance) { return std::abs(value - target) <= tolerance * target; }
+    }
+
+    CPU_TEST(FrameTimeGovernorConverges)
+    {
+        FrameTimeGovernor::Options options;
+        options.targetFrameTime = 30.f;
+        FrameTimeGovernor governor(options);
+        EXPECT_EQ(governor.getBudget(), 1.f);
+
+        // Ideal budget is (30 - 10) / 40 = 0.5.
+        SyntheticLoad load = { 10.f, 40.f };
+        simulate(governor, load, 50, 2);
+        EXPECT(isNear(load.frameTime(governor.getBudget()), options.targetFrameTime, options.tolerance));
+        EXPECT(isNear(governor.getPredictedFrameTime(), options.targetFrameTime, options.tolerance));
+
+        // Doubling the scaled cost halves the budget.
+        load.fullScaledTime = 80.f;
+        simulate(governor, load, 200, 2);
+        EXPECT(isNear(load.frameTime(governor.getBudget()), options.targetFrameTime, options.tolerance));
+        EXPECT(isNear(governor.getBudget(), 0.25f, 0.1f));
+
+        // Dropping it again raises the budget back.
+        load.fullScaledTime = 40.f;
+        simulate(governor, load, 200, 2);
+        EXPECT(isNear(load.frameTime(governor.getBudget()), options.targetFrameTime, options.tolerance));
+    }
+
+    CPU_TEST(FrameTimeGovernorLimits)
+    {
+        FrameTimeGovernor::Options options;
+        options.targetFrameTime = 30.f;
+
+        // Under the target the full budget is kept.
+        {
+            FrameTimeGovernor governor(options);
+            for (uint32_t i = 0; i < 10; i++) EXPECT(!governor.update(5.f, 10.f));
+            EXPECT_EQ(governor.getBudget(), 1.f);
+            EXPECT_EQ(governor.getRadiusScale(), 1.f);
+        }
+
+        // If the fixed work alone exceeds the target, the budget goes to its minimum.
+        {
+            FrameTimeGovernor governor(options);
+            simulate(governor, { 40.f, 40.f }, 100, 2);
+            EXPECT_EQ(governor.getBudget(), options.minBudget);
+        }
+
+        // A single update changes the budget by at most maxStepScale.
+        {
+            FrameTimeGovernor governor(options);
+            EXPECT(governor.update(0.f, 1000.f));
+            EXPECT_EQ(governor.getBudget(), 1.f / options.maxStepScale);
+        }
+    }
+
+    CPU_TEST(FrameTimeGovernorSettle)
+    {
+        FrameTimeGovernor::Options options;
+        options.targetFrameTime = 30.f;
+        options.settleFrames = 3;
+        FrameTimeGovernor governor(options);
+
+        EXPECT(governor.update(10.f, 40.f));
+        const float budget = governor.getBudget();
+
+        // Timings right after a change are ignored.
+        for (uint32_t i = 0; i < options.settleFrames; i++)
+        {
+            EXPECT(!governor.update(100.f, 100.f));
+            EXPECT_EQ(governor.getBudget(), budget);
+        }
+        EXPECT(governor.update(100.f, 100.f));
+    }
+
+    CPU_TEST(FrameTimeGovernorRadiusScale)
+    {
+        FrameTimeGovernor governor;
+
+        governor.reset(0.25f);
+        EXPECT_EQ(governor.getBudget(), 0.25f);
+        EXPECT_EQ(governor.getRadiusScale(), 2.f);
+
+        // The budget is clamped to the minimum, and the radius scale to its maximum.
+        governor.reset(0.f);
+        EXPECT_EQ(governor.getBudget(), governor.getOptions().minBudget);
+        EXPECT_EQ(governor.getRadiusScale(), 4.f);
+
+        FrameTimeGovernor::Options options = governor.getOptions();
+        options.maxRadiusScale = 2.f;
+        governor.setOptions(options);
+        EXPECT_EQ(governor.getRadiusScale(), 2.f);
+    }
+
+    CPU_TEST(FrameTimeGovernorInvalidTimes)
+    {
+        FrameTimeGovernor governor;
+        bool thrown = false;
+        try { governor.update(-1.f, 0.f); }
+        catch (const ArgumentError&) { thrown = true; }
+        EXPECT(thrown);
+    }
+}
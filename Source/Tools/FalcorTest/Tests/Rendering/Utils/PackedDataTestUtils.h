@@ -0,0 +1,54 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/Math/Vector.h"
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+    // Helpers shared by the tests of the packed data formats.
+
+    /// Largest relative error of fp16 with round-to-nearest in the normal range.
+    inline constexpr float kHalfRelError = 1.f / 2048.f;
+    /// Largest direction error of the octahedral 2x16 snorm encoding.
+    inline constexpr float kDirError = 2e-4f;
+
+    inline float3 randomDir(std::mt19937& r)
+    {
+        std::uniform_real_distribution<float> u(-1.f, 1.f);
+        float3 d;
+        do { d = float3(u(r), u(r), u(r)); } while (glm::length(d) < 1e-3f || glm::length(d) > 1.f);
+        return glm::normalize(d);
+    }
+
+    inline bool nearlyEqualHalf(float a, float b)
+    {
+        return std::abs(a - b) <= kHalfRelError * std::abs(b);
+    }
+}
@@ -0,0 +1,257 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "PackedDataTestUtils.h"
+#include "Rendering/Utils/PackedSampleData.slang"
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        struct Bounds
+        {
+            float3 corner;
+            float3 dimension;
+        };
+
+        Bounds randomBounds(std::mt19937& r)
+        {
+            std::uniform_real_distribution<float> u(0.f, 1.f);
+            Bounds b;
+            b.corner = float3(u(r), u(r), u(r)) * 200.f - 100.f;
+            b.dimension = float3(std::pow(10.f, -1.f + 3.f * u(r)), std::pow(10.f, -1.f + 3.f * u(r)), std::pow(10.f, -1.f + 3.f * u(r)));
+            return b;
+        }
+
+        float3 randomPosition(std::mt19937& r, const Bounds& b)
+        {
+            std::uniform_real_distribution<float> u(0.f, 1.f);
+            // Cluster some of the points around the center to cover the small exponents.
+            float3 t = float3(u(r), u(r), u(r));
+            float shrink = std::pow(2.f, -20.f * u(r));
+            return getPackedPositionCenter(b.corner, b.dimension) + (t - 0.5f) * shrink * b.dimension;
+        }
+
+        /** Check a decoded position against the quantization error bound of the shared exponent encoding.
+        */
+        bool nearlyEqualPosition(const float3& decoded, const float3& pos, const Bounds& b)
+        {
+            const float3 center = getPackedPositionCenter(b.corner, b.dimension);
+            const float3 halfExtent = getPackedPositionHalfExtent(b.dimension);
+            const float3 p = glm::abs((pos - center) / halfExtent);
+            const float maxAbs = std::max(std::max(p.x, p.y), p.z);
+            // The shared scale is below twice the largest component, unless it is clamped to the smallest exponent.
+            const float scale = std::max(2.f * maxAbs, std::ldexp(1.f, -(int)kPackedPositionMaxExponent));
+            for (int c = 0; c < 3; c++)
+            {
+                float bound = 0.5f * halfExtent[c] * scale / kPackedPositionMaxMantissa + 1e-6f * (std::abs(center[c]) + halfExtent[c]);
+                if (std::abs(decoded[c] - pos[c]) > bound) return false;
+            }
+            return true;
+        }
+    }
+
+    CPU_TEST(PackedSamplePositionRoundTrip)
+    {
+        std::mt19937 r;
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            Bounds b = randomBounds(r);
+            float3 pos = randomPosition(r, b);
+            uint2 packed = encodePositionSharedExp(pos, b.corner, b.dimension);
+            float3 decoded = decodePositionSharedExp(packed, b.corner, b.dimension);
+            EXPECT(nearlyEqualPosition(decoded, pos, b)) << "i = " << i << ", pos = " << to_string(pos) << ", decoded = " << to_string(decoded);
+
+            // Positions carried over between frames are re-encoded every frame, which must not drift.
+            float3 carried = pos;
+            for (uint32_t frame = 0; frame < 16; frame++) carried = decodePositionSharedExp(encodePositionSharedExp(carried, b.corner, b.dimension), b.corner, b.dimension);
+            EXPECT(nearlyEqualPosition(carried, pos, b)) << "i = " << i << ", pos = " << to_string(pos) << ", carried = " << to_string(carried);
+        }
+    }
+
+    CPU_TEST(PackedSamplePositionBounds)
+    {
+        const Bounds b = { float3(-1.f, 2.f, 10.f), float3(4.f, 2.f, 8.f) };
+
+        // The corners of the bounds are exact.
+        EXPECT(decodePositionSharedExp(encodePositionSharedExp(b.corner, b.corner, b.dimension), b.corner, b.dimension) == b.corner);
+        EXPECT(decodePositionSharedExp(encodePositionSharedExp(b.corner + b.dimension, b.corner, b.dimension), b.corner, b.dimension) == b.corner + b.dimension);
+
+        // Positions outside the bounds are clamped.
+        float3 decoded = decodePositionSharedExp(encodePositionSharedExp(float3(-5.f, 3.f, 30.f), b.corner, b.dimension), b.corner, b.dimension);
+        EXPECT(decoded == float3(-1.f, 3.f, 18.f)) << to_string(decoded);
+
+        // Flat bounds map all positions to the plane.
+        const Bounds flat = { float3(0.f), float3(2.f, 0.f, 2.f) };
+        decoded = decodePositionSharedExp(encodePositionSharedExp(float3(0.5f, 0.f, 1.5f), flat.corner, flat.dimension), flat.corner, flat.dimension);
+        EXPECT(nearlyEqualPosition(decoded, float3(0.5f, 0.f, 1.5f), flat)) << to_string(decoded);
+    }
+
+    CPU_TEST(PackedSamplePointRoundTrip)
+    {
+        std::mt19937 r;
+        std::uniform_real_distribution<float> u(0.f, 1.f);
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            Bounds b = randomBounds(r);
+            SamplePointData d;
+            d.pos = randomPosition(r, b);
+            d.w = std::pow(10.f, -10.f + 20.f * u(r));
+            d.normal = randomDir(r);
+
+            SamplePointData e = unpackSamplePoint(packSamplePoint(d, b.corner, b.dimension), b.corner, b.dimension);
+            EXPECT(nearlyEqualPosition(e.pos, d.pos, b)) << "i = " << i;
+            EXPECT_EQ(e.w, d.w) << "i = " << i;
+            EXPECT_LE(glm::length(e.normal - d.normal), kDirError) << "i = " << i;
+        }
+    }
+
+    CPU_TEST(PackedSamplePointPdf)
+    {
+        // The pdf towards a reservoir sample is stored in the w slot of the hit point, which must hold values outside the fp16 range.
+        const Bounds b = { float3(-1.f), float3(2.f) };
+        for (float pdf : { 1e6f, 3.4e38f, 1e-9f })
+        {
+            SamplePointData d;
+            d.pos = float3(0.25f, -0.5f, 0.75f);
+            d.w = pdf;
+            d.normal = float3(0.f, 0.f, 1.f);
+            EXPECT_EQ(unpackSamplePoint(packSamplePoint(d, b.corner, b.dimension), b.corner, b.dimension).w, pdf);
+        }
+    }
+
+    CPU_TEST(PackedSampleRadiance)
+    {
+        std::mt19937 r;
+        std::uniform_real_distribution<float> u(0.f, 1.f);
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            float4 v = float4(std::pow(10.f, -3.f + 7.f * u(r)), std::pow(10.f, -3.f + 7.f * u(r)), std::pow(10.f, -3.f + 7.f * u(r)), std::pow(10.f, -3.f + 7.f * u(r)));
+            float4 e = unpackSampleRadiance(packSampleRadiance(v));
+            for (int c = 0; c < 4; c++) EXPECT(nearlyEqualHalf(e[c], v[c])) << "i = " << i << ", v = " << v[c];
+        }
+
+        // Values beyond the fp16 range are clamped instead of becoming infinite.
+        float4 e = unpackSampleRadiance(packSampleRadiance(float4(1e6f, 0.f, std::numeric_limits<float>::infinity(), -1e9f)));
+        EXPECT(e == float4(kPackedSampleMaxHalf, 0.f, kPackedSampleMaxHalf, -kPackedSampleMaxHalf)) << to_string(e);
+    }
+
+    CPU_TEST(PackedGatherPointRoundTrip)
+    {
+        std::mt19937 r;
+        std::uniform_real_distribution<float> u(0.f, 1.f);
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            Bounds b = randomBounds(r);
+            const float diagonal = glm::length(b.dimension);
+
+            GatherPointData d;
+            d.flux = float3(std::pow(10.f, -10.f + 20.f * u(r)), std::pow(10.f, -10.f + 20.f * u(r)), std::pow(10.f, -10.f + 20.f * u(r)));
+            d.photonCount = 1e5f * u(r);
+            d.pos = randomPosition(r, b);
+            d.radius = diagonal * std::pow(10.f, -8.f + 7.f * u(r));
+            d.newRadius = d.radius * u(r);
+            d.normal = randomDir(r);
+            d.iteration = r();
+
+            GatherPointData e = unpackGatherPoint(packGatherPoint(d, b.corner, b.dimension), b.corner, b.dimension);
+
+            // Exactly preserved.
+            EXPECT(e.flux == d.flux) << "i = " << i;
+            EXPECT_EQ(e.photonCount, d.photonCount);
+            EXPECT_EQ(e.radius, d.radius);
+            EXPECT_EQ(e.newRadius, d.newRadius);
+            EXPECT_EQ(e.iteration, d.iteration);
+
+            // Quantized.
+            EXPECT(nearlyEqualPosition(e.pos, d.pos, b)) << "i = " << i;
+            EXPECT_LE(glm::length(e.normal - d.normal), kDirError) << "i = " << i;
+        }
+    }
+
+    CPU_TEST(PackedGatherPointProgressiveUpdate)
+    {
+        // Run the progressive photon mapping update of the temporal reuse on a gather point that is carried over
+        // between frames, once in the packed layout and once in full precision. The radius shrinks and the flux
+        // is rescaled every iteration, so any rounding of them would accumulate and bias the estimate.
+        const Bounds b = { float3(-10.f), float3(20.f) };
+        const float kAlpha = 0.667f;
+
+        GatherPointData reference = {};
+        reference.pos = float3(1.f, 2.f, 3.f);
+        reference.normal = float3(0.f, 1.f, 0.f);
+        reference.radius = 0.05f;
+        reference.newRadius = 0.05f;
+        reference.iteration = 1;
+        GatherPointData packed = reference;
+
+        auto update = [&](GatherPointData& d, float3 phi, float M)
+        {
+            float nextN = d.photonCount + kAlpha * M;
+            float reduction = nextN / (d.photonCount + M);
+            d.flux = (d.flux + phi) * reduction;
+            d.photonCount = nextN;
+            d.newRadius = d.newRadius * std::sqrt(reduction);
+            d.iteration++;
+        };
+        auto estimate = [](const GatherPointData& d) { return d.flux / (d.newRadius * d.newRadius * (float)d.iteration); };
+
+        std::mt19937 r;
+        std::uniform_real_distribution<float> u(0.f, 1.f);
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            const float M = (float)(1 + r() % 8);
+            const float3 phi = float3(u(r), u(r), u(r)) * M;
+            update(reference, phi, M);
+            update(packed, phi, M);
+            packed = unpackGatherPoint(packGatherPoint(packed, b.corner, b.dimension), b.corner, b.dimension);
+        }
+
+        EXPECT_LT(reference.newRadius, 0.01f * reference.radius);
+        EXPECT_EQ(packed.newRadius, reference.newRadius);
+        EXPECT(packed.flux == reference.flux);
+        EXPECT_EQ(packed.iteration, reference.iteration);
+        const float3 e = estimate(packed);
+        const float3 ref = estimate(reference);
+        for (int c = 0; c < 3; c++) EXPECT_LE(std::abs(e[c] - ref[c]), 1e-5f * ref[c]) << "c = " << c;
+    }
+
+    CPU_TEST(PackedGatherPointCleared)
+    {
+        // Cleared textures unpack to an empty gather point, which the temporal reuse treats as invalid.
+        const Bounds b = { float3(-1.f), float3(2.f) };
+        PackedGatherPoint p = {};
+        GatherPointData d = unpackGatherPoint(p, b.corner, b.dimension);
+        EXPECT_EQ(d.iteration, 0u);
+        EXPECT_EQ(d.photonCount, 0.f);
+        EXPECT(d.flux == float3(0.f));
+        EXPECT_EQ(d.radius, 0.f);
+        EXPECT(d.pos == float3(0.f));
+    }
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "PackedDataTestUtils.h"
+#include "Rendering/Utils/PackedVertexInfo.slang"
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        VertexInfoData randomVertexInfo(std::mt19937& r)
+        {
+            std::uniform_real_distribution<float> u(0.f, 1.f);
+            // Values span several orders of magnitude within the normal fp16 range.
+            auto randomScalar = [&]() { return std::pow(10.f, -3.f + 7.f * u(r)); };
+
+            VertexInfoData v;
+            v.hitData = uint4(r(), r(), r(), r());
+            v.origin = float3(u(r), u(r), u(r)) * 100.f - 50.f;
+            v.dir = randomDir(r);
+            v.originN = randomDir(r);
+            v.beta = float3(randomScalar(), randomScalar(), randomScalar());
+            v.pdfFwd = randomScalar();
+            v.pdfRev = randomScalar();
+            v.flagAndType = r() & 0x3f;
+            v.de = randomScalar();
+            v.pe = randomScalar();
+            v.prevIndex = r();
+            return v;
+        }
+    }
+
+    CPU_TEST(PackedVertexInfoRoundTrip)
+    {
+        std::mt19937 r;
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            VertexInfoData v = randomVertexInfo(r);
+            VertexInfoData u = unpackVertexInfo(packVertexInfo(v));
+
+            // Exactly preserved.
+            EXPECT(u.hitData == v.hitData);
+            EXPECT(u.origin == v.origin);
+            EXPECT_EQ(u.flagAndType, v.flagAndType);
+            EXPECT_EQ(u.de, v.de);
+            EXPECT_EQ(u.pe, v.pe);
+            EXPECT_EQ(u.prevIndex, 0u);
+
+            // Quantized.
+            EXPECT_LE(glm::length(u.dir - v.dir), kDirError) << "i = " << i;
+            EXPECT_LE(glm::length(u.originN - v.originN), kDirError) << "i = " << i;
+            for (int c = 0; c < 3; c++) EXPECT(nearlyEqualHalf(u.beta[c], v.beta[c])) << "i = " << i << ", beta = " << v.beta[c];
+            EXPECT(nearlyEqualHalf(u.pdfFwd, v.pdfFwd)) << "i = " << i << ", pdfFwd = " << v.pdfFwd;
+            EXPECT(nearlyEqualHalf(u.pdfRev, v.pdfRev)) << "i = " << i << ", pdfRev = " << v.pdfRev;
+        }
+    }
+
+    CPU_TEST(PackedVertexInfoClamp)
+    {
+        std::mt19937 r;
+        VertexInfoData v = randomVertexInfo(r);
+        v.beta = float3(1e6f, 0.f, 65504.f);
+        v.pdfFwd = 1e9f;
+        v.pdfRev = std::numeric_limits<float>::infinity();
+
+        // Values beyond the fp16 range are clamped instead of becoming infinite.
+        VertexInfoData u = unpackVertexInfo(packVertexInfo(v));
+        EXPECT_EQ(u.beta.x, kPackedVertexInfoMaxHalf);
+        EXPECT_EQ(u.beta.y, 0.f);
+        EXPECT_EQ(u.beta.z, kPackedVertexInfoMaxHalf);
+        EXPECT_EQ(u.pdfFwd, kPackedVertexInfoMaxHalf);
+        EXPECT_EQ(u.pdfRev, kPackedVertexInfoMaxHalf);
+    }
+
+    CPU_TEST(PackedVertexInfoAxes)
+    {
+        // The octahedral encoding is exact for the principal axes.
+        const float3 axes[] = { float3(1, 0, 0), float3(-1, 0, 0), float3(0, 1, 0), float3(0, -1, 0), float3(0, 0, 1), float3(0, 0, -1) };
+        std::mt19937 r;
+        for (const float3& axis : axes)
+        {
+            VertexInfoData v = randomVertexInfo(r);
+            v.dir = axis;
+            v.originN = -axis;
+            VertexInfoData u = unpackVertexInfo(packVertexInfo(v));
+            EXPECT(u.dir == axis) << to_string(u.dir);
+            EXPECT(u.originN == -axis) << to_string(u.originN);
+        }
+    }
+}
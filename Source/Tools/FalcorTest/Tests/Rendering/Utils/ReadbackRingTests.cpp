@@ -0,0 +1,143 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/ReadbackRing.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Mock staging buffer holding a single uint32_t.
+        */
+        struct MockBuffer
+        {
+            uint32_t value = 0;
+            uint32_t mapCount = 0;
+            bool mapped = false;
+
+            void* map(Buffer::MapType type)
+            {
+                mapped = true;
+                mapCount++;
+                return &value;
+            }
+            void unmap() { mapped = false; }
+        };
+
+        using MockRing = ReadbackRing<MockBuffer>;
+
+        std::vector<std::shared_ptr<MockBuffer>> createSlots(uint32_t count)
+        {
+            std::vector<std::shared_ptr<MockBuffer>> slots(count);
+            for (auto& pSlot : slots) pSlot = std::make_shared<MockBuffer>();
+            return slots;
+        }
+
+        void push(MockRing& ring, uint32_t value, uint64_t fenceValue)
+        {
+            MockBuffer* pSlot = ring.beginWrite();
+            FALCOR_ASSERT(pSlot);
+            pSlot->value = value;
+            ring.endWrite(fenceValue);
+        }
+    }
+
+    CPU_TEST(ReadbackRingDelayed)
+    {
+        auto slots = createSlots(3);
+        MockRing ring(slots);
+        EXPECT_EQ(ring.getLatency(), 3u);
+
+        uint32_t result = 0;
+        EXPECT(!ring.poll(0, &result, sizeof(result)));
+
+        // Nothing is visible before the GPU passes the fence.
+        push(ring, 10, 1);
+        EXPECT(!ring.poll(0, &result, sizeof(result)));
+        EXPECT_EQ(ring.getInFlightCount(), 1u);
+
+        push(ring, 20, 2);
+        EXPECT(ring.poll(1, &result, sizeof(result)));
+        EXPECT_EQ(result, 10u);
+        EXPECT_EQ(ring.getInFlightCount(), 1u);
+
+        // The same data is not returned twice.
+        EXPECT(!ring.poll(1, &result, sizeof(result)));
+
+        EXPECT(ring.poll(2, &result, sizeof(result)));
+        EXPECT_EQ(result, 20u);
+        EXPECT_EQ(ring.getInFlightCount(), 0u);
+
+        for (const auto& pSlot : slots) EXPECT(!pSlot->mapped);
+    }
+
+    CPU_TEST(ReadbackRingNewestWins)
+    {
+        auto slots = createSlots(4);
+        MockRing ring(slots);
+
+        push(ring, 1, 1);
+        push(ring, 2, 2);
+        push(ring, 3, 3);
+
+        // When several slots complete at once only the newest one is mapped, and all of them are released.
+        uint32_t result = 0;
+        EXPECT(ring.poll(3, &result, sizeof(result)));
+        EXPECT_EQ(result, 3u);
+        EXPECT_EQ(ring.getInFlightCount(), 0u);
+        EXPECT_EQ(slots[0]->mapCount, 0u);
+        EXPECT_EQ(slots[1]->mapCount, 0u);
+        EXPECT_EQ(slots[2]->mapCount, 1u);
+    }
+
+    CPU_TEST(ReadbackRingFull)
+    {
+        auto slots = createSlots(2);
+        MockRing ring(slots);
+
+        push(ring, 1, 1);
+        push(ring, 2, 2);
+
+        // All slots in flight: the write is skipped rather than waiting for the GPU.
+        EXPECT(ring.beginWrite() == nullptr);
+
+        uint32_t result = 0;
+        EXPECT(ring.poll(1, &result, sizeof(result)));
+        EXPECT_EQ(result, 1u);
+
+        // The oldest slot is reused first.
+        MockBuffer* pSlot = ring.beginWrite();
+        EXPECT(pSlot == slots[0].get());
+        pSlot->value = 3;
+        ring.endWrite(3);
+
+        EXPECT(ring.poll(3, &result, sizeof(result)));
+        EXPECT_EQ(result, 3u);
+        EXPECT_EQ(ring.getInFlightCount(), 0u);
+    }
+}
@@ -0,0 +1,167 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "../Utils/MeshTestUtils.h"
+#include "Scene/Meshlets.h"
+#include <set>
+
+namespace Falcor
+{
+    namespace
+    {
+        void testMeshletLimits(CPUUnitTestContext& ctx, const TestMesh& mesh, const MeshletBuilder::Settings& settings)
+        {
+            auto result = MeshletBuilder::build(mesh.indices, mesh.positions, false, settings);
+            EXPECT_EQ(result.indices.size(), mesh.indices.size());
+            EXPECT(getSortedTriangles(result.indices) == getSortedTriangles(mesh.indices));
+
+            uint32_t triangleOffset = 0;
+            for (const auto& meshlet : result.meshlets)
+            {
+                EXPECT_EQ(meshlet.triangleOffset, triangleOffset);
+                EXPECT_GT(meshlet.triangleCount, 0u);
+                EXPECT_LE(meshlet.triangleCount, settings.maxTriangles);
+                EXPECT_LE(meshlet.vertexCount, settings.maxVertices);
+
+                auto first = result.indices.begin() + meshlet.triangleOffset * 3;
+                std::set<uint32_t> vertices(first, first + meshlet.triangleCount * 3);
+                EXPECT_EQ(meshlet.vertexCount, vertices.size());
+
+                triangleOffset += meshlet.triangleCount;
+            }
+            EXPECT_EQ(triangleOffset * 3, mesh.indices.size());
+        }
+    }
+
+    CPU_TEST(MeshletBuilderLimits)
+    {
+        TestMesh mesh = createGrid(64);
+        testMeshletLimits(ctx, mesh, MeshletBuilder::Settings());
+
+        MeshletBuilder::Settings settings;
+        settings.maxVertices = 32;
+        settings.maxTriangles = 16;
+        testMeshletLimits(ctx, mesh, settings);
+
+        // A full meshlet of a regular grid should approach two triangles per vertex.
+        auto result = MeshletBuilder::build(mesh.indices, mesh.positions, false, MeshletBuilder::Settings());
+        EXPECT_LE(result.meshlets.size(), 100u);
+
+        bool caught = false;
+        try
+        {
+            settings.maxVertices = 2;
+            MeshletBuilder::build(mesh.indices, mesh.positions, false, settings);
+        }
+        catch (const ArgumentError&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+    }
+
+    CPU_TEST(MeshletBuilderBounds)
+    {
+        TestMesh mesh = createGrid(64);
+
+        for (bool isFrontFaceCW : { false, true })
+        {
+            auto result = MeshletBuilder::build(mesh.indices, mesh.positions, isFrontFaceCW, MeshletBuilder::Settings());
+            for (const auto& meshlet : result.meshlets)
+            {
+                for (uint32_t i = meshlet.triangleOffset * 3; i < (meshlet.triangleOffset + meshlet.triangleCount) * 3; i++)
+                {
+                    EXPECT_LE(length(mesh.positions[result.indices[i]] - meshlet.center), meshlet.radius * 1.0001f);
+                }
+
+                // The grid is flat, so the cones are tight around the grid normal.
+                float expectedZ = isFrontFaceCW ? -1.f : 1.f;
+                EXPECT_GE(meshlet.coneAxis.z * expectedZ, 0.999f);
+                EXPECT_LE(meshlet.coneCutoff, 0.01f);
+            }
+        }
+    }
+
+    CPU_TEST(MeshletFrustumCulling)
+    {
+        TestMesh mesh = createGrid(64);
+        auto result = MeshletBuilder::build(mesh.indices, mesh.positions, false, MeshletBuilder::Settings());
+        const size_t meshletCount = result.meshlets.size();
+
+        const float3 eye(32.f, 32.f, 10.f);
+        rmcv::mat4 proj = rmcv::perspective(0.5f, 1.f, 0.1f, 100.f);
+        auto frustum = CullingFrustum::create(proj * rmcv::lookAt(eye, float3(32.f, 32.f, 0.f), float3(0.f, 1.f, 0.f)), eye);
+
+        std::vector<uint32_t> visible;
+        cullMeshlets(result.meshlets, rmcv::identity<rmcv::mat4>(), frustum, false, visible);
+        EXPECT_GT(visible.size(), 0u);
+        EXPECT_LT(visible.size(), meshletCount);
+        for (uint32_t meshletIndex : visible)
+        {
+            const auto& meshlet = result.meshlets[meshletIndex];
+            EXPECT(!frustum.isSphereCulled(meshlet.center, meshlet.radius));
+        }
+
+        // The grid faces the camera.
+        std::vector<uint32_t> visibleFront;
+        cullMeshlets(result.meshlets, rmcv::identity<rmcv::mat4>(), frustum, true, visibleFront);
+        EXPECT(visibleFront == visible);
+
+        // Scaling the instance up moves more meshlets out of the frustum.
+        rmcv::mat4 worldMat = rmcv::translate(float3(-96.f, -96.f, 0.f)) * rmcv::scale(float3(4.f));
+        std::vector<uint32_t> visibleScaled;
+        cullMeshlets(result.meshlets, worldMat, frustum, false, visibleScaled);
+        EXPECT_GT(visibleScaled.size(), 0u);
+        EXPECT_LT(visibleScaled.size(), visible.size());
+
+        // Looking away from the grid culls all meshlets.
+        frustum = CullingFrustum::create(proj * rmcv::lookAt(eye, float3(32.f, 32.f, 20.f), float3(0.f, 1.f, 0.f)), eye);
+        visible.clear();
+        cullMeshlets(result.meshlets, rmcv::identity<rmcv::mat4>(), frustum, false, visible);
+        EXPECT_EQ(visible.size(), 0u);
+    }
+
+    CPU_TEST(MeshletBackfaceCulling)
+    {
+        TestMesh mesh = createGrid(64);
+        auto result = MeshletBuilder::build(mesh.indices, mesh.positions, false, MeshletBuilder::Settings());
+
+        // View the grid from below.
+        const float3 eye(32.f, 32.f, -10.f);
+        rmcv::mat4 viewProj = rmcv::perspective(0.5f, 1.f, 0.1f, 100.f) * rmcv::lookAt(eye, float3(32.f, 32.f, 0.f), float3(0.f, 1.f, 0.f));
+        auto frustum = CullingFrustum::create(viewProj, eye);
+
+        std::vector<uint32_t> visible;
+        cullMeshlets(result.meshlets, rmcv::identity<rmcv::mat4>(), frustum, false, visible);
+        EXPECT_GT(visible.size(), 0u);
+
+        visible.clear();
+        cullMeshlets(result.meshlets, rmcv::identity<rmcv::mat4>(), frustum, true, visible);
+        EXPECT_EQ(visible.size(), 0u);
+    }
+}
@@ -0,0 +1,479 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        using Mesh = SceneBuilder::Mesh;
+        using VertexWeldSettings = SceneBuilder::VertexWeldSettings;
+
+        struct TestMesh
+        {
+            std::vector<uint32_t> indices;
+            std::vector<float3> positions;
+            std::vector<float3> normals;
+            std::vector<float4> tangents;
+            std::vector<float2> texCrds;
+
+            Mesh getDesc(const Material::SharedPtr& pMaterial) const
+            {
+                Mesh mesh;
+                mesh.name = "TestMesh";
+                mesh.faceCount = (uint32_t)indices.size() / 3;
+                mesh.vertexCount = (uint32_t)positions.size();
+                mesh.indexCount = (uint32_t)indices.size();
+                mesh.pIndices = indices.data();
+                mesh.topology = Vao::Topology::TriangleList;
+                mesh.pMaterial = pMaterial;
+                mesh.positions = { positions.data(), Mesh::AttributeFrequency::Vertex };
+                mesh.normals = { normals.data(), Mesh::AttributeFrequency::Vertex };
+                mesh.tangents = { tangents.data(), Mesh::AttributeFrequency::Vertex };
+                mesh.texCrds = { texCrds.data(), Mesh::AttributeFrequency::Vertex };
+                mesh.useOriginalTangentSpace = true;
+                return mesh;
+            }
+
+            void addVertex(float3 position, float2 texCrd)
+            {
+                indices.push_back((uint32_t)positions.size());
+                positions.push_back(position);
+                normals.push_back(float3(0.f, 0.f, 1.f));
+                tangents.push_back(float4(1.f, 0.f, 0.f, 1.f));
+                texCrds.push_back(texCrd);
+            }
+        };
+
+        /** Create a grid of quads in the xy-plane. Each triangle has its own vertex indices, as in meshes imported from OBJ files.
+        */
+        TestMesh createSplitGrid(uint32_t size)
+        {
+            TestMesh mesh;
+            mesh.indices.reserve(size * size * 6);
+            mesh.positions.reserve(size * size * 6);
+            mesh.normals.reserve(size * size * 6);
+            mesh.tangents.reserve(size * size * 6);
+            mesh.texCrds.reserve(size * size * 6);
+
+            const uint2 corners[6] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+            for (uint32_t y = 0; y < size; y++)
+            {
+                for (uint32_t x = 0; x < size; x++)
+                {
+                    for (const uint2& c : corners)
+                    {
+                        float2 p = float2(x + c.x, y + c.y) / (float)size;
+                        mesh.addVertex(float3(p, 0.f), p);
+                    }
+                }
+            }
+            return mesh;
+        }
+
+        /** Create a grid of quads in the xy-plane where all triangles share their vertex indices.
+        */
+        TestMesh createSharedGrid(uint32_t size)
+        {
+            TestMesh mesh;
+            for (uint32_t y = 0; y <= size; y++)
+            {
+                for (uint32_t x = 0; x <= size; x++)
+                {
+                    float2 p = float2(x, y) / (float)size;
+                    mesh.addVertex(float3(p, 0.f), p);
+                }
+            }
+            mesh.indices.clear();
+            for (uint32_t y = 0; y < size; y++)
+            {
+                for (uint32_t x = 0; x < size; x++)
+                {
+                    uint32_t i = y * (size + 1) + x;
+                    for (uint32_t index : { i, i + 1, i + size + 2, i, i + size + 2, i + size + 1 }) mesh.indices.push_back(index);
+                }
+            }
+            return mesh;
+        }
+
+        SceneBuilder::ProcessedMesh processMesh(const TestMesh& mesh, const VertexWeldSettings& settings)
+        {
+            auto pBuilder = SceneBuilder::create();
+            pBuilder->setVertexWeldSettings(settings);
+            return pBuilder->processMesh(mesh.getDesc(StandardMaterial::create("TestMaterial")));
+        }
+
+        VertexWeldSettings getHashSettings(float positionEpsilon = 0.f)
+        {
+            VertexWeldSettings settings;
+            settings.mode = VertexWeldSettings::Mode::Hash;
+            settings.positionEpsilon = positionEpsilon;
+            return settings;
+        }
+
+        /** Add one instance of each mesh and build the scene.
+        */
+        Scene::SharedPtr buildScene(const SceneBuilder::SharedPtr& pBuilder, const std::vector<MeshID>& meshIDs)
+        {
+            for (MeshID meshID : meshIDs) pBuilder->addMeshInstance(pBuilder->addNode(SceneBuilder::Node()), meshID);
+            return pBuilder->getScene();
+        }
+
+        /** Check that two scenes have the same meshes in the same order.
+        */
+        bool isSameMeshes(const Scene::SharedPtr& pScene, const Scene::SharedPtr& pReference)
+        {
+            if (pScene->getMeshCount() != pReference->getMeshCount()) return false;
+            for (uint32_t i = 0; i < pScene->getMeshCount(); i++)
+            {
+                const auto& mesh = pScene->getMesh(MeshID(i));
+                const auto& reference = pReference->getMesh(MeshID(i));
+                if (pScene->getMeshName(i) != pReference->getMeshName(i)) return false;
+                if (mesh.vertexCount != reference.vertexCount || mesh.indexCount != reference.indexCount) return false;
+            }
+            return true;
+        }
+    }
+
+    GPU_TEST(VertexWeldTopology)
+    {
+        // The default mode only merges vertices with the same original index.
+        TestMesh mesh = createSplitGrid(1);
+        mesh.indices[3] = 0;
+        mesh.indices[4] = 2;
+
+        auto processed = processMesh(mesh, VertexWeldSettings());
+        EXPECT_EQ(processed.staticData.size(), 4u);
+        EXPECT_EQ(processed.inputVertexCount, 6u);
+        EXPECT_EQ(processed.removedVertexCount, 2u);
+    }
+
+    GPU_TEST(VertexWeldHash)
+    {
+        TestMesh mesh = createSplitGrid(2);
+        EXPECT_EQ(processMesh(mesh, VertexWeldSettings()).staticData.size(), 24u);
+
+        auto processed = processMesh(mesh, getHashSettings());
+        EXPECT_EQ(processed.staticData.size(), 9u);
+        EXPECT_EQ(processed.removedVertexCount, 15u);
+        EXPECT(processed.use16BitIndices);
+
+        // Check that the welded triangles have the original positions.
+        EXPECT_EQ(processed.indexCount, mesh.indices.size());
+        if (processed.indexCount != mesh.indices.size()) return;
+        const uint16_t* pIndices = reinterpret_cast<const uint16_t*>(processed.indexData.data());
+        for (size_t i = 0; i < mesh.indices.size(); i++)
+        {
+            EXPECT(processed.staticData[pIndices[i]].position == mesh.positions[i]) << "i = " << i;
+        }
+    }
+
+    GPU_TEST(VertexWeldHashEpsilon)
+    {
+        TestMesh mesh = createSplitGrid(2);
+        mesh.positions[1].x += 1e-5f;
+        mesh.positions[7].y -= 1e-5f;
+
+        // Positions need to be identical by default.
+        EXPECT_EQ(processMesh(mesh, getHashSettings()).staticData.size(), 11u);
+        EXPECT_EQ(processMesh(mesh, getHashSettings(1e-4f)).staticData.size(), 9u);
+    }
+
+    GPU_TEST(VertexWeldHashAttributes)
+    {
+        // Vertices at a texture seam are only merged if the texture coordinates are ignored.
+        TestMesh mesh = createSplitGrid(1);
+        mesh.texCrds[3] = float2(0.5f);
+
+        auto settings = getHashSettings();
+        EXPECT_EQ(processMesh(mesh, settings).staticData.size(), 5u);
+
+        settings.attributes &= ~VertexWeldSettings::Attributes::TexCrd;
+        EXPECT_EQ(processMesh(mesh, settings).staticData.size(), 4u);
+
+        // Vertices with opposite tangent handedness are never merged unless tangents are ignored.
+        mesh = createSplitGrid(1);
+        mesh.tangents[3].w = -1.f;
+        EXPECT_EQ(processMesh(mesh, settings).staticData.size(), 5u);
+        settings.attributes &= ~VertexWeldSettings::Attributes::Tangent;
+        EXPECT_EQ(processMesh(mesh, settings).staticData.size(), 4u);
+    }
+
+    GPU_TEST(VertexWeldStats)
+    {
+        auto pBuilder = SceneBuilder::create(SceneBuilder::Flags::WeldVerticesByHash);
+        EXPECT(pBuilder->getVertexWeldSettings().mode == VertexWeldSettings::Mode::Hash);
+
+        auto pMaterial = StandardMaterial::create("TestMaterial");
+        TestMesh mesh = createSplitGrid(2);
+        pBuilder->addMesh(mesh.getDesc(pMaterial));
+        pBuilder->addMesh(mesh.getDesc(pMaterial));
+
+        EXPECT_EQ(pBuilder->getVertexWeldStats().inputVertexCount, 48u);
+        EXPECT_EQ(pBuilder->getVertexWeldStats().removedVertexCount, 30u);
+    }
+
+    GPU_TEST(SceneBuilderAddMeshes)
+    {
+        // Adding a batch of meshes must give the same mesh IDs in the same order as adding them one at a time.
+        auto pMaterial = StandardMaterial::create("TestMaterial");
+        std::vector<TestMesh> testMeshes;
+        for (uint32_t size = 1; size <= 8; size++) testMeshes.push_back(createSharedGrid(size));
+        std::vector<Mesh> meshes;
+        for (size_t i = 0; i < testMeshes.size(); i++)
+        {
+            meshes.push_back(testMeshes[i].getDesc(pMaterial));
+            meshes.back().name = "Mesh" + std::to_string(i);
+        }
+
+        auto pSingleBuilder = SceneBuilder::create();
+        std::vector<MeshID> singleIDs;
+        for (const auto& mesh : meshes) singleIDs.push_back(pSingleBuilder->addMesh(mesh));
+
+        auto pBatchBuilder = SceneBuilder::create();
+        pBatchBuilder->addMesh(meshes[0]);
+        std::vector<MeshID> batchIDs = pBatchBuilder->addMeshes(fstd::span<const Mesh>(meshes.data() + 1, meshes.size() - 1));
+        batchIDs.insert(batchIDs.begin(), MeshID{ 0 });
+
+        EXPECT(batchIDs == singleIDs);
+        if (batchIDs != singleIDs) return;
+        for (size_t i = 0; i < singleIDs.size(); i++) EXPECT_EQ(singleIDs[i].get(), (uint32_t)i) << "i = " << i;
+
+        // The meshes end up with the same content in both scenes.
+        EXPECT(isSameMeshes(buildScene(pBatchBuilder, batchIDs), buildScene(pSingleBuilder, singleIDs)));
+    }
+
+    GPU_TEST(SceneBuilderAddTriangleMeshes)
+    {
+        auto pMaterial = StandardMaterial::create("TestMaterial");
+        std::vector<TriangleMesh::SharedPtr> triangleMeshes = { TriangleMesh::createQuad(), TriangleMesh::createCube(), TriangleMesh::createSphere(), TriangleMesh::createDisk(1.f) };
+        std::vector<Material::SharedPtr> materials(triangleMeshes.size(), pMaterial);
+
+        auto pSingleBuilder = SceneBuilder::create();
+        std::vector<MeshID> singleIDs;
+        for (const auto& pTriangleMesh : triangleMeshes) singleIDs.push_back(pSingleBuilder->addTriangleMesh(pTriangleMesh, pMaterial));
+
+        auto pBatchBuilder = SceneBuilder::create();
+        std::vector<MeshID> batchIDs = pBatchBuilder->addTriangleMeshes(triangleMeshes, materials);
+        EXPECT(batchIDs == singleIDs);
+        if (batchIDs != singleIDs) return;
+
+        bool caught = false;
+        try
+        {
+            pBatchBuilder->addTriangleMeshes(triangleMeshes, { pMaterial });
+        }
+        catch (const ArgumentError&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+
+        // The meshes have different vertex counts, so this also checks that they were added in the input order.
+        EXPECT(isSameMeshes(buildScene(pBatchBuilder, batchIDs), buildScene(pSingleBuilder, singleIDs)));
+    }
+
+    GPU_TEST(SceneBuilderOptimizeVertexCache)
+    {
+        auto pBuilder = SceneBuilder::create(SceneBuilder::Flags::OptimizeVertexCache | SceneBuilder::Flags::Force32BitIndices);
+        TestMesh mesh = createSharedGrid(32);
+        auto processed = pBuilder->processMesh(mesh.getDesc(StandardMaterial::create("TestMaterial")));
+
+        EXPECT_EQ(processed.inputVertexCacheStats.triangleCount, 2048u);
+        EXPECT_LT(processed.vertexCacheStats.getACMR(), processed.inputVertexCacheStats.getACMR());
+        EXPECT_EQ(processed.staticData.size(), mesh.positions.size());
+
+        // The vertices are in the order of first use, and the triangles still cover the grid with the same winding.
+        const auto& indices = processed.indexData;
+        uint32_t nextIndex = 0;
+        float area = 0.f;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            float3 p[3];
+            for (size_t j = 0; j < 3; j++)
+            {
+                EXPECT_LE(indices[i + j], nextIndex) << "i = " << i + j;
+                if (indices[i + j] == nextIndex) nextIndex++;
+                p[j] = processed.staticData[indices[i + j]].position;
+            }
+            float z = glm::cross(p[1] - p[0], p[2] - p[0]).z;
+            EXPECT_GT(z, 0.f) << "i = " << i;
+            area += 0.5f * z;
+        }
+        EXPECT(std::abs(area - 1.f) < 1e-4f);
+    }
+
+    GPU_TEST(SceneBuilderOptimizeVertexCacheMeshlets)
+    {
+        auto pBuilder = SceneBuilder::create(SceneBuilder::Flags::OptimizeVertexCache | SceneBuilder::Flags::BuildMeshlets);
+        TestMesh mesh = createSharedGrid(32);
+        MeshID meshID = pBuilder->addMesh(mesh.getDesc(StandardMaterial::create("TestMaterial")));
+        const SceneBuilder::VertexCacheOptimizationStats addedStats = pBuilder->getVertexCacheOptimizationStats();
+        auto pScene = buildScene(pBuilder, { meshID });
+        EXPECT_GT(pScene->getMeshletRange(MeshID{ 0 }).y, 1u);
+
+        // Partitioning into meshlets reorders the triangles, so the output statistics are recomputed for the final index buffer.
+        // Reordering the triangles within each meshlet keeps most of the vertex cache efficiency.
+        const auto& stats = pBuilder->getVertexCacheOptimizationStats();
+        EXPECT_EQ(stats.input.triangleCount, addedStats.input.triangleCount);
+        EXPECT_EQ(stats.output.triangleCount, 2048u);
+        EXPECT_LT(stats.output.getACMR(), stats.input.getACMR());
+    }
+
+    GPU_TEST(SceneBuilderGenerateLODs)
+    {
+        auto pBuilder = SceneBuilder::create(SceneBuilder::Flags::GenerateLODs);
+        TestMesh mesh = createSharedGrid(32);
+        MeshID meshID = pBuilder->addMesh(mesh.getDesc(StandardMaterial::create("TestMaterial")));
+        pBuilder->addMeshInstance(pBuilder->addNode(SceneBuilder::Node()), meshID);
+        SceneBuilder::Node node;
+        node.transform = rmcv::translate(float3(2.f, 0.f, 0.f));
+        pBuilder->addMeshInstance(pBuilder->addNode(node), meshID);
+        auto pScene = pBuilder->getScene();
+
+        // The grid is flat, so each LOD halves the triangle count without error until the error targets are used up.
+        const uint32_t lodCount = pScene->getMeshLODCount(MeshID{ 0 });
+        EXPECT_EQ(lodCount, 1u + (uint32_t)pBuilder->getLODSettings().errorTargets.size());
+        EXPECT_EQ(pScene->getMeshLOD(MeshID{ 0 }, 0).indexCount, 2048u * 3);
+        for (uint32_t lod = 1; lod < lodCount; lod++)
+        {
+            MeshLODDesc lodDesc = pScene->getMeshLOD(MeshID{ 0 }, lod);
+            EXPECT_LE(lodDesc.indexCount, pScene->getMeshLOD(MeshID{ 0 }, lod - 1).indexCount / 2) << "lod = " << lod;
+            EXPECT_LT(lodDesc.error, 1e-4f) << "lod = " << lod;
+        }
+
+        // Select a LOD for the mesh. The instances of a mesh share a BLAS, so all of them use it.
+        EXPECT_EQ(pScene->getSelectedMeshLOD(MeshID{ 0 }), 0u);
+        pScene->setMeshLOD(MeshID{ 0 }, lodCount - 1);
+        EXPECT_EQ(pScene->getSelectedMeshLOD(MeshID{ 0 }), lodCount - 1);
+        for (uint32_t instanceID = 0; instanceID < 2; instanceID++)
+        {
+            EXPECT_EQ(pScene->getGeometryInstance(instanceID).ibOffset, pScene->getMeshLOD(MeshID{ 0 }, lodCount - 1).ibOffset) << "instanceID = " << instanceID;
+        }
+        pScene->update(ctx.getRenderContext(), 0.0);
+        EXPECT(is_set(pScene->getUpdates(), Scene::UpdateFlags::MeshLODsChanged));
+
+        bool caught = false;
+        try
+        {
+            pScene->setMeshLOD(MeshID{ 0 }, lodCount);
+        }
+        catch (const ArgumentError&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+    }
+
+    GPU_TEST(SceneBuilderMeshletsWithLODs)
+    {
+        auto pBuilder = SceneBuilder::create(SceneBuilder::Flags::BuildMeshlets | SceneBuilder::Flags::GenerateLODs);
+        TestMesh mesh = createSharedGrid(32);
+        auto pScene = buildScene(pBuilder, { pBuilder->addMesh(mesh.getDesc(StandardMaterial::create("TestMaterial"))) });
+        const uint32_t lodCount = pScene->getMeshLODCount(MeshID{ 0 });
+        EXPECT_GT(lodCount, 1u);
+
+        auto pCamera = Camera::create();
+        pCamera->setPosition(float3(0.5f, 0.5f, 2.f));
+        pCamera->setTarget(float3(0.5f, 0.5f, 0.f));
+        pCamera->setUpVector(float3(0.f, 1.f, 0.f));
+        const size_t meshletCount = pScene->getMeshletRange(MeshID{ 0 }).y;
+        EXPECT_EQ(pScene->cullMeshlets(*pCamera).size(), meshletCount);
+
+        // The meshlets only cover the full mesh, so they are not used with a simplified LOD.
+        pScene->setMeshLOD(MeshID{ 0 }, lodCount - 1);
+        EXPECT_EQ(pScene->cullMeshlets(*pCamera).size(), 0u);
+        pScene->setMeshLOD(MeshID{ 0 }, 0);
+        EXPECT_EQ(pScene->cullMeshlets(*pCamera).size(), meshletCount);
+    }
+
+    GPU_TEST(SceneBuilderDeduplicateMeshes)
+    {
+        auto pBuilder = SceneBuilder::create(SceneBuilder::Flags::DeduplicateMeshes);
+        auto pMaterial = StandardMaterial::create("TestMaterial");
+        TestMesh grid = createSharedGrid(8);
+        TestMesh otherGrid = createSharedGrid(4);
+
+        // Two identical meshes, one with different content and one with a different material.
+        MeshID meshIDs[] =
+        {
+            pBuilder->addMesh(grid.getDesc(pMaterial)),
+            pBuilder->addMesh(grid.getDesc(pMaterial)),
+            pBuilder->addMesh(otherGrid.getDesc(pMaterial)),
+            pBuilder->addMesh(grid.getDesc(StandardMaterial::create("OtherMaterial"))),
+        };
+        for (MeshID meshID : meshIDs)
+        {
+            SceneBuilder::Node node;
+            node.transform = rmcv::translate(float3((float)meshID.get(), 0.f, 0.f));
+            pBuilder->addMeshInstance(pBuilder->addNode(node), meshID);
+        }
+        auto pScene = pBuilder->getScene();
+
+        const auto& stats = pBuilder->getMeshDeduplicationStats();
+        EXPECT_EQ(stats.removedMeshCount, 1u);
+        EXPECT_EQ(stats.removedVertexCount, (uint64_t)grid.positions.size());
+        EXPECT_EQ(stats.removedIndexCount, (uint64_t)grid.indices.size());
+        EXPECT_GT(stats.savedBytes, 0u);
+        EXPECT_EQ(pScene->getMeshCount(), 3u);
+        EXPECT_EQ(pScene->getGeometryInstanceCount(), 4u);
+    }
+
+    GPU_TEST(VertexWeldBenchmark)
+    {
+        // Compare the weld modes on a grid with 2M triangles. The timings are written to the log.
+        const uint32_t kGridSize = 1024;
+        auto pBuilder = SceneBuilder::create();
+        auto pMaterial = StandardMaterial::create("TestMaterial");
+
+        auto measure = [&](const char* name, const TestMesh& mesh, const VertexWeldSettings& settings)
+        {
+            pBuilder->setVertexWeldSettings(settings);
+            auto t0 = CpuTimer::getCurrentTimePoint();
+            auto processed = pBuilder->processMesh(mesh.getDesc(pMaterial));
+            double time = CpuTimer::calcDuration(t0, CpuTimer::getCurrentTimePoint());
+            logInfo("{}: {} triangles, {} -> {} vertices, {:.1f} ms", name, mesh.indices.size() / 3, mesh.positions.size(), processed.staticData.size(), time);
+            return processed.staticData.size();
+        };
+
+        {
+            TestMesh mesh = createSplitGrid(kGridSize);
+            EXPECT_EQ(measure("Split grid, topology weld", mesh, VertexWeldSettings()), mesh.positions.size());
+            EXPECT_EQ(measure("Split grid, hash weld", mesh, getHashSettings()), (kGridSize + 1) * (kGridSize + 1));
+        }
+        {
+            TestMesh mesh = createSharedGrid(kGridSize);
+            EXPECT_EQ(measure("Shared grid, topology weld", mesh, VertexWeldSettings()), mesh.positions.size());
+            EXPECT_EQ(measure("Shared grid, hash weld", mesh, getHashSettings()), mesh.positions.size());
+        }
+    }
+}
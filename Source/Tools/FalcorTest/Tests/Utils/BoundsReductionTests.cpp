@@ -0,0 +1,110 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/BoundsReduction.h"
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        std::vector<float4> createPoints(uint32_t numElems, uint32_t seed)
+        {
+            std::mt19937 r(seed);
+            std::uniform_real_distribution<float> u(-100.f, 100.f);
+            std::vector<float4> points(numElems);
+            for (auto& p : points) p = float4(u(r), u(r), u(r), u(r));
+            return points;
+        }
+
+        void testBoundsReduction(GPUUnitTestContext& ctx, const BoundsReduction::SharedPtr& pReduction, uint32_t numElems)
+        {
+            // The input buffer is filled to capacity and only the first numElems elements are counted.
+            // The points beyond the count lie outside the range of the counted points, so reading them changes the result.
+            const uint32_t capacity = pReduction->getMaxElementCount();
+            FALCOR_ASSERT(numElems <= capacity);
+            std::vector<float4> points = createPoints(capacity, numElems);
+            for (uint32_t i = numElems; i < capacity; i++) points[i] = float4(1e6f);
+
+            Buffer::SharedPtr pInput = Buffer::createStructured(sizeof(float4), capacity, ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, points.data(), false);
+            Buffer::SharedPtr pCounter = Buffer::create(4, ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, &numElems);
+            Buffer::SharedPtr pResult = Buffer::createStructured(sizeof(float4), 2, ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+
+            pReduction->execute(ctx.getRenderContext(), pInput, pCounter, 0, pResult);
+
+            points.resize(numElems);
+            const AABB ref = BoundsReduction::reduceHost(points);
+
+            const float4* result = (const float4*)pResult->map(Buffer::MapType::Read);
+            FALCOR_ASSERT(result);
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                EXPECT_EQ(result[0][i], ref.minPoint[i]) << "numElems = " << numElems << ", i = " << i;
+                EXPECT_EQ(result[1][i], ref.maxPoint[i]) << "numElems = " << numElems << ", i = " << i;
+            }
+            pResult->unmap();
+        }
+    }
+
+    CPU_TEST(BoundsReductionHost)
+    {
+        // Empty input gives an invalid AABB.
+        EXPECT(!BoundsReduction::reduceHost({}).valid());
+
+        AABB single = BoundsReduction::reduceHost({ float4(1.f, -2.f, 3.f, 5.f) });
+        EXPECT(single.valid());
+        EXPECT(single.minPoint == float3(1.f, -2.f, 3.f));
+        EXPECT(single.maxPoint == float3(1.f, -2.f, 3.f));
+
+        // The w component is ignored.
+        AABB bounds = BoundsReduction::reduceHost({ float4(1.f, 0.f, 0.f, -9.f), float4(-1.f, 4.f, 0.f, 9.f), float4(0.f, 2.f, -3.f, 0.f) });
+        EXPECT(bounds.minPoint == float3(-1.f, 0.f, -3.f));
+        EXPECT(bounds.maxPoint == float3(1.f, 4.f, 0.f));
+    }
+
+    GPU_TEST(BoundsReduction)
+    {
+        // A capacity above 2048^2 elements takes three levels.
+        const uint32_t kLargeCount = 2048 * 2048 + 4097;
+        BoundsReduction::SharedPtr pReduction = BoundsReduction::create(kLargeCount);
+
+        testBoundsReduction(ctx, pReduction, 0);
+        testBoundsReduction(ctx, pReduction, 1);
+        testBoundsReduction(ctx, pReduction, 1000);
+        testBoundsReduction(ctx, pReduction, 2048);
+        testBoundsReduction(ctx, pReduction, 2049);
+        testBoundsReduction(ctx, pReduction, 231917);
+        testBoundsReduction(ctx, pReduction, kLargeCount);
+
+        // Single level.
+        BoundsReduction::SharedPtr pSmall = BoundsReduction::create(2048);
+        testBoundsReduction(ctx, pSmall, 0);
+        testBoundsReduction(ctx, pSmall, 1531);
+        testBoundsReduction(ctx, pSmall, 2048);
+    }
+}
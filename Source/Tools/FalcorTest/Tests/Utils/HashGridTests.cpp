@@ -0,0 +1,191 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/HashGrid.h"
+#include <algorithm>
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFile[] = "Utils/Algorithm/HashGrid.cs.slang";
+
+        // Points in a unit cube, half of them in a few tight clusters so that some cells hold many points.
+        std::vector<float3> createPoints(size_t n, uint32_t seed)
+        {
+            std::mt19937 r(seed);
+            std::uniform_real_distribution<float> u(0.f, 1.f);
+            std::vector<float3> centers(8);
+            for (auto& c : centers) c = float3(u(r), u(r), u(r)) * 2.f - 1.f;
+
+            std::vector<float3> points(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                if (i & 1) points[i] = float3(u(r), u(r), u(r)) * 2.f - 1.f;
+                else points[i] = centers[r() % centers.size()] + (float3(u(r), u(r), u(r)) - 0.5f) * 0.02f;
+            }
+            return points;
+        }
+
+        std::vector<uint32_t> bruteForceQuery(const std::vector<float3>& points, const float3& center, float radius)
+        {
+            std::vector<uint32_t> result;
+            for (uint32_t i = 0; i < (uint32_t)points.size(); i++)
+            {
+                const float3 d = points[i] - center;
+                if (glm::dot(d, d) < radius * radius) result.push_back(i);
+            }
+            return result;
+        }
+
+        void testQueries(CPUUnitTestContext& ctx, size_t n, float radius, float cellSize, uint32_t bucketCount)
+        {
+            const std::vector<float3> points = createPoints(n, (uint32_t)n);
+            HashGrid grid;
+            grid.build(points, cellSize, bucketCount);
+
+            // Query at the points themselves and at random positions, including some outside the point bounds.
+            std::mt19937 r(1234);
+            std::uniform_real_distribution<float> u(-1.2f, 1.2f);
+            for (uint32_t q = 0; q < 1000; q++)
+            {
+                const float3 center = (q & 1) && n > 0 ? points[r() % n] : float3(u(r), u(r), u(r));
+                std::vector<uint32_t> result = grid.query(center, radius);
+                const std::vector<uint32_t> expected = bruteForceQuery(points, center, radius);
+
+                // Every point is visited once, so the result has no duplicates.
+                std::sort(result.begin(), result.end());
+                EXPECT(std::adjacent_find(result.begin(), result.end()) == result.end()) << "n = " << n << " q = " << q;
+                EXPECT(result == expected) << "n = " << n << " radius = " << radius << " buckets = " << bucketCount << " q = " << q;
+            }
+        }
+    }
+
+    CPU_TEST(HashGridBuckets)
+    {
+        const std::vector<float3> points = createPoints(10000, 1);
+        const float cellSize = 0.05f;
+        HashGrid grid;
+        grid.build(points, cellSize, HashGrid::getBucketCount((uint32_t)points.size()));
+        EXPECT_EQ(grid.getBucketCount(), 16384u);
+
+        // Every point is in exactly one bucket, the one its cell hashes to.
+        std::vector<uint32_t> seen(points.size(), 0);
+        for (uint32_t b = 0; b < grid.getBucketCount(); b++)
+        {
+            for (uint32_t i : grid.getBucket(b))
+            {
+                EXPECT_EQ(hashGridBucket(hashGridCell(points[i], cellSize), grid.getBucketCount()), b) << "i = " << i;
+                seen[i]++;
+            }
+        }
+        for (size_t i = 0; i < seen.size(); i++) EXPECT_EQ(seen[i], 1u) << "i = " << i;
+    }
+
+    CPU_TEST(HashGridQuery)
+    {
+        // Cell size tied to the radius, as used for vertex merging.
+        testQueries(ctx, 0, 0.01f, 0.02f, 1);
+        testQueries(ctx, 1, 0.01f, 0.02f, 1);
+        testQueries(ctx, 10000, 0.01f, 0.02f, HashGrid::getBucketCount(10000));
+        testQueries(ctx, 10000, 0.05f, 0.1f, HashGrid::getBucketCount(10000));
+
+        // Few buckets, so that many cells share a bucket.
+        testQueries(ctx, 10000, 0.05f, 0.1f, 4);
+
+        // Radius larger than half the cell size, so that a query spans more than two cells per axis.
+        testQueries(ctx, 10000, 0.1f, 0.03f, HashGrid::getBucketCount(10000));
+    }
+
+    CPU_TEST(HashGridInvalidArguments)
+    {
+        const std::vector<float3> points = createPoints(16, 1);
+        HashGrid grid;
+        bool thrown = false;
+        try { grid.build(points, 0.1f, 3); }
+        catch (const ArgumentError&) { thrown = true; }
+        EXPECT(thrown);
+
+        thrown = false;
+        try { grid.build(points, 0.f, 4); }
+        catch (const ArgumentError&) { thrown = true; }
+        EXPECT(thrown);
+    }
+
+    GPU_TEST(HashGridBuild)
+    {
+        // Build over the first n of a larger point buffer, with the count read from a counter buffer.
+        const uint32_t capacity = 50000;
+        const uint32_t n = 40000;
+        const float cellSize = 0.02f;
+        const uint32_t bucketCount = HashGrid::getBucketCount(n);
+
+        const std::vector<float3> points = createPoints(capacity, 2);
+        std::vector<float4> positions(capacity);
+        for (uint32_t i = 0; i < capacity; i++) positions[i] = float4(points[i], 1.f);
+
+        HashGrid grid;
+        grid.build(std::vector<float3>(points.begin(), points.begin() + n), cellSize, bucketCount);
+
+        Buffer::SharedPtr pCounter = Buffer::create(sizeof(uint32_t), Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, &n);
+        Buffer::SharedPtr pPositions = Buffer::createStructured(sizeof(float4), capacity, Resource::BindFlags::ShaderResource, Buffer::CpuAccess::None, positions.data(), false);
+        Buffer::SharedPtr pHeads = Buffer::createStructured(sizeof(uint32_t), bucketCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        Buffer::SharedPtr pNext = Buffer::createStructured(sizeof(uint32_t), capacity, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        ctx.getRenderContext()->clearUAV(pHeads->getUAV().get(), uint4(HashGrid::kInvalidIndex));
+
+        ctx.createProgram(kShaderFile, "build");
+        ctx["CB"]["gMaxCount"] = capacity;
+        ctx["CB"]["gCounterOffset"] = 0u;
+        ctx["CB"]["gCellSize"] = cellSize;
+        ctx["CB"]["gBucketCount"] = bucketCount;
+        ctx["gCounter"] = pCounter;
+        ctx["gPositions"] = pPositions;
+        ctx["gHeads"] = pHeads;
+        ctx["gNext"] = pNext;
+        ctx.runProgram(capacity, 1, 1);
+
+        // The GPU inserts in arbitrary order, so compare the sets of points in each bucket.
+        const uint32_t* pHeadData = (const uint32_t*)pHeads->map(Buffer::MapType::Read);
+        const std::vector<uint32_t> heads(pHeadData, pHeadData + bucketCount);
+        pHeads->unmap();
+        const uint32_t* pNextData = (const uint32_t*)pNext->map(Buffer::MapType::Read);
+        const std::vector<uint32_t> next(pNextData, pNextData + capacity);
+        pNext->unmap();
+
+        for (uint32_t b = 0; b < bucketCount; b++)
+        {
+            std::vector<uint32_t> gpuBucket;
+            for (uint32_t i = heads[b]; i != HashGrid::kInvalidIndex && gpuBucket.size() <= n; i = next[i]) gpuBucket.push_back(i);
+            std::vector<uint32_t> cpuBucket = grid.getBucket(b);
+            std::sort(gpuBucket.begin(), gpuBucket.end());
+            std::sort(cpuBucket.begin(), cpuBucket.end());
+            EXPECT(gpuBucket == cpuBucket) << "bucket = " << b;
+        }
+    }
+}
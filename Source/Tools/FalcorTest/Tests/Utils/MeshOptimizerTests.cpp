@@ -0,0 +1,124 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "MeshTestUtils.h"
+#include "Utils/Geometry/MeshOptimizer.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kVertexSize = 32;
+    }
+
+    CPU_TEST(AnalyzeVertexCache)
+    {
+        // Two triangles sharing an edge transform four vertices. The 32 byte vertices span two cache lines.
+        std::vector<uint32_t> indices = { 0, 1, 2, 2, 1, 3 };
+        VertexCacheStats stats = analyzeVertexCache(indices, 4, kVertexSize);
+        EXPECT_EQ(stats.triangleCount, 2u);
+        EXPECT_EQ(stats.cacheMissCount, 4u);
+        EXPECT_EQ(stats.fetchedBytes, 128u);
+        EXPECT_EQ(stats.getACMR(), 2.f);
+        EXPECT_EQ(stats.getATVR(), 1.f);
+        EXPECT_EQ(stats.getOverfetch(), 1.f);
+
+        // With a cache of three vertices, vertex 0 is evicted before it is used again.
+        indices = { 0, 1, 2, 2, 1, 3, 3, 0, 2 };
+        EXPECT_EQ(analyzeVertexCache(indices, 4, kVertexSize, 3).cacheMissCount, 5u);
+        EXPECT_EQ(analyzeVertexCache(indices, 4, kVertexSize, 4).cacheMissCount, 4u);
+
+        bool caught = false;
+        try
+        {
+            analyzeVertexCache(indices, 3, kVertexSize);
+        }
+        catch (const ArgumentError&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+    }
+
+    CPU_TEST(OptimizeVertexCache)
+    {
+        TestMesh mesh = createShuffledGrid(64);
+        const uint32_t vertexCount = (uint32_t)mesh.positions.size();
+
+        std::vector<uint32_t> indices = optimizeVertexCache(mesh.indices, vertexCount);
+        EXPECT(getSortedTriangles(indices) == getSortedTriangles(mesh.indices));
+
+        float inputACMR = analyzeVertexCache(mesh.indices, vertexCount, kVertexSize).getACMR();
+        float outputACMR = analyzeVertexCache(indices, vertexCount, kVertexSize).getACMR();
+        EXPECT_GT(inputACMR, 2.5f);
+        EXPECT_LT(outputACMR, 0.7f);
+    }
+
+    CPU_TEST(OptimizeOverdraw)
+    {
+        TestMesh mesh = createShuffledGrid(64);
+        const uint32_t vertexCount = (uint32_t)mesh.positions.size();
+
+        // Reordering clusters keeps the triangles and most of the vertex cache efficiency.
+        std::vector<uint32_t> cacheOptimized = optimizeVertexCache(mesh.indices, vertexCount);
+        std::vector<uint32_t> indices = optimizeOverdraw(cacheOptimized, mesh.positions);
+        EXPECT(getSortedTriangles(indices) == getSortedTriangles(mesh.indices));
+
+        float cacheOptimizedACMR = analyzeVertexCache(cacheOptimized, vertexCount, kVertexSize).getACMR();
+        float outputACMR = analyzeVertexCache(indices, vertexCount, kVertexSize).getACMR();
+        EXPECT_LE(outputACMR, cacheOptimizedACMR * 1.1f);
+
+        // Two quads at z = 1 and z = -1 that both face -z. The quad at z = -1 faces away from the center
+        // and is moved first, as it occludes the other quad when viewed from -z.
+        std::vector<float3> positions =
+        {
+            { 0.f, 0.f, 1.f }, { 0.f, 1.f, 1.f }, { 1.f, 0.f, 1.f }, { 1.f, 1.f, 1.f },
+            { 0.f, 0.f, -1.f }, { 0.f, 1.f, -1.f }, { 1.f, 0.f, -1.f }, { 1.f, 1.f, -1.f },
+        };
+        std::vector<uint32_t> quads = { 0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7 };
+        std::vector<uint32_t> expected = { 4, 5, 6, 6, 5, 7, 0, 1, 2, 2, 1, 3 };
+        EXPECT(optimizeOverdraw(quads, positions) == expected);
+    }
+
+    CPU_TEST(OptimizeVertexFetchRemap)
+    {
+        // Vertices are ordered by first use, with the unused vertex 1 last.
+        std::vector<uint32_t> indices = { 3, 0, 4, 4, 0, 2 };
+        std::vector<uint32_t> expected = { 1, 4, 3, 0, 2 };
+        EXPECT(optimizeVertexFetchRemap(indices, 5) == expected);
+
+        // Remapping a cache optimized grid brings the fetches close to the vertex buffer size.
+        TestMesh mesh = createShuffledGrid(64);
+        const uint32_t vertexCount = (uint32_t)mesh.positions.size();
+        indices = optimizeVertexCache(mesh.indices, vertexCount);
+        std::vector<uint32_t> remap = optimizeVertexFetchRemap(indices, vertexCount);
+        for (uint32_t& index : indices) index = remap[index];
+
+        EXPECT_LT(analyzeVertexCache(indices, vertexCount, kVertexSize).getOverfetch(), 1.5f);
+    }
+}
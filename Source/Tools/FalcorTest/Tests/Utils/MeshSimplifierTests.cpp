@@ -0,0 +1,218 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "MeshTestUtils.h"
+#include "Utils/Geometry/MeshSimplifier.h"
+#include <algorithm>
+#include <set>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Create a closed unit sphere centered at the origin.
+        */
+        TestMesh createSphere(uint32_t segments, uint32_t rings)
+        {
+            TestMesh mesh;
+            mesh.positions.push_back(float3(0.f, 0.f, -1.f));
+            for (uint32_t r = 1; r < rings; r++)
+            {
+                float theta = (float)M_PI * r / rings;
+                for (uint32_t s = 0; s < segments; s++)
+                {
+                    float phi = 2.f * (float)M_PI * s / segments;
+                    mesh.positions.push_back(float3(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), -std::cos(theta)));
+                }
+            }
+            mesh.positions.push_back(float3(0.f, 0.f, 1.f));
+
+            auto ringVertex = [&](uint32_t r, uint32_t s) { return 1 + (r - 1) * segments + s % segments; };
+            const uint32_t top = (uint32_t)mesh.positions.size() - 1;
+            for (uint32_t s = 0; s < segments; s++)
+            {
+                mesh.indices.insert(mesh.indices.end(), { 0, ringVertex(1, s + 1), ringVertex(1, s) });
+                for (uint32_t r = 1; r < rings - 1; r++)
+                {
+                    uint32_t a = ringVertex(r, s), b = ringVertex(r, s + 1), c = ringVertex(r + 1, s + 1), d = ringVertex(r + 1, s);
+                    mesh.indices.insert(mesh.indices.end(), { a, b, c, a, c, d });
+                }
+                mesh.indices.insert(mesh.indices.end(), { ringVertex(rings - 1, s), ringVertex(rings - 1, s + 1), top });
+            }
+            return mesh;
+        }
+
+        /** Compute the largest distance of a triangle list to the unit sphere, relative to the sphere diameter.
+            The distance is sampled at the centroids and edge midpoints of the triangles.
+        */
+        float getSphereDeviation(const std::vector<uint32_t>& indices, const std::vector<float3>& positions)
+        {
+            float maxDeviation = 0.f;
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                float3 p0 = positions[indices[i]], p1 = positions[indices[i + 1]], p2 = positions[indices[i + 2]];
+                for (float3 p : { (p0 + p1 + p2) / 3.f, (p0 + p1) / 2.f, (p1 + p2) / 2.f, (p2 + p0) / 2.f })
+                {
+                    maxDeviation = std::max(maxDeviation, (1.f - length(p)) / 2.f);
+                }
+            }
+            return maxDeviation;
+        }
+
+        /** Compute the signed area of each triangle when projected to the xy-plane.
+        */
+        std::vector<float> getProjectedAreas(const std::vector<uint32_t>& indices, const std::vector<float3>& positions)
+        {
+            std::vector<float> areas;
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                float3 p0 = positions[indices[i]], p1 = positions[indices[i + 1]], p2 = positions[indices[i + 2]];
+                areas.push_back(0.5f * cross(p1 - p0, p2 - p0).z);
+            }
+            return areas;
+        }
+    }
+
+    CPU_TEST(SimplifyMeshFlat)
+    {
+        // A flat grid simplifies to a few triangles without error, keeping the outline.
+        TestMesh mesh = createGrid(32);
+        float error = 1.f;
+        auto result = simplifyMesh(mesh.indices, mesh.positions, 6, 0.001f, &error);
+
+        EXPECT_LE(result.size(), 6u * 3);
+        EXPECT_LE(error, 1e-4f);
+
+        float totalArea = 0.f;
+        for (float area : getProjectedAreas(result, mesh.positions))
+        {
+            EXPECT_GT(area, 0.f);
+            totalArea += area;
+        }
+        EXPECT(std::abs(totalArea - 32.f * 32.f) < 1e-2f);
+    }
+
+    CPU_TEST(SimplifyMeshTargetCount)
+    {
+        TestMesh mesh = createGrid(32);
+
+        // Without simplification the indices are returned unchanged.
+        float error = 1.f;
+        auto result = simplifyMesh(mesh.indices, mesh.positions, mesh.indices.size(), 0.f, &error);
+        EXPECT(result == mesh.indices);
+        EXPECT_EQ(error, 0.f);
+
+        // The triangle count is reduced close to the target and not far below it.
+        const size_t targetIndexCount = mesh.indices.size() / 4;
+        result = simplifyMesh(mesh.indices, mesh.positions, targetIndexCount, 1.f);
+        EXPECT_LE(result.size(), targetIndexCount);
+        EXPECT_GE(result.size(), targetIndexCount * 3 / 4);
+    }
+
+    CPU_TEST(SimplifyMeshError)
+    {
+        // The simplified sphere should not deviate from the sphere by much more than the error limit.
+        // The error is relative to the mesh extent, which is the sphere diameter.
+        TestMesh mesh = createSphere(64, 32);
+        const float inputDeviation = getSphereDeviation(mesh.indices, mesh.positions);
+        size_t prevIndexCount = mesh.indices.size();
+
+        for (float targetError : { 0.001f, 0.01f, 0.05f })
+        {
+            float error = 0.f;
+            auto result = simplifyMesh(mesh.indices, mesh.positions, 0, targetError, &error);
+            EXPECT_LE(error, targetError);
+            EXPECT_LT(result.size(), prevIndexCount) << "targetError = " << targetError;
+            prevIndexCount = result.size();
+
+            // The triangles are still facing outwards.
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                float3 p0 = mesh.positions[result[i]], p1 = mesh.positions[result[i + 1]], p2 = mesh.positions[result[i + 2]];
+                EXPECT_GT(dot(cross(p1 - p0, p2 - p0), p0), 0.f) << "targetError = " << targetError;
+            }
+            EXPECT_LE(getSphereDeviation(result, mesh.positions) - inputDeviation, 2.f * targetError) << "targetError = " << targetError;
+        }
+    }
+
+    CPU_TEST(SimplifyMeshSeams)
+    {
+        // Split the grid in two halves with separate vertices along the middle column.
+        // The seam vertices have attribute discontinuities and must be kept.
+        const uint32_t size = 16;
+        TestMesh mesh = createGrid(size);
+        std::vector<uint32_t> seamVertices;
+        for (uint32_t y = 0; y <= size; y++)
+        {
+            uint32_t vertex = y * (size + 1) + size / 2;
+            seamVertices.push_back((uint32_t)mesh.positions.size());
+            mesh.positions.push_back(mesh.positions[vertex]);
+        }
+        for (size_t i = 0; i < mesh.indices.size(); i += 3)
+        {
+            float centroidX = (mesh.positions[mesh.indices[i]].x + mesh.positions[mesh.indices[i + 1]].x + mesh.positions[mesh.indices[i + 2]].x) / 3.f;
+            if (centroidX < size / 2) continue;
+            for (size_t j = i; j < i + 3; j++)
+            {
+                uint32_t x = mesh.indices[j] % (size + 1), y = mesh.indices[j] / (size + 1);
+                if (mesh.indices[j] < (size + 1) * (size + 1) && x == size / 2) mesh.indices[j] = seamVertices[y];
+            }
+        }
+
+        auto result = simplifyMesh(mesh.indices, mesh.positions, 0, 0.001f);
+        EXPECT_LT(result.size(), mesh.indices.size() / 4);
+
+        std::set<uint32_t> usedVertices(result.begin(), result.end());
+        for (uint32_t y = 0; y <= size; y++)
+        {
+            EXPECT(usedVertices.count(y * (size + 1) + size / 2) == 1) << "y = " << y;
+            EXPECT(usedVertices.count(seamVertices[y]) == 1) << "y = " << y;
+        }
+
+        float totalArea = 0.f;
+        for (float area : getProjectedAreas(result, mesh.positions)) totalArea += area;
+        EXPECT(std::abs(totalArea - size * size) < 1e-2f);
+    }
+
+    CPU_TEST(SimplifyMeshInvalidArguments)
+    {
+        TestMesh mesh = createGrid(4);
+
+        bool caught = false;
+        try
+        {
+            mesh.indices.push_back(0);
+            simplifyMesh(mesh.indices, mesh.positions, 0, 0.01f);
+        }
+        catch (const ArgumentError&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+    }
+}
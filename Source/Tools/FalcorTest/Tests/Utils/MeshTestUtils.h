@@ -0,0 +1,97 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/Math/Vector.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace Falcor
+{
+    // Helpers shared by the tests of the mesh processing utilities.
+
+    struct TestMesh
+    {
+        std::vector<float3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    /** Create a grid of quads in the xy-plane, with counter-clockwise triangles facing +z.
+    */
+    inline TestMesh createGrid(uint32_t size)
+    {
+        TestMesh mesh;
+        for (uint32_t y = 0; y <= size; y++)
+        {
+            for (uint32_t x = 0; x <= size; x++) mesh.positions.push_back(float3(x, y, 0.f));
+        }
+        for (uint32_t y = 0; y < size; y++)
+        {
+            for (uint32_t x = 0; x < size; x++)
+            {
+                uint32_t i = y * (size + 1) + x;
+                mesh.indices.insert(mesh.indices.end(), { i, i + 1, i + size + 2, i, i + size + 2, i + size + 1 });
+            }
+        }
+        return mesh;
+    }
+
+    /** Create a grid of quads in the xy-plane, with the triangles in random order.
+    */
+    inline TestMesh createShuffledGrid(uint32_t size)
+    {
+        TestMesh mesh = createGrid(size);
+        std::vector<uint3> triangles;
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) triangles.push_back({ mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2] });
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937(0));
+
+        mesh.indices.clear();
+        for (const uint3& t : triangles) mesh.indices.insert(mesh.indices.end(), { t.x, t.y, t.z });
+        return mesh;
+    }
+
+    /** Get the sorted list of triangles. Each triangle is rotated to start with its smallest index, which keeps the winding.
+    */
+    inline std::vector<uint3> getSortedTriangles(const std::vector<uint32_t>& indices)
+    {
+        std::vector<uint3> triangles;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            uint3 t = { indices[i], indices[i + 1], indices[i + 2] };
+            while (t.x > t.y || t.x > t.z) t = { t.y, t.z, t.x };
+            triangles.push_back(t);
+        }
+        std::sort(triangles.begin(), triangles.end(), [](const uint3& a, const uint3& b)
+        {
+            return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+        });
+        return triangles;
+    }
+}
@@ -0,0 +1,134 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <numeric>
+#include <random>
+
+/** Microbenchmarks comparing the host parallel algorithms against their serial counterparts.
+    The timings are written to the log. Each benchmark also checks that both versions agree.
+*/
+
+namespace Falcor
+{
+    namespace
+    {
+        const size_t kElementCount = 1 << 22;
+        const uint32_t kRunCount = 5;
+
+        std::vector<uint32_t> createBenchmarkData(size_t n)
+        {
+            std::mt19937 r(0);
+            std::vector<uint32_t> data(n);
+            for (auto& value : data) value = r();
+            return data;
+        }
+
+        /** Returns the minimum time in ms of running func() a few times. setup() is called before each run and is not timed.
+        */
+        template<typename Setup, typename Func>
+        double measure(Setup&& setup, Func&& func)
+        {
+            double minTime = std::numeric_limits<double>::max();
+            for (uint32_t run = 0; run < kRunCount; run++)
+            {
+                setup();
+                auto t0 = CpuTimer::getCurrentTimePoint();
+                func();
+                minTime = std::min(minTime, CpuTimer::calcDuration(t0, CpuTimer::getCurrentTimePoint()));
+            }
+            return minTime;
+        }
+
+        void logResult(const std::string& name, double serialTime, double parallelTime)
+        {
+            logInfo("{}: {} elements, serial {:.3f} ms, parallel {:.3f} ms ({:.2f}x, {} workers)",
+                name, kElementCount, serialTime, parallelTime, serialTime / parallelTime, Threading::getWorkerCount());
+        }
+    }
+
+    CPU_TEST(ParallelAlgorithmsBenchmarkReduce)
+    {
+        const std::vector<uint32_t> data = createBenchmarkData(kElementCount);
+        auto transform = [&](size_t i) { uint64_t x = data[i]; return x * x % 1000003; };
+
+        uint64_t serialSum = 0;
+        uint64_t parallelSum = 0;
+        double serialTime = measure([] {}, [&]
+        {
+            serialSum = 0;
+            for (size_t i = 0; i < data.size(); i++) serialSum += transform(i);
+        });
+        double parallelTime = measure([] {}, [&] { parallelSum = parallelReduce(0, data.size(), uint64_t(0), transform, std::plus<uint64_t>()); });
+
+        EXPECT_EQ(serialSum, parallelSum);
+        logResult("parallelReduce", serialTime, parallelTime);
+    }
+
+    CPU_TEST(ParallelAlgorithmsBenchmarkScan)
+    {
+        const std::vector<uint32_t> data = createBenchmarkData(kElementCount);
+        std::vector<uint32_t> serialResult(data.size());
+        std::vector<uint32_t> parallelResult(data.size());
+
+        double serialTime = measure([] {}, [&] { std::exclusive_scan(data.begin(), data.end(), serialResult.begin(), 0u); });
+        double parallelTime = measure([] {}, [&] { parallelExclusiveScan(data.data(), parallelResult.data(), data.size(), 0u, std::plus<uint32_t>()); });
+
+        EXPECT(serialResult == parallelResult);
+        logResult("parallelExclusiveScan", serialTime, parallelTime);
+    }
+
+    CPU_TEST(ParallelAlgorithmsBenchmarkRadixSort)
+    {
+        const std::vector<uint32_t> data = createBenchmarkData(kElementCount);
+        std::vector<uint32_t> serialResult;
+        std::vector<uint32_t> parallelResult;
+        auto getKey = [](uint32_t value) { return value; };
+
+        double serialTime = measure([&] { serialResult = data; }, [&] { std::stable_sort(serialResult.begin(), serialResult.end()); });
+        double parallelTime = measure([&] { parallelResult = data; }, [&] { parallelRadixSort(parallelResult, getKey, 32); });
+
+        EXPECT(serialResult == parallelResult);
+        logResult("parallelRadixSort", serialTime, parallelTime);
+    }
+
+    CPU_TEST(ParallelAlgorithmsBenchmarkMergeSort)
+    {
+        const std::vector<uint32_t> data = createBenchmarkData(kElementCount);
+        std::vector<uint32_t> serialResult;
+        std::vector<uint32_t> parallelResult;
+
+        double serialTime = measure([&] { serialResult = data; }, [&] { std::stable_sort(serialResult.begin(), serialResult.end()); });
+        double parallelTime = measure([&] { parallelResult = data; }, [&] { parallelMergeSort(parallelResult); });
+
+        EXPECT(serialResult == parallelResult);
+        logResult("parallelMergeSort", serialTime, parallelTime);
+    }
+}
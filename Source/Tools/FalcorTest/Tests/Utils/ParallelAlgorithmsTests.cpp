@@ -0,0 +1,254 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include <numeric>
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        std::vector<uint32_t> createTestData(size_t n, uint32_t seed, uint32_t maxValue = 0xffffffff)
+        {
+            std::mt19937 r(seed);
+            std::vector<uint32_t> data(n);
+            for (auto& value : data) value = r() % (uint64_t(maxValue) + 1);
+            return data;
+        }
+
+        const size_t kTestSizes[] = { 0, 1, 2, 1000, 4097, 100000, 1000003 };
+    }
+
+    CPU_TEST(ParallelFor)
+    {
+        for (size_t n : kTestSizes)
+        {
+            for (size_t grainSize : { 0, 1, 100 })
+            {
+                if (grainSize == 1 && n > 100000) continue;
+
+                std::vector<uint32_t> data(n + 10, 0);
+                parallelFor(10, n + 10, [&](size_t i) { data[i]++; }, ParallelOptions{ grainSize });
+                for (size_t i = 0; i < data.size(); i++) EXPECT_EQ(data[i], i < 10 ? 0u : 1u) << "i = " << i << " n = " << n;
+            }
+        }
+
+        // Chunks cover the range exactly once and are no larger than the grain size.
+        std::vector<uint32_t> data(1000, 0);
+        parallelForChunks(0, data.size(), [&](size_t begin, size_t end)
+        {
+            EXPECT_LE(end - begin, size_t(64));
+            for (size_t i = begin; i < end; i++) data[i]++;
+        }, ParallelOptions{ 64 });
+        for (size_t i = 0; i < data.size(); i++) EXPECT_EQ(data[i], 1u) << "i = " << i;
+    }
+
+    CPU_TEST(ParallelReduce)
+    {
+        for (size_t n : kTestSizes)
+        {
+            std::vector<uint32_t> data = createTestData(n, (uint32_t)n, 1000);
+            uint64_t expectedSum = std::accumulate(data.begin(), data.end(), uint64_t(0));
+            uint32_t expectedMax = n > 0 ? *std::max_element(data.begin(), data.end()) : 0;
+
+            for (bool deterministic : { false, true })
+            {
+                ParallelOptions options;
+                options.deterministic = deterministic;
+
+                uint64_t sum = parallelReduce(0, n, uint64_t(0), [&](size_t i) { return uint64_t(data[i]); }, std::plus<uint64_t>(), options);
+                EXPECT_EQ(sum, expectedSum) << "n = " << n;
+
+                uint32_t maxValue = parallelReduce(0, n, 0u, [&](size_t i) { return data[i]; }, [](uint32_t a, uint32_t b) { return std::max(a, b); }, options);
+                EXPECT_EQ(maxValue, expectedMax) << "n = " << n;
+
+                // Composing affine maps x -> a * x + b is associative but not commutative.
+                using Affine = std::pair<uint64_t, uint64_t>;
+                auto compose = [](const Affine& f, const Affine& g) { return Affine(g.first * f.first, g.first * f.second + g.second); };
+                auto affine = [&](size_t i) { return Affine(data[i] % 3 + 1, data[i]); };
+                Affine expectedAffine(1, 0);
+                for (size_t i = 0; i < n; i++) expectedAffine = compose(expectedAffine, affine(i));
+                Affine composed = parallelReduce(0, n, Affine(1, 0), affine, compose, options);
+                EXPECT(composed == expectedAffine) << "n = " << n << ", deterministic = " << deterministic;
+            }
+        }
+    }
+
+    CPU_TEST(ParallelReduceDeterministic)
+    {
+        // Float addition is not associative. A deterministic reduce matches a serial reduce of the same chunks, in every run.
+        const size_t n = 1000003;
+        const size_t grainSize = 1000;
+        std::mt19937 r(0);
+        std::uniform_real_distribution<float> u(0.f, 1.f);
+        std::vector<float> data(n);
+        for (auto& value : data) value = u(r) * (r() % 2 ? 1e4f : 1e-4f);
+
+        float expected = 0.f;
+        for (size_t begin = 0; begin < n; begin += grainSize)
+        {
+            float chunkSum = 0.f;
+            for (size_t i = begin; i < std::min(n, begin + grainSize); i++) chunkSum += data[i];
+            expected += chunkSum;
+        }
+
+        ParallelOptions options;
+        options.grainSize = grainSize;
+        options.deterministic = true;
+        for (uint32_t run = 0; run < 10; run++)
+        {
+            float sum = parallelReduce(0, n, 0.f, [&](size_t i) { return data[i]; }, std::plus<float>(), options);
+            EXPECT_EQ(sum, expected) << "run = " << run;
+        }
+
+        // Without a grain size the chunks only depend on the element count.
+        options.grainSize = 0;
+        float first = parallelReduce(0, n, 0.f, [&](size_t i) { return data[i]; }, std::plus<float>(), options);
+        for (uint32_t run = 0; run < 10; run++)
+        {
+            float sum = parallelReduce(0, n, 0.f, [&](size_t i) { return data[i]; }, std::plus<float>(), options);
+            EXPECT_EQ(sum, first) << "run = " << run;
+        }
+    }
+
+    CPU_TEST(ParallelScan)
+    {
+        for (size_t n : kTestSizes)
+        {
+            std::vector<uint32_t> data = createTestData(n, (uint32_t)n, 1000);
+            std::vector<uint32_t> expectedInclusive(n);
+            std::vector<uint32_t> expectedExclusive(n);
+            std::inclusive_scan(data.begin(), data.end(), expectedInclusive.begin());
+            std::exclusive_scan(data.begin(), data.end(), expectedExclusive.begin(), 0u);
+            const uint32_t expectedTotal = n > 0 ? expectedInclusive.back() : 0;
+
+            for (bool deterministic : { false, true })
+            {
+                ParallelOptions options;
+                options.deterministic = deterministic;
+
+                std::vector<uint32_t> result(n);
+                EXPECT_EQ(parallelInclusiveScan(data.data(), result.data(), n, 0u, std::plus<uint32_t>(), options), expectedTotal);
+                EXPECT(result == expectedInclusive) << "n = " << n;
+
+                EXPECT_EQ(parallelExclusiveScan(data.data(), result.data(), n, 0u, std::plus<uint32_t>(), options), expectedTotal);
+                EXPECT(result == expectedExclusive) << "n = " << n;
+
+                // In-place.
+                result = data;
+                EXPECT_EQ(parallelExclusiveScan(result.data(), result.data(), n, 0u, std::plus<uint32_t>(), options), expectedTotal);
+                EXPECT(result == expectedExclusive) << "n = " << n;
+            }
+        }
+    }
+
+    CPU_TEST(ParallelRadixSort)
+    {
+        struct Element
+        {
+            uint64_t key = 0;
+            uint32_t index = 0;
+        };
+
+        for (size_t n : kTestSizes)
+        {
+            // Use a small key range for half of the data so that there are many equal keys to check stability.
+            std::mt19937_64 r(n);
+            std::vector<Element> data(n);
+            for (size_t i = 0; i < n; i++) data[i] = { (i & 1) ? r() : r() % 16, (uint32_t)i };
+
+            for (uint32_t keyBits : { 4u, 32u, 41u, 64u })
+            {
+                const uint64_t keyMask = keyBits >= 64 ? ~0ull : (1ull << keyBits) - 1;
+                auto getKey = [=](const Element& e) { return e.key & keyMask; };
+
+                std::vector<Element> expected = data;
+                std::stable_sort(expected.begin(), expected.end(), [&](const Element& a, const Element& b) { return getKey(a) < getKey(b); });
+
+                for (size_t grainSize : { 0, 1000 })
+                {
+                    std::vector<Element> result = data;
+                    parallelRadixSort(result, getKey, keyBits, ParallelOptions{ grainSize });
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        EXPECT_EQ(result[i].index, expected[i].index) << "i = " << i << " n = " << n << " keyBits = " << keyBits;
+                    }
+                }
+            }
+        }
+
+        // Invalid key bits.
+        std::vector<uint32_t> data(16);
+        auto getKey = [](uint32_t value) { return value; };
+        for (uint32_t keyBits : { 0u, 33u })
+        {
+            bool caught = false;
+            try
+            {
+                parallelRadixSort(data, getKey, keyBits);
+            }
+            catch (const ArgumentError&)
+            {
+                caught = true;
+            }
+            EXPECT(caught) << "keyBits = " << keyBits;
+        }
+    }
+
+    CPU_TEST(ParallelMergeSort)
+    {
+        for (size_t n : kTestSizes)
+        {
+            std::vector<uint32_t> keys = createTestData(n, (uint32_t)n, 255);
+            std::vector<uint32_t> data(n);
+            std::iota(data.begin(), data.end(), 0u);
+
+            // Sort indices by a key with many duplicates to check stability.
+            auto compare = [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; };
+            std::vector<uint32_t> expected = data;
+            std::stable_sort(expected.begin(), expected.end(), compare);
+
+            for (size_t grainSize : { 0, 1, 1000 })
+            {
+                if (grainSize == 1 && n > 100000) continue;
+
+                std::vector<uint32_t> result = data;
+                parallelMergeSort(result, compare, ParallelOptions{ grainSize });
+                EXPECT(result == expected) << "n = " << n << " grainSize = " << grainSize;
+            }
+        }
+
+        // Default comparison.
+        std::vector<uint32_t> data = createTestData(100000, 1);
+        std::vector<uint32_t> expected = data;
+        std::sort(expected.begin(), expected.end());
+        parallelMergeSort(data);
+        EXPECT(data == expected);
+    }
+}
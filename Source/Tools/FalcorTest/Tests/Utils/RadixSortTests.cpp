@@ -0,0 +1,144 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/RadixSort.h"
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        std::vector<uint2> createTestData(size_t n, uint32_t seed)
+        {
+            // Use a small key range for part of the data so that there are many equal keys to check stability.
+            std::mt19937 r(seed);
+            std::vector<uint2> data(n);
+            for (size_t i = 0; i < n; i++) data[i] = uint2((uint32_t)i, (i & 1) ? r() : r() % 16);
+            return data;
+        }
+
+        // Reference result using std::stable_sort on the masked key.
+        std::vector<uint2> referenceSort(std::vector<uint2> data, RadixSort::Order order, uint32_t keyBits)
+        {
+            const uint32_t keyMask = keyBits >= 32 ? 0xffffffff : (1u << keyBits) - 1;
+            std::stable_sort(data.begin(), data.end(), [&](const uint2& a, const uint2& b)
+            {
+                return order == RadixSort::Order::Ascending ? (a.y & keyMask) < (b.y & keyMask) : (a.y & keyMask) > (b.y & keyMask);
+            });
+            return data;
+        }
+
+        void testHostSort(CPUUnitTestContext& ctx, size_t n, RadixSort::Order order, uint32_t keyBits, uint32_t threadCount)
+        {
+            std::vector<uint2> data = createTestData(n, (uint32_t)n);
+            std::vector<uint2> expected = referenceSort(data, order, keyBits);
+
+            RadixSort::executeHost(data, order, keyBits, threadCount);
+
+            EXPECT_EQ(data.size(), expected.size());
+            for (size_t i = 0; i < n; i++)
+            {
+                EXPECT(data[i] == expected[i]) << "i = " << i << " n = " << n << " keyBits = " << keyBits << " threads = " << threadCount;
+            }
+        }
+
+        void testGpuSort(GPUUnitTestContext& ctx, RadixSort* pSort, uint32_t n, uint32_t capacity, RadixSort::Order order, uint32_t keyBits)
+        {
+            std::vector<uint2> data = createTestData(capacity, n);
+            std::vector<uint2> expected(data.begin(), data.begin() + n);
+            expected = referenceSort(expected, order, keyBits);
+
+            Buffer::SharedPtr pData = Buffer::create(capacity * sizeof(uint2), Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, data.data());
+
+            if (n == capacity)
+            {
+                pSort->execute(ctx.getRenderContext(), pData, n, order, keyBits);
+            }
+            else
+            {
+                // Only the first n elements are sorted when the count comes from a counter buffer.
+                Buffer::SharedPtr pCounter = Buffer::create(sizeof(uint32_t), Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, &n);
+                pSort->execute(ctx.getRenderContext(), pData, capacity, order, keyBits, pCounter);
+            }
+
+            const uint2* result = (const uint2*)pData->map(Buffer::MapType::Read);
+            FALCOR_ASSERT(result);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                EXPECT(result[i] == expected[i]) << "i = " << i << " n = " << n;
+            }
+            for (uint32_t i = n; i < capacity; i++)
+            {
+                EXPECT(result[i] == data[i]) << "i = " << i << " n = " << n;
+            }
+            pData->unmap();
+        }
+    }
+
+    CPU_TEST(RadixSortHost)
+    {
+        for (auto order : { RadixSort::Order::Ascending, RadixSort::Order::Descending })
+        {
+            testHostSort(ctx, 0, order, 32, 0);
+            testHostSort(ctx, 1, order, 32, 0);
+            testHostSort(ctx, 1000, order, 32, 1);
+            testHostSort(ctx, 100000, order, 30, 1);
+            testHostSort(ctx, 100000, order, 30, 4);
+            testHostSort(ctx, 250001, order, 32, 0);
+            testHostSort(ctx, 250001, order, 12, 0);
+        }
+    }
+
+    CPU_TEST(RadixSortHostInvalidKeyBits)
+    {
+        std::vector<uint2> data(16);
+        bool thrown = false;
+        try
+        {
+            RadixSort::executeHost(data, RadixSort::Order::Ascending, 33);
+        }
+        catch (const ArgumentError&)
+        {
+            thrown = true;
+        }
+        EXPECT(thrown);
+    }
+
+    GPU_TEST(RadixSort)
+    {
+        RadixSort::SharedPtr pSort = RadixSort::create();
+
+        testGpuSort(ctx, pSort.get(), 2, 2, RadixSort::Order::Ascending, 32);
+        testGpuSort(ctx, pSort.get(), 1000, 1000, RadixSort::Order::Ascending, 32);
+        testGpuSort(ctx, pSort.get(), 4099, 4099, RadixSort::Order::Descending, 30);
+        testGpuSort(ctx, pSort.get(), 100000, 100000, RadixSort::Order::Descending, 30);
+        testGpuSort(ctx, pSort.get(), 77777, 131072, RadixSort::Order::Descending, 30);
+        testGpuSort(ctx, pSort.get(), 0, 1024, RadixSort::Order::Ascending, 32);
+        testGpuSort(ctx, pSort.get(), 50000, 50000, RadixSort::Order::Ascending, 12);
+    }
+}
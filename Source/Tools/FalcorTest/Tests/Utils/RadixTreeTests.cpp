@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/RadixTree.h"
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Common prefix length with equal keys disambiguated by index, as in the radix tree construction.
+        int commonPrefix(const std::vector<uint32_t>& keys, uint32_t i, uint32_t j)
+        {
+            uint64_t a = (uint64_t(keys[i]) << 32) | i;
+            uint64_t b = (uint64_t(keys[j]) << 32) | j;
+            int prefix = 0;
+            for (uint64_t diff = a ^ b; !(diff & (1ull << 63)); diff <<= 1) prefix++;
+            return prefix;
+        }
+
+        // Reference split of the key range [first,last]: the last key sharing a longer prefix with 'first' than 'last' does.
+        uint32_t referenceSplit(const std::vector<uint32_t>& keys, uint32_t first, uint32_t last)
+        {
+            const int rangePrefix = commonPrefix(keys, first, last);
+            uint32_t split = first;
+            for (uint32_t i = first + 1; i < last; i++)
+            {
+                if (commonPrefix(keys, first, i) > rangePrefix) split = i;
+            }
+            return split;
+        }
+
+        std::vector<uint32_t> createKeys(size_t n, uint32_t keyRange, bool descending, uint32_t seed)
+        {
+            std::mt19937 r(seed);
+            std::vector<uint32_t> keys(n);
+            for (auto& key : keys) key = keyRange ? r() % keyRange : r();
+            if (descending) std::sort(keys.rbegin(), keys.rend());
+            else std::sort(keys.begin(), keys.end());
+            return keys;
+        }
+
+        void testTree(CPUUnitTestContext& ctx, const std::vector<uint32_t>& keys)
+        {
+            const uint32_t n = (uint32_t)keys.size();
+            std::vector<RadixTree::Node> nodes = RadixTree::build(keys);
+            EXPECT_EQ(nodes.size(), RadixTree::getNodeCount(n));
+            if (n == 0) return;
+
+            const uint32_t leafStart = RadixTree::getLeafNodeStart(n);
+            EXPECT_EQ(nodes[0].parent, RadixTree::kInvalidIndex);
+            EXPECT_EQ(nodes[0].leafRange.x, 0u);
+            EXPECT_EQ(nodes[0].leafRange.y, n - 1);
+
+            // Traverse from the root and check that the tree matches the top-down definition and reaches every node once.
+            std::vector<uint32_t> visitCount(nodes.size(), 0);
+            std::vector<uint32_t> stack = { 0 };
+            while (!stack.empty())
+            {
+                uint32_t nodeIndex = stack.back();
+                stack.pop_back();
+                visitCount[nodeIndex]++;
+
+                const RadixTree::Node& node = nodes[nodeIndex];
+                if (nodeIndex >= leafStart)
+                {
+                    EXPECT_EQ(node.leafRange.x, nodeIndex - leafStart);
+                    EXPECT_EQ(node.leafRange.y, nodeIndex - leafStart);
+                    continue;
+                }
+
+                EXPECT_EQ(node.split, referenceSplit(keys, node.leafRange.x, node.leafRange.y)) << "node = " << nodeIndex;
+
+                uint2 children = RadixTree::getChildren(node, n);
+                EXPECT_EQ(nodes[children.x].parent, nodeIndex);
+                EXPECT_EQ(nodes[children.y].parent, nodeIndex);
+                EXPECT_EQ(nodes[children.x].leafRange.x, node.leafRange.x);
+                EXPECT_EQ(nodes[children.x].leafRange.y, node.split);
+                EXPECT_EQ(nodes[children.y].leafRange.x, node.split + 1);
+                EXPECT_EQ(nodes[children.y].leafRange.y, node.leafRange.y);
+                stack.push_back(children.x);
+                stack.push_back(children.y);
+            }
+
+            for (uint32_t i = 0; i < visitCount.size(); i++) EXPECT_EQ(visitCount[i], 1u) << "node = " << i;
+        }
+    }
+
+    CPU_TEST(RadixTreeNodeCount)
+    {
+        EXPECT_EQ(RadixTree::getNodeCount(0), 0u);
+        EXPECT_EQ(RadixTree::getNodeCount(1), 1u);
+        EXPECT_EQ(RadixTree::getNodeCount(1025), 2049u);
+        EXPECT_EQ(RadixTree::getLeafNodeStart(1025), 1024u);
+    }
+
+    CPU_TEST(RadixTree)
+    {
+        const size_t counts[] = { 0, 1, 2, 3, 5, 64, 100, 1025, 4000 };
+        for (size_t n : counts)
+        {
+            // Unique-ish keys, many duplicates and all-equal keys, in both sort orders.
+            for (uint32_t keyRange : { 0u, 8u, 1u })
+            {
+                testTree(ctx, createKeys(n, keyRange, false, (uint32_t)n));
+                testTree(ctx, createKeys(n, keyRange, true, (uint32_t)n));
+            }
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Threading.h"
+#include <atomic>
+#include <stdexcept>
+
+namespace Falcor
+{
+    namespace
+    {
+        uint64_t fibonacci(uint64_t n)
+        {
+            if (n < 2) return n;
+            auto a = Threading::dispatch([n]() { return fibonacci(n - 1); });
+            uint64_t b = fibonacci(n - 2);
+            return a.get() + b;
+        }
+    }
+
+    CPU_TEST(ThreadingDispatchTask)
+    {
+        std::atomic<uint32_t> counter = 0;
+        std::vector<Threading::Task> tasks;
+        for (uint32_t i = 0; i < 1000; ++i) tasks.push_back(Threading::dispatchTask([&]() { counter++; }));
+        for (const auto& task : tasks) task.finish();
+
+        EXPECT_EQ(counter.load(), 1000u);
+        for (const auto& task : tasks) EXPECT(!task.isRunning());
+        EXPECT(!Threading::Task().isValid());
+    }
+
+    CPU_TEST(ThreadingFinish)
+    {
+        std::atomic<uint32_t> counter = 0;
+        for (uint32_t i = 0; i < 1000; ++i) Threading::dispatchTask([&]() { counter++; });
+        Threading::finish();
+
+        EXPECT_EQ(counter.load(), 1000u);
+    }
+
+    CPU_TEST(ThreadingFuture)
+    {
+        auto future = Threading::dispatch([]() { return std::string("result"); });
+        EXPECT_EQ(future.get(), "result");
+
+        // Nested tasks that wait on their children must not deadlock the pool.
+        EXPECT_EQ(fibonacci(20), 6765ull);
+    }
+
+    CPU_TEST(ThreadingException)
+    {
+        auto task = Threading::dispatchTask([]() { throw std::runtime_error("task"); });
+        bool caught = false;
+        try
+        {
+            task.finish();
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+    }
+
+    CPU_TEST(ThreadingTaskGroup)
+    {
+        std::atomic<uint32_t> counter = 0;
+        Threading::TaskGroup group;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            group.run([&]()
+            {
+                for (uint32_t j = 0; j < 16; ++j) group.run([&]() { counter++; });
+            });
+        }
+        group.wait();
+
+        EXPECT_EQ(counter.load(), 256u);
+
+        // The first exception is rethrown after all tasks have finished.
+        counter = 0;
+        for (uint32_t i = 0; i < 64; ++i)
+        {
+            group.run([&, i]()
+            {
+                counter++;
+                if (i % 16 == 0) throw std::runtime_error("group");
+            });
+        }
+        bool caught = false;
+        try
+        {
+            group.wait();
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+        EXPECT_EQ(counter.load(), 64u);
+    }
+
+    CPU_TEST(ThreadingParallelFor)
+    {
+        for (size_t grainSize : { 0, 1, 7, 1000 })
+        {
+            std::vector<uint32_t> data(10000, 0);
+            Threading::parallelFor(100, data.size(), [&](size_t i) { data[i] += (uint32_t)i; }, grainSize);
+            for (size_t i = 0; i < data.size(); ++i) EXPECT_EQ(data[i], i < 100 ? 0u : (uint32_t)i) << "grainSize = " << grainSize;
+        }
+
+        // Nested loops spawn tasks from worker threads.
+        std::atomic<uint32_t> counter = 0;
+        Threading::parallelFor(0, 32, [&](size_t) { Threading::parallelFor(0, 32, [&](size_t) { counter++; }, 1); }, 1);
+        EXPECT_EQ(counter.load(), 1024u);
+
+        // Empty ranges do nothing.
+        Threading::parallelFor(10, 10, [&](size_t) { counter++; });
+        EXPECT_EQ(counter.load(), 1024u);
+    }
+}
@@ -0,0 +1,31 @@
+from falcor import *
+
+def render_graph_BDPT():
+    g = RenderGraph("BDPT")
+    loadRenderPassLibrary("AccumulatePass.dll")
+    loadRenderPassLibrary("BDPT.dll")
+    loadRenderPassLibrary("GBuffer.dll")
+    loadRenderPassLibrary("ToneMapper.dll")
+
+    BDPT = createPass("BDPT", {'samplesPerPixel': 1, 'maxSurfaceBounces': 5, 'maxDiffuseBounces': 3, 'maxSpecularBounces': 3, 'maxTransmissionBounces': 5, 'fixedSeed': 1})
+    g.addPass(BDPT, "BDPT")
+    VBufferRT = createPass("VBufferRT", {'samplePattern': SamplePattern.Center, 'sampleCount': 16, 'useAlphaTest': True})
+    g.addPass(VBufferRT, "VBufferRT")
+    AccumulatePass = createPass("AccumulatePass", {'enabled': True, 'precisionMode': AccumulatePrecision.Single})
+    g.addPass(AccumulatePass, "AccumulatePass")
+    ToneMapper = createPass("ToneMapper", {'autoExposure': False, 'exposureCompensation': 0.0})
+    g.addPass(ToneMapper, "ToneMapper")
+
+    g.addEdge("VBufferRT.vbuffer", "BDPT.vbuffer")
+    g.addEdge("VBufferRT.mvec", "BDPT.mvec")
+    g.addEdge("VBufferRT.viewW", "BDPT.viewW")
+    g.addEdge("BDPT.color", "AccumulatePass.input")
+    g.addEdge("AccumulatePass.output", "ToneMapper.src")
+
+    g.markOutput("ToneMapper.dst")
+
+    return g
+
+BDPT = render_graph_BDPT()
+try: m.addGraph(BDPT)
+except NameError: None
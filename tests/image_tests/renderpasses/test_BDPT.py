@@ -0,0 +1,13 @@
+import sys
+sys.path.append('..')
+from helpers import render_frames
+from graphs.BDPT import BDPT as g
+from falcor import *
+
+m.addGraph(g)
+m.loadScene('Arcade/Arcade.pyscene')
+
+# default
+render_frames(m, 'default', frames=[64])
+
+exit()
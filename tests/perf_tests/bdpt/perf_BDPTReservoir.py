@@ -0,0 +1,16 @@
+PERF_TEST = {
+    'tolerance': 0.1
+}
+
+import sys
+sys.path.append('..')
+from helpers import run_benchmark
+from graphs.BDPT import render_graph_BDPT
+from falcor import *
+
+m.addGraph(render_graph_BDPT({'useReservoir': True}))
+m.loadScene('Arcade/Arcade.pyscene')
+
+run_benchmark(m, 'BDPT', frames=64)
+
+exit()
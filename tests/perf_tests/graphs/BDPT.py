@@ -0,0 +1,25 @@
+from falcor import *
+
+def render_graph_BDPT(options={}):
+    '''
+    Create a BDPT graph without accumulation or post-processing, so that the timings only cover the path tracer and its G-buffer.
+    The options are passed on to the BDPT pass. The seed is fixed, so that every run traces the same paths.
+    '''
+    g = RenderGraph("BDPT")
+    loadRenderPassLibrary("BDPT.dll")
+    loadRenderPassLibrary("GBuffer.dll")
+
+    bdpt_options = {'samplesPerPixel': 1, 'maxSurfaceBounces': 5, 'maxDiffuseBounces': 3, 'maxSpecularBounces': 3, 'maxTransmissionBounces': 5, 'fixedSeed': 1, 'useFrameTimeGovernor': False}
+    bdpt_options.update(options)
+    BDPT = createPass("BDPT", bdpt_options)
+    g.addPass(BDPT, "BDPT")
+    VBufferRT = createPass("VBufferRT", {'samplePattern': SamplePattern.Center, 'sampleCount': 16, 'useAlphaTest': True})
+    g.addPass(VBufferRT, "VBufferRT")
+
+    g.addEdge("VBufferRT.vbuffer", "BDPT.vbuffer")
+    g.addEdge("VBufferRT.mvec", "BDPT.mvec")
+    g.addEdge("VBufferRT.viewW", "BDPT.viewW")
+
+    g.markOutput("BDPT.color")
+
+    return g
@@ -0,0 +1,45 @@
+import json
+from pathlib import Path
+
+def run_benchmark(m, pass_name, frames=64, warmup_frames=16, framerate=60, resolution=[1920,1080]):
+    '''
+    Render a fixed number of frames and write the per-frame profiler timings and the memory usage of a pass
+    to perf.json in the frame capture output directory.
+    The clock is fixed, so every run renders the same frames.
+    '''
+    m.resizeSwapChain(*resolution)
+    m.ui = False
+    m.clock.framerate = framerate
+    m.clock.time = 0
+    m.clock.pause()
+
+    frame = 0
+    def render(count):
+        nonlocal frame
+        for i in range(count):
+            frame += 1
+            m.clock.frame = frame
+            m.renderFrame()
+
+    # Warm up to compile programs and fill caches and temporal history.
+    m.profiler.enabled = True
+    render(warmup_frames)
+
+    m.profiler.startCapture(reservedFrames=frames)
+    render(frames)
+    capture = m.profiler.endCapture()
+
+    result = {
+        'frameCount': capture['frameCount'],
+        'events': { name: lane['records'] for name, lane in capture['events'].items() },
+        'memory': {}
+    }
+
+    render_pass = m.activeGraph.getPass(pass_name)
+    if hasattr(render_pass, 'memoryUsage'):
+        result['memory'] = dict(render_pass.memoryUsage)
+
+    output_dir = Path(str(m.frameCapture.outputDir))
+    output_dir.mkdir(parents=True, exist_ok=True)
+    with open(output_dir / 'perf.json', 'w') as f:
+        json.dump(result, f, indent=2)
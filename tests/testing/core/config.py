@@ -18,6 +18,11 @@ DEFAULT_PROCESS_COUNT = 4
 
 IMAGE_TESTS_DIR = "tests/image_tests"
 
+PERF_TESTS_DIR = "tests/perf_tests"
+
+# Default performance test timeout.
+DEFAULT_PERF_TIMEOUT = 900
+
 # Supported image extensions.
 IMAGE_EXTENSIONS = ['.png', '.jpg', '.tga', '.bmp', '.pfm', '.exr']
 
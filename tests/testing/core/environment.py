@@ -51,6 +51,14 @@ class Environment:
                         'ref_dir': { 'type': str },
                         'remote_ref_dir': { 'type': str, 'optional': True }
                     }
+                },
+                'perf_tests': {
+                    'type': dict,
+                    'optional': True,
+                    'properties': {
+                        'result_dir': { 'type': str },
+                        'baseline_dir': { 'type': str }
+                    }
                 }
             }
         }
@@ -76,6 +84,9 @@ class Environment:
         self.image_tests_result_dir = env['image_tests']['result_dir']
         self.image_tests_ref_dir = env['image_tests']['ref_dir']
         self.image_tests_remote_ref_dir = env['image_tests'].get('remote_ref_dir', None)
+        self.perf_tests_dir = self.project_dir / config.PERF_TESTS_DIR
+        self.perf_tests_result_dir = env.get('perf_tests', {}).get('result_dir', None)
+        self.perf_tests_baseline_dir = env.get('perf_tests', {}).get('baseline_dir', None)
 
         self.build_config = build_config
         self.branch = helpers.get_git_head_branch(self.project_dir)
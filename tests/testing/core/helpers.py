@@ -12,6 +12,37 @@ from urllib.parse import urlparse
 class GitError(Exception):
     pass
 
+def read_script_header(script_file, header_name):
+    '''
+    Check if script has a dictionary named header_name defined at the top and return it's content.
+    '''
+    with open(script_file) as f:
+        script = f.read()
+        # Find HEADER_NAME={} at the top of the script
+        m = re.match(header_name + r'\s*=\s*({.*})', script, re.DOTALL)
+        if m:
+            header = None
+            # Match curly braces
+            depth = 0
+            for i, c in enumerate(m.group(1)):
+                if c == '{':
+                    depth += 1
+                if c == '}':
+                    depth -= 1
+                    if depth == 0:
+                        header = m.group(1)[0:i+1]
+                        break
+            if depth != 0:
+                raise Exception(f'Failed to parse script header in {script_file} (curly braces do not match)')
+            # Evaluate dictionary
+            if header:
+                try:
+                    return eval(header)
+                except Exception as e:
+                    raise Exception(f'Failed to parse script header in {script_file} ({e})')
+
+    return {}
+
 def get_git_head_branch(path):
     '''
     Return the git HEAD branch name by reading from .git/HEAD file.
@@ -0,0 +1,180 @@
+'''
+Module for summarizing and comparing performance test results.
+This module only works on the JSON files written by the benchmark scripts and does not require Falcor.
+'''
+
+import json
+import statistics
+from enum import Enum
+
+# Name of the result file written by the benchmark scripts (see tests/perf_tests/helpers.py).
+RESULT_FILE = 'perf.json'
+
+# Default relative tolerance of timings (fraction of the baseline).
+DEFAULT_TIME_TOLERANCE = 0.1
+
+# Default absolute tolerance of timings in ms. This keeps stages that take only a few microseconds from failing on noise.
+DEFAULT_TIME_TOLERANCE_ABS = 0.05
+
+# Default relative tolerance of memory usage (fraction of the baseline).
+DEFAULT_MEMORY_TOLERANCE = 0.0
+
+# Profiler lanes that are compared by default. CPU times are recorded but too noisy to compare.
+DEFAULT_LANES = ['gpuTime']
+
+class Status(Enum):
+    OK = 1
+    REGRESSED = 2
+    IMPROVED = 3
+    MISSING = 4
+    NEW = 5
+
+# Statuses that fail a test.
+FAILED_STATUSES = [Status.REGRESSED, Status.MISSING]
+
+class Tolerance:
+    '''
+    Tolerances of a performance test.
+    A value regresses if it exceeds the baseline by more than both the relative and absolute tolerance.
+    '''
+
+    def __init__(self, time=DEFAULT_TIME_TOLERANCE, time_abs=DEFAULT_TIME_TOLERANCE_ABS, memory=DEFAULT_MEMORY_TOLERANCE):
+        self.time = time
+        self.time_abs = time_abs
+        self.memory = memory
+
+    @staticmethod
+    def from_header(header):
+        '''
+        Create tolerances from a PERF_TEST script header.
+        '''
+        return Tolerance(
+            time=header.get('tolerance', DEFAULT_TIME_TOLERANCE),
+            time_abs=header.get('tolerance_abs', DEFAULT_TIME_TOLERANCE_ABS),
+            memory=header.get('memory_tolerance', DEFAULT_MEMORY_TOLERANCE))
+
+class Comparison:
+    '''
+    Comparison of a single metric against its baseline.
+    '''
+
+    def __init__(self, name, kind, baseline, value, status):
+        self.name = name
+        self.kind = kind
+        self.baseline = baseline
+        self.value = value
+        self.status = status
+
+    def __repr__(self):
+        return f'Comparison(name={self.name},kind={self.kind},baseline={self.baseline},value={self.value},status={self.status.name})'
+
+    @property
+    def failed(self):
+        return self.status in FAILED_STATUSES
+
+    @property
+    def change(self):
+        '''
+        Relative change to the baseline, or None if not available.
+        '''
+        if self.baseline is None or self.value is None or self.baseline == 0:
+            return None
+        return self.value / self.baseline - 1.0
+
+    def to_dict(self):
+        return {
+            'name': self.name,
+            'kind': self.kind,
+            'baseline': self.baseline,
+            'value': self.value,
+            'status': self.status.name
+        }
+
+def load_result(path):
+    '''
+    Load a result file written by a benchmark script.
+    '''
+    with open(path) as f:
+        return json.load(f)
+
+def summarize(result, lanes=DEFAULT_LANES):
+    '''
+    Summarize a benchmark result.
+    Timings are reduced to the median over all captured frames, which is robust against single slow frames.
+    Returns a dictionary with 'timings' (lane name to time in ms) and 'memory' (resource group to bytes).
+    '''
+    timings = {}
+    for name, records in result.get('events', {}).items():
+        if not any(name.endswith('/' + lane) for lane in lanes):
+            continue
+        if len(records) == 0:
+            continue
+        timings[name] = statistics.median(records)
+
+    memory = dict(result.get('memory', {}))
+
+    return {'timings': timings, 'memory': memory}
+
+def _compare_values(name, kind, baseline, value, tolerance_rel, tolerance_abs):
+    if baseline is None:
+        return Comparison(name, kind, None, value, Status.NEW)
+    if value is None:
+        return Comparison(name, kind, baseline, None, Status.MISSING)
+
+    threshold = max(baseline * tolerance_rel, tolerance_abs)
+    if value > baseline + threshold:
+        status = Status.REGRESSED
+    elif value < baseline - threshold:
+        status = Status.IMPROVED
+    else:
+        status = Status.OK
+    return Comparison(name, kind, baseline, value, status)
+
+def compare(summary, baseline, tolerance=Tolerance()):
+    '''
+    Compare a summarized result against a summarized baseline.
+    Returns a list of comparisons, sorted by kind and name.
+    '''
+    comparisons = []
+
+    for kind, tolerance_rel, tolerance_abs in [('timings', tolerance.time, tolerance.time_abs), ('memory', tolerance.memory, 0)]:
+        values = summary.get(kind, {})
+        baseline_values = baseline.get(kind, {})
+        for name in sorted(set(values.keys()) | set(baseline_values.keys())):
+            comparisons.append(_compare_values(name, kind, baseline_values.get(name), values.get(name), tolerance_rel, tolerance_abs))
+
+    return comparisons
+
+def passed(comparisons):
+    '''
+    Return True if none of the comparisons failed.
+    '''
+    return not any(c.failed for c in comparisons)
+
+def short_name(name):
+    '''
+    Shorten a profiler lane name to the event and lane, e.g. '/onFrameRender/.../BDPT/sortLightVertices/gpuTime' to 'sortLightVertices/gpuTime'.
+    '''
+    parts = [p for p in name.split('/') if p != '']
+    return '/'.join(parts[-2:])
+
+def _format_value(kind, value):
+    if value is None:
+        return '-'
+    if kind == 'memory':
+        return f'{value / (1024 * 1024):.2f} MB'
+    return f'{value:.3f} ms'
+
+def format_report(comparisons, verbose=False):
+    '''
+    Format comparisons as a list of lines.
+    Only changed, missing and new metrics are listed unless verbose is True.
+    '''
+    lines = []
+    for c in comparisons:
+        if c.status == Status.OK and not verbose:
+            continue
+        change = c.change
+        change_str = f'{change * 100:+.1f}%' if change is not None else ''
+        lines.append(f'{c.status.name:<9} {short_name(c.name):<48} {_format_value(c.kind, c.baseline):>12} -> {_format_value(c.kind, c.value):>12} {change_str}')
+    return lines
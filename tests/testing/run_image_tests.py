@@ -68,32 +68,7 @@ def read_header(script_file):
     '''
     Check if script has a IMAGE_TEST dictionary defined at the top and return it's content.
     '''
-    with open(script_file) as f:
-        script = f.read()
-        # Find IMAGE_TEST={} at the top of the script
-        m = re.match(r'IMAGE_TEST\s*=\s*({.*})', script, re.DOTALL)
-        if m:
-            header = None
-            # Match curly braces
-            depth = 0
-            for i, c in enumerate(m.group(1)):
-                if c == '{':
-                    depth += 1
-                if c == '}':
-                    depth -= 1
-                    if depth == 0:
-                        header = m.group(1)[0:i+1]
-                        break
-            if depth != 0:
-                raise Exception(f'Failed to parse script header in {script_file} (curly braces do not match)')
-            # Evaluate dictionary
-            if header:
-                try:
-                    return eval(header)
-                except Exception as e:
-                    raise Exception(f'Failed to parse script header in {script_file} ({e})')
-
-    return {}
+    return helpers.read_script_header(script_file, 'IMAGE_TEST')
 
 class Test:
     '''
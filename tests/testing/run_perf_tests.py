@@ -0,0 +1,377 @@
+'''
+Script for running performance tests.
+'''
+
+import os
+import sys
+import re
+import json
+import time
+import datetime
+import argparse
+import subprocess
+import shutil
+from pathlib import Path
+from enum import Enum
+
+from build_falcor import build_falcor
+
+from core import Environment, helpers, config, perf
+from core.termcolor import colored
+
+class PerfTest:
+    '''
+    Represents a single performance test.
+    '''
+
+    class Result(Enum):
+        PASSED = 1
+        FAILED = 2
+        SKIPPED = 3
+
+    COLORED_RESULT_STRING = {
+        Result.PASSED: colored('PASSED', 'green'),
+        Result.FAILED: colored('FAILED', 'red'),
+        Result.SKIPPED: colored('SKIPPED', 'yellow')
+    }
+
+    RESULT_STRING = {
+        Result.PASSED: 'PASSED',
+        Result.FAILED: 'FAILED',
+        Result.SKIPPED: 'SKIPPED'
+    }
+
+    def __init__(self, script_file, root_dir):
+        self.script_file = script_file
+
+        # Test directory relative to root directory.
+        self.test_dir = self.script_file.relative_to(root_dir).with_suffix('')
+
+        # Test name derived from test directory.
+        self.name = str(self.test_dir.as_posix())
+
+        # Read script header.
+        try:
+            self.header = helpers.read_script_header(script_file, 'PERF_TEST')
+        except Exception as e:
+            print(e)
+            sys.exit(1)
+
+        # Get tags.
+        self.tags = self.header.get('tags', ['default'])
+
+        # Get skipped tests.
+        self.skip_message = self.header.get('skipped', None)
+        self.skipped = self.skip_message != None
+
+        # Get tolerances.
+        self.tolerance = perf.Tolerance.from_header(self.header)
+
+        # Get compared profiler lanes.
+        self.lanes = self.header.get('lanes', perf.DEFAULT_LANES)
+
+        # Get timeout.
+        self.timeout = self.header.get('timeout', config.DEFAULT_PERF_TIMEOUT)
+
+    def __repr__(self):
+        return f'PerfTest(name={self.name},script_file={self.script_file})'
+
+    def matches_tags(self, tags):
+        '''
+        Check if the test's tags matches any of the given tags.
+        '''
+        for tag in self.tags:
+            if tag in tags:
+                return True
+        return False
+
+    def generate_result(self, output_dir, mogwai_exe):
+        '''
+        Run Mogwai to render the benchmark and store the result file in output_dir.
+        Returns a tuple containing the result code and a list of messages.
+        '''
+        # Bail out if test is skipped.
+        if self.skipped:
+            return PerfTest.Result.SKIPPED, [self.skip_message] if self.skip_message != '' else []
+
+        # Determine full output directory.
+        output_dir = output_dir / self.test_dir
+        output_dir.mkdir(parents=True, exist_ok=True)
+
+        # Mogwai runs with the working directory set to the directory the test script resides in (see run_image_tests.py).
+        cwd = self.script_file.parent
+        relative_to_cwd = lambda p: os.path.relpath(p, cwd)
+
+        # Write helper script to run test. The benchmark writes its result to the frame capture output directory.
+        generate_file = output_dir / 'generate.py'
+        with open(generate_file, 'w') as f:
+            f.write(f'm.frameCapture.outputDir = r"{output_dir}"\n')
+            f.write(f'm.script(r"{relative_to_cwd(self.script_file)}")\n')
+
+        # Run Mogwai to render the benchmark.
+        args = [
+            str(mogwai_exe),
+            '--script', str(relative_to_cwd(generate_file)),
+            '--logfile', str(output_dir / 'log.txt'),
+            '--silent'
+        ]
+        p = subprocess.Popen(args, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        try:
+            outs, errs = p.communicate(timeout=self.timeout)
+        except subprocess.TimeoutExpired:
+            p.kill()
+            return PerfTest.Result.FAILED, ['Process killed due to timeout']
+
+        # Check for success.
+        if p.returncode != 0:
+            # Generate list of errors from stderr.
+            errors = list(map(lambda l: l.rstrip(), errs.decode('utf-8').splitlines()))
+            return PerfTest.Result.FAILED, errors + [f'{mogwai_exe} exited with return code {p.returncode}']
+
+        # Bail out if no result has been written.
+        if not (output_dir / perf.RESULT_FILE).exists():
+            return PerfTest.Result.FAILED, ['Test did not write a result file.']
+
+        return PerfTest.Result.PASSED, []
+
+    def compare_result(self, baseline_dir, result_dir, verbose):
+        '''
+        Compare the result in result_dir against the baseline in baseline_dir.
+        Returns a tuple containing the result code, a list of messages and a list of comparisons.
+        '''
+        # Bail out if test is skipped.
+        if self.skipped:
+            return PerfTest.Result.SKIPPED, [self.skip_message] if self.skip_message != '' else [], []
+
+        baseline_file = baseline_dir / self.test_dir / perf.RESULT_FILE
+        result_file = result_dir / self.test_dir / perf.RESULT_FILE
+
+        if not baseline_file.exists():
+            return PerfTest.Result.FAILED, [f'Baseline "{baseline_file}" does not exist.'], []
+        elif not result_file.exists():
+            return PerfTest.Result.FAILED, [f'Result "{result_file}" does not exist.'], []
+
+        baseline = perf.summarize(perf.load_result(baseline_file), self.lanes)
+        summary = perf.summarize(perf.load_result(result_file), self.lanes)
+        comparisons = perf.compare(summary, baseline, self.tolerance)
+
+        result = PerfTest.Result.PASSED if perf.passed(comparisons) else PerfTest.Result.FAILED
+        return result, perf.format_report(comparisons, verbose), comparisons
+
+    def run(self, compare_only, baseline_dir, result_dir, mogwai_exe, verbose):
+        '''
+        Run the performance test.
+        First, the benchmark is rendered (unless compare_only is True).
+        Second, the result is compared against the baseline.
+        Third, writes a JSON report to the result_dir containing details on the test run.
+        Returns a tuple containing the result code and a list of messages.
+        '''
+        # Setup report.
+        report = {
+            'name': self.name,
+            'baseline_dir': str(baseline_dir / self.test_dir),
+            'metrics': []
+        }
+
+        start_time = time.time()
+        result = PerfTest.Result.PASSED
+        messages = []
+        comparisons = []
+
+        # Render benchmark.
+        if not compare_only:
+            result, messages = self.generate_result(result_dir, mogwai_exe)
+
+        # Compare to baseline.
+        if result == PerfTest.Result.PASSED:
+            result, messages, comparisons = self.compare_result(baseline_dir, result_dir, verbose)
+
+        # Finish report.
+        report['result'] = PerfTest.RESULT_STRING[result]
+        report['messages'] = messages
+        report['metrics'] = [c.to_dict() for c in comparisons]
+        report['duration'] = time.time() - start_time
+
+        # Write JSON report.
+        report_dir = result_dir / self.test_dir
+        report_dir.mkdir(parents=True, exist_ok=True)
+        report_file = report_dir / 'report.json'
+        with open(report_file, 'w') as f:
+            json.dump(report, f, indent=4)
+
+        return result, messages
+
+def generate_baselines(env, tests, baseline_dir):
+    '''
+    Renders baselines for a set of tests and stores them into baseline_dir.
+    '''
+    print(f'Baseline directory: {baseline_dir}')
+    print(f'Generating baselines for {len(tests)} tests')
+
+    success = True
+    start_time = time.time()
+
+    for test in tests:
+        print(f'  {test.name:<60} : ', end='', flush=True)
+        test_start_time = time.time()
+
+        # Remove existing baseline.
+        if (baseline_dir / test.test_dir).exists():
+            shutil.rmtree(baseline_dir / test.test_dir, ignore_errors=True)
+
+        result, messages = test.generate_result(baseline_dir, env.mogwai_exe)
+        if result == PerfTest.Result.FAILED:
+            success = False
+
+        print(f'{PerfTest.COLORED_RESULT_STRING[result]} ({time.time() - test_start_time:.1f} s)')
+        for message in messages:
+            print(f'    {message}')
+
+    status = colored('PASSED', 'green') if success else colored('FAILED', 'red')
+    print(f'\nGenerating baselines {status} ({time.time() - start_time:.1f} s).')
+
+    return success
+
+def run_tests(env, tests, compare_only, baseline_dir, result_dir, verbose):
+    '''
+    Runs a set of tests, stores them into result_dir and compares them to baseline_dir.
+    Tests are run one at a time, as concurrent processes would distort the timings.
+    '''
+    print(f'Result directory: {result_dir}')
+    print(f'Baseline directory: {baseline_dir}')
+    print(f'Running {len(tests)} tests')
+
+    success = True
+    run_date = datetime.datetime.now()
+    run_start_time = time.time()
+
+    for test in tests:
+        print(f'  {test.name:<60} : ', end='', flush=True)
+        start_time = time.time()
+        result, messages = test.run(compare_only, baseline_dir, result_dir, env.mogwai_exe, verbose)
+        if result == PerfTest.Result.FAILED:
+            success = False
+
+        print(f'{PerfTest.COLORED_RESULT_STRING[result]} ({time.time() - start_time:.1f} s)')
+        for message in messages:
+            print(f'    {message}')
+
+    status = colored('PASSED', 'green') if success else colored('FAILED', 'red')
+    print(f'\nPerformance tests {status} ({time.time() - run_start_time:.1f} s).')
+
+    # Setup report.
+    report = {
+        'date': run_date.isoformat(),
+        'result': 'PASSED' if success else 'FAILED',
+        'tests': [t.name for t in tests],
+        'duration': time.time() - run_start_time
+    }
+
+    # Write JSON report.
+    result_dir.mkdir(parents=True, exist_ok=True)
+    report_file = result_dir / 'report.json'
+    with open(report_file, 'w') as f:
+        json.dump(report, f, indent=4)
+
+    return success
+
+def list_tests(tests):
+    '''
+    Print a list of tests.
+    '''
+    print(f'Found {len(tests)} tests')
+    for test in tests:
+        print(f'  {test.name}')
+
+def collect_tests(root_dir, filter_regex, tags):
+    '''
+    Collect a list of all tests found in root_dir that are matching the filter_regex and tags.
+    A test script needs to be named perf_*.py to be detected.
+    '''
+    # Find all script files.
+    script_files = list(root_dir.glob('**/perf_*.py'))
+
+    # Filter using regex.
+    if filter_regex != '':
+        regex = re.compile(filter_regex or '')
+        script_files = list(filter(lambda f: regex.search(str(f.as_posix())) != None, script_files))
+
+    tests = list(map(lambda f: PerfTest(f, root_dir), script_files))
+
+    # Filter using tags.
+    tags = tags.split(',')
+    tests = list(filter(lambda t: t.matches_tags(tags), tests))
+
+    return tests
+
+def main():
+    parser = argparse.ArgumentParser(description="Utility for running performance tests.")
+    parser.add_argument('-c', '--config', type=str, action='store', help=f'Build configuration')
+    parser.add_argument('-e', '--environment', type=str, action='store', help='Environment', default=config.DEFAULT_ENVIRONMENT)
+    parser.add_argument('-l', '--list', action='store_true', help='List available tests')
+    parser.add_argument('-t', '--tags', type=str, action='store', help='Comma separated list of tags for filtering tests to run', default='default')
+    parser.add_argument('-f', '--filter', type=str, action='store', help='Regular expression for filtering tests to run')
+    parser.add_argument('-v', '--verbose', action='store_true', help='List all compared metrics, not only the changed ones')
+    parser.add_argument('--compare-only', action='store_true', help='Compare previous results against baselines without rendering')
+    parser.add_argument('--gen-baselines', action='store_true', help='Generate baselines instead of running tests')
+    parser.add_argument('--skip-build', action='store_true', help='Skip building project before running')
+    parser.add_argument('--list-configs', action='store_true', help='List available build configurations.')
+
+    args = parser.parse_args()
+
+    # Load environment.
+    try:
+        env = Environment(args.environment, args.config)
+    except Exception as e:
+        print(e)
+        sys.exit(1)
+
+    # List build configurations.
+    if args.list_configs:
+        print('Available build configurations:\n' + '\n'.join(config.BUILD_CONFIGS.keys()))
+        sys.exit(0)
+
+    if not env.perf_tests_result_dir or not env.perf_tests_baseline_dir:
+        print('Performance test directories are not configured for this environment.')
+        sys.exit(1)
+
+    # Build before running tests.
+    if not (args.skip_build or args.list):
+        if not build_falcor(env):
+            print('Failed to build')
+            sys.exit(1)
+
+    # Collect tests to run.
+    tests = collect_tests(env.perf_tests_dir, args.filter, args.tags)
+
+    baseline_dir = env.resolve_image_dir(env.perf_tests_baseline_dir, env.branch, 'unknown')
+
+    if args.list:
+        # List available tests.
+        list_tests(tests)
+    elif args.gen_baselines:
+        # Generate baselines.
+        if not generate_baselines(env, tests, baseline_dir):
+            sys.exit(1)
+    else:
+        result_dir = env.resolve_image_dir(env.perf_tests_result_dir, env.branch, 'unknown')
+
+        # Give some instructions on how to acquire baselines if not available.
+        if not baseline_dir.exists():
+            print(colored(f'\n!!! Baselines are not available in "{baseline_dir}" !!!', 'red'))
+            print('')
+            print('Baselines are specific to a machine and build configuration. Generate them using:')
+            print('')
+            print('  run_perf_tests --gen-baselines')
+            print('')
+            sys.exit(1)
+
+        # Run tests.
+        if not run_tests(env, tests, args.compare_only, baseline_dir, result_dir, args.verbose):
+            sys.exit(1)
+
+    sys.exit(0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,154 @@
+'''
+Unit tests for the performance test comparison logic (core/perf.py).
+These run without Falcor and on any OS: python test_perf.py
+'''
+
+import sys
+import json
+import tempfile
+import unittest
+from pathlib import Path
+
+# Import the module directly, the core package only loads on Windows.
+sys.path.insert(0, str(Path(__file__).parent / 'core'))
+import perf
+from perf import Status, Tolerance
+
+kTraceLane = '/onFrameRender/RenderGraphExe::execute()/BDPT/traceLightPath/gpuTime'
+kSortLane = '/onFrameRender/RenderGraphExe::execute()/BDPT/sortLightVertices/gpuTime'
+kSortCpuLane = '/onFrameRender/RenderGraphExe::execute()/BDPT/sortLightVertices/cpuTime'
+
+def make_result(trace, sort, memory={}):
+    return {
+        'frameCount': len(trace),
+        'events': { kTraceLane: trace, kSortLane: sort, kSortCpuLane: [1.0] * len(sort) },
+        'memory': memory
+    }
+
+def find(comparisons, name):
+    return next(c for c in comparisons if c.name == name)
+
+class SummarizeTest(unittest.TestCase):
+
+    def test_median(self):
+        summary = perf.summarize(make_result([1.0, 2.0, 100.0], [0.5, 0.5, 0.5, 0.7]))
+        self.assertEqual(summary['timings'][kTraceLane], 2.0)
+        self.assertEqual(summary['timings'][kSortLane], 0.5)
+
+    def test_lanes(self):
+        summary = perf.summarize(make_result([1.0], [0.5]))
+        self.assertNotIn(kSortCpuLane, summary['timings'])
+        summary = perf.summarize(make_result([1.0], [0.5]), lanes=['gpuTime', 'cpuTime'])
+        self.assertIn(kSortCpuLane, summary['timings'])
+
+    def test_empty_records(self):
+        summary = perf.summarize(make_result([], [0.5]))
+        self.assertNotIn(kTraceLane, summary['timings'])
+
+    def test_memory(self):
+        summary = perf.summarize(make_result([1.0], [0.5], { 'lightVertices': 1024, 'total': 1024 }))
+        self.assertEqual(summary['memory'], { 'lightVertices': 1024, 'total': 1024 })
+
+class CompareTest(unittest.TestCase):
+
+    def compare(self, result, baseline, tolerance=Tolerance()):
+        return perf.compare(perf.summarize(result), perf.summarize(baseline), tolerance)
+
+    def test_within_tolerance(self):
+        comparisons = self.compare(make_result([10.5], [1.0]), make_result([10.0], [1.0]))
+        self.assertTrue(perf.passed(comparisons))
+        self.assertEqual(find(comparisons, kTraceLane).status, Status.OK)
+
+    def test_regression(self):
+        comparisons = self.compare(make_result([11.5], [1.0]), make_result([10.0], [1.0]))
+        self.assertFalse(perf.passed(comparisons))
+        c = find(comparisons, kTraceLane)
+        self.assertEqual(c.status, Status.REGRESSED)
+        self.assertAlmostEqual(c.change, 0.15)
+        self.assertEqual(find(comparisons, kSortLane).status, Status.OK)
+
+    def test_improvement(self):
+        comparisons = self.compare(make_result([8.0], [1.0]), make_result([10.0], [1.0]))
+        self.assertTrue(perf.passed(comparisons))
+        self.assertEqual(find(comparisons, kTraceLane).status, Status.IMPROVED)
+
+    def test_absolute_tolerance(self):
+        # A 100% increase of a 0.01 ms stage is within the default absolute tolerance.
+        comparisons = self.compare(make_result([10.0], [0.02]), make_result([10.0], [0.01]))
+        self.assertEqual(find(comparisons, kSortLane).status, Status.OK)
+        comparisons = self.compare(make_result([10.0], [0.02]), make_result([10.0], [0.01]), Tolerance(time_abs=0.0))
+        self.assertEqual(find(comparisons, kSortLane).status, Status.REGRESSED)
+
+    def test_relative_tolerance(self):
+        tolerance = Tolerance(time=0.5)
+        comparisons = self.compare(make_result([14.0], [1.0]), make_result([10.0], [1.0]), tolerance)
+        self.assertEqual(find(comparisons, kTraceLane).status, Status.OK)
+        comparisons = self.compare(make_result([16.0], [1.0]), make_result([10.0], [1.0]), tolerance)
+        self.assertEqual(find(comparisons, kTraceLane).status, Status.REGRESSED)
+
+    def test_missing_and_new(self):
+        result = make_result([10.0], [1.0])
+        baseline = make_result([10.0], [1.0])
+        del result['events'][kSortLane]
+        baseline['events'].pop(kTraceLane)
+        baseline['events']['/onFrameRender/RenderGraphExe::execute()/BDPT/buildPhotonAS/gpuTime'] = [1.0]
+        comparisons = self.compare(result, baseline)
+        self.assertFalse(perf.passed(comparisons))
+        self.assertEqual(find(comparisons, kTraceLane).status, Status.NEW)
+        self.assertEqual(find(comparisons, kSortLane).status, Status.MISSING)
+
+    def test_new_only_passes(self):
+        result = make_result([10.0], [1.0])
+        baseline = make_result([10.0], [1.0])
+        baseline['events'].pop(kTraceLane)
+        self.assertTrue(perf.passed(self.compare(result, baseline)))
+
+    def test_memory(self):
+        baseline = make_result([10.0], [1.0], { 'lightVertices': 1000, 'total': 1000 })
+        comparisons = self.compare(make_result([10.0], [1.0], { 'lightVertices': 1000, 'total': 1000 }), baseline)
+        self.assertTrue(perf.passed(comparisons))
+        comparisons = self.compare(make_result([10.0], [1.0], { 'lightVertices': 1001, 'total': 1001 }), baseline)
+        self.assertFalse(perf.passed(comparisons))
+        self.assertEqual(find(comparisons, 'total').status, Status.REGRESSED)
+        comparisons = self.compare(make_result([10.0], [1.0], { 'lightVertices': 1001, 'total': 1001 }), baseline, Tolerance(memory=0.01))
+        self.assertTrue(perf.passed(comparisons))
+        comparisons = self.compare(make_result([10.0], [1.0], { 'lightVertices': 500, 'total': 500 }), baseline)
+        self.assertEqual(find(comparisons, 'total').status, Status.IMPROVED)
+
+    def test_zero_baseline(self):
+        comparisons = self.compare(make_result([10.0], [0.0]), make_result([10.0], [0.0]))
+        self.assertIsNone(find(comparisons, kSortLane).change)
+
+class ToleranceTest(unittest.TestCase):
+
+    def test_from_header(self):
+        tolerance = Tolerance.from_header({ 'tolerance': 0.2, 'memory_tolerance': 0.05 })
+        self.assertEqual(tolerance.time, 0.2)
+        self.assertEqual(tolerance.time_abs, perf.DEFAULT_TIME_TOLERANCE_ABS)
+        self.assertEqual(tolerance.memory, 0.05)
+
+class ReportTest(unittest.TestCase):
+
+    def test_short_name(self):
+        self.assertEqual(perf.short_name(kSortLane), 'sortLightVertices/gpuTime')
+        self.assertEqual(perf.short_name('total'), 'total')
+
+    def test_format_report(self):
+        comparisons = perf.compare(perf.summarize(make_result([12.0], [1.0])), perf.summarize(make_result([10.0], [1.0])))
+        lines = perf.format_report(comparisons)
+        self.assertEqual(len(lines), 1)
+        self.assertIn('REGRESSED', lines[0])
+        self.assertIn('traceLightPath/gpuTime', lines[0])
+        self.assertIn('+20.0%', lines[0])
+        self.assertEqual(len(perf.format_report(comparisons, verbose=True)), len(comparisons))
+
+    def test_load_result(self):
+        result = make_result([1.0, 2.0], [0.5, 0.5], { 'total': 64 })
+        with tempfile.TemporaryDirectory() as d:
+            path = Path(d) / perf.RESULT_FILE
+            with open(path, 'w') as f:
+                json.dump(result, f)
+            self.assertEqual(perf.load_result(path), result)
+
+if __name__ == '__main__':
+    unittest.main()